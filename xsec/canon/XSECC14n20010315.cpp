@@ -367,6 +367,12 @@ void XSECC14n20010315::init() {
 	// Namespace handling
 	m_useNamespaceStack = true;
 
+	// Nothing excluded
+	mp_excludedNode = NULL;
+	m_excludedNodeFound = false;
+	m_excludedOffset = 0;
+	m_outputCount = 0;
+
 	// INitialise the stack - even if we don't use it later, at least this sets us up
 	if (mp_startNode != NULL) {
 		stackInit(mp_startNode->getParentNode());
@@ -435,6 +441,22 @@ bool XSECC14n20010315::getCommentsProcessing(void) {
 
 }
 
+// --------------------------------------------------------------------------------
+//           XSECC14n20010315 Excluded node
+// --------------------------------------------------------------------------------
+
+bool XSECC14n20010315::getExcludedNodeOffset(xsecsize_t & offset) const {
+
+	// Only valid once the canonicaliser has walked past the node
+
+	if (!m_excludedNodeFound)
+		return false;
+
+	offset = m_excludedOffset;
+	return true;
+
+}
+
 
 // --------------------------------------------------------------------------------
 //           XSECC14n20010315 XPathSelectNodes method
@@ -954,6 +976,9 @@ xsecsize_t XSECC14n20010315::processNextNode() {
 
 	}
 
+	// Everything in the current buffer has been handed out
+	m_outputCount += m_bufferLength;
+
 	// Always zeroise buffers to make work simpler
 	m_bufferLength = m_bufferPoint = 0;
 	m_buffer.sbStrcpyIn("");
@@ -1104,6 +1129,16 @@ xsecsize_t XSECC14n20010315::processNextNode() {
 
 		// If we are going "up" then we simply close off the element
 
+		if (!m_returnedFromChild && mp_nextNode == mp_excludedNode) {
+
+			// Skip the subtree - the caller will fill the gap
+			m_excludedOffset = m_outputCount;
+			m_excludedNodeFound = true;
+			m_returnedFromChild = true;
+			break;
+
+		}
+
 		if (m_returnedFromChild) {
 			if (processNode) {
 				m_buffer.sbStrcpyIn ("</");
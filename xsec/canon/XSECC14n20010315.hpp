@@ -77,6 +77,15 @@ struct XSECNodeListElt {
 #define NOURI_PREFIX         "a"
 #define HAVEURI_PREFIX       "b"
 
+// --------------------------------------------------------------------------------
+//           Escaping of text and attribute values
+// --------------------------------------------------------------------------------
+
+// Shared with XSECC14nSAX.  Input and output are UTF-8.
+
+safeBuffer c14nCleanText(safeBuffer &input);
+safeBuffer c14nCleanAttribute(safeBuffer &input);
+
 // --------------------------------------------------------------------------------
 //           XSECC14n20010315 Object definition
 // --------------------------------------------------------------------------------
@@ -124,6 +133,11 @@ public:
 	// Namespace processing
 	void setUseNamespaceStack(bool flag) {m_useNamespaceStack = flag;}
 
+	// Skip an element (and its subtree), recording where in the output it
+	// would have started.  Used to serialise enveloped signatures.
+	void setExcludedNode(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * n) {mp_excludedNode = n;}
+	bool getExcludedNodeOffset(xsecsize_t & offset) const;
+
 protected:
 
 	// Implementation of virtual function
@@ -176,6 +190,12 @@ private:
 	bool					m_useNamespaceStack;
 	XSECXMLNSStack			m_nsStack;
 
+	// Excluded node handling
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * mp_excludedNode;
+	bool					m_excludedNodeFound;
+	xsecsize_t				m_excludedOffset;	// Output position of the excluded node
+	xsecsize_t				m_outputCount;		// Bytes output prior to current buffer
+
 
 
 };
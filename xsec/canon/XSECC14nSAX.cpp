@@ -0,0 +1,759 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECC14nSAX := Canonicaliser driven by SAX2 events, for byte streams
+ *                that would otherwise have to be parsed into a DOM
+ *
+ * $Id$
+ *
+ */
+
+// XSEC includes
+#include <xsec/canon/XSECC14nSAX.hpp>
+#include <xsec/canon/XSECC14n20010315.hpp>
+#include <xsec/framework/XSECError.hpp>
+#include <xsec/utils/XSECSafeBufferFormatter.hpp>
+
+// Xerces includes
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+#include <algorithm>
+#include <string.h>
+#include <stdlib.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+// --------------------------------------------------------------------------------
+//           Constant Strings
+// --------------------------------------------------------------------------------
+
+static const XMLCh s_xmlns[] = {
+
+	chLatin_x, chLatin_m, chLatin_l, chLatin_n, chLatin_s, chNull };
+
+// Prefix and URI of an undeclared default namespace
+static char s_empty[] = "";
+
+// --------------------------------------------------------------------------------
+//           Constructors and Destructors
+// --------------------------------------------------------------------------------
+
+XSECC14nSAX::XSECC14nSAX(InputSource * is) :
+mp_inputSource(is),
+mp_reader(NULL),
+m_started(false),
+mp_formatter(NULL),
+m_depth(0),
+m_rootDone(false),
+m_inDTD(false),
+m_processComments(true),
+m_exclusive(false),
+m_exclusiveDefault(false),
+mp_excludedURI(NULL),
+mp_excludedName(NULL),
+m_excludedDepth(0),
+m_excludedFound(false),
+m_excludedLength(0),
+m_renderedBase(0) {
+
+	mp_doc = NULL;
+	mp_startNode = mp_nextNode = NULL;
+	m_bufferLength = m_bufferPoint = 0;
+	m_allNodesDone = false;
+
+	m_securityManager.setEntityExpansionLimit(XSEC_ENTITY_EXPANSION_LIMIT);
+
+	XSECnew(mp_formatter, XSECSafeBufferFormatter("UTF-8",XMLFormatter::NoEscapes,
+												XMLFormatter::UnRep_CharRef));
+
+}
+
+XSECC14nSAX::~XSECC14nSAX() {
+
+	// The reader goes first as it may still hold a stream from the source
+	if (mp_reader != NULL)
+		delete mp_reader;
+
+	if (mp_inputSource != NULL)
+		delete mp_inputSource;
+
+	if (mp_formatter != NULL)
+		delete mp_formatter;
+
+	NSEntryVectorType::size_type i;
+	for (i = 0; i < m_inScope.size(); ++i) {
+		XSEC_RELEASE_XMLCH(m_inScope[i].prefix);
+		XSEC_RELEASE_XMLCH(m_inScope[i].uri);
+	}
+
+	XMLAttrEntryVectorType::size_type k;
+	for (k = 0; k < m_xmlAttrs.size(); ++k) {
+		XSEC_RELEASE_XMLCH(m_xmlAttrs[k].localName);
+		XSEC_RELEASE_XMLCH(m_xmlAttrs[k].value);
+	}
+
+	CharListVectorType::size_type j;
+	for (j = 0; j < m_exclNSList.size(); ++j)
+		free(m_exclNSList[j]);
+
+	if (mp_excludedURI != NULL)
+		XSEC_RELEASE_XMLCH(mp_excludedURI);
+	if (mp_excludedName != NULL)
+		XSEC_RELEASE_XMLCH(mp_excludedName);
+
+}
+
+// --------------------------------------------------------------------------------
+//           Options
+// --------------------------------------------------------------------------------
+
+void XSECC14nSAX::setExclusive(void) {
+
+	m_exclusive = true;
+	m_exclusiveDefault = true;
+
+}
+
+void XSECC14nSAX::setExclusive(char * xmlnsList) {
+
+	setExclusive();
+
+	// White space separated list of prefixes to be treated inclusively
+
+	char * p = xmlnsList;
+
+	while (*p != '\0') {
+
+		while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+			++p;
+
+		char * start = p;
+		while (!(*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == '\0'))
+			++p;
+
+		if (p == start)
+			continue;
+
+		char * prefix = (char *) malloc(p - start + 1);
+		if (prefix == NULL) {
+			throw XSECException (XSECException::MemoryAllocationFail,
+				"Error allocating a string buffer in XSECC14nSAX::setExclusive");
+		}
+
+		memcpy(prefix, start, p - start);
+		prefix[p - start] = '\0';
+
+		if (strcmp(prefix, "#default") == 0) {
+
+			m_exclusiveDefault = false;
+			free(prefix);
+
+		}
+		else
+			m_exclNSList.push_back(prefix);
+
+	}
+
+}
+
+void XSECC14nSAX::setInclusive11(void) {
+
+	// 1.1 only differs from 1.0 in what is inherited from ancestors that
+	// are not output - never the case for a complete document
+
+	m_exclusive = false;
+	m_exclusiveDefault = false;
+
+}
+
+void XSECC14nSAX::setExcludedElement(const XMLCh * uri, const XMLCh * localName) {
+
+	if (mp_excludedURI != NULL)
+		XSEC_RELEASE_XMLCH(mp_excludedURI);
+	if (mp_excludedName != NULL)
+		XSEC_RELEASE_XMLCH(mp_excludedName);
+
+	mp_excludedURI = XMLString::replicate(uri);
+	mp_excludedName = XMLString::replicate(localName);
+
+}
+
+const char * XSECC14nSAX::getExcludedElement(xsecsize_t & length) const {
+
+	// Not complete until its end tag has been read
+	if (!m_excludedFound || m_excludedDepth != 0) {
+		length = 0;
+		return NULL;
+	}
+
+	length = m_excludedLength;
+	return m_excluded.rawCharBuffer();
+
+}
+
+// --------------------------------------------------------------------------------
+//           Utilities
+// --------------------------------------------------------------------------------
+
+bool XSECC14nSAX::compareNS(const NSEntry & a, const NSEntry & b) {
+
+	// The default namespace ("") sorts first
+	return strcmp(a.prefix, b.prefix) < 0;
+
+}
+
+bool XSECC14nSAX::compareAttr(const AttrEntry & a, const AttrEntry & b) {
+
+	// Namespace URI then local name.  Attributes in no namespace have an
+	// empty URI so come first.
+
+	int res = strcmp(a.uri, b.uri);
+	if (res == 0)
+		res = strcmp(a.localName, b.localName);
+
+	return res < 0;
+
+}
+
+int XSECC14nSAX::findInScope(const char * prefix, xsecsize_t len) const {
+
+	int i = (int) m_inScope.size();
+
+	while (--i >= 0) {
+
+		const char * p = m_inScope[i].prefix;
+		if (strncmp(p, prefix, len) == 0 && p[len] == '\0')
+			return i;
+
+	}
+
+	return -1;
+
+}
+
+const char * XSECC14nSAX::findRendered(const char * prefix) const {
+
+	// Inside the excluded element only its own declarations count
+
+	int i = (int) m_rendered.size();
+
+	while (--i >= (int) m_renderedBase) {
+
+		if (strcmp(m_rendered[i].prefix, prefix) == 0)
+			return m_rendered[i].uri;
+
+	}
+
+	return NULL;
+
+}
+
+void XSECC14nSAX::addRenderCandidate(char * prefix, char * uri) {
+
+	NSEntryVectorType::size_type i;
+	for (i = 0; i < m_toRender.size(); ++i) {
+		if (strcmp(m_toRender[i].prefix, prefix) == 0)
+			return;
+	}
+
+	// Only output if the nearest output ancestor doesn't already have it.
+	// Nothing rendered for the default namespace is the same as xmlns="".
+
+	const char * r = findRendered(prefix);
+	if (r == NULL && *prefix == '\0')
+		r = s_empty;
+
+	if (r != NULL && strcmp(r, uri) == 0)
+		return;
+
+	NSEntry e;
+	e.prefix = prefix;
+	e.uri = uri;
+	e.depth = m_depth;
+
+	m_toRender.push_back(e);
+
+}
+
+void XSECC14nSAX::addUsedPrefix(const char * prefix, xsecsize_t len) {
+
+	int i = findInScope(prefix, len);
+
+	if (i >= 0)
+		addRenderCandidate(m_inScope[i].prefix, m_inScope[i].uri);
+	else if (len == 0)
+		addRenderCandidate(s_empty, s_empty);
+
+}
+
+void XSECC14nSAX::addInheritedXMLAttrs(void) {
+
+	// The excluded element is canonicalised on its own, so give it the
+	// xml: attributes an inclusive canonicalisation would take from its
+	// ancestors.  The nearest one wins and the element's own override.
+
+	int i = (int) m_xmlAttrs.size();
+
+	while (--i >= 0) {
+
+		const char * ln = m_xmlAttrs[i].localName;
+		bool found = false;
+
+		AttrEntryVectorType::size_type j;
+		for (j = 0; j < m_attrs.size() && !found; ++j) {
+
+			const char * q = m_attrs[j].qName;
+			found = (strncmp(q, "xml:", 4) == 0 && strcmp(&q[4], ln) == 0);
+
+		}
+
+		if (found)
+			continue;
+
+		safeBuffer qName;
+		qName.sbStrcpyIn("xml:");
+		qName.sbStrcatIn(ln);
+
+		AttrEntry a;
+		a.uri = XMLString::replicate(format(XMLUni::fgXMLURIName));
+		a.localName = XMLString::replicate(ln);
+		a.qName = XMLString::replicate(qName.rawCharBuffer());
+		a.value = XMLString::replicate(m_xmlAttrs[i].value);
+		m_attrs.push_back(a);
+
+	}
+
+}
+
+void XSECC14nSAX::output(const char * str, xsecsize_t len) {
+
+	if (m_excludedDepth != 0) {
+		m_excluded.sbMemcpyIn(m_excludedLength, str, len);
+		m_excludedLength += len;
+	}
+	else {
+		m_buffer.sbMemcpyIn(m_bufferLength, str, len);
+		m_bufferLength += len;
+	}
+
+}
+
+void XSECC14nSAX::output(const char * str) {
+
+	output(str, (xsecsize_t) strlen(str));
+
+}
+
+void XSECC14nSAX::outputAttributeValue(const char * value) {
+
+	m_formatBuffer.sbStrcpyIn(value);
+	safeBuffer sb = c14nCleanAttribute(m_formatBuffer);
+
+	output("=\"");
+	output(sb.rawCharBuffer(), sb.sbStrlen());
+	output("\"");
+
+}
+
+const char * XSECC14nSAX::format(const XMLCh * str) {
+
+	m_formatBuffer << (*mp_formatter << str);
+	m_formatBuffer.setBufferType(safeBuffer::BUFFER_CHAR);
+
+	return m_formatBuffer.rawCharBuffer();
+
+}
+
+const char * XSECC14nSAX::format(const XMLCh * chars, xsecsize_t length) {
+
+	// SAX character data is not terminated
+
+	xsecsize_t bytes = length * (xsecsize_t) sizeof(XMLCh);
+
+	m_text.sbMemcpyIn(chars, bytes);
+	m_text[bytes] = 0;
+	m_text[bytes + 1] = 0;
+	m_text.setBufferType(safeBuffer::BUFFER_UNICODE);
+
+	return format(m_text.rawXMLChBuffer());
+
+}
+
+bool XSECC14nSAX::isExcludedElement(const XMLCh * uri, const XMLCh * localname) const {
+
+	return (mp_excludedName != NULL && !m_excludedFound &&
+		XMLString::equals(localname, mp_excludedName) &&
+		XMLString::equals(uri, mp_excludedURI));
+
+}
+
+// --------------------------------------------------------------------------------
+//           Parsing
+// --------------------------------------------------------------------------------
+
+void XSECC14nSAX::finish(void) {
+
+	m_allNodesDone = true;
+
+	if (mp_reader->getErrorCount() > 0 || m_depth != 0 || !m_rootDone)
+		throw XSECException(XSECException::XSLError, "Errors occured parsing BYTE STREAM");
+
+}
+
+xsecsize_t XSECC14nSAX::processNextNode() {
+
+	if (m_allNodesDone)
+		return 0;
+
+	// Always zeroise buffers to make work simpler
+	m_bufferLength = m_bufferPoint = 0;
+
+	if (!m_started) {
+
+		mp_reader = XMLReaderFactory::createXMLReader();
+
+		mp_reader->setFeature(XMLUni::fgSAX2CoreNameSpaces, true);
+		mp_reader->setFeature(XMLUni::fgSAX2CoreNameSpacePrefixes, true);
+		mp_reader->setFeature(XMLUni::fgXercesLoadExternalDTD, false);
+		mp_reader->setFeature(XMLUni::fgXercesSchema, false);
+		mp_reader->setProperty(XMLUni::fgXercesSecurityManager, &m_securityManager);
+		mp_reader->setContentHandler(this);
+		mp_reader->setLexicalHandler(this);
+
+		m_started = true;
+
+		if (!mp_reader->parseFirst(*mp_inputSource, m_token))
+			finish();
+
+	}
+
+	// Scan until something is output.  Only the current event's output
+	// is ever held.
+
+	while (m_bufferLength == 0 && !m_allNodesDone) {
+
+		if (!mp_reader->parseNext(m_token))
+			finish();
+
+	}
+
+	return m_bufferLength;
+
+}
+
+// --------------------------------------------------------------------------------
+//           SAX2 handlers
+// --------------------------------------------------------------------------------
+
+void XSECC14nSAX::startElement(const XMLCh* const uri,
+							   const XMLCh* const localname,
+							   const XMLCh* const qname,
+							   const Attributes& attrs) {
+
+	++m_depth;
+
+	// Start of the excluded element?  Its serialisation has to stand on
+	// its own, so it declares everything in scope.
+
+	bool apex = false;
+
+	if (isExcludedElement(uri, localname)) {
+
+		apex = true;
+		m_excludedFound = true;
+		m_excludedDepth = m_depth;
+		m_excludedLength = 0;
+		m_renderedBase = m_rendered.size();
+
+	}
+
+	// Split the namespace declarations from the attributes
+
+	XMLSize_t sz = attrs.getLength();
+
+	for (XMLSize_t i = 0; i < sz; ++i) {
+
+		const XMLCh * aq = attrs.getQName(i);
+
+		if (XMLString::compareNString(aq, s_xmlns, 5) == 0 &&
+			(aq[5] == chNull || aq[5] == chColon)) {
+
+			// The xml prefix is never output
+			const char * p = format(aq[5] == chNull ? &aq[5] : &aq[6]);
+			if (strcmp(p, "xml") == 0)
+				continue;
+
+			NSEntry e;
+			e.prefix = XMLString::replicate(p);
+			e.uri = XMLString::replicate(format(attrs.getValue(i)));
+			e.depth = m_depth;
+			m_inScope.push_back(e);
+
+		}
+		else {
+
+			AttrEntry a;
+			a.uri = XMLString::replicate(format(attrs.getURI(i)));
+			a.localName = XMLString::replicate(format(attrs.getLocalName(i)));
+			a.qName = XMLString::replicate(format(aq));
+			a.value = XMLString::replicate(format(attrs.getValue(i)));
+			m_attrs.push_back(a);
+
+			// Remember xml: attributes until the excluded element is seen
+
+			if (!apex && mp_excludedName != NULL && !m_excludedFound &&
+				strncmp(a.qName, "xml:", 4) == 0) {
+
+				XMLAttrEntry x;
+				x.localName = XMLString::replicate(a.localName);
+				x.value = XMLString::replicate(a.value);
+				x.depth = m_depth;
+				m_xmlAttrs.push_back(x);
+
+			}
+
+		}
+
+	}
+
+	if (apex)
+		addInheritedXMLAttrs();
+
+	// Work out which namespace nodes to output
+
+	m_toRender.clear();
+
+	if (!m_exclusive || m_excludedDepth != 0) {
+
+		// The whole document is output, so everything in scope at the
+		// parent has been rendered already.  Only declarations made on
+		// this element can make a difference.
+
+		NSEntryVectorType::size_type i = m_inScope.size();
+		while (i > 0 && (apex || m_inScope[i - 1].depth == m_depth)) {
+			--i;
+			addRenderCandidate(m_inScope[i].prefix, m_inScope[i].uri);
+		}
+
+	}
+
+	else {
+
+		// Exclusive - the namespaces visibly utilised by the element and
+		// its attributes, plus any to be treated inclusively
+
+		int colon = XMLString::indexOf(qname, chColon);
+		if (colon < 0)
+			addUsedPrefix(s_empty, 0);
+		else {
+			const char * p = format(qname, (xsecsize_t) colon);
+			addUsedPrefix(p, (xsecsize_t) strlen(p));
+		}
+
+		AttrEntryVectorType::size_type j;
+		for (j = 0; j < m_attrs.size(); ++j) {
+
+			const char * q = m_attrs[j].qName;
+			const char * c = strchr(q, ':');
+
+			if (c != NULL && !(c - q == 3 && strncmp(q, "xml", 3) == 0))
+				addUsedPrefix(q, (xsecsize_t) (c - q));
+
+		}
+
+		CharListVectorType::size_type k;
+		for (k = 0; k < m_exclNSList.size(); ++k) {
+
+			int l = findInScope(m_exclNSList[k], (xsecsize_t) strlen(m_exclNSList[k]));
+			if (l >= 0)
+				addRenderCandidate(m_inScope[l].prefix, m_inScope[l].uri);
+
+		}
+
+		if (!m_exclusiveDefault)
+			addUsedPrefix(s_empty, 0);
+
+	}
+
+	std::sort(m_toRender.begin(), m_toRender.end(), compareNS);
+	std::sort(m_attrs.begin(), m_attrs.end(), compareAttr);
+
+	// Output the start tag
+
+	output("<");
+	output(format(qname));
+
+	NSEntryVectorType::size_type n;
+	for (n = 0; n < m_toRender.size(); ++n) {
+
+		output(" xmlns");
+		if (m_toRender[n].prefix[0] != '\0') {
+			output(":");
+			output(m_toRender[n].prefix);
+		}
+		outputAttributeValue(m_toRender[n].uri);
+
+		m_rendered.push_back(m_toRender[n]);
+
+	}
+
+	AttrEntryVectorType::size_type a;
+	for (a = 0; a < m_attrs.size(); ++a) {
+
+		output(" ");
+		output(m_attrs[a].qName);
+		outputAttributeValue(m_attrs[a].value);
+
+		XSEC_RELEASE_XMLCH(m_attrs[a].uri);
+		XSEC_RELEASE_XMLCH(m_attrs[a].localName);
+		XSEC_RELEASE_XMLCH(m_attrs[a].qName);
+		XSEC_RELEASE_XMLCH(m_attrs[a].value);
+
+	}
+
+	m_attrs.clear();
+
+	output(">");
+
+}
+
+void XSECC14nSAX::endElement(const XMLCh* const uri,
+							 const XMLCh* const localname,
+							 const XMLCh* const qname) {
+
+	output("</");
+	output(format(qname));
+	output(">");
+
+	// Unwind this element's namespaces
+
+	while (!m_rendered.empty() && m_rendered.back().depth == m_depth)
+		m_rendered.pop_back();
+
+	while (!m_inScope.empty() && m_inScope.back().depth == m_depth) {
+		XSEC_RELEASE_XMLCH(m_inScope.back().prefix);
+		XSEC_RELEASE_XMLCH(m_inScope.back().uri);
+		m_inScope.pop_back();
+	}
+
+	while (!m_xmlAttrs.empty() && m_xmlAttrs.back().depth == m_depth) {
+		XSEC_RELEASE_XMLCH(m_xmlAttrs.back().localName);
+		XSEC_RELEASE_XMLCH(m_xmlAttrs.back().value);
+		m_xmlAttrs.pop_back();
+	}
+
+	if (m_excludedDepth == m_depth) {
+		m_excludedDepth = 0;
+		m_renderedBase = 0;
+	}
+
+	if (--m_depth == 0)
+		m_rootDone = true;
+
+}
+
+void XSECC14nSAX::characters(const XMLCh* const chars, const xsecsize_t length) {
+
+	// Nothing outside the document element is text
+	if (m_depth == 0)
+		return;
+
+	format(chars, length);
+	safeBuffer sb = c14nCleanText(m_formatBuffer);
+	output(sb.rawCharBuffer(), sb.sbStrlen());
+
+}
+
+void XSECC14nSAX::ignorableWhitespace(const XMLCh* const chars, const xsecsize_t length) {
+
+	// Kept, as the DOM parser does
+	characters(chars, length);
+
+}
+
+void XSECC14nSAX::comment(const XMLCh* const chars, const xsecsize_t length) {
+
+	// The excluded element keeps its comments - what is done with them
+	// is up to whoever canonicalises it
+
+	if (m_inDTD || (!m_processComments && m_excludedDepth == 0))
+		return;
+
+	// Outside the document element, comments are separated from it by
+	// a line feed
+
+	if (m_depth == 0 && m_rootDone)
+		output("\n");
+
+	output("<!--");
+	output(format(chars, length));
+	output("-->");
+
+	if (m_depth == 0 && !m_rootDone)
+		output("\n");
+
+}
+
+void XSECC14nSAX::processingInstruction(const XMLCh* const target,
+										const XMLCh* const data) {
+
+	if (m_inDTD)
+		return;
+
+	if (m_depth == 0 && m_rootDone)
+		output("\n");
+
+	output("<?");
+	output(format(target));
+
+	const char * d = format(data);
+	if (*d != '\0') {
+		output(" ");
+		output(d);
+	}
+
+	output("?>");
+
+	if (m_depth == 0 && !m_rootDone)
+		output("\n");
+
+}
+
+void XSECC14nSAX::startDTD(const XMLCh* const name,
+						   const XMLCh* const publicId,
+						   const XMLCh* const systemId) {
+
+	m_inDTD = true;
+
+}
+
+void XSECC14nSAX::endDTD() {
+
+	m_inDTD = false;
+
+}
@@ -0,0 +1,263 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECC14nSAX := Canonicaliser driven by SAX2 events, for byte streams
+ *                that would otherwise have to be parsed into a DOM
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSECC14NSAX_INCLUDE
+#define XSECC14NSAX_INCLUDE
+
+// XSEC includes
+#include <xsec/framework/XSECDefs.hpp>
+#include <xsec/utils/XSECSafeBuffer.hpp>
+#include <xsec/canon/XSECCanon.hpp>
+
+// Xerces includes
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/framework/XMLPScanToken.hpp>
+#include <xercesc/util/SecurityManager.hpp>
+
+// General includes
+#include <vector>
+
+XSEC_DECLARE_XERCES_CLASS(InputSource);
+XSEC_DECLARE_XERCES_CLASS(SAX2XMLReader);
+
+class XSECSafeBufferFormatter;
+
+/**
+ * @ingroup internal
+ */
+
+/**
+ * \brief Canonicalise a serialised document without building a DOM.
+ *
+ * A byte stream that has to be canonicalised (an external reference, the
+ * output of a base64 or XSLT transform) used to be parsed into a DOM that
+ * XSECC14n20010315 then walked.  This class runs a progressive SAX2 parse
+ * instead, writing canonical output as events arrive, so only the current
+ * element's namespace context is held and memory use does not grow with
+ * the size of the document.
+ *
+ * The input is always a complete document, so there is no node-set and
+ * no ancestor context to take into account.  For a complete document
+ * inclusive c14n 1.0 and 1.1 give the same output.  Exclusive c14n (with
+ * an optional list of inclusive prefixes) and comment handling behave as
+ * for XSECC14n20010315.
+ *
+ * The parser applies the library's parse policy - namespaces on, no
+ * external DTD loading and entity expansion limited to
+ * XSEC_ENTITY_EXPANSION_LIMIT.
+ */
+
+class CANON_EXPORT XSECC14nSAX : public XSECCanon,
+	public XERCES_CPP_NAMESPACE_QUALIFIER DefaultHandler {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	/**
+	 * \brief Constructor
+	 *
+	 * @param is Source of the document.  Adopted by the canonicaliser.
+	 */
+
+	XSECC14nSAX(XERCES_CPP_NAMESPACE_QUALIFIER InputSource * is);
+	virtual ~XSECC14nSAX();
+
+	//@}
+
+	/** @name Canonicalisation options */
+	//@{
+
+	void setCommentsProcessing(bool onoff) {m_processComments = onoff;}
+	bool getCommentsProcessing(void) {return m_processComments;}
+	void setExclusive(void);
+	void setExclusive(char * xmlnsList);
+	void setInclusive11(void);
+
+	/**
+	 * \brief Leave an element out of the output
+	 *
+	 * The first element with the given name, and everything in it, is
+	 * written to a separate buffer instead of the canonical output (the
+	 * enveloped-signature transform, applied as the document is read).
+	 * The copy is in inclusive canonical form with every namespace in
+	 * scope declared on the element, and the xml: attributes it inherits
+	 * from its ancestors added to it, so it can be parsed on its own and
+	 * canonicalised as if it were still in the document.  Comments
+	 * inside it are always kept.
+	 *
+	 * @param uri Namespace URI of the element
+	 * @param localName Local name of the element
+	 */
+
+	void setExcludedElement(const XMLCh * uri, const XMLCh * localName);
+
+	/**
+	 * \brief Get the element left out of the output
+	 *
+	 * @param length Set to the number of bytes in the element
+	 * @returns The (UTF-8) element, or NULL if it has not been seen
+	 */
+
+	const char * getExcludedElement(xsecsize_t & length) const;
+
+	//@}
+
+	/** @name SAX2 handlers */
+	//@{
+
+	virtual void startElement(const XMLCh* const uri,
+		const XMLCh* const localname,
+		const XMLCh* const qname,
+		const XERCES_CPP_NAMESPACE_QUALIFIER Attributes& attrs);
+	virtual void endElement(const XMLCh* const uri,
+		const XMLCh* const localname,
+		const XMLCh* const qname);
+	virtual void characters(const XMLCh* const chars, const xsecsize_t length);
+	virtual void ignorableWhitespace(const XMLCh* const chars, const xsecsize_t length);
+	virtual void comment(const XMLCh* const chars, const xsecsize_t length);
+	virtual void processingInstruction(const XMLCh* const target,
+		const XMLCh* const data);
+	virtual void startDTD(const XMLCh* const name,
+		const XMLCh* const publicId,
+		const XMLCh* const systemId);
+	virtual void endDTD();
+
+	//@}
+
+protected:
+
+	// Implementation of virtual function
+	xsecsize_t processNextNode();
+
+private:
+
+	// A namespace declaration in scope (or rendered)
+	struct NSEntry {
+		char			* prefix;		// "" for the default namespace
+		char			* uri;
+		unsigned int	depth;			// Element depth it belongs to
+	};
+
+	// An attribute waiting to be sorted
+	struct AttrEntry {
+		char			* uri;
+		char			* localName;
+		char			* qName;
+		char			* value;
+	};
+
+	// An xml: attribute of an open element
+	struct XMLAttrEntry {
+		char			* localName;
+		char			* value;
+		unsigned int	depth;
+	};
+
+#if defined(XSEC_NO_NAMESPACES)
+	typedef vector<NSEntry>					NSEntryVectorType;
+	typedef vector<AttrEntry>				AttrEntryVectorType;
+	typedef vector<XMLAttrEntry>			XMLAttrEntryVectorType;
+	typedef vector<char *>					CharListVectorType;
+#else
+	typedef std::vector<NSEntry>			NSEntryVectorType;
+	typedef std::vector<AttrEntry>			AttrEntryVectorType;
+	typedef std::vector<XMLAttrEntry>		XMLAttrEntryVectorType;
+	typedef std::vector<char *>				CharListVectorType;
+#endif
+
+	static bool compareNS(const NSEntry & a, const NSEntry & b);
+	static bool compareAttr(const AttrEntry & a, const AttrEntry & b);
+
+	int findInScope(const char * prefix, xsecsize_t len) const;
+	const char * findRendered(const char * prefix) const;
+	void addRenderCandidate(char * prefix, char * uri);
+	void addUsedPrefix(const char * prefix, xsecsize_t len);
+	void addInheritedXMLAttrs(void);
+	void output(const char * str);
+	void output(const char * str, xsecsize_t len);
+	void outputAttributeValue(const char * value);
+	bool isExcludedElement(const XMLCh * uri, const XMLCh * localname) const;
+	const char * format(const XMLCh * str);
+	const char * format(const XMLCh * chars, xsecsize_t length);
+	void finish(void);
+
+	// Parsing
+	XERCES_CPP_NAMESPACE_QUALIFIER InputSource
+							* mp_inputSource;
+	XERCES_CPP_NAMESPACE_QUALIFIER SAX2XMLReader
+							* mp_reader;
+	XERCES_CPP_NAMESPACE_QUALIFIER SecurityManager
+							m_securityManager;
+	XERCES_CPP_NAMESPACE_QUALIFIER XMLPScanToken
+							m_token;
+	bool					m_started;
+
+	// Formatting
+	XSECSafeBufferFormatter	* mp_formatter;
+	safeBuffer				m_formatBuffer;
+	safeBuffer				m_text;				// Scratch for character data
+
+	// Document state
+	unsigned int			m_depth;			// Element depth (root is 1)
+	bool					m_rootDone;			// Document element closed?
+	bool					m_inDTD;
+
+	// Namespaces
+	NSEntryVectorType		m_inScope;			// Declarations (owned strings)
+	NSEntryVectorType		m_rendered;			// Output by an open element
+	NSEntryVectorType		m_toRender;			// Scratch for one element
+	AttrEntryVectorType		m_attrs;			// Scratch for one element
+
+	// Options
+	bool					m_processComments;
+	bool					m_exclusive;
+	bool					m_exclusiveDefault;	// Default namespace is exclusive
+	CharListVectorType		m_exclNSList;		// Prefixes treated inclusively
+
+	// Excluded element
+	XMLCh					* mp_excludedURI;
+	XMLCh					* mp_excludedName;
+	unsigned int			m_excludedDepth;	// Depth of the element while in it
+	bool					m_excludedFound;
+	safeBuffer				m_excluded;			// Its serialisation
+	xsecsize_t				m_excludedLength;
+	NSEntryVectorType::size_type
+							m_renderedBase;		// First m_rendered entry that counts
+	XMLAttrEntryVectorType	m_xmlAttrs;			// Inherited by the excluded element
+
+	// Unimplemented
+	XSECC14nSAX();
+	XSECC14nSAX(const XSECC14nSAX &);
+	XSECC14nSAX & operator = (const XSECC14nSAX &);
+
+};
+
+#endif /* XSECC14NSAX_INCLUDE */
@@ -38,56 +38,39 @@
 XERCES_CPP_NAMESPACE_USE
 
 // --------------------------------------------------------------------------------
-//           Holder structures
+//           Name hashing
 // --------------------------------------------------------------------------------
 
-typedef struct XSECNSHolderStruct {
+static unsigned int hashName(const XMLCh * name) {
 
-	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode	* mp_ns;		// Actual NS attribute
-	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode	* mp_owner;		// Owner Element
+	unsigned int h = 0;
 
-	struct XSECNSHolderStruct				* mp_hides;		// WHat does this NS hide?
-	struct XSECNSHolderStruct				* mp_next;		// Next in list
-
-	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode	* mp_printed;	// Node at which it was printed
-
-	bool									m_isDefault;	// Is this a default NS?
-
-} XSECNSHolder;
-
-typedef struct XSECNSElementStruct {
+	if (name != NULL) {
+		while (*name != 0)
+			h = (h * 31) + (unsigned int) *name++;
+	}
 
-	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode	* mp_elt;		// Element
-	struct XSECNSHolderStruct				* mp_firstNS;	// WHat does this NS hide?
+	return h;
 
-} XSECNSElement;
+}
 
 // --------------------------------------------------------------------------------
 //           Construct/Destruct
 // --------------------------------------------------------------------------------
 
 
+// Starting number of hash buckets (a power of two)
+#define XSEC_NS_BUCKETS		32
+
 XSECXMLNSStack::XSECXMLNSStack() {
 
+	m_iterator = 0;
+	m_buckets.resize(XSEC_NS_BUCKETS, -1);
+
 }
 
 XSECXMLNSStack::~XSECXMLNSStack() {
 
-	// Need to iterate through the Stack to 
-	XSECNSElement * t;
-	XSECNSHolder * u, *v;
-	
-	while (m_elements.size() > 0) {
-		t = m_elements.top();
-		u = t->mp_firstNS;
-		while (u != NULL) {
-			v = u->mp_next;
-			delete u;
-			u = v;
-		}
-		delete t;
-		m_elements.pop();
-	}
 }
 
 
@@ -96,58 +79,49 @@ XSECXMLNSStack::~XSECXMLNSStack() {
 // --------------------------------------------------------------------------------
 void XSECXMLNSStack::pushElement(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * elt) {
 
-	XSECNSElement * t;
-	XSECnew(t, XSECNSElement);
+	XSECNSFrame f;
 
-	t->mp_elt = elt;
-	t->mp_firstNS = NULL;
+	f.mp_elt = elt;
+	f.m_firstEntry = (unsigned int) m_entries.size();
+	f.m_firstPrinted = (unsigned int) m_printedLog.size();
 
-	m_elements.push(t);
+	m_frames.push_back(f);
 
 }
 
 void XSECXMLNSStack::popElement() {
 
-	// First - are there any namespaces to remove from the currently visible list?
-	XSECNSHolder * t, *u;
-	XSECNSElement * e = m_elements.top();
+	if (m_frames.empty())
+		return;
 
-	// Iterate through the current namespaces vector
-	XSECNSHolderVectorType::iterator it = m_currentNS.begin();
+	const XSECNSFrame & f = m_frames.back();
+	unsigned int i;
 
-	while (it != m_currentNS.end()) {
+	// Anything printed at this element is no longer printed
+	for (i = (unsigned int) m_printedLog.size(); i > f.m_firstPrinted; --i) {
 
-		t = *it;
-		if (t->mp_owner == e->mp_elt) {
+		XSECNSEntry & e = m_entries[m_printedLog[i - 1]];
+		if (e.mp_printed == f.mp_elt)
+			e.mp_printed = NULL;
 
-			// Need to delete this
-			m_currentNS.erase(it);
-			if (t->mp_hides != NULL) {
-				m_currentNS.push_back(t->mp_hides);
-			}
-			// TODO - Fix this, it is naieve and slow
-			it = m_currentNS.begin();
+	}
+	m_printedLog.resize(f.m_firstPrinted);
 
-		}
-		else {
-			if (t->mp_printed == e->mp_elt)
-				t->mp_printed = NULL;
-			it++;
-		}
+	// Unwind this element's declarations.  Slots added by this element are
+	// at the end of the visible list (anything added later has already been
+	// popped), so working backwards they can simply be dropped.
+	for (i = (unsigned int) m_entries.size(); i > f.m_firstEntry; --i) {
 
-	}
+		const XSECNSEntry & e = m_entries[i - 1];
+		if (e.m_hides >= 0)
+			m_visible[e.m_slot] = e.m_hides;
+		else
+			dropSlot();
 
-	// OK - Now we delete the NS nodes
-	t = e->mp_firstNS;
-	while (t != NULL) {
-		u = t->mp_next;
-		delete t;
-		t = u;
 	}
+	m_entries.resize(f.m_firstEntry);
 
-	// Now delete the element holder itself
-	m_elements.pop();
-	delete e;
+	m_frames.pop_back();
 
 }
 
@@ -156,60 +130,127 @@ void XSECXMLNSStack::popElement() {
 //           NS Addition
 // --------------------------------------------------------------------------------
 
+int XSECXMLNSStack::findVisible(const XMLCh * name, unsigned int hash) {
+
+	int i = m_buckets[hash & (m_buckets.size() - 1)];
+
+	while (i >= 0) {
+
+		const XSECNSEntry & e = m_entries[m_visible[i]];
+		if (e.m_hash == hash && strEquals(e.mp_ns->getNodeName(), name))
+			return i;
+
+		i = m_chain[i];
+
+	}
+
+	return -1;
+
+}
+
+void XSECXMLNSStack::addSlot(int idx) {
+
+	int slot = (int) m_visible.size();
+	m_visible.push_back(idx);
+
+	if (m_visible.size() > m_buckets.size() * 2) {
+		rehash();
+		return;
+	}
+
+	unsigned int b = m_entries[idx].m_hash & (unsigned int) (m_buckets.size() - 1);
+	m_chain.push_back(m_buckets[b]);
+	m_buckets[b] = slot;
+
+}
+
+void XSECXMLNSStack::dropSlot(void) {
+
+	int slot = (int) m_visible.size() - 1;
+	unsigned int b = m_entries[m_visible[slot]].m_hash & (unsigned int) (m_buckets.size() - 1);
+
+	m_buckets[b] = m_chain[slot];
+	m_chain.pop_back();
+	m_visible.pop_back();
+
+}
+
+void XSECXMLNSStack::rehash(void) {
+
+	// Grow the table and re-insert the slots in order, so each chain
+	// still runs from the newest slot to the oldest
+
+	m_buckets.assign(m_buckets.size() * 2, -1);
+	m_chain.resize(m_visible.size());
+
+	XSECNSIndexVectorType::size_type i;
+	for (i = 0; i < m_visible.size(); ++i) {
+
+		unsigned int b = m_entries[m_visible[i]].m_hash & (unsigned int) (m_buckets.size() - 1);
+		m_chain[i] = m_buckets[b];
+		m_buckets[b] = (int) i;
+
+	}
+
+}
+
 void XSECXMLNSStack::addNamespace(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * ns) {
 
+	if (m_frames.empty()) {
+		throw XSECException(XSECException::InternalError,
+			"XSECXMLNSStack::addNamespace called with no element on the stack");
+	}
+
 	// Create the new entry for this node
-	XSECNSHolder * t, *u;
-	XSECnew(t, XSECNSHolder);
+	const XMLCh * name = ns->getNodeName();
+	XSECNSEntry t;
 
-	t->mp_hides = NULL;
-	t->mp_next = NULL;
-	t->mp_ns = ns;
-	t->mp_owner = (m_elements.top())->mp_elt;
-	t->mp_printed = NULL;
+	t.mp_ns = ns;
+	t.mp_printed = NULL;
+	t.m_hash = hashName(name);
+	t.m_isDefault = strEquals(name, DSIGConstants::s_unicodeStrXmlns);
 
-	t->m_isDefault = strEquals(ns->getNodeName(), DSIGConstants::s_unicodeStrXmlns);
+	int idx = (int) m_entries.size();
 
 	// Does this hide something in the current namespace list?
-	XSECNSHolderVectorType::iterator it = m_currentNS.begin();
+	int slot = findVisible(name, t.m_hash);
 
-	while (it != m_currentNS.end()) {
-		u = (*it);
-		if (strEquals(u->mp_ns->getNodeName(), ns->getNodeName())) {
+	if (slot >= 0) {
+
+		// Take over the slot of the namespace we hide
+		t.m_hides = m_visible[slot];
+		t.m_slot = slot;
+		m_visible[slot] = idx;
+
+	}
+	else {
+
+		t.m_hides = -1;
+		t.m_slot = (int) m_visible.size();
 
-			// This hides a current NS entry
-			t->mp_hides = u;
-			m_currentNS.erase(it);
-			it = m_currentNS.end();
-		}
-		else
-			it++;
 	}
 
-	// Now push it onto the namespace vector
-	m_currentNS.push_back(t);
+	m_entries.push_back(t);
 
-	// Add me to the current element's namespaces
-	XSECNSElement * e = m_elements.top();
-	
-	t->mp_next = e->mp_firstNS;
-	e->mp_firstNS = t;
+	if (slot < 0)
+		addSlot(idx);
 
 }
 
 void XSECXMLNSStack::printNamespace(DOMNode * ns, DOMNode * elt) {
 
-	XSECNSHolder * t;
-	XSECNSHolderVectorType::iterator it = m_currentNS.begin();
+	const XMLCh * name = ns->getNodeName();
+	int slot = findVisible(name, hashName(name));
 
-	while (it != m_currentNS.end()) {
-		t = (*it);
+	if (slot >= 0) {
+
+		XSECNSEntry & e = m_entries[m_visible[slot]];
 		// Fix for bug#47353, go ahead and track printing of default namespaces.
-		if (t->mp_ns == ns) { //  && t->m_isDefault == false) {
-			t->mp_printed = elt;
-			break;
+		if (e.mp_ns == ns) {
+			e.mp_printed = elt;
+			m_printedLog.push_back(m_visible[slot]);
 		}
-		it++;
+
 	}
 }
 
@@ -219,42 +260,46 @@ void XSECXMLNSStack::printNamespace(DOMNode * ns, DOMNode * elt) {
 
 DOMNode * XSECXMLNSStack::getFirstNamespace(void) {
 
-	m_currentNSIterator = m_currentNS.begin();
+	m_iterator = 0;
 
-	while (m_currentNSIterator != m_currentNS.end() && 
-		(*m_currentNSIterator)->mp_printed != NULL)
-		m_currentNSIterator++;
+	while (m_iterator < m_visible.size() && 
+		m_entries[m_visible[m_iterator]].mp_printed != NULL)
+		m_iterator++;
 
-	if (m_currentNSIterator != m_currentNS.end())
-		return (*m_currentNSIterator)->mp_ns;
+	if (m_iterator < m_visible.size())
+		return m_entries[m_visible[m_iterator]].mp_ns;
 
 	return NULL;
 
 }
 
 DOMNode * XSECXMLNSStack::getNextNamespace(void) {
-	if (m_currentNSIterator == m_currentNS.end()) 
+
+	if (m_iterator >= m_visible.size()) 
 		return NULL;
-	m_currentNSIterator++;
-	while (m_currentNSIterator != m_currentNS.end() && 
-		(*m_currentNSIterator)->mp_printed != NULL)
-		m_currentNSIterator++;
 
-	if (m_currentNSIterator == m_currentNS.end()) 
+	m_iterator++;
+	while (m_iterator < m_visible.size() && 
+		m_entries[m_visible[m_iterator]].mp_printed != NULL)
+		m_iterator++;
+
+	if (m_iterator >= m_visible.size()) 
 		return NULL;
 
-	return (*m_currentNSIterator)->mp_ns;
+	return m_entries[m_visible[m_iterator]].mp_ns;
 
 }
 
 // Fix for bug#47353, explicit check for non-empty default NS decl.
 bool XSECXMLNSStack::isNonEmptyDefaultNS(void) {
-    for (XSECNSHolderVectorType::iterator it = m_currentNS.begin(); it != m_currentNS.end(); ++it) {
-        if ((*it)->m_isDefault) {
-            const XMLCh* val = (*it)->mp_ns->getNodeValue();
-            if (val && *val)
-                return true;
-        }
-    }
-    return false;
+
+	int slot = findVisible(DSIGConstants::s_unicodeStrXmlns, hashName(DSIGConstants::s_unicodeStrXmlns));
+
+	if (slot >= 0) {
+		const XMLCh* val = m_entries[m_visible[slot]].mp_ns->getNodeValue();
+		return (val && *val);
+	}
+
+	return false;
+
 }
@@ -39,24 +39,42 @@ XSEC_DECLARE_XERCES_CLASS(DOMNode)
 // General
 
 #include <vector>
-#include <stack>
 
 // --------------------------------------------------------------------------------
 //           Holder structures
 // --------------------------------------------------------------------------------
 
-struct XSECNSHolderStruct;
-struct XSECNSElementStruct;
+// One entry per namespace declaration on an element currently on the stack.
+// Entries for an element are contiguous, and are unwound in reverse order
+// when the element is popped.
 
-typedef struct XSECNSHolderStruct XSECNSHolder;
-typedef struct XSECNSElementStruct XSECNSElement;
+typedef struct XSECNSEntryStruct {
+
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode	* mp_ns;		// Actual NS attribute
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode	* mp_printed;	// Node at which it was printed
+	unsigned int							m_hash;			// Hash of the attribute name
+	int										m_hides;		// Entry this hides (-1 if none)
+	int										m_slot;			// Position in the visible list
+	bool									m_isDefault;	// Is this a default NS?
+
+} XSECNSEntry;
+
+typedef struct XSECNSFrameStruct {
+
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode	* mp_elt;		// Element
+	unsigned int							m_firstEntry;	// First NS entry for this element
+	unsigned int							m_firstPrinted;	// Print log mark on entry
+
+} XSECNSFrame;
 
 #if defined(XSEC_NO_NAMESPACES)
-	typedef vector<XSECNSHolder *>				XSECNSHolderVectorType;
-	typedef stack<XSECNSElement *>              XSECNSElementStackType;
+	typedef vector<XSECNSEntry>					XSECNSEntryVectorType;
+	typedef vector<XSECNSFrame>					XSECNSFrameVectorType;
+	typedef vector<int>							XSECNSIndexVectorType;
 #else
-	typedef std::vector<XSECNSHolder *>			XSECNSHolderVectorType;
-	typedef std::stack<XSECNSElement *>         XSECNSElementStackType;
+	typedef std::vector<XSECNSEntry>			XSECNSEntryVectorType;
+	typedef std::vector<XSECNSFrame>			XSECNSFrameVectorType;
+	typedef std::vector<int>					XSECNSIndexVectorType;
 #endif
 
 
@@ -90,13 +108,30 @@ public:
 
 private:
 
-	// The stack holds all the elements, with a linked list of NS nodes
-	// THat were pushed in for each element
-	XSECNSElementStackType m_elements;
-	// The vector holds all the "currently visible" namespaces for this element
-	XSECNSHolderVectorType m_currentNS;
-	// Hold a pointer into the visible namespace list for the current element
-	XSECNSHolderVectorType::iterator m_currentNSIterator;
+	int findVisible(const XMLCh * name, unsigned int hash);
+	void addSlot(int idx);
+	void dropSlot(void);
+	void rehash(void);
+
+	// All declarations on the elements in the stack, in document order.
+	// The storage is retained between elements, so once the vectors have
+	// grown to the depth of the document nothing more is allocated.
+	XSECNSEntryVectorType m_entries;
+	// One frame per element - marks where its entries start
+	XSECNSFrameVectorType m_frames;
+	// The "currently visible" namespaces (indexes into m_entries).  A
+	// declaration that hides another takes over its slot.
+	XSECNSIndexVectorType m_visible;
+	// Hash index of the visible slots by prefix.  A bucket holds the most
+	// recently added slot with that hash, m_chain the next slot in the
+	// same bucket.  As slots are only ever added and dropped at the end of
+	// m_visible, the slot being dropped is always at the head of its chain.
+	XSECNSIndexVectorType m_buckets;
+	XSECNSIndexVectorType m_chain;
+	// Entries marked as printed, so they can be reset on pop
+	XSECNSIndexVectorType m_printedLog;
+	// Position in m_visible for getFirst/NextNamespace
+	unsigned int m_iterator;
 
 };
 
@@ -729,6 +729,44 @@ bool DSIGAlgorithmHandlerDefault::appendHashTxfm(
 
 }
 
+bool DSIGAlgorithmHandlerDefault::mapHashURI(
+		const XMLCh * URI,
+		XSECCryptoHash::HashType & type) {
+
+	hashMethod hm;
+
+	if (!XSECmapURIToHashMethod(URI, hm))
+		return false;
+
+	switch (hm) {
+
+	case HASH_SHA1 :
+		type = XSECCryptoHash::HASH_SHA1;
+		break;
+	case HASH_SHA224 :
+		type = XSECCryptoHash::HASH_SHA224;
+		break;
+	case HASH_SHA256 :
+		type = XSECCryptoHash::HASH_SHA256;
+		break;
+	case HASH_SHA384 :
+		type = XSECCryptoHash::HASH_SHA384;
+		break;
+	case HASH_SHA512 :
+		type = XSECCryptoHash::HASH_SHA512;
+		break;
+	case HASH_MD5 :
+		type = XSECCryptoHash::HASH_MD5;
+		break;
+	default :
+		return false;
+
+	}
+
+	return true;
+
+}
+
 // --------------------------------------------------------------------------------
 //			SafeBuffer decryption
 // --------------------------------------------------------------------------------
@@ -79,6 +79,11 @@ public:
 		const XMLCh * URI
 	);
 
+	virtual bool mapHashURI(
+		const XMLCh * URI,
+		XSECCryptoHash::HashType & type
+	);
+
 	// Unsupported Encryption Operations
 
 	virtual unsigned int decryptToSafeBuffer(
@@ -33,408 +33,915 @@
 
 #include <xercesc/util/XMLUniDefs.hpp>
 
+#include <string.h>
+
 XERCES_CPP_NAMESPACE_USE
 
-// We need a special version of XSEC_RELEASE_XMLCH
+// --------------------------------------------------------------------------------
+//           Constant Strings Storage
+// --------------------------------------------------------------------------------
 
-#undef XSEC_RELEASE_XMLCH
+// The strings are static data, so nothing is transcoded or allocated
+// at start up.  Strings that are the same URI share storage.
 
-#if defined (XSEC_XERCES_XMLSTRING_HAS_RELEASE)
-#    define XSEC_RELEASE_XMLCH(x) XMLString::release((XMLCh **) &x)
-#else
-#    define XSEC_RELEASE_XMLCH(x) delete[] x;
-#endif
+static const XMLCh s_strEmpty[] = {
+	chNull
+};
 
-// --------------------------------------------------------------------------------
-//			Some useful defines
-// --------------------------------------------------------------------------------
+static const XMLCh s_strNL[] = {
+	chLF, chNull
+};
+
+static const XMLCh s_strXmlns[] = {
+	chLatin_x, chLatin_m, chLatin_l, chLatin_n, chLatin_s, chNull
+};
+
+static const XMLCh s_strURI[] = {
+	chLatin_U, chLatin_R, chLatin_I, chNull
+};
 
-static XMLCh s_dsa[] = {
+static const XMLCh s_strAlgorithm[] = {
+	chLatin_A, chLatin_l, chLatin_g, chLatin_o, chLatin_r, chLatin_i,
+	chLatin_t, chLatin_h, chLatin_m, chNull
+};
+
+static const XMLCh s_strPrefixList[] = {
+	chLatin_P, chLatin_r, chLatin_e, chLatin_f, chLatin_i, chLatin_x,
+	chLatin_L, chLatin_i, chLatin_s, chLatin_t, chNull
+};
+
+static const XMLCh s_strURIRawX509[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chDigit_0,
+	chDigit_9, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chPound, chLatin_r, chLatin_a,
+	chLatin_w, chLatin_X, chDigit_5, chDigit_0, chDigit_9, chLatin_C,
+	chLatin_e, chLatin_r, chLatin_t, chLatin_i, chLatin_f, chLatin_i,
+	chLatin_c, chLatin_a, chLatin_t, chLatin_e, chNull
+};
+
+static const XMLCh s_strURIDSIG[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chDigit_0,
+	chDigit_9, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chPound, chNull
+};
+
+static const XMLCh s_strURIDSIG11[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_d, chLatin_s, chLatin_i, chLatin_g,
+	chDigit_1, chDigit_1, chPound, chNull
+};
+
+static const XMLCh s_strURIEC[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_1,
+	chDigit_0, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chDash,
+	chLatin_e, chLatin_x, chLatin_c, chDash, chLatin_c, chDigit_1,
+	chDigit_4, chLatin_n, chPound, chNull
+};
+
+static const XMLCh s_strURIXPF[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_2, chForwardSlash, chDigit_0,
+	chDigit_6, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_f, chLatin_i,
+	chLatin_l, chLatin_t, chLatin_e, chLatin_r, chDigit_2, chNull
+};
 
-	chLatin_d,
-	chLatin_s,
-	chLatin_a,
+static const XMLCh s_strURIXENC[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chNull
+};
+
+static const XMLCh s_strURIXENC11[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chNull
+};
+
+static const XMLCh s_strURISIGBASEMORE[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chNull
+};
+
+static const XMLCh s_strURISHA1[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chDigit_0,
+	chDigit_9, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chPound, chLatin_s, chLatin_h,
+	chLatin_a, chDigit_1, chNull
+};
+
+static const XMLCh s_strURISHA224[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_2, chDigit_2, chDigit_4, chNull
+};
+
+static const XMLCh s_strURISHA256[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_2, chDigit_5, chDigit_6, chNull
+};
+
+static const XMLCh s_strURISHA384[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_3, chDigit_8, chDigit_4, chNull
+};
+
+static const XMLCh s_strURISHA512[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_5, chDigit_1, chDigit_2, chNull
+};
+
+static const XMLCh s_strURIMD5[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_m, chLatin_d, chDigit_5,
 	chNull
 };
 
-static XMLCh s_rsa[] = {
+static const XMLCh s_strURIBASE64[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chDigit_0,
+	chDigit_9, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chPound, chLatin_b, chLatin_a,
+	chLatin_s, chLatin_e, chDigit_6, chDigit_4, chNull
+};
+
+static const XMLCh s_strURIXPATH[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chLatin_T, chLatin_R, chForwardSlash, chDigit_1, chDigit_9, chDigit_9,
+	chDigit_9, chForwardSlash, chLatin_R, chLatin_E, chLatin_C, chDash,
+	chLatin_x, chLatin_p, chLatin_a, chLatin_t, chLatin_h, chDash,
+	chDigit_1, chDigit_9, chDigit_9, chDigit_9, chDigit_1, chDigit_1,
+	chDigit_1, chDigit_6, chNull
+};
+
+static const XMLCh s_strURIXSLT[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chLatin_T, chLatin_R, chForwardSlash, chDigit_1, chDigit_9, chDigit_9,
+	chDigit_9, chForwardSlash, chLatin_R, chLatin_E, chLatin_C, chDash,
+	chLatin_x, chLatin_s, chLatin_l, chLatin_t, chDash, chDigit_1,
+	chDigit_9, chDigit_9, chDigit_9, chDigit_1, chDigit_1, chDigit_1,
+	chDigit_6, chNull
+};
+
+static const XMLCh s_strURIENVELOPE[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chDigit_0,
+	chDigit_9, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chPound, chLatin_e, chLatin_n,
+	chLatin_v, chLatin_e, chLatin_l, chLatin_o, chLatin_p, chLatin_e,
+	chLatin_d, chDash, chLatin_s, chLatin_i, chLatin_g, chLatin_n,
+	chLatin_a, chLatin_t, chLatin_u, chLatin_r, chLatin_e, chNull
+};
+
+static const XMLCh s_strURIC14N_NOC[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chLatin_T, chLatin_R, chForwardSlash, chDigit_2, chDigit_0, chDigit_0,
+	chDigit_1, chForwardSlash, chLatin_R, chLatin_E, chLatin_C, chDash,
+	chLatin_x, chLatin_m, chLatin_l, chDash, chLatin_c, chDigit_1,
+	chDigit_4, chLatin_n, chDash, chDigit_2, chDigit_0, chDigit_0,
+	chDigit_1, chDigit_0, chDigit_3, chDigit_1, chDigit_5, chNull
+};
 
-	chLatin_r,
-	chLatin_s,
-	chLatin_a,
+static const XMLCh s_strURIC14N_COM[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chLatin_T, chLatin_R, chForwardSlash, chDigit_2, chDigit_0, chDigit_0,
+	chDigit_1, chForwardSlash, chLatin_R, chLatin_E, chLatin_C, chDash,
+	chLatin_x, chLatin_m, chLatin_l, chDash, chLatin_c, chDigit_1,
+	chDigit_4, chLatin_n, chDash, chDigit_2, chDigit_0, chDigit_0,
+	chDigit_1, chDigit_0, chDigit_3, chDigit_1, chDigit_5, chPound,
+	chLatin_W, chLatin_i, chLatin_t, chLatin_h, chLatin_C, chLatin_o,
+	chLatin_m, chLatin_m, chLatin_e, chLatin_n, chLatin_t, chLatin_s,
 	chNull
 };
 
-static XMLCh s_ecdsa[] = {
+static const XMLCh s_strURIC14N11_NOC[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_6, chForwardSlash, chDigit_1,
+	chDigit_2, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chDash,
+	chLatin_c, chDigit_1, chDigit_4, chLatin_n, chDigit_1, chDigit_1,
+	chNull
+};
+
+static const XMLCh s_strURIC14N11_COM[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_6, chForwardSlash, chDigit_1,
+	chDigit_2, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chDash,
+	chLatin_c, chDigit_1, chDigit_4, chLatin_n, chDigit_1, chDigit_1,
+	chPound, chLatin_W, chLatin_i, chLatin_t, chLatin_h, chLatin_C,
+	chLatin_o, chLatin_m, chLatin_m, chLatin_e, chLatin_n, chLatin_t,
+	chLatin_s, chNull
+};
 
-	chLatin_e,
-	chLatin_c,
-	chLatin_d,
-    chLatin_s,
-    chLatin_a,
+static const XMLCh s_strURIEXC_C14N_COM[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_1,
+	chDigit_0, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chDash,
+	chLatin_e, chLatin_x, chLatin_c, chDash, chLatin_c, chDigit_1,
+	chDigit_4, chLatin_n, chPound, chLatin_W, chLatin_i, chLatin_t,
+	chLatin_h, chLatin_C, chLatin_o, chLatin_m, chLatin_m, chLatin_e,
+	chLatin_n, chLatin_t, chLatin_s, chNull
+};
+
+static const XMLCh s_strURIDSA_SHA1[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chDigit_0,
+	chDigit_9, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chPound, chLatin_d, chLatin_s,
+	chLatin_a, chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_1,
 	chNull
 };
 
-static XMLCh s_hmac[] = {
+static const XMLCh s_strURIDSA_SHA256[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_d, chLatin_s, chLatin_i, chLatin_g,
+	chDigit_1, chDigit_1, chPound, chLatin_d, chLatin_s, chLatin_a,
+	chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_2, chDigit_5,
+	chDigit_6, chNull
+};
 
-	chLatin_h,
-	chLatin_m,
-	chLatin_a,
-	chLatin_c,
+static const XMLCh s_strURIRSA_MD5[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_r, chLatin_s, chLatin_a,
+	chDash, chLatin_m, chLatin_d, chDigit_5, chNull
+};
+
+static const XMLCh s_strURIRSA_SHA1[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chDigit_0,
+	chDigit_9, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chPound, chLatin_r, chLatin_s,
+	chLatin_a, chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_1,
 	chNull
 };
 
-static XMLCh s_sha1[] = {
+static const XMLCh s_strURIRSA_SHA224[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_r, chLatin_s, chLatin_a,
+	chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_2, chDigit_2,
+	chDigit_4, chNull
+};
+
+static const XMLCh s_strURIRSA_SHA256[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_r, chLatin_s, chLatin_a,
+	chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_2, chDigit_5,
+	chDigit_6, chNull
+};
+
+static const XMLCh s_strURIRSA_SHA384[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_r, chLatin_s, chLatin_a,
+	chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_3, chDigit_8,
+	chDigit_4, chNull
+};
+
+static const XMLCh s_strURIRSA_SHA512[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_r, chLatin_s, chLatin_a,
+	chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_5, chDigit_1,
+	chDigit_2, chNull
+};
+
+static const XMLCh s_strURIECDSA_SHA1[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_e, chLatin_c, chLatin_d,
+	chLatin_s, chLatin_a, chDash, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_1, chNull
+};
+
+static const XMLCh s_strURIECDSA_SHA224[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_e, chLatin_c, chLatin_d,
+	chLatin_s, chLatin_a, chDash, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_2, chDigit_2, chDigit_4, chNull
+};
+
+static const XMLCh s_strURIECDSA_SHA256[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_e, chLatin_c, chLatin_d,
+	chLatin_s, chLatin_a, chDash, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_2, chDigit_5, chDigit_6, chNull
+};
+
+static const XMLCh s_strURIECDSA_SHA384[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_e, chLatin_c, chLatin_d,
+	chLatin_s, chLatin_a, chDash, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_3, chDigit_8, chDigit_4, chNull
+};
+
+static const XMLCh s_strURIECDSA_SHA512[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_e, chLatin_c, chLatin_d,
+	chLatin_s, chLatin_a, chDash, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_5, chDigit_1, chDigit_2, chNull
+};
+
+static const XMLCh s_strURIHMAC_SHA1[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chDigit_0,
+	chDigit_9, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chPound, chLatin_h, chLatin_m,
+	chLatin_a, chLatin_c, chDash, chLatin_s, chLatin_h, chLatin_a,
+	chDigit_1, chNull
+};
+
+static const XMLCh s_strURIHMAC_SHA224[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_h, chLatin_m, chLatin_a,
+	chLatin_c, chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_2,
+	chDigit_2, chDigit_4, chNull
+};
+
+static const XMLCh s_strURIHMAC_SHA256[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_h, chLatin_m, chLatin_a,
+	chLatin_c, chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_2,
+	chDigit_5, chDigit_6, chNull
+};
+
+static const XMLCh s_strURIHMAC_SHA384[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_h, chLatin_m, chLatin_a,
+	chLatin_c, chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_3,
+	chDigit_8, chDigit_4, chNull
+};
+
+static const XMLCh s_strURIHMAC_SHA512[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chDash, chLatin_m, chLatin_o,
+	chLatin_r, chLatin_e, chPound, chLatin_h, chLatin_m, chLatin_a,
+	chLatin_c, chDash, chLatin_s, chLatin_h, chLatin_a, chDigit_5,
+	chDigit_1, chDigit_2, chNull
+};
+
+static const XMLCh s_strURIXMLNS[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_n, chLatin_s, chForwardSlash, chNull
+};
 
-	chLatin_s,
-	chLatin_h,
-	chLatin_a,
-	chDigit_1,
+static const XMLCh s_strURIMANIFEST[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_0, chForwardSlash, chDigit_0,
+	chDigit_9, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_d,
+	chLatin_s, chLatin_i, chLatin_g, chPound, chLatin_M, chLatin_a,
+	chLatin_n, chLatin_i, chLatin_f, chLatin_e, chLatin_s, chLatin_t,
 	chNull
 };
 
-static XMLCh s_sha224[] = {
+static const XMLCh s_strURI3DES_CBC[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_t, chLatin_r, chLatin_i,
+	chLatin_p, chLatin_l, chLatin_e, chLatin_d, chLatin_e, chLatin_s,
+	chDash, chLatin_c, chLatin_b, chLatin_c, chNull
+};
+
+static const XMLCh s_strURIAES128_CBC[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_a, chLatin_e, chLatin_s,
+	chDigit_1, chDigit_2, chDigit_8, chDash, chLatin_c, chLatin_b,
+	chLatin_c, chNull
+};
+
+static const XMLCh s_strURIAES192_CBC[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_a, chLatin_e, chLatin_s,
+	chDigit_1, chDigit_9, chDigit_2, chDash, chLatin_c, chLatin_b,
+	chLatin_c, chNull
+};
+
+static const XMLCh s_strURIAES256_CBC[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_a, chLatin_e, chLatin_s,
+	chDigit_2, chDigit_5, chDigit_6, chDash, chLatin_c, chLatin_b,
+	chLatin_c, chNull
+};
 
-	chLatin_s,
-	chLatin_h,
-	chLatin_a,
-	chDigit_2,
-	chDigit_2,
-	chDigit_4,
+static const XMLCh s_strURIAES128_GCM[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_a, chLatin_e, chLatin_s, chDigit_1,
+	chDigit_2, chDigit_8, chDash, chLatin_g, chLatin_c, chLatin_m,
 	chNull
 };
 
-static XMLCh s_sha256[] = {
+static const XMLCh s_strURIAES192_GCM[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_a, chLatin_e, chLatin_s, chDigit_1,
+	chDigit_9, chDigit_2, chDash, chLatin_g, chLatin_c, chLatin_m,
+	chNull
+};
 
-	chLatin_s,
-	chLatin_h,
-	chLatin_a,
-	chDigit_2,
-	chDigit_5,
-	chDigit_6,
+static const XMLCh s_strURIAES256_GCM[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_a, chLatin_e, chLatin_s, chDigit_2,
+	chDigit_5, chDigit_6, chDash, chLatin_g, chLatin_c, chLatin_m,
 	chNull
 };
 
-static XMLCh s_sha384[] = {
+static const XMLCh s_strURIKW_3DES[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_k, chLatin_w, chDash,
+	chLatin_t, chLatin_r, chLatin_i, chLatin_p, chLatin_l, chLatin_e,
+	chLatin_d, chLatin_e, chLatin_s, chNull
+};
 
-	chLatin_s,
-	chLatin_h,
-	chLatin_a,
-	chDigit_3,
-	chDigit_8,
-	chDigit_4,
+static const XMLCh s_strURIKW_AES128[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_k, chLatin_w, chDash,
+	chLatin_a, chLatin_e, chLatin_s, chDigit_1, chDigit_2, chDigit_8,
 	chNull
 };
 
-static XMLCh s_sha512[] = {
+static const XMLCh s_strURIKW_AES192[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_k, chLatin_w, chDash,
+	chLatin_a, chLatin_e, chLatin_s, chDigit_1, chDigit_9, chDigit_2,
+	chNull
+};
 
-	chLatin_s,
-	chLatin_h,
-	chLatin_a,
-	chDigit_5,
-	chDigit_1,
-	chDigit_2,
+static const XMLCh s_strURIKW_AES256[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_k, chLatin_w, chDash,
+	chLatin_a, chLatin_e, chLatin_s, chDigit_2, chDigit_5, chDigit_6,
 	chNull
 };
 
-static XMLCh s_md5[] = {
+static const XMLCh s_strURIKW_AES128_PAD[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_k, chLatin_w, chDash, chLatin_a,
+	chLatin_e, chLatin_s, chDash, chDigit_1, chDigit_2, chDigit_8,
+	chDash, chLatin_p, chLatin_a, chLatin_d, chNull
+};
+
+static const XMLCh s_strURIKW_AES192_PAD[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_k, chLatin_w, chDash, chLatin_a,
+	chLatin_e, chLatin_s, chDash, chDigit_1, chDigit_9, chDigit_2,
+	chDash, chLatin_p, chLatin_a, chLatin_d, chNull
+};
+
+static const XMLCh s_strURIKW_AES256_PAD[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_k, chLatin_w, chDash, chLatin_a,
+	chLatin_e, chLatin_s, chDash, chDigit_2, chDigit_5, chDigit_6,
+	chDash, chLatin_p, chLatin_a, chLatin_d, chNull
+};
+
+static const XMLCh s_strURIRSA_1_5[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_r, chLatin_s, chLatin_a,
+	chDash, chDigit_1, chUnderscore, chDigit_5, chNull
+};
 
-	chLatin_m,
-	chLatin_d,
-	chDigit_5,
+static const XMLCh s_strURIRSA_OAEP_MGFP1[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_r, chLatin_s, chLatin_a,
+	chDash, chLatin_o, chLatin_a, chLatin_e, chLatin_p, chDash,
+	chLatin_m, chLatin_g, chLatin_f, chDigit_1, chLatin_p, chNull
+};
+
+static const XMLCh s_strURIRSA_OAEP[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_r, chLatin_s, chLatin_a, chDash,
+	chLatin_o, chLatin_a, chLatin_e, chLatin_p, chNull
+};
+
+static const XMLCh s_strURIMGF1_BASE[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_m, chLatin_g, chLatin_f, chDigit_1,
 	chNull
 };
 
-// --------------------------------------------------------------------------------
-//           Constant Strings Storage
-// --------------------------------------------------------------------------------
+static const XMLCh s_strURIMGF1_SHA1[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_m, chLatin_g, chLatin_f, chDigit_1,
+	chLatin_s, chLatin_h, chLatin_a, chDigit_1, chNull
+};
+
+static const XMLCh s_strURIMGF1_SHA224[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_m, chLatin_g, chLatin_f, chDigit_1,
+	chLatin_s, chLatin_h, chLatin_a, chDigit_2, chDigit_2, chDigit_4,
+	chNull
+};
+
+static const XMLCh s_strURIMGF1_SHA256[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_m, chLatin_g, chLatin_f, chDigit_1,
+	chLatin_s, chLatin_h, chLatin_a, chDigit_2, chDigit_5, chDigit_6,
+	chNull
+};
+
+static const XMLCh s_strURIMGF1_SHA384[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_m, chLatin_g, chLatin_f, chDigit_1,
+	chLatin_s, chLatin_h, chLatin_a, chDigit_3, chDigit_8, chDigit_4,
+	chNull
+};
+
+static const XMLCh s_strURIMGF1_SHA512[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_9, chForwardSlash, chLatin_x,
+	chLatin_m, chLatin_l, chLatin_e, chLatin_n, chLatin_c, chDigit_1,
+	chDigit_1, chPound, chLatin_m, chLatin_g, chLatin_f, chDigit_1,
+	chLatin_s, chLatin_h, chLatin_a, chDigit_5, chDigit_1, chDigit_2,
+	chNull
+};
+
+static const XMLCh s_strURIXENC_ELEMENT[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_E, chLatin_l, chLatin_e,
+	chLatin_m, chLatin_e, chLatin_n, chLatin_t, chNull
+};
+
+static const XMLCh s_strURIXENC_CONTENT[] = {
+	chLatin_h, chLatin_t, chLatin_t, chLatin_p, chColon, chForwardSlash,
+	chForwardSlash, chLatin_w, chLatin_w, chLatin_w, chPeriod, chLatin_w,
+	chDigit_3, chPeriod, chLatin_o, chLatin_r, chLatin_g, chForwardSlash,
+	chDigit_2, chDigit_0, chDigit_0, chDigit_1, chForwardSlash, chDigit_0,
+	chDigit_4, chForwardSlash, chLatin_x, chLatin_m, chLatin_l, chLatin_e,
+	chLatin_n, chLatin_c, chPound, chLatin_C, chLatin_o, chLatin_n,
+	chLatin_t, chLatin_e, chLatin_n, chLatin_t, chNull
+};
+
+static const XMLCh s_strPROVOpenSSL[] = {
+	chLatin_O, chLatin_p, chLatin_e, chLatin_n, chLatin_S, chLatin_S,
+	chLatin_L, chSpace, chLatin_P, chLatin_r, chLatin_o, chLatin_v,
+	chLatin_i, chLatin_d, chLatin_e, chLatin_r, chNull
+};
+
+static const XMLCh s_strPROVWinCAPI[] = {
+	chLatin_W, chLatin_i, chLatin_n, chLatin_C, chLatin_A, chLatin_P,
+	chLatin_I, chSpace, chLatin_P, chLatin_r, chLatin_o, chLatin_v,
+	chLatin_i, chLatin_d, chLatin_e, chLatin_r, chNull
+};
+
+static const XMLCh s_strPROVNSS[] = {
+	chLatin_N, chLatin_S, chLatin_S, chSpace, chLatin_P, chLatin_r,
+	chLatin_o, chLatin_v, chLatin_i, chLatin_d, chLatin_e, chLatin_r,
+	chNull
+};
 
-const XMLCh * DSIGConstants::s_unicodeStrEmpty;		// ""
-const XMLCh * DSIGConstants::s_unicodeStrNL;		// "\n"
-const XMLCh * DSIGConstants::s_unicodeStrXmlns;		// "xmlns"
-const XMLCh * DSIGConstants::s_unicodeStrURI;
-
-const XMLCh * DSIGConstants::s_unicodeStrAlgorithm;
-
-const XMLCh * DSIGConstants::s_unicodeStrURIDSIG;
-const XMLCh * DSIGConstants::s_unicodeStrURIDSIG11;
-const XMLCh * DSIGConstants::s_unicodeStrURIEC;
-const XMLCh * DSIGConstants::s_unicodeStrURIXPF;
-const XMLCh * DSIGConstants::s_unicodeStrURIXENC;
-const XMLCh * DSIGConstants::s_unicodeStrURIXENC11;
-
-const XMLCh * DSIGConstants::s_unicodeStrURISIGBASE;
-const XMLCh * DSIGConstants::s_unicodeStrURISIGBASEMORE;
-const XMLCh * DSIGConstants::s_unicodeStrURISIGBASE11;
-
-const XMLCh * DSIGConstants::s_unicodeStrURIRawX509;
-const XMLCh * DSIGConstants::s_unicodeStrURISHA1;
-const XMLCh * DSIGConstants::s_unicodeStrURISHA224;
-const XMLCh * DSIGConstants::s_unicodeStrURISHA256;
-const XMLCh * DSIGConstants::s_unicodeStrURISHA384;
-const XMLCh * DSIGConstants::s_unicodeStrURISHA512;
-const XMLCh * DSIGConstants::s_unicodeStrURIMD5;		// Not recommended
-const XMLCh * DSIGConstants::s_unicodeStrURIBASE64;
-const XMLCh * DSIGConstants::s_unicodeStrURIXPATH;
-const XMLCh * DSIGConstants::s_unicodeStrURIXSLT;
-const XMLCh * DSIGConstants::s_unicodeStrURIENVELOPE;
-const XMLCh * DSIGConstants::s_unicodeStrURIC14N_NOC;
-const XMLCh * DSIGConstants::s_unicodeStrURIC14N_COM;
-const XMLCh * DSIGConstants::s_unicodeStrURIC14N11_NOC;
-const XMLCh * DSIGConstants::s_unicodeStrURIC14N11_COM;
-const XMLCh * DSIGConstants::s_unicodeStrURIEXC_C14N_NOC;
-const XMLCh * DSIGConstants::s_unicodeStrURIEXC_C14N_COM;
-
-const XMLCh * DSIGConstants::s_unicodeStrURIDSA_SHA1;
-const XMLCh * DSIGConstants::s_unicodeStrURIDSA_SHA256;
-
-const XMLCh * DSIGConstants::s_unicodeStrURIRSA_MD5;
-const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA1;
-const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA224;
-const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA256;
-const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA384;
-const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA512;
-
-const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA1;
-const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA224;
-const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA256;
-const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA384;
-const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA512;
-
-const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA1;
-const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA224;
-const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA256;
-const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA384;
-const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA512;
-
-const XMLCh * DSIGConstants::s_unicodeStrURIXMLNS;
-const XMLCh * DSIGConstants::s_unicodeStrURIMANIFEST;
-
-const XMLCh * DSIGConstants::s_unicodeStrURI3DES_CBC;
-const XMLCh * DSIGConstants::s_unicodeStrURIAES128_CBC;
-const XMLCh * DSIGConstants::s_unicodeStrURIAES192_CBC;
-const XMLCh * DSIGConstants::s_unicodeStrURIAES256_CBC;
-const XMLCh * DSIGConstants::s_unicodeStrURIAES128_GCM;
-const XMLCh * DSIGConstants::s_unicodeStrURIAES192_GCM;
-const XMLCh * DSIGConstants::s_unicodeStrURIAES256_GCM;
-const XMLCh * DSIGConstants::s_unicodeStrURIKW_3DES;
-const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES128;
-const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES192;
-const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES256;
-const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES128_PAD;
-const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES192_PAD;
-const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES256_PAD;
-const XMLCh * DSIGConstants::s_unicodeStrURIRSA_1_5;
-const XMLCh * DSIGConstants::s_unicodeStrURIRSA_OAEP_MGFP1;
-const XMLCh * DSIGConstants::s_unicodeStrURIRSA_OAEP;
-
-const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_BASE;
-const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA1;
-const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA224;
-const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA256;
-const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA384;
-const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA512;
-
-const XMLCh * DSIGConstants::s_unicodeStrURIXENC_ELEMENT;
-const XMLCh * DSIGConstants::s_unicodeStrURIXENC_CONTENT;
-
-const XMLCh * DSIGConstants::s_unicodeStrPROVOpenSSL;
-const XMLCh * DSIGConstants::s_unicodeStrPROVWinCAPI;
-const XMLCh * DSIGConstants::s_unicodeStrPROVNSS;
+const XMLCh * DSIGConstants::s_unicodeStrEmpty = s_strEmpty;		// ""
+const XMLCh * DSIGConstants::s_unicodeStrNL = s_strNL;		// "\n"
+const XMLCh * DSIGConstants::s_unicodeStrXmlns = s_strXmlns;		// "xmlns"
+const XMLCh * DSIGConstants::s_unicodeStrURI = s_strURI;
+
+const XMLCh * DSIGConstants::s_unicodeStrAlgorithm = s_strAlgorithm;
+const XMLCh * DSIGConstants::s_unicodeStrPrefixList = s_strPrefixList;
+
+const XMLCh * DSIGConstants::s_unicodeStrURIDSIG = s_strURIDSIG;
+const XMLCh * DSIGConstants::s_unicodeStrURIDSIG11 = s_strURIDSIG11;
+const XMLCh * DSIGConstants::s_unicodeStrURIEC = s_strURIEC;
+const XMLCh * DSIGConstants::s_unicodeStrURIXPF = s_strURIXPF;
+const XMLCh * DSIGConstants::s_unicodeStrURIXENC = s_strURIXENC;
+const XMLCh * DSIGConstants::s_unicodeStrURIXENC11 = s_strURIXENC11;
+
+const XMLCh * DSIGConstants::s_unicodeStrURISIGBASE = s_strURIDSIG;
+const XMLCh * DSIGConstants::s_unicodeStrURISIGBASEMORE = s_strURISIGBASEMORE;
+const XMLCh * DSIGConstants::s_unicodeStrURISIGBASE11 = s_strURIDSIG11;
+
+const XMLCh * DSIGConstants::s_unicodeStrURIRawX509 = s_strURIRawX509;
+const XMLCh * DSIGConstants::s_unicodeStrURISHA1 = s_strURISHA1;
+const XMLCh * DSIGConstants::s_unicodeStrURISHA224 = s_strURISHA224;
+const XMLCh * DSIGConstants::s_unicodeStrURISHA256 = s_strURISHA256;
+const XMLCh * DSIGConstants::s_unicodeStrURISHA384 = s_strURISHA384;
+const XMLCh * DSIGConstants::s_unicodeStrURISHA512 = s_strURISHA512;
+const XMLCh * DSIGConstants::s_unicodeStrURIMD5 = s_strURIMD5;		// Not recommended
+const XMLCh * DSIGConstants::s_unicodeStrURIBASE64 = s_strURIBASE64;
+const XMLCh * DSIGConstants::s_unicodeStrURIXPATH = s_strURIXPATH;
+const XMLCh * DSIGConstants::s_unicodeStrURIXSLT = s_strURIXSLT;
+const XMLCh * DSIGConstants::s_unicodeStrURIENVELOPE = s_strURIENVELOPE;
+const XMLCh * DSIGConstants::s_unicodeStrURIC14N_NOC = s_strURIC14N_NOC;
+const XMLCh * DSIGConstants::s_unicodeStrURIC14N_COM = s_strURIC14N_COM;
+const XMLCh * DSIGConstants::s_unicodeStrURIC14N11_NOC = s_strURIC14N11_NOC;
+const XMLCh * DSIGConstants::s_unicodeStrURIC14N11_COM = s_strURIC14N11_COM;
+const XMLCh * DSIGConstants::s_unicodeStrURIEXC_C14N_NOC = s_strURIEC;
+const XMLCh * DSIGConstants::s_unicodeStrURIEXC_C14N_COM = s_strURIEXC_C14N_COM;
+
+const XMLCh * DSIGConstants::s_unicodeStrURIDSA_SHA1 = s_strURIDSA_SHA1;
+const XMLCh * DSIGConstants::s_unicodeStrURIDSA_SHA256 = s_strURIDSA_SHA256;
+
+const XMLCh * DSIGConstants::s_unicodeStrURIRSA_MD5 = s_strURIRSA_MD5;
+const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA1 = s_strURIRSA_SHA1;
+const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA224 = s_strURIRSA_SHA224;
+const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA256 = s_strURIRSA_SHA256;
+const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA384 = s_strURIRSA_SHA384;
+const XMLCh * DSIGConstants::s_unicodeStrURIRSA_SHA512 = s_strURIRSA_SHA512;
+
+const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA1 = s_strURIECDSA_SHA1;
+const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA224 = s_strURIECDSA_SHA224;
+const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA256 = s_strURIECDSA_SHA256;
+const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA384 = s_strURIECDSA_SHA384;
+const XMLCh * DSIGConstants::s_unicodeStrURIECDSA_SHA512 = s_strURIECDSA_SHA512;
+
+const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA1 = s_strURIHMAC_SHA1;
+const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA224 = s_strURIHMAC_SHA224;
+const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA256 = s_strURIHMAC_SHA256;
+const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA384 = s_strURIHMAC_SHA384;
+const XMLCh * DSIGConstants::s_unicodeStrURIHMAC_SHA512 = s_strURIHMAC_SHA512;
+
+const XMLCh * DSIGConstants::s_unicodeStrURIXMLNS = s_strURIXMLNS;
+const XMLCh * DSIGConstants::s_unicodeStrURIMANIFEST = s_strURIMANIFEST;
+
+const XMLCh * DSIGConstants::s_unicodeStrURI3DES_CBC = s_strURI3DES_CBC;
+const XMLCh * DSIGConstants::s_unicodeStrURIAES128_CBC = s_strURIAES128_CBC;
+const XMLCh * DSIGConstants::s_unicodeStrURIAES192_CBC = s_strURIAES192_CBC;
+const XMLCh * DSIGConstants::s_unicodeStrURIAES256_CBC = s_strURIAES256_CBC;
+const XMLCh * DSIGConstants::s_unicodeStrURIAES128_GCM = s_strURIAES128_GCM;
+const XMLCh * DSIGConstants::s_unicodeStrURIAES192_GCM = s_strURIAES192_GCM;
+const XMLCh * DSIGConstants::s_unicodeStrURIAES256_GCM = s_strURIAES256_GCM;
+const XMLCh * DSIGConstants::s_unicodeStrURIKW_3DES = s_strURIKW_3DES;
+const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES128 = s_strURIKW_AES128;
+const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES192 = s_strURIKW_AES192;
+const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES256 = s_strURIKW_AES256;
+const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES128_PAD = s_strURIKW_AES128_PAD;
+const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES192_PAD = s_strURIKW_AES192_PAD;
+const XMLCh * DSIGConstants::s_unicodeStrURIKW_AES256_PAD = s_strURIKW_AES256_PAD;
+const XMLCh * DSIGConstants::s_unicodeStrURIRSA_1_5 = s_strURIRSA_1_5;
+const XMLCh * DSIGConstants::s_unicodeStrURIRSA_OAEP_MGFP1 = s_strURIRSA_OAEP_MGFP1;
+const XMLCh * DSIGConstants::s_unicodeStrURIRSA_OAEP = s_strURIRSA_OAEP;
+
+const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_BASE = s_strURIMGF1_BASE;
+const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA1 = s_strURIMGF1_SHA1;
+const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA224 = s_strURIMGF1_SHA224;
+const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA256 = s_strURIMGF1_SHA256;
+const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA384 = s_strURIMGF1_SHA384;
+const XMLCh * DSIGConstants::s_unicodeStrURIMGF1_SHA512 = s_strURIMGF1_SHA512;
+
+const XMLCh * DSIGConstants::s_unicodeStrURIXENC_ELEMENT = s_strURIXENC_ELEMENT;
+const XMLCh * DSIGConstants::s_unicodeStrURIXENC_CONTENT = s_strURIXENC_CONTENT;
+
+const XMLCh * DSIGConstants::s_unicodeStrPROVOpenSSL = s_strPROVOpenSSL;
+const XMLCh * DSIGConstants::s_unicodeStrPROVWinCAPI = s_strPROVWinCAPI;
+const XMLCh * DSIGConstants::s_unicodeStrPROVNSS = s_strPROVNSS;
 
 // --------------------------------------------------------------------------------
-//           Constant Strings Creation and Deletion
+//           Constant Tables Creation and Deletion
 // --------------------------------------------------------------------------------
 
+static void createURIMappings(void);
+
 void DSIGConstants::create() {
 
-	// Set up the static strings
-
-	s_unicodeStrEmpty = XMLString::transcode("");
-	s_unicodeStrNL = XMLString::transcode("\n");
-	s_unicodeStrXmlns = XMLString::transcode("xmlns");
-	s_unicodeStrURI = XMLString::transcode("URI");
-
-	s_unicodeStrAlgorithm = XMLString::transcode("Algorithm");
-
-	s_unicodeStrURIRawX509 = XMLString::transcode(URI_ID_RAWX509);
-	s_unicodeStrURIDSIG = XMLString::transcode(URI_ID_DSIG);
-    s_unicodeStrURIDSIG11 = XMLString::transcode(URI_ID_DSIG11);
-	s_unicodeStrURIEC = XMLString::transcode(URI_ID_EC);
-	s_unicodeStrURIXPF = XMLString::transcode(URI_ID_XPF);
-	s_unicodeStrURIXENC = XMLString::transcode(URI_ID_XENC);
-    s_unicodeStrURIXENC11 = XMLString::transcode(URI_ID_XENC11);
-
-	s_unicodeStrURISIGBASE = XMLString::transcode(URI_ID_SIG_BASE);
-	s_unicodeStrURISIGBASEMORE = XMLString::transcode(URI_ID_SIG_BASEMORE);
-    s_unicodeStrURISIGBASE11 = XMLString::transcode(URI_ID_SIG_BASE11);
-
-	s_unicodeStrURISHA1 = XMLString::transcode(URI_ID_SHA1);
-	s_unicodeStrURISHA224 = XMLString::transcode(URI_ID_SHA224);
-	s_unicodeStrURISHA256 = XMLString::transcode(URI_ID_SHA256);
-	s_unicodeStrURISHA384 = XMLString::transcode(URI_ID_SHA384);
-	s_unicodeStrURISHA512 = XMLString::transcode(URI_ID_SHA512);
-	s_unicodeStrURIMD5 = XMLString::transcode(URI_ID_MD5);
-	s_unicodeStrURIBASE64 = XMLString::transcode(URI_ID_BASE64);
-	s_unicodeStrURIXPATH = XMLString::transcode(URI_ID_XPATH);
-	s_unicodeStrURIXSLT = XMLString::transcode(URI_ID_XSLT);
-	s_unicodeStrURIENVELOPE = XMLString::transcode(URI_ID_ENVELOPE);
-	s_unicodeStrURIC14N_NOC = XMLString::transcode(URI_ID_C14N_NOC);
-	s_unicodeStrURIC14N_COM = XMLString::transcode(URI_ID_C14N_COM);
-    s_unicodeStrURIC14N11_NOC = XMLString::transcode(URI_ID_C14N11_NOC);
-    s_unicodeStrURIC14N11_COM = XMLString::transcode(URI_ID_C14N11_COM);
-	s_unicodeStrURIEXC_C14N_NOC = XMLString::transcode(URI_ID_EXC_C14N_NOC);
-	s_unicodeStrURIEXC_C14N_COM = XMLString::transcode(URI_ID_EXC_C14N_COM);
-
-	s_unicodeStrURIDSA_SHA1 = XMLString::transcode(URI_ID_DSA_SHA1);
-    s_unicodeStrURIDSA_SHA256 = XMLString::transcode(URI_ID_DSA_SHA256);
-
-	s_unicodeStrURIRSA_MD5 = XMLString::transcode(URI_ID_RSA_MD5);
-	s_unicodeStrURIRSA_SHA1 = XMLString::transcode(URI_ID_RSA_SHA1);
-	s_unicodeStrURIRSA_SHA224 = XMLString::transcode(URI_ID_RSA_SHA224);
-	s_unicodeStrURIRSA_SHA256 = XMLString::transcode(URI_ID_RSA_SHA256);
-	s_unicodeStrURIRSA_SHA384 = XMLString::transcode(URI_ID_RSA_SHA384);
-	s_unicodeStrURIRSA_SHA512 = XMLString::transcode(URI_ID_RSA_SHA512);
-
-	s_unicodeStrURIECDSA_SHA1 = XMLString::transcode(URI_ID_ECDSA_SHA1);
-    s_unicodeStrURIECDSA_SHA224 = XMLString::transcode(URI_ID_ECDSA_SHA224);
-	s_unicodeStrURIECDSA_SHA256 = XMLString::transcode(URI_ID_ECDSA_SHA256);
-	s_unicodeStrURIECDSA_SHA384 = XMLString::transcode(URI_ID_ECDSA_SHA384);
-	s_unicodeStrURIECDSA_SHA512 = XMLString::transcode(URI_ID_ECDSA_SHA512);
-
-	s_unicodeStrURIHMAC_SHA1 = XMLString::transcode(URI_ID_HMAC_SHA1);
-	s_unicodeStrURIHMAC_SHA224 = XMLString::transcode(URI_ID_HMAC_SHA224);
-	s_unicodeStrURIHMAC_SHA256 = XMLString::transcode(URI_ID_HMAC_SHA256);
-	s_unicodeStrURIHMAC_SHA384 = XMLString::transcode(URI_ID_HMAC_SHA384);
-	s_unicodeStrURIHMAC_SHA512 = XMLString::transcode(URI_ID_HMAC_SHA512);
-
-	s_unicodeStrURIXMLNS = XMLString::transcode(URI_ID_XMLNS);
-	s_unicodeStrURIMANIFEST = XMLString::transcode(URI_ID_MANIFEST);
-
-	s_unicodeStrURI3DES_CBC	= XMLString::transcode(URI_ID_3DES_CBC);
-	s_unicodeStrURIAES128_CBC	= XMLString::transcode(URI_ID_AES128_CBC);
-	s_unicodeStrURIAES192_CBC	= XMLString::transcode(URI_ID_AES192_CBC);
-	s_unicodeStrURIAES256_CBC	= XMLString::transcode(URI_ID_AES256_CBC);
-	s_unicodeStrURIAES128_GCM	= XMLString::transcode(URI_ID_AES128_GCM);
-    s_unicodeStrURIAES192_GCM	= XMLString::transcode(URI_ID_AES192_GCM);
-    s_unicodeStrURIAES256_GCM	= XMLString::transcode(URI_ID_AES256_GCM);
-	s_unicodeStrURIKW_3DES = XMLString::transcode(URI_ID_KW_3DES);
-    s_unicodeStrURIKW_AES128 = XMLString::transcode(URI_ID_KW_AES128);
-	s_unicodeStrURIKW_AES192 = XMLString::transcode(URI_ID_KW_AES192);
-	s_unicodeStrURIKW_AES256 = XMLString::transcode(URI_ID_KW_AES256);
-    s_unicodeStrURIKW_AES128_PAD = XMLString::transcode(URI_ID_KW_AES128_PAD);
-	s_unicodeStrURIKW_AES192_PAD = XMLString::transcode(URI_ID_KW_AES192_PAD);
-	s_unicodeStrURIKW_AES256_PAD = XMLString::transcode(URI_ID_KW_AES256_PAD);
-	s_unicodeStrURIRSA_1_5 = XMLString::transcode(URI_ID_RSA_1_5);
-	s_unicodeStrURIRSA_OAEP_MGFP1 = XMLString::transcode(URI_ID_RSA_OAEP_MGFP1);
-    s_unicodeStrURIRSA_OAEP = XMLString::transcode(URI_ID_RSA_OAEP);
-
-    s_unicodeStrURIMGF1_BASE = XMLString::transcode(URI_ID_MGF1_BASE);
-	s_unicodeStrURIMGF1_SHA1 = XMLString::transcode(URI_ID_MGF1_SHA1);
-	s_unicodeStrURIMGF1_SHA224 = XMLString::transcode(URI_ID_MGF1_SHA224);
-	s_unicodeStrURIMGF1_SHA256 = XMLString::transcode(URI_ID_MGF1_SHA256);
-	s_unicodeStrURIMGF1_SHA384 = XMLString::transcode(URI_ID_MGF1_SHA384);
-	s_unicodeStrURIMGF1_SHA512 = XMLString::transcode(URI_ID_MGF1_SHA512);
-
-	s_unicodeStrURIXENC_ELEMENT = XMLString::transcode(URI_ID_XENC_ELEMENT);
-	s_unicodeStrURIXENC_CONTENT = XMLString::transcode(URI_ID_XENC_CONTENT);
-
-	s_unicodeStrPROVOpenSSL = XMLString::transcode(PROV_OPENSSL);
-	s_unicodeStrPROVWinCAPI = XMLString::transcode(PROV_WINCAPI);
-    s_unicodeStrPROVNSS = XMLString::transcode(PROV_NSS);
+	// Only the URI index needs building - the strings are static
+
+	createURIMappings();
 
 }
 
 void DSIGConstants::destroy() {
 
-	// Delete the static strings
-	XSEC_RELEASE_XMLCH(s_unicodeStrEmpty);
-	XSEC_RELEASE_XMLCH(s_unicodeStrNL);
-	XSEC_RELEASE_XMLCH(s_unicodeStrXmlns);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURI);
-
-	XSEC_RELEASE_XMLCH(s_unicodeStrAlgorithm);
-
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIRawX509);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIDSIG);
-    XSEC_RELEASE_XMLCH(s_unicodeStrURIDSIG11);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIEC);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIXPF);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIXENC);
-    XSEC_RELEASE_XMLCH(s_unicodeStrURIXENC11);
-
-	XSEC_RELEASE_XMLCH(s_unicodeStrURISIGBASE);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURISIGBASEMORE);
-    XSEC_RELEASE_XMLCH(s_unicodeStrURISIGBASE11);
-
-	XSEC_RELEASE_XMLCH(s_unicodeStrURISHA1);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURISHA224);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURISHA256);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURISHA384);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURISHA512);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIMD5);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIBASE64);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIXPATH);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIXSLT);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIENVELOPE);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIC14N_NOC);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIC14N_COM);
-    XSEC_RELEASE_XMLCH(s_unicodeStrURIC14N11_NOC);
-    XSEC_RELEASE_XMLCH(s_unicodeStrURIC14N11_COM);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIEXC_C14N_NOC);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIEXC_C14N_COM);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIDSA_SHA1);
-    XSEC_RELEASE_XMLCH(s_unicodeStrURIDSA_SHA256);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIRSA_MD5);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIRSA_SHA1);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIRSA_SHA224);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIRSA_SHA256);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIRSA_SHA384);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIRSA_SHA512);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIECDSA_SHA1);
-    XSEC_RELEASE_XMLCH(s_unicodeStrURIECDSA_SHA224);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIECDSA_SHA256);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIECDSA_SHA384);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIECDSA_SHA512);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIHMAC_SHA1);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIHMAC_SHA224);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIHMAC_SHA256);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIHMAC_SHA384);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIHMAC_SHA512);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIXMLNS);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIMANIFEST);
-
-	XSEC_RELEASE_XMLCH(s_unicodeStrURI3DES_CBC);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIAES128_CBC);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIAES192_CBC);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIAES256_CBC);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIAES128_GCM);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIAES192_GCM);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIAES256_GCM);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIKW_3DES);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIKW_AES128);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIKW_AES192);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIKW_AES256);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIKW_AES128_PAD);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIKW_AES192_PAD);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIKW_AES256_PAD);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIRSA_1_5);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIRSA_OAEP_MGFP1);
-    XSEC_RELEASE_XMLCH(s_unicodeStrURIRSA_OAEP);
-
-    XSEC_RELEASE_XMLCH(s_unicodeStrURIMGF1_BASE);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIMGF1_SHA1);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIMGF1_SHA224);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIMGF1_SHA256);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIMGF1_SHA384);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIMGF1_SHA512);
-
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIXENC_ELEMENT);
-	XSEC_RELEASE_XMLCH(s_unicodeStrURIXENC_CONTENT);
-
-	XSEC_RELEASE_XMLCH(s_unicodeStrPROVOpenSSL);
-	XSEC_RELEASE_XMLCH(s_unicodeStrPROVWinCAPI);
-	XSEC_RELEASE_XMLCH(s_unicodeStrPROVNSS);
+	// Nothing to release
 
 }
 
@@ -442,236 +949,264 @@ void DSIGConstants::destroy() {
 //			URI Mappings
 // --------------------------------------------------------------------------------
 
-bool getHashMethod(const XMLCh * URI, hashMethod & hm) {
+/*
+ * Every algorithm URI with an enum mapping is listed once in s_URIMappings.
+ * The table is plain static data.  DSIGConstants::create() indexes it into
+ * s_URISlots, an open addressed hash table, so each mapping call is a hash
+ * of the URI and (normally) a single string compare.
+ *
+ * The digest and signature families used to be matched by prefix and then
+ * suffix, so every prefix/digest combination accepted then is listed here.
+ */
 
-	if (strEquals(URI, s_md5)) {
+#define URIMAP_KIND_HASH		0x01
+#define URIMAP_KIND_SIGNATURE	0x02
+#define URIMAP_KIND_CANON		0x04
+#define URIMAP_KIND_TRANSFORM	0x08
+#define URIMAP_KIND_MGF			0x10
 
-		hm = HASH_MD5;
-		return true;
+struct XSECURIMapping {
 
-	}
+	const char				* uri;
+	unsigned int			kinds;		// URIMAP_KIND_* flags
+	signatureMethod			sm;
+	hashMethod				hm;
+	canonicalizationMethod	cm;
+	transformType			tt;			// Only valid with URIMAP_KIND_TRANSFORM
+	maskGenerationFunc		mgf;
 
-	if (strEquals(URI, s_sha1)) {
+};
 
-		hm = HASH_SHA1;
-		return true;
-	}
+#define URIMAP_HASH(u, h) \
+	{u, URIMAP_KIND_HASH, SIGNATURE_NONE, h, CANON_NONE, TRANSFORM_BASE64, MGF_NONE}
+#define URIMAP_SIGNATURE(u, s, h) \
+	{u, URIMAP_KIND_SIGNATURE, s, h, CANON_NONE, TRANSFORM_BASE64, MGF_NONE}
+#define URIMAP_CANON(u, c, t) \
+	{u, URIMAP_KIND_CANON | URIMAP_KIND_TRANSFORM, SIGNATURE_NONE, HASH_NONE, c, t, MGF_NONE}
+#define URIMAP_TRANSFORM(u, t) \
+	{u, URIMAP_KIND_TRANSFORM, SIGNATURE_NONE, HASH_NONE, CANON_NONE, t, MGF_NONE}
+#define URIMAP_MGF(u, m) \
+	{u, URIMAP_KIND_MGF, SIGNATURE_NONE, HASH_NONE, CANON_NONE, TRANSFORM_BASE64, m}
+
+static const XSECURIMapping s_URIMappings[] = {
+
+	// Digests.  Any of the three base URIs is accepted with any digest name
+	URIMAP_HASH(URI_ID_SIG_BASE URI_ID_SIG_MD5, HASH_MD5),
+	URIMAP_HASH(URI_ID_SIG_BASE URI_ID_SIG_SHA1, HASH_SHA1),
+	URIMAP_HASH(URI_ID_SIG_BASE URI_ID_SIG_SHA224, HASH_SHA224),
+	URIMAP_HASH(URI_ID_SIG_BASE URI_ID_SIG_SHA256, HASH_SHA256),
+	URIMAP_HASH(URI_ID_SIG_BASE URI_ID_SIG_SHA384, HASH_SHA384),
+	URIMAP_HASH(URI_ID_SIG_BASE URI_ID_SIG_SHA512, HASH_SHA512),
+	URIMAP_HASH(URI_ID_SIG_BASEMORE URI_ID_SIG_MD5, HASH_MD5),
+	URIMAP_HASH(URI_ID_SIG_BASEMORE URI_ID_SIG_SHA1, HASH_SHA1),
+	URIMAP_HASH(URI_ID_SIG_BASEMORE URI_ID_SIG_SHA224, HASH_SHA224),
+	URIMAP_HASH(URI_ID_SIG_BASEMORE URI_ID_SIG_SHA256, HASH_SHA256),
+	URIMAP_HASH(URI_ID_SIG_BASEMORE URI_ID_SIG_SHA384, HASH_SHA384),
+	URIMAP_HASH(URI_ID_SIG_BASEMORE URI_ID_SIG_SHA512, HASH_SHA512),
+	URIMAP_HASH(URI_ID_XENC URI_ID_SIG_MD5, HASH_MD5),
+	URIMAP_HASH(URI_ID_XENC URI_ID_SIG_SHA1, HASH_SHA1),
+	URIMAP_HASH(URI_ID_XENC URI_ID_SIG_SHA224, HASH_SHA224),
+	URIMAP_HASH(URI_ID_XENC URI_ID_SIG_SHA256, HASH_SHA256),
+	URIMAP_HASH(URI_ID_XENC URI_ID_SIG_SHA384, HASH_SHA384),
+	URIMAP_HASH(URI_ID_XENC URI_ID_SIG_SHA512, HASH_SHA512),
+
+	// Signature methods
+	URIMAP_SIGNATURE(URI_ID_DSA_SHA1, SIGNATURE_DSA, HASH_SHA1),
+	URIMAP_SIGNATURE(URI_ID_RSA_SHA1, SIGNATURE_RSA, HASH_SHA1),
+	URIMAP_SIGNATURE(URI_ID_HMAC_SHA1, SIGNATURE_HMAC, HASH_SHA1),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_HMAC "-" URI_ID_SIG_MD5, SIGNATURE_HMAC, HASH_MD5),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_HMAC "-" URI_ID_SIG_SHA1, SIGNATURE_HMAC, HASH_SHA1),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_HMAC "-" URI_ID_SIG_SHA224, SIGNATURE_HMAC, HASH_SHA224),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_HMAC "-" URI_ID_SIG_SHA256, SIGNATURE_HMAC, HASH_SHA256),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_HMAC "-" URI_ID_SIG_SHA384, SIGNATURE_HMAC, HASH_SHA384),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_HMAC "-" URI_ID_SIG_SHA512, SIGNATURE_HMAC, HASH_SHA512),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_RSA "-" URI_ID_SIG_MD5, SIGNATURE_RSA, HASH_MD5),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_RSA "-" URI_ID_SIG_SHA1, SIGNATURE_RSA, HASH_SHA1),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_RSA "-" URI_ID_SIG_SHA224, SIGNATURE_RSA, HASH_SHA224),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_RSA "-" URI_ID_SIG_SHA256, SIGNATURE_RSA, HASH_SHA256),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_RSA "-" URI_ID_SIG_SHA384, SIGNATURE_RSA, HASH_SHA384),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_RSA "-" URI_ID_SIG_SHA512, SIGNATURE_RSA, HASH_SHA512),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_ECDSA "-" URI_ID_SIG_MD5, SIGNATURE_ECDSA, HASH_MD5),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_ECDSA "-" URI_ID_SIG_SHA1, SIGNATURE_ECDSA, HASH_SHA1),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_ECDSA "-" URI_ID_SIG_SHA224, SIGNATURE_ECDSA, HASH_SHA224),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_ECDSA "-" URI_ID_SIG_SHA256, SIGNATURE_ECDSA, HASH_SHA256),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_ECDSA "-" URI_ID_SIG_SHA384, SIGNATURE_ECDSA, HASH_SHA384),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASEMORE URI_ID_SIG_ECDSA "-" URI_ID_SIG_SHA512, SIGNATURE_ECDSA, HASH_SHA512),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASE11 URI_ID_SIG_DSA "-" URI_ID_SIG_MD5, SIGNATURE_DSA, HASH_MD5),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASE11 URI_ID_SIG_DSA "-" URI_ID_SIG_SHA1, SIGNATURE_DSA, HASH_SHA1),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASE11 URI_ID_SIG_DSA "-" URI_ID_SIG_SHA224, SIGNATURE_DSA, HASH_SHA224),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASE11 URI_ID_SIG_DSA "-" URI_ID_SIG_SHA256, SIGNATURE_DSA, HASH_SHA256),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASE11 URI_ID_SIG_DSA "-" URI_ID_SIG_SHA384, SIGNATURE_DSA, HASH_SHA384),
+	URIMAP_SIGNATURE(URI_ID_SIG_BASE11 URI_ID_SIG_DSA "-" URI_ID_SIG_SHA512, SIGNATURE_DSA, HASH_SHA512),
+
+	// Canonicalisation methods (also usable as transforms)
+	URIMAP_CANON(URI_ID_C14N_NOC, CANON_C14N_NOC, TRANSFORM_C14N),
+	URIMAP_CANON(URI_ID_C14N_COM, CANON_C14N_COM, TRANSFORM_C14N),
+	URIMAP_CANON(URI_ID_C14N11_NOC, CANON_C14N11_NOC, TRANSFORM_C14N11),
+	URIMAP_CANON(URI_ID_C14N11_COM, CANON_C14N11_COM, TRANSFORM_C14N11),
+	URIMAP_CANON(URI_ID_EXC_C14N_NOC, CANON_C14NE_NOC, TRANSFORM_EXC_C14N),
+	URIMAP_CANON(URI_ID_EXC_C14N_COM, CANON_C14NE_COM, TRANSFORM_EXC_C14N),
+
+	// Other transforms
+	URIMAP_TRANSFORM(URI_ID_BASE64, TRANSFORM_BASE64),
+	URIMAP_TRANSFORM(URI_ID_XPATH, TRANSFORM_XPATH),
+	URIMAP_TRANSFORM(URI_ID_XPF, TRANSFORM_XPATH_FILTER),
+	URIMAP_TRANSFORM(URI_ID_ENVELOPE, TRANSFORM_ENVELOPED_SIGNATURE),
+	URIMAP_TRANSFORM(URI_ID_XSLT, TRANSFORM_XSLT),
+
+	// Mask generation functions
+	URIMAP_MGF(URI_ID_MGF1_SHA1, MGF1_SHA1),
+	URIMAP_MGF(URI_ID_MGF1_SHA224, MGF1_SHA224),
+	URIMAP_MGF(URI_ID_MGF1_SHA256, MGF1_SHA256),
+	URIMAP_MGF(URI_ID_MGF1_SHA384, MGF1_SHA384),
+	URIMAP_MGF(URI_ID_MGF1_SHA512, MGF1_SHA512)
 
-	if (strEquals(URI, s_sha224)) {
+};
 
-		hm = HASH_SHA224;
-		return true;
-	}
+#define URIMAP_COUNT	(sizeof(s_URIMappings) / sizeof(XSECURIMapping))
+#define URIMAP_SLOTS	256		// Power of two, well over twice URIMAP_COUNT
 
-	if (strEquals(URI, s_sha256)) {
+// Index + 1 of the mapping in each slot, 0 if empty
+static unsigned char s_URISlots[URIMAP_SLOTS];
 
-		hm = HASH_SHA256;
-		return true;
-	}
+// FNV-1a over the UTF-16 code units.  The table URIs are ASCII, so hashing
+// their bytes gives the same value.
 
-	if (strEquals(URI, s_sha384)) {
+static unsigned int hashURI(const XMLCh * URI) {
 
-		hm = HASH_SHA384;
-		return true;
+	unsigned int h = 2166136261U;
+	while (*URI != 0) {
+		h = (h ^ (unsigned int) *URI++) * 16777619U;
 	}
+	return h;
+
+}
 
-	if (strEquals(URI, s_sha512)) {
+static unsigned int hashURI(const char * URI) {
 
-		hm = HASH_SHA512;
-		return true;
+	unsigned int h = 2166136261U;
+	while (*URI != 0) {
+		h = (h ^ (unsigned int) (unsigned char) *URI++) * 16777619U;
 	}
-
-	hm = HASH_NONE;
-	return false;
+	return h;
 
 }
 
-bool XSECmapURIToSignatureMethods(const XMLCh * URI,
-								  signatureMethod & sm,
-								  hashMethod & hm) {
-
+static void createURIMappings(void) {
 
-	// The easy ones!
+	memset(s_URISlots, 0, sizeof(s_URISlots));
 
-	if (strEquals(URI, DSIGConstants::s_unicodeStrURIDSA_SHA1)) {
+	for (unsigned int i = 0; i < URIMAP_COUNT; ++i) {
 
-		sm = SIGNATURE_DSA;
-		hm = HASH_SHA1;
+		unsigned int slot = hashURI(s_URIMappings[i].uri) & (URIMAP_SLOTS - 1);
+		while (s_URISlots[slot] != 0)
+			slot = (slot + 1) & (URIMAP_SLOTS - 1);
 
-		return true;
+		s_URISlots[slot] = (unsigned char) (i + 1);
 
 	}
 
-	if (strEquals(URI, DSIGConstants::s_unicodeStrURIRSA_SHA1)) {
+}
 
-		sm = SIGNATURE_RSA;
-		hm = HASH_SHA1;
+static const XSECURIMapping * findURIMapping(const XMLCh * URI, unsigned int kind) {
 
-		return true;
+	if (URI == NULL)
+		return NULL;
 
-	}
+	unsigned int slot = hashURI(URI) & (URIMAP_SLOTS - 1);
 
-	if (strEquals(URI, DSIGConstants::s_unicodeStrURIHMAC_SHA1)) {
+	while (s_URISlots[slot] != 0) {
 
-		sm = SIGNATURE_HMAC;
-		hm = HASH_SHA1;
+		const XSECURIMapping * m = &s_URIMappings[s_URISlots[slot] - 1];
+		if (strEquals(URI, m->uri))
+			return ((m->kinds & kind) != 0 ? m : NULL);
 
-		return true;
+		slot = (slot + 1) & (URIMAP_SLOTS - 1);
 
 	}
 
-	/* Check to see if we are one of the more exotic RSA signatures */
-	xsecsize_t cnt = XMLString::stringLen(DSIGConstants::s_unicodeStrURISIGBASEMORE);
-
-	if (XMLString::compareNString(URI, DSIGConstants::s_unicodeStrURISIGBASEMORE, cnt) == 0) {
-
-		// Have a "new" algorithm
-		if (XMLString::compareNString(&URI[cnt], s_hmac, 4) == 0) {
+	return NULL;
 
-			// Some kind of HMAC
-			sm = SIGNATURE_HMAC;
+}
 
-			// Determine a trailing hash method
-			if (URI[cnt+4] != chDash)
-				return false;
-			return getHashMethod(&(URI[cnt+5]), hm);
+bool XSECmapURIToSignatureMethods(const XMLCh * URI,
+								  signatureMethod & sm,
+								  hashMethod & hm) {
 
-		}
-		else if (XMLString::compareNString(&URI[cnt], s_rsa, 3) == 0) {
+	const XSECURIMapping * m = findURIMapping(URI, URIMAP_KIND_SIGNATURE);
 
-			sm = SIGNATURE_RSA;
-			if (URI[cnt+3] != chDash)
-				return false;
-			return getHashMethod(&(URI[cnt+4]), hm);
-		}
-		else if (XMLString::compareNString(&URI[cnt], s_ecdsa, 5) == 0) {
+	if (m == NULL) {
 
-			sm = SIGNATURE_ECDSA;
-			if (URI[cnt+5] != chDash)
-				return false;
-			return getHashMethod(&(URI[cnt+6]), hm);
-		}
+		sm = SIGNATURE_NONE;
+		hm = HASH_NONE;
+		return false;
 
 	}
 
-    cnt = XMLString::stringLen(DSIGConstants::s_unicodeStrURISIGBASE11);
-
-    if (XMLString::compareNString(URI, DSIGConstants::s_unicodeStrURISIGBASE11, cnt) == 0) {
-
-        if (XMLString::compareNString(&URI[cnt], s_dsa, 3) == 0) {
-
-            sm = SIGNATURE_DSA;
-            if (URI[cnt+3] != chDash)
-                return false;
-            return getHashMethod(&(URI[cnt+4]), hm);
-        }
-
-    }
-
-	sm = SIGNATURE_NONE;
-	hm = HASH_NONE;
-	return false;
+	sm = m->sm;
+	hm = m->hm;
+	return true;
 
 }
 
 bool XSECmapURIToHashMethod(const XMLCh * URI,
 							hashMethod & hm) {
 
+	const XSECURIMapping * m = findURIMapping(URI, URIMAP_KIND_HASH);
 
-	// Check this is a known prefix on the URI.
-	xsecsize_t blen = XMLString::stringLen(DSIGConstants::s_unicodeStrURISIGBASE);
-	xsecsize_t bmlen = XMLString::stringLen(DSIGConstants::s_unicodeStrURISIGBASEMORE);
-	xsecsize_t belen = XMLString::stringLen(DSIGConstants::s_unicodeStrURIXENC);
-	if (XMLString::compareNString(URI, DSIGConstants::s_unicodeStrURISIGBASE, blen) == 0) {
+	if (m == NULL) {
 
-		// This is actually cheating - this will return SHA256 (as an example), even if
-		// the base URI is the original DSIG uri (ie not base-more)
-		return getHashMethod(&URI[blen], hm);
+		hm = HASH_NONE;
+		return false;
 
 	}
 
-	if (XMLString::compareNString(URI, DSIGConstants::s_unicodeStrURISIGBASEMORE, bmlen) == 0) {
+	hm = m->hm;
+	return true;
 
-		return getHashMethod(&URI[bmlen], hm);
+}
 
-	}
+bool XSECmapURIToCanonicalizationMethod(const XMLCh * URI,
+							canonicalizationMethod & cm) {
 
-	if (XMLString::compareNString(URI, DSIGConstants::s_unicodeStrURIXENC, belen) == 0) {
+	const XSECURIMapping * m = findURIMapping(URI, URIMAP_KIND_CANON);
 
-		return getHashMethod(&URI[belen], hm);
+	if (m == NULL) {
 
-	}
+		cm = CANON_NONE;
+		return false;
 
-	hm = HASH_NONE;
-	return false;
-}
+	}
 
-bool XSECmapURIToCanonicalizationMethod(const XMLCh * URI,
-							canonicalizationMethod & cm) {
+	cm = m->cm;
+	return true;
 
-	// Quick and dirty but inefficient
-	if (strEquals(URI, DSIGConstants::s_unicodeStrURIC14N_NOC)) {
-		cm = CANON_C14N_NOC;
-	}
-	else if (strEquals(URI, DSIGConstants::s_unicodeStrURIC14N_COM)) {
-		cm = CANON_C14N_COM;
-	}
+}
 
-	else if (strEquals(URI, DSIGConstants::s_unicodeStrURIEXC_C14N_COM)) {
-		cm = CANON_C14NE_COM;
-	}
+bool XSECmapURIToMaskGenerationFunc(const XMLCh * URI, maskGenerationFunc & mgf) {
 
-	else if (strEquals(URI, DSIGConstants::s_unicodeStrURIEXC_C14N_NOC)) {
-		cm = CANON_C14NE_NOC;
-	}
-	else if (strEquals(URI, DSIGConstants::s_unicodeStrURIC14N11_NOC)) {
-        cm = CANON_C14N11_NOC;
-    }
-    else if (strEquals(URI, DSIGConstants::s_unicodeStrURIC14N11_COM)) {
-        cm = CANON_C14N11_COM;
-    }
+	const XSECURIMapping * m = findURIMapping(URI, URIMAP_KIND_MGF);
 
-	else {
+	if (m == NULL) {
 
-		// Unknown
-		cm = CANON_NONE;
+		mgf = MGF_NONE;
 		return false;
+
 	}
 
+	mgf = m->mgf;
 	return true;
+
 }
 
-bool XSECmapURIToMaskGenerationFunc(const XMLCh * URI, maskGenerationFunc & mgf) {
+bool XSECmapURIToTransformType(const XMLCh * URI, transformType & tt) {
 
+	const XSECURIMapping * m = findURIMapping(URI, URIMAP_KIND_TRANSFORM);
 
-	// Check this is a known prefix on the URI.
-	xsecsize_t len = XMLString::stringLen(DSIGConstants::s_unicodeStrURIMGF1_BASE);
-	if (XMLString::compareNString(URI, DSIGConstants::s_unicodeStrURIMGF1_BASE, len) == 0) {
-
-        hashMethod hm;
-		if (getHashMethod(&URI[len], hm)) {
-            switch (hm) {
-                case HASH_SHA1:
-                    mgf = MGF1_SHA1;
-                    return true;
-                case HASH_SHA224:
-                    mgf = MGF1_SHA224;
-                    return true;
-                case HASH_SHA256:
-                    mgf = MGF1_SHA256;
-                    return true;
-                case HASH_SHA384:
-                    mgf = MGF1_SHA384;
-                    return true;
-                case HASH_SHA512:
-                    mgf = MGF1_SHA512;
-                    return true;
-                default:
-                    ;
-            }
-        }
-	}
+	if (m == NULL)
+		return false;
 
-	mgf = MGF_NONE;
-	return false;
-}
\ No newline at end of file
+	tt = m->tt;
+	return true;
+
+}
@@ -572,6 +572,7 @@ public:
 
 	// DSIG Element Strings
 	static const XMLCh * s_unicodeStrAlgorithm;
+	static const XMLCh * s_unicodeStrPrefixList;	// "PrefixList"
 
 	// URI_IDs
 	static const XMLCh * s_unicodeStrURIDSIG;
@@ -724,6 +725,8 @@ bool DSIG_EXPORT XSECmapURIToCanonicalizationMethod(const XMLCh * URI,
 
 bool DSIG_EXPORT XSECmapURIToMaskGenerationFunc(const XMLCh * URI,
 												  maskGenerationFunc & mgf);
+bool DSIG_EXPORT XSECmapURIToTransformType(const XMLCh * URI,
+												  transformType & tt);
 
 #endif /* DSIGCONSTANTS_HEADER */
 
@@ -147,31 +147,18 @@ void DSIGKeyInfoX509::load(void) {
 			// See if it's a known element type
 			if (strEquals(getDSIGLocalName(tmpElt), "X509Certificate")) {
 
-			    // Loop over Text nodes until we successfully load a certificate.
-			    // If we run out, throw out the last exception raised.
+				// The certificate is only parsed when someone asks for it
 
-				X509Holder * h;
-                XSECCryptoX509* cryptoX509 = XSECPlatformUtils::g_cryptoProvider->X509();
 				DOMNode *certElt = findFirstChildOfType(tmpElt, DOMNode::TEXT_NODE);
-				while (certElt) {
-                    XSECAutoPtrChar charX509(certElt->getNodeValue());
-				    try {
-                        cryptoX509->loadX509Base64Bin(charX509.get(), (int) strlen(charX509.get()));
-
-	                    // Add to the list
-                        XSECnew(h, X509Holder);
-	                    m_X509List.push_back(h);
-	                    h->mp_encodedX509 = certElt->getNodeValue();
-	                    h->mp_cryptoX509 = cryptoX509;
-	                    break;
-				    }
-				    catch (XSECCryptoException&) {
-	                    certElt = findNextChildOfType(certElt, DOMNode::TEXT_NODE);
-	                    if (!certElt) {
-	                        delete cryptoX509;
-	                        throw;
-	                    }
-				    }
+				if (certElt != NULL) {
+
+					X509Holder * h;
+					XSECnew(h, X509Holder);
+					m_X509List.push_back(h);
+					h->mp_encodedX509 = certElt->getNodeValue();
+					h->mp_cryptoX509 = NULL;
+					h->mp_certElement = tmpElt;
+
 				}
 			}
 
@@ -380,10 +367,44 @@ const XMLCh * DSIGKeyInfoX509::getCertificateItem(int item) const {
 
 }
 
+XSECCryptoX509 * DSIGKeyInfoX509::parseCertificate(X509Holder * h) const {
+
+	if (h->mp_cryptoX509 != NULL)
+		return h->mp_cryptoX509;
+
+	// Loop over Text nodes until we successfully load a certificate.
+	// If we run out, throw out the last exception raised.
+
+	XSECCryptoX509 * cryptoX509 = XSECPlatformUtils::g_cryptoProvider->X509();
+	DOMNode *certElt = findFirstChildOfType(h->mp_certElement, DOMNode::TEXT_NODE);
+	while (certElt) {
+		XSECAutoPtrChar charX509(certElt->getNodeValue());
+		try {
+			cryptoX509->loadX509Base64Bin(charX509.get(), (unsigned int) strlen(charX509.get()));
+			h->mp_encodedX509 = certElt->getNodeValue();
+			h->mp_cryptoX509 = cryptoX509;
+			break;
+		}
+		catch (XSECCryptoException&) {
+			certElt = findNextChildOfType(certElt, DOMNode::TEXT_NODE);
+			if (!certElt) {
+				delete cryptoX509;
+				throw;
+			}
+		}
+	}
+
+	if (h->mp_cryptoX509 == NULL)
+		delete cryptoX509;
+
+	return h->mp_cryptoX509;
+
+}
+
 XSECCryptoX509 * DSIGKeyInfoX509::getCertificateCryptoItem(int item) {
 
     if (item >=0 && (unsigned int) item < m_X509List.size())
-        return m_X509List[item]->mp_cryptoX509;
+        return parseCertificate(m_X509List[item]);
 
     return 0;
 }
@@ -391,7 +412,7 @@ XSECCryptoX509 * DSIGKeyInfoX509::getCertificateCryptoItem(int item) {
 const XSECCryptoX509 * DSIGKeyInfoX509::getCertificateCryptoItem(int item) const {
 
 	if (item >=0 && (unsigned int) item < m_X509List.size())
-		return m_X509List[item]->mp_cryptoX509;
+		return parseCertificate(m_X509List[item]);
 
 	return 0;
 }
@@ -643,8 +664,7 @@ void DSIGKeyInfoX509::appendX509Certificate(const XMLCh * base64Certificate) {
 	XSECnew(h, X509Holder);
 	m_X509List.push_back(h);
 	h->mp_encodedX509 = b64Txt->getNodeValue();
-	h->mp_cryptoX509 = XSECPlatformUtils::g_cryptoProvider->X509();
-	XSECAutoPtrChar charX509(h->mp_encodedX509);
-	h->mp_cryptoX509->loadX509Base64Bin(charX509.get(), (unsigned int) strlen(charX509.get()));
-	
+	h->mp_cryptoX509 = NULL;
+	h->mp_certElement = s;
+
 }
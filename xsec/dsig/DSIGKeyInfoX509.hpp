@@ -59,7 +59,9 @@ public:
 	struct X509Holder {
 
 		const XMLCh			* mp_encodedX509;		// Base64 encoding
-		XSECCryptoX509		* mp_cryptoX509;		// The certificate
+		XSECCryptoX509		* mp_cryptoX509;		// The certificate (NULL until parsed)
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode
+							* mp_certElement;		// <X509Certificate> it came from
 
 	};
 
@@ -276,9 +278,12 @@ public:
 	 * \brief Get the Crypto Interface X509 structure version of the certificate
 	 *
 	 * Use the index to find the required certificate and return a pointer
-	 * to the XSECCryptoX509 cert
+	 * to the XSECCryptoX509 cert.  Certificates are not parsed when the
+	 * KeyInfo is loaded - the first call for an item decodes and parses
+	 * it, and later calls return the same object.
 	 *
 	 * @returns A pointer to the XSECCryptoX509 cert structure
+	 * @throws XSECCryptoException if the certificate cannot be parsed
 	 */
 
 	XSECCryptoX509 * getCertificateCryptoItem(int item);
@@ -429,6 +434,8 @@ private:
 
 	DSIGKeyInfoX509();
 
+	XSECCryptoX509 * parseCertificate(X509Holder * h) const;
+
 	X509ListType		m_X509List;				// The X509 structures
 	X509CRLListType     m_X509CRLList;          // The X509CRL list
 	XMLCh 				* mp_X509IssuerName;	// Parameters from KeyInfo (not cert)
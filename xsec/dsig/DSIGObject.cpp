@@ -135,19 +135,26 @@ void DSIGObject::load(void) {
 
 
 	mp_idAttr = ((DOMElement *) mp_objectNode)->getAttributeNodeNS(NULL, s_Id);
-	if (mp_idAttr) {
-#if defined (XSEC_XERCES_HAS_SETIDATTRIBUTE)
-	    ((DOMElement *) mp_objectNode)->setIdAttributeNS(NULL, s_Id);
-#elif defined (XSEC_XERCES_HAS_BOOLSETIDATTRIBUTE)
-		((DOMElement *) mp_objectNode)->setIdAttributeNS(NULL, s_Id, true);
-#endif
-	}
+	registerId((DOMElement *) mp_objectNode);
 
 	mp_mimeTypeAttr = ((DOMElement *) mp_objectNode)->getAttributeNodeNS(NULL, s_MimeType);
 	mp_encodingAttr = ((DOMElement *) mp_objectNode)->getAttributeNodeNS(NULL, s_Encoding);
 
 }
 
+void DSIGObject::registerId(DOMElement * objectNode) {
+
+	if (objectNode->getAttributeNodeNS(NULL, s_Id) == NULL)
+		return;
+
+#if defined (XSEC_XERCES_HAS_SETIDATTRIBUTE)
+	objectNode->setIdAttributeNS(NULL, s_Id);
+#elif defined (XSEC_XERCES_HAS_BOOLSETIDATTRIBUTE)
+	objectNode->setIdAttributeNS(NULL, s_Id, true);
+#endif
+
+}
+
 
 DOMElement * DSIGObject::createBlankObject(void) {
 
@@ -103,6 +103,17 @@ public:
 
 	void load(void);
 
+	/**
+	 * \brief Mark the Id attribute of an Object element as an ID
+	 *
+	 * Lets same document references find the Object before a DSIGObject
+	 * has been built for it.  Does nothing if there is no Id attribute.
+	 *
+	 * @param objectNode The <Object> element
+	 */
+
+	static void registerId(XERCES_CPP_NAMESPACE_QUALIFIER DOMElement * objectNode);
+
 	/**
 	 * \brief Create a new Object
 	 *
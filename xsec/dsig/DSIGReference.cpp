@@ -50,14 +50,18 @@
 #include <xsec/dsig/DSIGTransformXPathFilter.hpp>
 #include <xsec/dsig/DSIGTransformXSL.hpp>
 #include <xsec/dsig/DSIGTransformC14n.hpp>
+#include <xsec/canon/XSECC14n20010315.hpp>
 
 #include <xsec/framework/XSECError.hpp>
 #include <xsec/framework/XSECEnv.hpp>
+#include <xsec/framework/XSECURIPrefetcher.hpp>
+#include <xsec/framework/XSECURIResolver.hpp>
 #include <xsec/framework/XSECAlgorithmHandler.hpp>
 #include <xsec/framework/XSECAlgorithmMapper.hpp>
 #include <xsec/utils/XSECPlatformUtils.hpp>
 #include <xsec/utils/XSECDOMUtils.hpp>
 #include <xsec/utils/XSECBinTXFMInputStream.hpp>
+#include <xsec/utils/XSECHashPool.hpp>
 
 // Xerces
 
@@ -68,6 +72,7 @@
 XERCES_CPP_NAMESPACE_USE
 
 #include <iostream>
+#include <vector>
 
 // --------------------------------------------------------------------------------
 //           Some useful strings
@@ -200,6 +205,8 @@ void DSIGReference::createTransformList(void) {
 
 void DSIGReference::addTransform(DSIGTransform * txfm, DOMElement * txfmElt) {
 
+	loadTransformList();
+
 	if (mp_transformList == NULL)
 		createTransformList();
 
@@ -477,7 +484,15 @@ TXFMBase * DSIGReference::getURIBaseTXFM(DOMDocument * doc,
 		XSECnew(retTransform, TXFMURL(doc, env->getURIResolver()));
 
 		try {
-			((TXFMURL *) retTransform)->setInput(URI);
+			// Use the data if it has already been (or is being) fetched
+			BinInputStream * is = NULL;
+			if (URI != NULL && env->getURIPrefetcher() != NULL)
+				is = env->getURIPrefetcher()->claimURI(URI);
+
+			if (is != NULL)
+				((TXFMURL *) retTransform)->setInput(is);
+			else
+				((TXFMURL *) retTransform)->setInput(URI);
 		}
 		catch (...) {
 
@@ -651,12 +666,10 @@ void DSIGReference::load(void) {
 
 	if (strEquals(getDSIGLocalName(tmpElt), "Transforms")) {
 
-		// Store node for later use
+		// Store node for later use.  The transforms themselves are only
+		// loaded when they are needed (see loadTransformList)
 		mp_transformsNode = tmpElt;
 
-		// Load the transforms
-		mp_transformList = loadTransforms(tmpElt, mp_formatter, mp_env);
-
 		// Find next node
 		tmpElt = tmpElt->getNextSibling();
 		while (tmpElt != 0 && (tmpElt->getNodeType() != DOMNode::ELEMENT_NODE)) {
@@ -866,6 +879,7 @@ XSECBinTXFMInputStream * DSIGReference::makeBinInputStream(void) const {
 
 	// Set up the transform chain
 
+	loadTransformList();
 	txfmChain = createTXFMChainFromList(currentTxfm, mp_transformList);
 	Janitor<TXFMChain> j_txfmChain(txfmChain);
 
@@ -910,7 +924,13 @@ void DSIGReference::hashReferenceList(DSIGReferenceList *lst, bool interlocking)
 	// Where a hash in a later calculated reference could impact an already calculated hash
 	// in a previous references
 	//
-	// If interlocking is set to false, assume there are no interacting <Reference> nodes
+	// If interlocking is set to false, assume there are no interacting <Reference> nodes,
+	// so all the digests can be calculated together
+
+	if (!interlocking) {
+		hashReferenceBatch(lst);
+		return;
+	}
 
 	do {
 
@@ -933,6 +953,219 @@ void DSIGReference::hashReferenceList(DSIGReferenceList *lst, bool interlocking)
 	} while (interlocking && !DSIGReference::verifyReferenceList(lst, errStr) && i-- >= 0);
 }
 
+// --------------------------------------------------------------------------------
+//           Hash a batch of references
+// --------------------------------------------------------------------------------
+
+// References whose canonical form is larger than this are digested as they
+// are read rather than being held for the batch
+#define DSIG_BATCH_HASH_LIMIT	16384
+
+struct DSIGBatchEntry {
+
+	DSIGReference			* ref;
+	XSECCryptoHash::HashType	type;
+	xsecsize_t				offset;		// Start of the content in the batch buffer
+	unsigned int			length;
+
+};
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef vector<DSIGBatchEntry>				DSIGBatchEntryVectorType;
+typedef vector<const unsigned char *>		DSIGBatchInputVectorType;
+typedef vector<unsigned char *>				DSIGBatchOutputVectorType;
+typedef vector<unsigned int>				DSIGBatchLengthVectorType;
+#else
+typedef std::vector<DSIGBatchEntry>			DSIGBatchEntryVectorType;
+typedef std::vector<const unsigned char *>	DSIGBatchInputVectorType;
+typedef std::vector<unsigned char *>		DSIGBatchOutputVectorType;
+typedef std::vector<unsigned int>			DSIGBatchLengthVectorType;
+#endif
+
+void DSIGReference::hashReferenceBatch(DSIGReferenceList *lst) {
+
+	// Canonicalise every reference into one buffer, then digest the
+	// content of all references sharing an algorithm in a single call
+	// to the provider.  Anything that can't be batched (pre-hash
+	// transforms, custom hash handlers, large content) is hashed
+	// straight away.
+
+	DSIGBatchEntryVectorType entries;
+	safeBuffer data;
+	xsecsize_t used = 0;
+	XMLByte buf[2048];
+
+	int size = (int) lst->getSize();
+
+	for (int j = 0; j < size; ++j) {
+
+		DSIGReference * r = lst->item(j);
+
+		if (r->isManifest())
+			hashReferenceList(r->getManifestReferenceList());
+
+		if (r->m_loaded == false) {
+
+			throw XSECException(XSECException::NotLoaded,
+				"calculateHash() called in DSIGReference before load()");
+
+		}
+
+		XSECAlgorithmHandler * handler =
+			XSECPlatformUtils::g_algorithmMapper->mapURIToHandler(r->mp_algorithmURI);
+
+		DSIGBatchEntry e;
+
+		if (handler == NULL || r->mp_preHash != NULL ||
+			!handler->mapHashURI(r->mp_algorithmURI, e.type)) {
+
+			r->setHash();
+			continue;
+
+		}
+
+		TXFMChain * chain = r->createHashInputChain();
+		Janitor<TXFMChain> j_chain(chain);
+
+		TXFMBase * last = chain->getLastTxfm();
+		XSECCryptoHash * h = NULL;
+		unsigned int length = 0;
+		unsigned int n;
+
+		try {
+
+			// A mapped file is digested in place rather than copied
+			xsecsize_t spanLen;
+			const XMLByte * span = last->consumeOutput(spanLen);
+			if (span != NULL) {
+
+				h = XSECHashPool::getHash(e.type);
+				while (spanLen > 0) {
+					n = (spanLen > 0x40000000 ? 0x40000000 : (unsigned int) spanLen);
+					h->hash((unsigned char *) span, n);
+					span += n;
+					spanLen -= n;
+				}
+
+			}
+
+			while ((n = last->readBytes(buf, 2048)) > 0) {
+
+				if (h == NULL && length + n > DSIG_BATCH_HASH_LIMIT) {
+
+					// Too big to be worth holding - digest it directly
+					h = XSECHashPool::getHash(e.type);
+					h->hash((unsigned char *) &(data.rawBuffer()[used]), length);
+
+				}
+
+				if (h != NULL) {
+					h->hash(buf, n);
+				}
+				else {
+					data.sbMemcpyIn(used + length, buf, n);
+				}
+
+				length += n;
+
+			}
+
+			if (h != NULL) {
+
+				XMLByte hashVal[CRYPTO_MAX_HASH_SIZE];
+				unsigned int hashLen = h->finish(hashVal, CRYPTO_MAX_HASH_SIZE);
+				XSECHashPool::releaseHash(h);
+				h = NULL;
+
+				r->setHashValue(hashVal, hashLen);
+
+			}
+			else {
+
+				e.ref = r;
+				e.offset = used;
+				e.length = length;
+				entries.push_back(e);
+				used += length;
+
+			}
+
+		}
+		catch (...) {
+			if (h != NULL)
+				XSECHashPool::releaseHash(h);
+			throw;
+		}
+
+		last->deleteExpandedNameSpaces();
+
+	}
+
+	if (entries.empty())
+		return;
+
+	// Now digest the held content, one provider call per algorithm
+
+	const unsigned char * base = data.rawBuffer();
+	DSIGBatchInputVectorType inputs;
+	DSIGBatchOutputVectorType outputs;
+	DSIGBatchLengthVectorType inputLengths;
+	DSIGBatchLengthVectorType outputLengths;
+	DSIGBatchEntryVectorType::size_type i, k;
+
+	XMLByte * hashVals;
+	XSECnew(hashVals, XMLByte[entries.size() * CRYPTO_MAX_HASH_SIZE]);
+	ArrayJanitor<XMLByte> j_hashVals(hashVals);
+
+	for (i = 0; i < entries.size(); ++i) {
+
+		XSECCryptoHash::HashType type = entries[i].type;
+
+		// Already processed along with an earlier entry?
+		for (k = 0; k < i && entries[k].type != type; ++k);
+		if (k < i)
+			continue;
+
+		inputs.clear();
+		inputLengths.clear();
+		outputs.clear();
+
+		for (k = i; k < entries.size(); ++k) {
+
+			if (entries[k].type != type)
+				continue;
+
+			inputs.push_back(base + entries[k].offset);
+			inputLengths.push_back(entries[k].length);
+			outputs.push_back(&hashVals[k * CRYPTO_MAX_HASH_SIZE]);
+
+		}
+
+		outputLengths.resize(inputs.size());
+
+		XSECPlatformUtils::g_cryptoProvider->hashMultiple(type,
+			(unsigned int) inputs.size(),
+			&inputs[0],
+			&inputLengths[0],
+			&outputs[0],
+			CRYPTO_MAX_HASH_SIZE,
+			&outputLengths[0]);
+
+		DSIGBatchLengthVectorType::size_type o = 0;
+		for (k = i; k < entries.size(); ++k) {
+
+			if (entries[k].type != type)
+				continue;
+
+			entries[k].ref->setHashValue(&hashVals[k * CRYPTO_MAX_HASH_SIZE],
+				outputLengths[o++]);
+
+		}
+
+	}
+
+}
+
 // --------------------------------------------------------------------------------
 //           Verify reference list
 // --------------------------------------------------------------------------------
@@ -1031,6 +1264,21 @@ TXFMChain * DSIGReference::createTXFMChainFromList(TXFMBase * input,
 
 }
 
+// --------------------------------------------------------------------------------
+//           loadTransformList
+// --------------------------------------------------------------------------------
+
+void DSIGReference::loadTransformList(void) const {
+
+	// A reference loaded from XML only remembers its <Transforms> node.
+	// The list (XPath namespace maps, stylesheets etc.) is built the first
+	// time something needs it.
+
+	if (mp_transformList == NULL && mp_transformsNode != NULL)
+		mp_transformList = loadTransforms(mp_transformsNode, mp_formatter, mp_env);
+
+}
+
 // --------------------------------------------------------------------------------
 //           loadTransforms
 // --------------------------------------------------------------------------------
@@ -1093,74 +1341,16 @@ DSIGTransformList * DSIGReference::loadTransforms(
 
 		}
 
-		safeBuffer algorithm;
-		algorithm << (*formatter << transformAtts->item(i)->getNodeValue());
-
 		// Determine what the transform is
 
-		if (algorithm.sbStrcmp(URI_ID_BASE64) == 0) {
-
-			DSIGTransformBase64 * b;
-			XSECnew(b, DSIGTransformBase64(env, transforms));
-			lst->addTransform(b);
-			b->load();
-		}
-
-		else if (algorithm.sbStrcmp(URI_ID_XPATH) == 0) {
-
-			DSIGTransformXPath * x;
-			XSECnew(x, DSIGTransformXPath(env, transforms));
-			lst->addTransform(x);
-			x->load();
-		}
-
-		else if (algorithm.sbStrcmp(URI_ID_XPF) == 0) {
-
-			DSIGTransformXPathFilter * xpf;
-
-			XSECnew(xpf, DSIGTransformXPathFilter(env, transforms));
-			lst->addTransform(xpf);
-			xpf->load();
-
-		}
-
-		else if (algorithm.sbStrcmp(URI_ID_ENVELOPE) == 0) {
-
-			DSIGTransformEnvelope * e;
-			XSECnew(e, DSIGTransformEnvelope(env, transforms));
-			lst->addTransform(e);
-			e->load();
-		}
-
-		else if (algorithm.sbStrcmp(URI_ID_XSLT) == 0) {
-
-			DSIGTransformXSL * x;
-			XSECnew(x, DSIGTransformXSL(env, transforms));
-			lst->addTransform(x);
-			x->load();
-
-		}
-
-
-		else if (algorithm.sbStrcmp(URI_ID_C14N_COM) == 0 ||
-			     algorithm.sbStrcmp(URI_ID_C14N_NOC) == 0 ||
-			     algorithm.sbStrcmp(URI_ID_C14N11_COM) == 0 ||
-                 algorithm.sbStrcmp(URI_ID_C14N11_NOC) == 0 ||
-				 algorithm.sbStrcmp(URI_ID_EXC_C14N_COM) == 0 ||
-				 algorithm.sbStrcmp(URI_ID_EXC_C14N_NOC) == 0) {
+		transformType tt;
 
-			DSIGTransformC14n * c;
-			XSECnew(c, DSIGTransformC14n(env, transforms));
-			lst->addTransform(c);
-			c->load();
-
-		}
-
-		else {
+		if (!XSECmapURIToTransformType(transformAtts->item(i)->getNodeValue(), tt)) {
 
 			// Not what we expected to see!
-			safeBuffer tmp;
+			safeBuffer tmp, algorithm;
 
+			algorithm << (*formatter << transformAtts->item(i)->getNodeValue());
 			tmp.sbStrcpyIn("Unknown transform : ");
 			tmp.sbStrcatIn(algorithm);
 			tmp.sbStrcatIn(" found.");
@@ -1168,6 +1358,66 @@ DSIGTransformList * DSIGReference::loadTransforms(
 			throw XSECException(XSECException::UnknownTransform, tmp.rawCharBuffer());
 		}
 
+		switch (tt) {
+
+		case TRANSFORM_BASE64 :
+			{
+				DSIGTransformBase64 * b;
+				XSECnew(b, DSIGTransformBase64(env, transforms));
+				lst->addTransform(b);
+				b->load();
+			}
+			break;
+
+		case TRANSFORM_XPATH :
+			{
+				DSIGTransformXPath * x;
+				XSECnew(x, DSIGTransformXPath(env, transforms));
+				lst->addTransform(x);
+				x->load();
+			}
+			break;
+
+		case TRANSFORM_XPATH_FILTER :
+			{
+				DSIGTransformXPathFilter * xpf;
+				XSECnew(xpf, DSIGTransformXPathFilter(env, transforms));
+				lst->addTransform(xpf);
+				xpf->load();
+			}
+			break;
+
+		case TRANSFORM_ENVELOPED_SIGNATURE :
+			{
+				DSIGTransformEnvelope * e;
+				XSECnew(e, DSIGTransformEnvelope(env, transforms));
+				lst->addTransform(e);
+				e->load();
+			}
+			break;
+
+		case TRANSFORM_XSLT :
+			{
+				DSIGTransformXSL * x;
+				XSECnew(x, DSIGTransformXSL(env, transforms));
+				lst->addTransform(x);
+				x->load();
+			}
+			break;
+
+		case TRANSFORM_C14N :
+		case TRANSFORM_C14N11 :
+		case TRANSFORM_EXC_C14N :
+			{
+				DSIGTransformC14n * c;
+				XSECnew(c, DSIGTransformC14n(env, transforms));
+				lst->addTransform(c);
+				c->load();
+			}
+			break;
+
+		}
+
 		// Now find next element
 
 		transforms = transforms->getNextSibling();
@@ -1189,11 +1439,18 @@ void DSIGReference::setHash(void) {
 	// First determine the hash value
 	XMLByte calculatedHashVal[CRYPTO_MAX_HASH_SIZE];	// The hash that we determined
 	unsigned int calculatedHashLen;
-	XMLByte base64Hash [CRYPTO_MAX_HASH_SIZE * 2];
-	unsigned int base64HashLen;
 
 	calculatedHashLen = calculateHash(calculatedHashVal, CRYPTO_MAX_HASH_SIZE);
 
+	setHashValue(calculatedHashVal, calculatedHashLen);
+
+}
+
+void DSIGReference::setHashValue(const XMLByte * calculatedHashVal, unsigned int calculatedHashLen) {
+
+	XMLByte base64Hash [CRYPTO_MAX_HASH_SIZE * 2];
+	unsigned int base64HashLen;
+
 	// Calculate the base64 value
 
 	XSECCryptoBase64 *	b64 = XSECPlatformUtils::g_cryptoProvider->base64();
@@ -1256,24 +1513,13 @@ void DSIGReference::setHash(void) {
 //           Create hash
 // --------------------------------------------------------------------------------
 
-unsigned int DSIGReference::calculateHash(XMLByte *toFill, unsigned int maxToFill) {
-
-	// Determine the hash value of the element
+TXFMChain * DSIGReference::createHashInputChain(void) {
 
-	// First set up for input
+	// Build the chain that produces the bytes to be digested
 
 	TXFMBase * currentTxfm;
 	TXFMChain * chain;
 
-	unsigned int size;
-
-	if (m_loaded == false) {
-
-		throw XSECException(XSECException::NotLoaded,
-			"calculateHash() called in DSIGReference before load()");
-
-	}
-
 	// Find base transform
 	currentTxfm = getURIBaseTXFM(mp_referenceNode->getOwnerDocument(), mp_URI,
 		mp_env);
@@ -1282,6 +1528,7 @@ unsigned int DSIGReference::calculateHash(XMLByte *toFill, unsigned int maxToFil
 	// Note this passes ownership of currentTxfm to the function, so it is the
 	// responsibility of createTXFMChain to ensure it gets deleted if this throws.
 
+	loadTransformList();
 	chain = createTXFMChainFromList(currentTxfm, mp_transformList);
 	Janitor<TXFMChain> j_chain(chain);
 
@@ -1311,6 +1558,71 @@ unsigned int DSIGReference::calculateHash(XMLByte *toFill, unsigned int maxToFil
     if (sink)
         chain->appendTxfm(sink);
 
+	j_chain.release();
+	return chain;
+
+}
+
+void DSIGReference::makeDigestMemoKey(safeBuffer & key) {
+
+	// The digest method and the canonical form of the Transforms
+	// element (which carries every parameter and the namespaces in
+	// scope) identify what is done to the dereferenced bytes
+
+	key << (*mp_formatter << mp_algorithmURI);
+	key.sbStrcatIn("\n");
+
+	if (mp_transformsNode == NULL)
+		return;
+
+	XSECC14n20010315 c14n(mp_referenceNode->getOwnerDocument(), mp_transformsNode);
+	c14n.setCommentsProcessing(false);
+
+	char buf[2048];
+	xsecsize_t len;
+
+	while ((len = c14n.outputBuffer((unsigned char *) buf, 2047)) > 0) {
+		buf[len] = '\0';
+		key.sbStrcatIn(buf);
+	}
+
+}
+
+unsigned int DSIGReference::calculateHash(XMLByte *toFill, unsigned int maxToFill) {
+
+	// Determine the hash value of the element
+
+	unsigned int size;
+
+	if (m_loaded == false) {
+
+		throw XSECException(XSECException::NotLoaded,
+			"calculateHash() called in DSIGReference before load()");
+
+	}
+
+	// A caching resolver may already know the digest of an external
+	// reference with these transforms
+
+	XSECURIResolver * resolver = mp_env->getURIResolver();
+	safeBuffer memoKey;
+	bool useMemo = (resolver != NULL && mp_preHash == NULL &&
+		mp_URI != NULL && mp_URI[0] != 0 && mp_URI[0] != chPound &&
+		resolver->usesDigestMemo());
+
+	if (useMemo) {
+
+		makeDigestMemoKey(memoKey);
+		size = resolver->findDigestMemo(mp_URI, memoKey.rawCharBuffer(), toFill, maxToFill);
+		if (size > 0)
+			return size;
+
+	}
+
+	// First set up for input
+
+	TXFMChain * chain = createHashInputChain();
+	Janitor<TXFMChain> j_chain(chain);
 
 	// Get the mapping for the hash transform
 
@@ -1339,6 +1651,9 @@ unsigned int DSIGReference::calculateHash(XMLByte *toFill, unsigned int maxToFil
 	// Clean out document if necessary
 	chain->getLastTxfm()->deleteExpandedNameSpaces();
 
+	if (useMemo && size > 0)
+		resolver->storeDigestMemo(mp_URI, memoKey.rawCharBuffer(), toFill, size);
+
 	return size;
 
 }
@@ -351,10 +351,13 @@ public:
 	 * \brief Obtain the transforms for this reference
 	 *
 	 * Get the DSIGTransformList object for this reference.  Can be used to
-	 * obtain information about the transforms and also change the the transforms
+	 * obtain information about the transforms and also change the the transforms.
+	 * For a reference read from XML the transforms are loaded on the first
+	 * call.
 	 */
 
 	DSIGTransformList * getTransforms(void) {
+		loadTransformList();
 		return mp_transformList;
 	}
 
@@ -535,7 +538,8 @@ public:
 	 * @param interlocking If set to false, the library will assume there
 	 * are no inter-related references.  The algorithm for determining this
 	 * internally is very primitive and CPU intensive, so this is a method to 
-	 * bypass the checks.
+	 * bypass the checks.  It also allows the library to digest the
+	 * references as a single batch (see XSECCryptoProvider::hashMultiple).
 	 */
 	static void hashReferenceList(DSIGReferenceList * list, bool interlocking = true);
 
@@ -545,6 +549,11 @@ private:
 
 	// Internal functions
 	void createTransformList(void);
+	void loadTransformList(void) const;
+	void setHashValue(const XMLByte * hash, unsigned int hashLen);
+	TXFMChain * createHashInputChain(void);
+	void makeDigestMemoKey(safeBuffer & key);
+	static void hashReferenceBatch(DSIGReferenceList * lst);
 	void addTransform(
 		DSIGTransform * txfm, 
 		XERCES_CPP_NAMESPACE_QUALIFIER DOMElement * txfmElt
@@ -565,7 +574,7 @@ private:
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode						
 								* mp_hashValueNode;		// Node where the Hash value is stored
 	const XSECEnv				* mp_env;
-	DSIGTransformList			* mp_transformList;		// List of transforms
+	mutable DSIGTransformList	* mp_transformList;		// List of transforms (loaded on demand)
 	const XMLCh					* mp_algorithmURI;		// Hash algorithm for this reference
 	
 	bool                        m_loaded;
@@ -575,6 +584,8 @@ private:
 	/*\@}*/
 
 	friend class DSIGSignedInfo;
+	friend class DSIGSignature;
+	friend class DSIGSignatureTemplate;
 };
 
 
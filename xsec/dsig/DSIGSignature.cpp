@@ -35,6 +35,7 @@
 #include <xsec/dsig/DSIGObject.hpp>
 #include <xsec/dsig/DSIGReference.hpp>
 #include <xsec/dsig/DSIGTransformList.hpp>
+#include <xsec/dsig/DSIGTransformC14n.hpp>
 #include <xsec/dsig/DSIGKeyInfoValue.hpp>
 #include <xsec/dsig/DSIGKeyInfoX509.hpp>
 #include <xsec/dsig/DSIGKeyInfoName.hpp>
@@ -50,6 +51,7 @@
 #include <xsec/framework/XSECAlgorithmMapper.hpp>
 #include <xsec/framework/XSECEnv.hpp>
 #include <xsec/framework/XSECURIResolver.hpp>
+#include <xsec/framework/XSECURIPrefetcher.hpp>
 #include <xsec/transformers/TXFMDocObject.hpp>
 #include <xsec/transformers/TXFMOutputFile.hpp>
 #include <xsec/transformers/TXFMSHA1.hpp>
@@ -64,6 +66,7 @@
 
 #include <xercesc/dom/DOMNamedNodeMap.hpp>
 #include <xercesc/util/Janitor.hpp>
+#include <xercesc/framework/XMLFormatter.hpp>
 
 XERCES_CPP_NAMESPACE_USE
 
@@ -226,6 +229,42 @@ XSECURIResolver * DSIGSignature::getURIResolver(void) const {
 
 }
 
+void DSIGSignature::setURIPrefetcher(XSECURIPrefetcher * prefetcher) {
+
+	mp_env->setURIPrefetcher(prefetcher);
+
+}
+
+XSECURIPrefetcher * DSIGSignature::getURIPrefetcher(void) const {
+
+	return mp_env->getURIPrefetcher();
+
+}
+
+void DSIGSignature::prefetchReferenceURIs(DSIGReferenceList * lst) {
+
+	if (lst == NULL)
+		return;
+
+	XSECURIPrefetcher * prefetcher = mp_env->getURIPrefetcher();
+	DSIGReferenceList::size_type sz = lst->getSize();
+
+	for (DSIGReferenceList::size_type i = 0; i < sz; ++i) {
+
+		DSIGReference * r = lst->item(i);
+		const XMLCh * URI = r->getURI();
+
+		// Same document and anonymous references are never fetched
+		if (URI != NULL && URI[0] != 0 && URI[0] != chPound)
+			prefetcher->prefetchURI(URI, mp_env->getURIResolver());
+
+		if (r->isManifest())
+			prefetchReferenceURIs(r->getManifestReferenceList());
+
+	}
+
+}
+
 void DSIGSignature::setKeyInfoResolver(XSECKeyInfoResolver * resolver) {
 
 	if (mp_KeyInfoResolver != 0)
@@ -248,6 +287,9 @@ XSECKeyInfoResolver * DSIGSignature::getKeyInfoResolver(void) const {
 DSIGObject * DSIGSignature::appendObject(void) {
 
 	DSIGObject * ret;
+	// Existing objects come first
+	loadObjects();
+
 	XSECnew(ret, DSIGObject(mp_env));
 	DOMElement * elt = ret->createBlankObject();
 
@@ -262,12 +304,15 @@ DSIGObject * DSIGSignature::appendObject(void) {
 
 int DSIGSignature::getObjectLength(void) const {
 
+	loadObjects();
 	return (unsigned int) m_objects.size();
 
 }
 
 DSIGObject * DSIGSignature::getObjectItem(int i) {
 
+	loadObjects();
+
 	if ( i < 0 || i >= ((int) m_objects.size())) {
 		throw XSECException(XSECException::ObjectError,
 			"DSIGSignature::getObjectItem - index out of range");
@@ -279,6 +324,8 @@ DSIGObject * DSIGSignature::getObjectItem(int i) {
 
 const DSIGObject * DSIGSignature::getObjectItem(int i) const {
 
+	loadObjects();
+
 	if ( i < 0 || i >= ((int) m_objects.size())) {
 		throw XSECException(XSECException::ObjectError,
 			"DSIGSignature::getObjectItem - index out of range");
@@ -304,8 +351,13 @@ m_errStr("") {
 	mp_signedInfo = NULL;
 	mp_KeyInfoResolver = NULL;
 	mp_KeyInfoNode = NULL;
+	mp_signatureValueNode = NULL;
 	m_loaded = false;
+	m_keyInfoLoaded = false;
+	m_objectsLoaded = false;
 	m_interlockingReferences = false;
+	mp_template = NULL;
+	m_templateGeneration = 0;
 
 	// Set up our formatter
 	XSECnew(mp_formatter, XSECSafeBufferFormatter("UTF-8",XMLFormatter::NoEscapes, 
@@ -327,8 +379,13 @@ m_errStr("") {
 	mp_signedInfo = NULL;
 	mp_KeyInfoResolver = NULL;
 	mp_KeyInfoNode = NULL;
+	mp_signatureValueNode = NULL;
 	m_loaded = false;
+	m_keyInfoLoaded = false;
+	m_objectsLoaded = false;
 	m_interlockingReferences = false;
+	mp_template = NULL;
+	m_templateGeneration = 0;
 
 	// Set up our formatter
 	XSECnew(mp_formatter, XSECSafeBufferFormatter("UTF-8",XMLFormatter::NoEscapes, 
@@ -530,6 +587,8 @@ DOMElement *DSIGSignature::createBlankSignature(
 	sigValNode->appendChild(doc->createTextNode(MAKE_UNICODE_STRING("Not yet signed")));
 
 	m_loaded = true;
+	m_keyInfoLoaded = true;
+	m_objectsLoaded = true;
 	
 	return sigNode;
 }
@@ -567,6 +626,9 @@ DSIGReference * DSIGSignature::removeReference(DSIGReferenceList::size_type inde
 
 void DSIGSignature::clearKeyInfo(void) {
 
+	// Whatever was there is going - no need to read it
+	m_keyInfoLoaded = true;
+
 	if (mp_KeyInfoNode == 0)
 		return;
 
@@ -588,6 +650,9 @@ void DSIGSignature::clearKeyInfo(void) {
 
 void DSIGSignature::createKeyInfoElement(void) {
 
+	// Appends must go after anything already in the list
+	loadKeyInfo();
+
 	if (mp_KeyInfoNode != NULL)
 		return;
 
@@ -746,7 +811,8 @@ void DSIGSignature::load(void) {
 	m_signatureValueSB.sbTranscodeIn(tmpSV->getNodeValue());
 
 
-	// Now look at KeyInfo
+	// Now look at KeyInfo.  Only the node is noted here - the list and any
+	// Objects are read when first needed (see loadKeyInfo/loadObjects)
 	tmpElt = tmpElt->getNextSibling();
 
 	while (tmpElt != 0 && !((tmpElt->getNodeType() == DOMNode::ELEMENT_NODE) && 
@@ -759,22 +825,30 @@ void DSIGSignature::load(void) {
 
 		mp_KeyInfoNode = tmpElt;		// In case we later want to manipulate it
 
-		m_keyInfoList.loadListFromXML(tmpElt);
-
-		tmpElt = findNextElementChild(tmpElt);
 	}
 
-	while (tmpElt != 0 && strEquals(getDSIGLocalName(tmpElt), "Object")) {
+	// The DSIGObjects are built on demand, but their Ids must be known
+	// now - a Reference to "#id" may point at one of our own Objects and
+	// can be hashed (sign, checkHash, verifySignatureOnly) without
+	// loadObjects() ever being called
 
-		DSIGObject * obj;
-		XSECnew(obj, DSIGObject(mp_env, tmpElt));
-		obj->load();
+	DOMNode * objElt = mp_signatureValueNode->getNextSibling();
 
-		m_objects.push_back(obj);
+	while (objElt != 0) {
 
-		tmpElt = findNextElementChild(tmpElt);
+		if (objElt->getNodeType() == DOMNode::ELEMENT_NODE &&
+			strEquals(getDSIGLocalName(objElt), "Object"))
+			DSIGObject::registerId((DOMElement *) objElt);
+
+		objElt = objElt->getNextSibling();
 
 	}
+
+	// Start fetching external references while the caller gets on
+	// with finding a key
+	if (mp_env->getURIPrefetcher() != NULL)
+		prefetchReferenceURIs(mp_signedInfo->getReferenceList());
+
 /*
 	* Strictly speaking, this should remain, but it causes too many problems with non
 	* conforming signatures
@@ -786,6 +860,48 @@ void DSIGSignature::load(void) {
 */
 }
 
+void DSIGSignature::loadKeyInfo(void) const {
+
+	if (m_keyInfoLoaded || !m_loaded)
+		return;
+
+	m_keyInfoLoaded = true;
+
+	if (mp_KeyInfoNode != NULL)
+		m_keyInfoList.loadListFromXML(mp_KeyInfoNode);
+
+}
+
+void DSIGSignature::loadObjects(void) const {
+
+	if (m_objectsLoaded || !m_loaded)
+		return;
+
+	m_objectsLoaded = true;
+
+	if (mp_signatureValueNode == NULL)
+		return;
+
+	// Objects follow the SignatureValue and the (optional) KeyInfo
+
+	DOMNode * tmpElt = findNextElementChild(mp_signatureValueNode);
+
+	if (tmpElt != 0 && strEquals(getDSIGLocalName(tmpElt), "KeyInfo"))
+		tmpElt = findNextElementChild(tmpElt);
+
+	while (tmpElt != 0 && strEquals(getDSIGLocalName(tmpElt), "Object")) {
+
+		DSIGObject * obj;
+		XSECnew(obj, DSIGObject(mp_env, tmpElt));
+		m_objects.push_back(obj);
+		obj->load();
+
+		tmpElt = findNextElementChild(tmpElt);
+
+	}
+
+}
+
 TXFMChain * DSIGSignature::getSignedInfoInput(void) {
 
 	TXFMBase * txfm;
@@ -937,6 +1053,8 @@ bool DSIGSignature::verifySignatureOnlyInternal(void) {
 
 		}
 		
+		loadKeyInfo();
+
 		if ((mp_signingKey = mp_KeyInfoResolver->resolveKey(&m_keyInfoList)) == NULL) {
 
 			throw XSECException(XSECException::SigVfyError,
@@ -1002,6 +1120,10 @@ bool DSIGSignature::verify(void) {
 	// Reset
 	m_errStr.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
 
+	// Anything load() left for later is needed now
+	loadKeyInfo();
+	loadObjects();
+
 	// First thing to do is check the references
 
 	referenceCheckResult = mp_signedInfo->verify(m_errStr);
@@ -1045,10 +1167,22 @@ void DSIGSignature::sign(void) {
 	// Set up the reference list hashes - including any manifests
 	mp_signedInfo->hash(m_interlockingReferences);
 
+	signSignedInfo();
+
+}
+
+void DSIGSignature::signSignedInfo(void) {
+
 	// Get the SignedInfo input bytes
 	TXFMChain * chain = getSignedInfoInput();
 	Janitor<TXFMChain> j_chain(chain);
 
+	signSignedInfo(chain);
+
+}
+
+void DSIGSignature::signSignedInfo(TXFMChain * chain) {
+
 	// Calculate the hash to be signed
 
 	safeBuffer b64Buf;
@@ -1095,6 +1229,186 @@ void DSIGSignature::sign(void) {
 	
 }
 
+// --------------------------------------------------------------------------------
+//           Sign and serialise
+// --------------------------------------------------------------------------------
+
+DSIGReference * DSIGSignature::findDocumentReference(void) {
+
+	// Find a reference whose digest input is the canonical form of the
+	// whole document less this signature.  That is exactly what gets
+	// written out, so the two can share a walk of the tree.
+
+	DSIGReferenceList * lst = mp_signedInfo->getReferenceList();
+	if (lst == NULL)
+		return NULL;
+
+	DSIGReferenceList::size_type sz = lst->getSize();
+
+	// Interlocking references need the multi-pass settle in hashReferenceList
+	if (m_interlockingReferences && sz > 1)
+		return NULL;
+
+	// The signature must actually be in the document for the enveloped
+	// transform to remove it
+	DOMNode * p = mp_sigNode;
+	while (p != NULL && p != mp_doc)
+		p = p->getParentNode();
+
+	if (p == NULL)
+		return NULL;
+
+	for (DSIGReferenceList::size_type i = 0; i < sz; ++i) {
+
+		DSIGReference * r = lst->item(i);
+
+		if (r->mp_URI == NULL || r->mp_URI[0] != 0 || r->m_isManifest || r->mp_preHash != NULL)
+			continue;
+
+		DSIGTransformList * tl = r->mp_transformList;
+		if (tl == NULL || tl->getSize() < 1 || tl->getSize() > 2)
+			continue;
+
+		if (tl->item(0)->getTransformType() != TRANSFORM_ENVELOPED_SIGNATURE)
+			continue;
+
+		if (tl->getSize() == 2 &&
+			(tl->item(1)->getTransformType() != TRANSFORM_C14N ||
+			 ((DSIGTransformC14n *) tl->item(1))->getCanonicalizationMethod() != CANON_C14N_NOC))
+			continue;
+
+		return r;
+
+	}
+
+	return NULL;
+
+}
+
+void DSIGSignature::serialiseNode(DOMNode * n, XMLFormatTarget * target) {
+
+	XSECC14n20010315 * c14n;
+
+	if (n->getNodeType() == DOMNode::DOCUMENT_NODE) {
+		XSECnew(c14n, XSECC14n20010315((DOMDocument *) n));
+	}
+	else {
+		XSECnew(c14n, XSECC14n20010315(mp_doc, n));
+	}
+	Janitor<XSECC14n20010315> j_c14n(c14n);
+
+	c14n->setCommentsProcessing(false);
+
+	unsigned char buf[2048];
+	xsecsize_t len;
+
+	while ((len = c14n->outputBuffer(buf, 2048)) > 0)
+		target->writeChars(buf, len, NULL);
+
+}
+
+void DSIGSignature::signAndSerialise(XMLFormatTarget * target) {
+
+	if (!m_loaded) {
+
+		throw XSECException(XSECException::SigVfyError,
+					"DSIGSignature::signAndSerialise() called prior to DSIGSignature::load()");
+
+	}
+
+	if (mp_signingKey == NULL) {
+
+		throw XSECException(XSECException::SigVfyError,
+			"DSIGSignature::signAndSerialise() - no signing key loaded");
+
+	}
+
+	DSIGReference * docRef = findDocumentReference();
+
+	if (docRef == NULL) {
+
+		// Nothing to share - sign and then write the document out
+		sign();
+		serialiseNode(mp_doc, target);
+		return;
+
+	}
+
+	m_errStr.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+
+	// Everything else first.  The enveloped transform removes the signature
+	// (and so the other digest values) from the document reference, but a
+	// manifest held outside the signature is part of it.
+
+	DSIGReferenceList * lst = mp_signedInfo->getReferenceList();
+	DSIGReferenceList::size_type sz = lst->getSize();
+
+	for (DSIGReferenceList::size_type i = 0; i < sz; ++i) {
+
+		DSIGReference * r = lst->item(i);
+		if (r == docRef)
+			continue;
+
+		if (r->isManifest())
+			DSIGReference::hashReferenceList(r->getManifestReferenceList(), m_interlockingReferences);
+
+		r->setHash();
+
+	}
+
+	// Now digest the document, copying the canonical bytes to the target
+	// on the way through
+
+	TXFMDocObject * to;
+	XSECnew(to, TXFMDocObject(mp_doc));
+	TXFMChain * chain;
+	XSECnew(chain, TXFMChain(to));
+	Janitor<TXFMChain> j_chain(chain);
+
+	to->setEnv(mp_env);
+	to->setInput(mp_doc);
+	to->stripComments();
+
+	TXFMC14n * c14n;
+	XSECnew(c14n, TXFMC14n(mp_doc));
+	chain->appendTxfm(c14n);
+	c14n->setOutputTarget(target, mp_sigNode);
+
+	TXFMBase * sink = XSECPlatformUtils::GetReferenceLoggingSink(mp_doc);
+	if (sink)
+		chain->appendTxfm(sink);
+
+	XSECAlgorithmHandler * handler =
+		XSECPlatformUtils::g_algorithmMapper->mapURIToHandler(docRef->getAlgorithmURI());
+
+	if (handler == NULL) {
+
+		throw XSECException(XSECException::SigVfyError,
+			"Hash method unknown in DSIGSignature::signAndSerialise()");
+
+	}
+
+	if (!handler->appendHashTxfm(chain, docRef->getAlgorithmURI())) {
+
+		throw XSECException(XSECException::SigVfyError,
+			"Unexpected error in handler whilst appending Hash transform");
+
+	}
+
+	XMLByte hashVal[CRYPTO_MAX_HASH_SIZE];
+	unsigned int hashLen = chain->getLastTxfm()->readBytes(hashVal, CRYPTO_MAX_HASH_SIZE);
+	chain->getLastTxfm()->deleteExpandedNameSpaces();
+
+	docRef->setHashValue(hashVal, hashLen);
+
+	// Sign, then fill the gap left by the signature and write the rest
+	signSignedInfo();
+
+	serialiseNode(mp_sigNode, target);
+	c14n->writeHeldOutput();
+
+}
+
 // --------------------------------------------------------------------------------
 //           Key Management
 // --------------------------------------------------------------------------------
@@ -42,9 +42,12 @@
 
 #include <xercesc/dom/DOM.hpp>
 
+XSEC_DECLARE_XERCES_CLASS(XMLFormatTarget);
+
 class XSECEnv;
 class XSECBinTXFMInputStream;
 class XSECURIResolver;
+class XSECURIPrefetcher;
 class XSECKeyInfoResolver;
 class DSIGKeyInfoValue;
 class DSIGKeyInfoX509;
@@ -53,6 +56,8 @@ class DSIGKeyInfoPGPData;
 class DSIGKeyInfoSPKIData;
 class DSIGKeyInfoMgmtData;
 class DSIGObject;
+class DSIGReference;
+class DSIGSignatureTemplate;
 
 /**
  * @ingroup pubsig
@@ -109,6 +114,12 @@ public:
 	  * into local structures.  Will throw various exceptions if it finds that
 	  * the DOM structure is not in line with the XML Signature standard.
 	  *
+	  * Only SignedInfo, its References and the SignatureValue are read
+	  * here.  Reference transforms, the KeyInfo list and any Objects are
+	  * loaded the first time they are asked for, so looking at the
+	  * signature method or reference URIs stays cheap.  verify() loads
+	  * everything.
+	  *
 	  */
 
 	void load(void);
@@ -197,6 +208,38 @@ public:
 	  */
 
 	void sign(void);
+
+	/**
+	  * \brief Sign the signature and serialise the signed document.
+	  *
+	  * <p>Performs the same operations as #sign and then writes the
+	  * document to a format target.  Where a reference covers the whole
+	  * document (URI="" with an enveloped signature transform, optionally
+	  * followed by inclusive canonicalisation without comments), the bytes
+	  * canonicalised for that reference's digest are written to the target
+	  * as they are produced, so the document is only walked once.  The
+	  * signature element is written into its place after the signature
+	  * value has been calculated.</p>
+	  *
+	  * <p>If no reference qualifies (or interlocking references are in use
+	  * with more than one reference) this falls back to #sign followed by
+	  * a separate serialisation pass.</p>
+	  *
+	  * @note The output is the canonical form of the document - UTF-8,
+	  * with no XML declaration, DOCTYPE or comments.  The signature element
+	  * carries the namespace declarations it inherits from its ancestors.
+	  * The part of the document that follows the signature element can
+	  * only be written once the signature is complete; past the first 64K
+	  * it is held in a temporary file rather than in memory.
+	  *
+	  * @param target The format target the document is written to
+	  * @throws XSECException (for errors during the XML formatting and loading)
+	  * @throws XSECCryptoException (for errors during the cryptographic operations)
+	  *
+	  * @see #sign
+	  */
+
+	void signAndSerialise(XERCES_CPP_NAMESPACE_QUALIFIER XMLFormatTarget * target);
 	//@}
 
 	/** @name Functions to create and manipulate signature elements. */
@@ -674,6 +717,31 @@ public:
 
 	XSECURIResolver * getURIResolver(void) const;
 
+	/**
+	 * \brief Register a URIPrefetcher
+	 *
+	 * If a prefetcher is registered before load() is called, every
+	 * external Reference URI (including those in Manifests) is handed
+	 * to it as soon as the signature is loaded, so the documents can be
+	 * fetched concurrently rather than one at a time during
+	 * verification.
+	 *
+	 * The prefetcher is not cloned - it remains owned by the caller
+	 * and must outlive the signature.
+	 *
+	 * @param prefetcher Prefetcher to use, or NULL to stop prefetching
+	 */
+
+	void setURIPrefetcher(XSECURIPrefetcher * prefetcher);
+
+	/**
+	 * \brief Return the prefetcher being used
+	 *
+	 * @returns The registered prefetcher, or NULL if there is none
+	 */
+
+	XSECURIPrefetcher * getURIPrefetcher(void) const;
+
 	/**
 	 * \brief Register a KeyInfoResolver 
 	 *
@@ -713,7 +781,7 @@ public:
 	 * @returns A pointer to the DSIGKeyInfoList object held by the DSIGSignature
 	 */
 	
-	DSIGKeyInfoList * getKeyInfoList() {return &m_keyInfoList;}
+	DSIGKeyInfoList * getKeyInfoList() {loadKeyInfo(); return &m_keyInfoList;}
 
 	/**
 	 * \brief Get the list of \<KeyInfo\> elements.
@@ -730,7 +798,7 @@ public:
 	 * @returns A pointer to the DSIGKeyInfoList object held by the DSIGSignature
 	 */
 	
-	const DSIGKeyInfoList * getKeyInfoList() const {return &m_keyInfoList;}
+	const DSIGKeyInfoList * getKeyInfoList() const {loadKeyInfo(); return &m_keyInfoList;}
 
 	/**
 	 * \brief Clear out all KeyInfo elements in the signature.
@@ -976,6 +1044,7 @@ public:
 	//@}
 
 	friend class XSECProvider;
+	friend class DSIGSignatureTemplate;
 
 private:
 
@@ -990,7 +1059,15 @@ private:
 	// Internal functions
 	void createKeyInfoElement(void);
 	bool verifySignatureOnlyInternal(void);
+	void loadKeyInfo(void) const;
+	void loadObjects(void) const;
 	TXFMChain * getSignedInfoInput(void);
+	void signSignedInfo(void);
+	void signSignedInfo(TXFMChain * chain);
+	DSIGReference * findDocumentReference(void);
+	void prefetchReferenceURIs(DSIGReferenceList * lst);
+	void serialiseNode(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * n,
+		XERCES_CPP_NAMESPACE_QUALIFIER XMLFormatTarget * target);
 
 	// Initialisation
 	static void Initialise(void);
@@ -1005,7 +1082,8 @@ private:
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode						
 								* mp_signatureValueNode;
 	safeBuffer					m_signatureValueSB;
-	DSIGKeyInfoList				m_keyInfoList;
+	mutable DSIGKeyInfoList		m_keyInfoList;
+	mutable bool				m_keyInfoLoaded;		// KeyInfo list read from mp_KeyInfoNode?
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode						
 								* mp_KeyInfoNode;
 	safeBuffer			        m_errStr;
@@ -1021,11 +1099,16 @@ private:
 
 	// Objects
 
-	ObjectVectorType			m_objects;
+	mutable ObjectVectorType	m_objects;
+	mutable bool				m_objectsLoaded;		// Object elements read?
 
 	// Interlocking references
 	bool						m_interlockingReferences;
 
+	// Set by DSIGSignatureTemplate::instantiate()
+	const DSIGSignatureTemplate	* mp_template;
+	unsigned int				m_templateGeneration;
+
 	// Not implemented constructors
 
 	DSIGSignature();
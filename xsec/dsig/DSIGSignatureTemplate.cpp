@@ -0,0 +1,633 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * DSIGSignatureTemplate := Pre-canonicalised SignedInfo for signing many
+ *                          messages of the same shape
+ *
+ * $Id$
+ *
+ */
+
+// XSEC Includes
+#include <xsec/dsig/DSIGSignatureTemplate.hpp>
+#include <xsec/dsig/DSIGSignature.hpp>
+#include <xsec/dsig/DSIGSignedInfo.hpp>
+#include <xsec/dsig/DSIGReference.hpp>
+#include <xsec/framework/XSECError.hpp>
+#include <xsec/framework/XSECProvider.hpp>
+#include <xsec/transformers/TXFMSB.hpp>
+#include <xsec/transformers/TXFMChain.hpp>
+#include <xsec/utils/XSECDOMUtils.hpp>
+
+// Xerces includes
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/util/Janitor.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef vector<DOMNode *>				DOMNodeVectorType;
+typedef vector<XMLCh *>					XMLChVectorType;
+#else
+typedef std::vector<DOMNode *>			DOMNodeVectorType;
+typedef std::vector<XMLCh *>			XMLChVectorType;
+#endif
+
+static const XMLCh s_xmlPrefix[] = {
+
+	chLatin_x,
+	chLatin_m,
+	chLatin_l,
+	chColon,
+	chNull
+
+};
+
+// --------------------------------------------------------------------------------
+//           Constructors and Destructors
+// --------------------------------------------------------------------------------
+
+DSIGSignatureTemplate::DSIGSignatureTemplate() :
+	m_compiled(false),
+	m_signedInfoLen(0),
+	m_canonicalizationMethod(CANON_NONE),
+	mp_templateDoc(NULL),
+	m_generation(0) {
+
+}
+
+DSIGSignatureTemplate::~DSIGSignatureTemplate() {
+
+	if (mp_templateDoc != NULL)
+		mp_templateDoc->release();
+
+}
+
+// --------------------------------------------------------------------------------
+//           Utilities
+// --------------------------------------------------------------------------------
+
+static bool inheritsContext(canonicalizationMethod cm) {
+
+	return (cm == CANON_C14N_NOC || cm == CANON_C14N_COM ||
+		cm == CANON_C14N11_NOC || cm == CANON_C14N11_COM);
+
+}
+
+static void getPrefixContext(DOMNode * sigNode, const XMLCh * prefixList, safeBuffer & context) {
+
+	// The bindings in scope for each prefix of an exclusive PrefixList
+
+	safeBuffer name;
+	const XMLCh * p = prefixList;
+
+	while (*p != chNull) {
+
+		while (*p == chSpace || *p == chHTab || *p == chLF || *p == chCR)
+			++p;
+
+		const XMLCh * start = p;
+		while (*p != chNull && !(*p == chSpace || *p == chHTab || *p == chLF || *p == chCR))
+			++p;
+
+		if (p == start)
+			continue;
+
+		name.sbXMLChIn(DSIGConstants::s_unicodeStrXmlns);
+		XMLSize_t len = p - start;
+		XMLCh * prefix = new XMLCh[len + 1];
+		ArrayJanitor<XMLCh> j_prefix(prefix);
+		XMLString::copyNString(prefix, start, len);
+		prefix[len] = chNull;
+
+		if (!strEquals(prefix, "#default")) {
+			name.sbXMLChAppendCh(chColon);
+			name.sbXMLChCat(prefix);
+		}
+
+		context.sbXMLChCat(name.rawXMLChBuffer());
+		context.sbXMLChAppendCh(chEqual);
+
+		DOMNode * n = sigNode;
+		while (n != NULL && n->getNodeType() == DOMNode::ELEMENT_NODE) {
+
+			DOMNode * a = n->getAttributes()->getNamedItem(name.rawXMLChBuffer());
+			if (a != NULL) {
+				context.sbXMLChCat(a->getNodeValue());
+				break;
+			}
+
+			n = n->getParentNode();
+
+		}
+
+		context.sbXMLChAppendCh(chSpace);
+
+	}
+
+}
+
+void DSIGSignatureTemplate::getContext(DOMNode * sigNode, safeBuffer & context) const {
+
+	context.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+
+	if (!inheritsContext(m_canonicalizationMethod)) {
+		getPrefixContext(sigNode, m_prefixList.rawXMLChBuffer(), context);
+		return;
+	}
+
+	// Everything an inclusive canonicalisation of the SignedInfo inherits
+	// from its ancestors.  Shadowed declarations are kept - it is only
+	// used to check nothing has changed.
+
+	DOMNode * n = sigNode;
+	while (n != NULL && n->getNodeType() == DOMNode::ELEMENT_NODE) {
+
+		DOMNamedNodeMap * atts = n->getAttributes();
+		XMLSize_t sz = (atts == NULL ? 0 : atts->getLength());
+
+		for (XMLSize_t i = 0; i < sz; ++i) {
+
+			DOMNode * a = atts->item(i);
+			const XMLCh * name = a->getNodeName();
+
+			if (XMLString::startsWith(name, DSIGConstants::s_unicodeStrXmlns) ||
+				XMLString::startsWith(name, s_xmlPrefix)) {
+
+				context.sbXMLChCat(name);
+				context.sbXMLChAppendCh(chEqual);
+				context.sbXMLChCat(a->getNodeValue());
+				context.sbXMLChAppendCh(chSpace);
+
+			}
+
+		}
+
+		n = n->getParentNode();
+
+	}
+
+}
+
+static void appendString(safeBuffer & sb, const XMLCh * str) {
+
+	// Length prefixed so that no two different trees give the same string
+
+	XMLCh len[16];
+	XMLString::binToText((unsigned int) (str == NULL ? 0 : XMLString::stringLen(str)), len, 15, 10);
+
+	sb.sbXMLChCat(len);
+	sb.sbXMLChAppendCh(chColon);
+	if (str != NULL)
+		sb.sbXMLChCat(str);
+
+}
+
+static bool isDigestValue(DOMNode * n, const DOMNodeVectorType & digests) {
+
+	DOMNodeVectorType::size_type sz = digests.size();
+	for (DOMNodeVectorType::size_type i = 0; i < sz; ++i) {
+		if (digests[i] == n)
+			return true;
+	}
+
+	return false;
+
+}
+
+static void appendTree(DOMNode * n, const DOMNodeVectorType & digests, safeBuffer & structure) {
+
+	switch (n->getNodeType()) {
+
+	case DOMNode::ELEMENT_NODE :
+		{
+
+			structure.sbXMLChAppendCh(chOpenAngle);
+			appendString(structure, n->getNodeName());
+			appendString(structure, n->getNamespaceURI());
+
+			DOMNamedNodeMap * atts = n->getAttributes();
+			XMLSize_t sz = (atts == NULL ? 0 : atts->getLength());
+
+			for (XMLSize_t i = 0; i < sz; ++i) {
+
+				DOMNode * a = atts->item(i);
+				structure.sbXMLChAppendCh(chSpace);
+				appendString(structure, a->getNodeName());
+				appendString(structure, a->getNamespaceURI());
+				appendString(structure, a->getNodeValue());
+
+			}
+
+			// The text of a DigestValue is what changes between signatures
+			if (!isDigestValue(n, digests)) {
+
+				DOMNode * c = n->getFirstChild();
+				while (c != NULL) {
+					appendTree(c, digests, structure);
+					c = c->getNextSibling();
+				}
+
+			}
+
+			structure.sbXMLChAppendCh(chCloseAngle);
+
+		}
+		break;
+
+	case DOMNode::TEXT_NODE :
+	case DOMNode::CDATA_SECTION_NODE :
+
+		structure.sbXMLChAppendCh(chLatin_t);
+		appendString(structure, n->getNodeValue());
+		break;
+
+	case DOMNode::COMMENT_NODE :
+
+		structure.sbXMLChAppendCh(chBang);
+		appendString(structure, n->getNodeValue());
+		break;
+
+	case DOMNode::PROCESSING_INSTRUCTION_NODE :
+
+		structure.sbXMLChAppendCh(chQuestion);
+		appendString(structure, n->getNodeName());
+		appendString(structure, n->getNodeValue());
+		break;
+
+	default :
+
+		// Entity references etc. - never match
+		structure.sbXMLChAppendCh(chAmpersand);
+		appendString(structure, n->getNodeName());
+		break;
+
+	}
+
+}
+
+void DSIGSignatureTemplate::getStructure(DSIGSignature * sig, safeBuffer & structure) {
+
+	// Everything in the SignedInfo other than the DigestValues
+
+	DSIGReferenceList * lst = sig->mp_signedInfo->getReferenceList();
+	DSIGReferenceList::size_type sz = lst->getSize();
+
+	DOMNodeVectorType digests;
+	for (DSIGReferenceList::size_type i = 0; i < sz; ++i)
+		digests.push_back(lst->item(i)->mp_hashValueNode);
+
+	structure.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+	appendTree(sig->mp_signedInfo->getDOMNode(), digests, structure);
+
+}
+
+static void restoreDigestValues(DOMNodeVectorType & texts, XMLChVectorType & values) {
+
+	DOMNodeVectorType::size_type sz = texts.size();
+
+	for (DOMNodeVectorType::size_type i = 0; i < sz; ++i) {
+
+		if (values[i] == NULL) {
+			// We created it
+			DOMNode * p = texts[i]->getParentNode();
+			p->removeChild(texts[i]);
+			texts[i]->release();
+		}
+		else {
+			texts[i]->setNodeValue(values[i]);
+			XMLString::release(&values[i]);
+		}
+
+	}
+
+	texts.clear();
+	values.clear();
+
+}
+
+static void makeMarker(DSIGReferenceList::size_type i, char * marker) {
+
+	// Base64 digests can never contain a '#'
+
+	strcpy(marker, "#xsec-digest-");
+	XMLString::binToText((unsigned int) i, &marker[13], 10, 10);
+	strcat(marker, "#");
+
+}
+
+// --------------------------------------------------------------------------------
+//           Compile
+// --------------------------------------------------------------------------------
+
+void DSIGSignatureTemplate::compile(DSIGSignature * sig) {
+
+	if (sig == NULL || !sig->m_loaded || sig->mp_signedInfo == NULL) {
+
+		throw XSECException(XSECException::NotLoaded,
+			"DSIGSignatureTemplate::compile() called with a signature that has not been loaded");
+
+	}
+
+	m_compiled = false;
+	m_digestOffsets.clear();
+	m_signedInfoLen = 0;
+
+	DSIGReferenceList * lst = sig->mp_signedInfo->getReferenceList();
+	DSIGReferenceList::size_type sz = lst->getSize();
+
+	// Put a marker in each DigestValue so it can be found in the
+	// canonical form.  What was there is put back afterwards.
+
+	DOMNodeVectorType texts;
+	XMLChVectorType values;
+	char marker[32];
+
+	try {
+
+		for (DSIGReferenceList::size_type i = 0; i < sz; ++i) {
+
+			DSIGReference * r = lst->item(i);
+
+			if (r->mp_hashValueNode == NULL) {
+
+				throw XSECException(XSECException::NotLoaded,
+					"DSIGSignatureTemplate::compile() - Reference has no DigestValue");
+
+			}
+
+			makeMarker(i, marker);
+
+			DOMNode * t = findFirstChildOfType(r->mp_hashValueNode, DOMNode::TEXT_NODE);
+
+			if (t == NULL) {
+				t = sig->mp_doc->createTextNode(MAKE_UNICODE_STRING(marker));
+				r->mp_hashValueNode->appendChild(t);
+				values.push_back(NULL);
+			}
+			else {
+				values.push_back(XMLString::replicate(t->getNodeValue()));
+				t->setNodeValue(MAKE_UNICODE_STRING(marker));
+			}
+
+			texts.push_back(t);
+
+		}
+
+		TXFMChain * chain = sig->getSignedInfoInput();
+		Janitor<TXFMChain> j_chain(chain);
+
+		safeBuffer c14n;
+		c14n << chain->getLastTxfm();
+
+		// Keep everything between the markers
+
+		xsecsize_t from = 0;
+
+		for (DSIGReferenceList::size_type i = 0; i < sz; ++i) {
+
+			makeMarker(i, marker);
+
+			long found = c14n.sbStrstr(marker);
+			if (found < (long) from ||
+				c14n.sbOffsetStrstr(marker, (xsecsize_t) found + 1) >= 0) {
+
+				throw XSECException(XSECException::SigVfyError,
+					"DSIGSignatureTemplate::compile() - unable to find DigestValue in canonical SignedInfo");
+
+			}
+
+			xsecsize_t at = (xsecsize_t) found;
+
+			m_signedInfo.sbMemcpyIn(m_signedInfoLen, &(c14n.rawBuffer()[from]), at - from);
+			m_signedInfoLen += at - from;
+			m_digestOffsets.push_back(m_signedInfoLen);
+			from = at + (xsecsize_t) strlen(marker);
+
+		}
+
+		xsecsize_t len = c14n.sbStrlen();
+		m_signedInfo.sbMemcpyIn(m_signedInfoLen, &(c14n.rawBuffer()[from]), len - from);
+		m_signedInfoLen += len - from;
+
+	}
+	catch (...) {
+		restoreDigestValues(texts, values);
+		m_digestOffsets.clear();
+		m_signedInfoLen = 0;
+		throw;
+	}
+
+	restoreDigestValues(texts, values);
+
+	m_canonicalizationMethod = sig->mp_signedInfo->getCanonicalizationMethod();
+	getStructure(sig, m_structure);
+
+	// An exclusive PrefixList brings in bindings from the ancestors
+
+	m_prefixList.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+
+	if (m_canonicalizationMethod == CANON_C14NE_NOC || m_canonicalizationMethod == CANON_C14NE_COM) {
+
+		DOMElement * cm = findFirstElementChild(sig->mp_signedInfo->getDOMNode());
+		DOMElement * inc = (cm == NULL ? NULL : findFirstElementChild(cm));
+
+		if (inc != NULL && strEquals(getECLocalName(inc), "InclusiveNamespaces"))
+			m_prefixList.sbXMLChIn(inc->getAttributeNS(NULL, DSIGConstants::s_unicodeStrPrefixList));
+
+	}
+
+	getContext(sig->mp_sigNode, m_context);
+
+	// Keep a copy of the Signature to create message signatures from
+
+	if (mp_templateDoc != NULL)
+		mp_templateDoc->release();
+
+	mp_templateDoc = sig->mp_doc->getImplementation()->createDocument();
+	mp_templateDoc->appendChild(mp_templateDoc->importNode(sig->mp_sigNode, true));
+
+	++m_generation;
+	m_compiled = true;
+
+}
+
+// --------------------------------------------------------------------------------
+//           Instantiate
+// --------------------------------------------------------------------------------
+
+DSIGSignature * DSIGSignatureTemplate::instantiate(XSECProvider & prov,
+												   DOMElement * parent,
+												   DOMNode * before) const {
+
+	if (!m_compiled) {
+
+		throw XSECException(XSECException::SigVfyError,
+			"DSIGSignatureTemplate::instantiate() called prior to compile()");
+
+	}
+
+	DOMDocument * doc = parent->getOwnerDocument();
+	DOMNode * sigNode = doc->importNode(mp_templateDoc->getDocumentElement(), true);
+	parent->insertBefore(sigNode, before);
+
+	DSIGSignature * sig = prov.newSignatureFromDOM(doc, sigNode);
+
+	try {
+		sig->load();
+	}
+	catch (...) {
+		prov.releaseSignature(sig);
+		throw;
+	}
+
+	sig->mp_template = this;
+	sig->m_templateGeneration = m_generation;
+
+	return sig;
+
+}
+
+// --------------------------------------------------------------------------------
+//           Sign
+// --------------------------------------------------------------------------------
+
+bool DSIGSignatureTemplate::matches(DSIGSignature * sig) const {
+
+	if (sig->mp_signedInfo->getCanonicalizationMethod() != m_canonicalizationMethod)
+		return false;
+
+	DSIGReferenceList * lst = sig->mp_signedInfo->getReferenceList();
+	DSIGReferenceList::size_type sz = lst->getSize();
+
+	if (sz != m_digestOffsets.size())
+		return false;
+
+	// Each DigestValue must be a single text node for the splice to
+	// give the same bytes as canonicalising the DOM
+
+	for (DSIGReferenceList::size_type i = 0; i < sz; ++i) {
+
+		DOMNode * c = lst->item(i)->mp_hashValueNode->getFirstChild();
+		if (c == NULL || c->getNodeType() != DOMNode::TEXT_NODE || c->getNextSibling() != NULL)
+			return false;
+
+	}
+
+	// Anything else that differs from the template (a Reference URI, a
+	// transform...) changes the canonical form.  A signature created by
+	// instantiate() is a copy of the template, so needs no check.
+
+	if (sig->mp_template != this || sig->m_templateGeneration != m_generation) {
+
+		safeBuffer structure;
+		getStructure(sig, structure);
+		if (!strEquals(structure.rawXMLChBuffer(), m_structure.rawXMLChBuffer()))
+			return false;
+
+	}
+
+	safeBuffer context;
+	getContext(sig->mp_sigNode, context);
+	if (!strEquals(context.rawXMLChBuffer(), m_context.rawXMLChBuffer()))
+		return false;
+
+	return true;
+
+}
+
+bool DSIGSignatureTemplate::sign(DSIGSignature * sig) const {
+
+	if (!m_compiled) {
+
+		throw XSECException(XSECException::SigVfyError,
+			"DSIGSignatureTemplate::sign() called prior to compile()");
+
+	}
+
+	if (sig == NULL || !sig->m_loaded) {
+
+		throw XSECException(XSECException::SigVfyError,
+			"DSIGSignatureTemplate::sign() called prior to DSIGSignature::load()");
+
+	}
+
+	if (sig->mp_signingKey == NULL) {
+
+		throw XSECException(XSECException::SigVfyError,
+			"DSIGSignatureTemplate::sign() - no signing key loaded");
+
+	}
+
+	sig->m_errStr.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+
+	// The references are digested as for DSIGSignature::sign()
+	sig->mp_signedInfo->hash(sig->m_interlockingReferences);
+
+	if (!matches(sig)) {
+		sig->signSignedInfo();
+		return false;
+	}
+
+	// Splice the new DigestValues into the canonical SignedInfo
+
+	DSIGReferenceList * lst = sig->mp_signedInfo->getReferenceList();
+	DSIGReferenceList::size_type sz = lst->getSize();
+
+	safeBuffer sb;
+	xsecsize_t len = 0;
+	xsecsize_t from = 0;
+
+	for (DSIGReferenceList::size_type i = 0; i < sz; ++i) {
+
+		xsecsize_t to = m_digestOffsets[i];
+		sb.sbMemcpyIn(len, &(m_signedInfo.rawBuffer()[from]), to - from);
+		len += to - from;
+		from = to;
+
+		// Base64, so no escaping is needed and each XMLCh is one byte
+		const XMLCh * v = lst->item(i)->mp_hashValueNode->getFirstChild()->getNodeValue();
+		while (v != NULL && *v != chNull)
+			sb[len++] = (unsigned char) *v++;
+
+	}
+
+	sb.sbMemcpyIn(len, &(m_signedInfo.rawBuffer()[from]), m_signedInfoLen - from);
+	len += m_signedInfoLen - from;
+
+	TXFMSB * sbt;
+	XSECnew(sbt, TXFMSB(sig->mp_doc));
+	TXFMChain * chain;
+	XSECnew(chain, TXFMChain(sbt));
+	Janitor<TXFMChain> j_chain(chain);
+
+	sbt->setInput(sb, len);
+
+	sig->signSignedInfo(chain);
+
+	return true;
+
+}
@@ -0,0 +1,190 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * DSIGSignatureTemplate := Pre-canonicalised SignedInfo for signing many
+ *                          messages of the same shape
+ *
+ * $Id$
+ *
+ */
+
+#ifndef DSIGSIGNATURETEMPLATE_INCLUDE
+#define DSIGSIGNATURETEMPLATE_INCLUDE
+
+// XSEC Includes
+#include <xsec/framework/XSECDefs.hpp>
+#include <xsec/dsig/DSIGConstants.hpp>
+#include <xsec/utils/XSECSafeBuffer.hpp>
+
+// Xerces Includes
+
+XSEC_DECLARE_XERCES_CLASS(DOMNode);
+XSEC_DECLARE_XERCES_CLASS(DOMElement);
+XSEC_DECLARE_XERCES_CLASS(DOMDocument);
+
+// General includes
+
+#include <vector>
+
+class DSIGSignature;
+class XSECProvider;
+
+/**
+ * @ingroup pubsig
+ */
+
+/**
+ * @brief Pre-canonicalised SignedInfo used to sign messages of one shape.
+ *
+ * When every message carries a signature with the same SignedInfo
+ * (canonicalisation and signature methods, references, transforms and
+ * Ids) the only parts of the canonical SignedInfo that change between
+ * messages are the DigestValues.  This class canonicalises the SignedInfo
+ * of a template signature once, and keeps the bytes either side of each
+ * DigestValue.
+ *
+ * Signing a message signature with the template calculates the reference
+ * digests as DSIGSignature::sign() does, then splices the new digest
+ * values into the stored bytes rather than canonicalising the SignedInfo
+ * again.  The resulting DOM is the same as sign() would produce.
+ *
+ * The message signature must have the same SignedInfo as the template.
+ * instantiate() copies the template's Signature element into the message
+ * and loads it, and such a signature is known to match.  A signature
+ * created any other way has its SignedInfo compared with the template's
+ * first, and if anything other than the DigestValues differs it is
+ * signed the usual way.
+ *
+ * Namespaces in scope at the Signature element can be part of the
+ * canonical form - all of them (and the xml: attributes) for inclusive
+ * canonicalisation, those named in an InclusiveNamespaces PrefixList for
+ * exclusive.  If they do not match those at compile time the signature
+ * is signed the usual way.
+ *
+ * A compiled template is not modified by sign() or instantiate() and
+ * may be shared between threads.
+ */
+
+class DSIG_EXPORT DSIGSignatureTemplate {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	DSIGSignatureTemplate();
+	~DSIGSignatureTemplate();
+
+	//@}
+
+	/** @name Template set up */
+	//@{
+
+	/**
+	 * \brief Compile the SignedInfo of a signature
+	 *
+	 * Canonicalises the SignedInfo of the passed in signature.  The
+	 * signature must have been created or loaded and have all its
+	 * references in place.  Its DOM is left as it was found.
+	 *
+	 * @param sig The signature to use as the template
+	 */
+
+	void compile(DSIGSignature * sig);
+
+	/**
+	 * \brief Has compile() been called?
+	 */
+
+	bool isCompiled(void) const {return m_compiled;}
+
+	/**
+	 * \brief Create a message signature from the template
+	 *
+	 * Copies the template's Signature element into the parent's
+	 * document, inserts it and loads it.  sign() knows the SignedInfo of
+	 * the result matches, so does not compare it with the template.  It
+	 * must not be altered before it is signed, and must be signed by this
+	 * template (without compile() being called again).
+	 *
+	 * @param prov The provider that owns the new signature
+	 * @param parent The element the Signature is inserted into
+	 * @param before The child to insert it before (NULL to append)
+	 * @returns The loaded signature, to be released via prov
+	 */
+
+	DSIGSignature * instantiate(XSECProvider & prov,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMElement * parent,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * before = NULL) const;
+
+	//@}
+
+	/** @name Signing */
+	//@{
+
+	/**
+	 * \brief Sign a signature with the same SignedInfo as the template
+	 *
+	 * Calculates the reference digests and signs the SignedInfo using
+	 * the key set in the signature.  Equivalent to DSIGSignature::sign().
+	 *
+	 * @param sig The (loaded) signature to sign
+	 * @returns true if the compiled SignedInfo was used, false if the
+	 * signature did not match the template and was signed from the DOM
+	 */
+
+	bool sign(DSIGSignature * sig) const;
+
+	//@}
+
+private:
+
+#if defined(XSEC_NO_NAMESPACES)
+	typedef vector<xsecsize_t>				OffsetVectorType;
+#else
+	typedef std::vector<xsecsize_t>			OffsetVectorType;
+#endif
+
+	bool matches(DSIGSignature * sig) const;
+	static void getStructure(DSIGSignature * sig, safeBuffer & structure);
+	void getContext(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * sigNode,
+		safeBuffer & context) const;
+
+	bool					m_compiled;
+	safeBuffer				m_signedInfo;		// Canonical SignedInfo without DigestValues
+	xsecsize_t				m_signedInfoLen;
+	OffsetVectorType		m_digestOffsets;	// Where each DigestValue goes
+	canonicalizationMethod	m_canonicalizationMethod;
+	safeBuffer				m_structure;		// SignedInfo less the DigestValue text
+	safeBuffer				m_context;			// What the SignedInfo takes from its ancestors
+	safeBuffer				m_prefixList;		// InclusiveNamespaces PrefixList (exclusive c14n)
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument
+							* mp_templateDoc;	// Copy of the Signature for instantiate()
+	unsigned int			m_generation;		// Incremented by each compile()
+
+	// Unimplemented
+	DSIGSignatureTemplate(const DSIGSignatureTemplate &);
+	DSIGSignatureTemplate & operator = (const DSIGSignatureTemplate &);
+
+};
+
+#endif /* DSIGSIGNATURETEMPLATE_INCLUDE */
@@ -0,0 +1,391 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * DSIGStreamingVerifier := Verify an enveloped signature over a whole
+ *                          document in one pass, without a DOM
+ *
+ * $Id$
+ *
+ */
+
+// XSEC Includes
+#include <xsec/dsig/DSIGStreamingVerifier.hpp>
+#include <xsec/dsig/DSIGSignature.hpp>
+#include <xsec/dsig/DSIGReference.hpp>
+#include <xsec/dsig/DSIGReferenceList.hpp>
+#include <xsec/dsig/DSIGTransformList.hpp>
+#include <xsec/dsig/DSIGTransformC14n.hpp>
+#include <xsec/canon/XSECC14nSAX.hpp>
+#include <xsec/enc/XSECCryptoKey.hpp>
+#include <xsec/enc/XSECCryptoProvider.hpp>
+#include <xsec/enc/XSECKeyInfoResolver.hpp>
+#include <xsec/framework/XSECError.hpp>
+#include <xsec/framework/XSECProvider.hpp>
+#include <xsec/utils/XSECHashPool.hpp>
+#include <xsec/utils/XSECParserPool.hpp>
+
+// Xerces includes
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/util/Janitor.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+static const XMLCh s_Signature[] = {
+
+	chLatin_S, chLatin_i, chLatin_g, chLatin_n, chLatin_a, chLatin_t,
+	chLatin_u, chLatin_r, chLatin_e, chNull };
+
+static const char s_bufId[] = "XSECStreamedSignature";
+
+// --------------------------------------------------------------------------------
+//           Constructors and Destructors
+// --------------------------------------------------------------------------------
+
+DSIGStreamingVerifier::DSIGStreamingVerifier() :
+me_canonicalizationMethod(CANON_C14NE_NOC),
+mp_inclusiveNamespaces(NULL),
+me_hashMethod(HASH_SHA256),
+mp_signingKey(NULL),
+mp_KeyInfoResolver(NULL),
+m_errStr("") {
+
+}
+
+DSIGStreamingVerifier::~DSIGStreamingVerifier() {
+
+	if (mp_inclusiveNamespaces != NULL)
+		XSEC_RELEASE_XMLCH(mp_inclusiveNamespaces);
+
+	if (mp_signingKey != NULL)
+		delete mp_signingKey;
+
+	if (mp_KeyInfoResolver != NULL)
+		delete mp_KeyInfoResolver;
+
+}
+
+// --------------------------------------------------------------------------------
+//           Set up
+// --------------------------------------------------------------------------------
+
+void DSIGStreamingVerifier::setCanonicalizationMethod(canonicalizationMethod cm,
+													  const char * inclusiveNamespaces) {
+
+	if (cm != CANON_C14N_NOC && cm != CANON_C14N11_NOC && cm != CANON_C14NE_NOC) {
+		throw XSECException(XSECException::UnsupportedFunction,
+			"DSIGStreamingVerifier - only canonicalisation without comments can be streamed");
+	}
+
+	if (inclusiveNamespaces != NULL && cm != CANON_C14NE_NOC) {
+		throw XSECException(XSECException::UnsupportedFunction,
+			"DSIGStreamingVerifier - InclusiveNamespaces only apply to exclusive canonicalisation");
+	}
+
+	me_canonicalizationMethod = cm;
+
+	if (mp_inclusiveNamespaces != NULL)
+		XSEC_RELEASE_XMLCH(mp_inclusiveNamespaces);
+
+	mp_inclusiveNamespaces = (inclusiveNamespaces == NULL ? NULL :
+		XMLString::replicate(inclusiveNamespaces));
+
+}
+
+void DSIGStreamingVerifier::setHashMethod(hashMethod hm) {
+
+	me_hashMethod = hm;
+
+}
+
+void DSIGStreamingVerifier::setSigningKey(XSECCryptoKey * k) {
+
+	if (mp_signingKey != NULL)
+		delete mp_signingKey;
+
+	mp_signingKey = k;
+
+}
+
+void DSIGStreamingVerifier::setKeyInfoResolver(XSECKeyInfoResolver * resolver) {
+
+	if (mp_KeyInfoResolver != NULL)
+		delete mp_KeyInfoResolver;
+
+	mp_KeyInfoResolver = resolver->clone();
+
+}
+
+const XMLCh * DSIGStreamingVerifier::getErrMsgs(void) const {
+
+	return m_errStr.rawXMLChBuffer();
+
+}
+
+// --------------------------------------------------------------------------------
+//           Profile
+// --------------------------------------------------------------------------------
+
+XSECCryptoHash::HashType DSIGStreamingVerifier::getHashType(void) const {
+
+	switch (me_hashMethod) {
+
+	case HASH_SHA1 :
+		return XSECCryptoHash::HASH_SHA1;
+	case HASH_SHA224 :
+		return XSECCryptoHash::HASH_SHA224;
+	case HASH_SHA256 :
+		return XSECCryptoHash::HASH_SHA256;
+	case HASH_SHA384 :
+		return XSECCryptoHash::HASH_SHA384;
+	case HASH_SHA512 :
+		return XSECCryptoHash::HASH_SHA512;
+	case HASH_MD5 :
+		return XSECCryptoHash::HASH_MD5;
+	default :
+		throw XSECException(XSECException::UnsupportedFunction,
+			"DSIGStreamingVerifier - unknown digest method");
+
+	}
+
+}
+
+static bool samePrefixList(const XMLCh * found, const char * expected) {
+
+	// Compare after collapsing white space.  A missing list is empty.
+
+	XMLCh * f = XMLString::replicate(found == NULL ? DSIGConstants::s_unicodeStrEmpty : found);
+	ArrayJanitor<XMLCh> j_f(f);
+	XMLCh * e = XMLString::transcode(expected == NULL ? "" : expected);
+	ArrayJanitor<XMLCh> j_e(e);
+
+	XMLString::collapseWS(f);
+	XMLString::collapseWS(e);
+
+	return XMLString::equals(f, e);
+
+}
+
+void DSIGStreamingVerifier::checkProfile(DSIGSignature * sig) const {
+
+	// Everything here was decided before the Signature was read, so
+	// anything else can't be checked
+
+	DSIGReferenceList * lst = sig->getReferenceList();
+
+	if (lst == NULL || lst->getSize() != 1) {
+		throw XSECException(XSECException::UnsupportedFunction,
+			"DSIGStreamingVerifier - signature must have exactly one Reference");
+	}
+
+	DSIGReference * r = lst->item(0);
+	const XMLCh * uri = r->getURI();
+
+	if (uri == NULL || uri[0] != 0 || r->isManifest()) {
+		throw XSECException(XSECException::UnsupportedFunction,
+			"DSIGStreamingVerifier - Reference must have URI=\"\"");
+	}
+
+	DSIGTransformList * tl = r->getTransforms();
+
+	if (tl == NULL || tl->getSize() < 1 || tl->getSize() > 2 ||
+		tl->item(0)->getTransformType() != TRANSFORM_ENVELOPED_SIGNATURE) {
+
+		throw XSECException(XSECException::UnsupportedFunction,
+			"DSIGStreamingVerifier - Reference must use the enveloped-signature transform, optionally followed by c14n");
+
+	}
+
+	// The enveloped transform leaves a node set that is serialised with
+	// inclusive c14n unless a c14n transform follows
+
+	bool exclusive = false;
+	const XMLCh * prefixList = NULL;
+
+	if (tl->getSize() == 2) {
+
+		DSIGTransform * t = tl->item(1);
+
+		switch (t->getTransformType()) {
+
+		case TRANSFORM_C14N :
+		case TRANSFORM_C14N11 :
+			break;
+
+		case TRANSFORM_EXC_C14N :
+			exclusive = true;
+			prefixList = ((DSIGTransformC14n *) t)->getPrefixList();
+			break;
+
+		default :
+			throw XSECException(XSECException::UnsupportedFunction,
+				"DSIGStreamingVerifier - Reference must use the enveloped-signature transform, optionally followed by c14n");
+
+		}
+
+	}
+
+	if (exclusive != (me_canonicalizationMethod == CANON_C14NE_NOC) ||
+		(exclusive && !samePrefixList(prefixList, mp_inclusiveNamespaces))) {
+
+		throw XSECException(XSECException::UnsupportedFunction,
+			"DSIGStreamingVerifier - Reference canonicalisation does not match the streaming profile");
+
+	}
+
+	if (r->getHashMethod() != me_hashMethod) {
+		throw XSECException(XSECException::UnsupportedFunction,
+			"DSIGStreamingVerifier - Reference digest method does not match the streaming profile");
+	}
+
+}
+
+// --------------------------------------------------------------------------------
+//           Verify
+// --------------------------------------------------------------------------------
+
+bool DSIGStreamingVerifier::verify(InputSource * is) {
+
+	m_errStr.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+
+	XSECC14nSAX * c14n;
+	XSECnew(c14n, XSECC14nSAX(is));
+	Janitor<XSECC14nSAX> j_c14n(c14n);
+
+	c14n->setCommentsProcessing(false);
+	if (me_canonicalizationMethod == CANON_C14NE_NOC) {
+		if (mp_inclusiveNamespaces != NULL)
+			c14n->setExclusive(mp_inclusiveNamespaces);
+		else
+			c14n->setExclusive();
+	}
+	c14n->setExcludedElement(DSIGConstants::s_unicodeStrURIDSIG, s_Signature);
+
+	// Digest the document, less the Signature, as it is parsed
+
+	XSECCryptoHash * h = XSECHashPool::getHash(getHashType());
+
+	XMLByte calculatedHashVal[CRYPTO_MAX_HASH_SIZE];
+	unsigned int calculatedHashSize;
+
+	try {
+
+		unsigned char buf[4096];
+		xsecsize_t len;
+
+		while ((len = c14n->outputBuffer(buf, 4096)) > 0)
+			h->hash(buf, (unsigned int) len);
+
+		calculatedHashSize = h->finish(calculatedHashVal, CRYPTO_MAX_HASH_SIZE);
+
+	}
+	catch (...) {
+		XSECHashPool::releaseHash(h);
+		throw;
+	}
+
+	XSECHashPool::releaseHash(h);
+
+	// Now the Signature on its own
+
+	xsecsize_t sigLen;
+	const char * sigBytes = c14n->getExcludedElement(sigLen);
+
+	if (sigBytes == NULL) {
+		throw XSECException(XSECException::SigVfyError,
+			"DSIGStreamingVerifier - no Signature element found in the document");
+	}
+
+	MemBufInputSource sigSource((const XMLByte *) sigBytes, sigLen, s_bufId, false);
+
+	XercesDOMParser * parser = XSECParserPool::getDOMParser();
+	DOMDocument * sigDoc = NULL;
+	xsecsize_t errorCount;
+
+	try {
+		parser->parse(sigSource);
+		errorCount = parser->getErrorCount();
+		if (errorCount == 0)
+			sigDoc = parser->adoptDocument();
+	}
+	catch (...) {
+		XSECParserPool::releaseDOMParser(parser);
+		throw;
+	}
+
+	XSECParserPool::releaseDOMParser(parser);
+
+	if (errorCount > 0 || sigDoc == NULL)
+		throw XSECException(XSECException::XSLError, "Errors occured parsing BYTE STREAM");
+
+	XSECProvider prov;
+	DSIGSignature * sig = NULL;
+	bool refResult, sigResult;
+
+	try {
+
+		sig = prov.newSignatureFromDOM(sigDoc, sigDoc->getDocumentElement());
+		sig->load();
+
+		checkProfile(sig);
+
+		if (mp_signingKey != NULL)
+			sig->setSigningKey(mp_signingKey->clone());
+		if (mp_KeyInfoResolver != NULL)
+			sig->setKeyInfoResolver(mp_KeyInfoResolver);
+
+		// Compare the streamed digest with the Reference
+
+		XMLByte readHashVal[CRYPTO_MAX_HASH_SIZE];
+		unsigned int readHashSize = sig->getReferenceList()->item(0)->readHash(readHashVal, CRYPTO_MAX_HASH_SIZE);
+
+		refResult = (readHashSize == calculatedHashSize);
+		for (unsigned int i = 0; refResult && i < calculatedHashSize; ++i) {
+			if (calculatedHashVal[i] != readHashVal[i])
+				refResult = false;
+		}
+
+		sigResult = sig->verifySignatureOnly();
+
+		if (!refResult)
+			m_errStr.sbXMLChCat("Reference URI=\"\" failed to verify\n");
+		if (!sigResult)
+			m_errStr.sbXMLChCat(sig->getErrMsgs());
+
+	}
+	catch (...) {
+		if (sig != NULL)
+			prov.releaseSignature(sig);
+		sigDoc->release();
+		throw;
+	}
+
+	prov.releaseSignature(sig);
+	sigDoc->release();
+
+	return refResult && sigResult;
+
+}
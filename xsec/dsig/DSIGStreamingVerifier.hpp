@@ -0,0 +1,176 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * DSIGStreamingVerifier := Verify an enveloped signature over a whole
+ *                          document in one pass, without a DOM
+ *
+ * $Id$
+ *
+ */
+
+#ifndef DSIGSTREAMINGVERIFIER_INCLUDE
+#define DSIGSTREAMINGVERIFIER_INCLUDE
+
+// XSEC Includes
+#include <xsec/framework/XSECDefs.hpp>
+#include <xsec/dsig/DSIGConstants.hpp>
+#include <xsec/utils/XSECSafeBuffer.hpp>
+#include <xsec/enc/XSECCryptoHash.hpp>
+
+XSEC_DECLARE_XERCES_CLASS(InputSource);
+
+class DSIGSignature;
+class XSECCryptoKey;
+class XSECKeyInfoResolver;
+
+/**
+ * @ingroup pubsig
+ */
+
+/**
+ * @brief Verify an enveloped signature while streaming the document.
+ *
+ * DSIGSignature::verify() needs the whole document in a DOM, which for
+ * very large documents costs many times the document size in memory.
+ * This class verifies the most common profile for signed documents -
+ * a single Reference with URI="", an enveloped-signature transform and
+ * (optionally) a canonicalisation transform - in a single SAX2 pass.
+ *
+ * The document is canonicalised as it is parsed and fed straight into
+ * the digest.  The first ds:Signature element is left out of the
+ * canonical output and kept aside, along with its comments and the
+ * namespaces and xml: attributes it inherits; once the document has been
+ * read it is parsed on its own and its SignedInfo verified as usual, with
+ * whatever canonicalisation method the SignedInfo names.  Memory use
+ * depends on the size of the Signature and the element nesting depth,
+ * not on the size of the document.
+ *
+ * As the digest has to be running before the Signature is seen, the
+ * canonicalisation and digest methods are set up front (exclusive c14n
+ * and SHA-256 by default).  A signature that does not use exactly that
+ * profile is rejected with an XSECException rather than reported as
+ * invalid.
+ */
+
+class DSIG_EXPORT DSIGStreamingVerifier {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	DSIGStreamingVerifier();
+	~DSIGStreamingVerifier();
+
+	//@}
+
+	/** @name Profile */
+	//@{
+
+	/**
+	 * \brief Set the canonicalisation the Reference is expected to use
+	 *
+	 * As the Reference has URI="", comments are never part of the
+	 * digest, so only the methods without comments are accepted.  The
+	 * two inclusive methods give the same output for this profile and
+	 * either matches a Reference using the other.
+	 *
+	 * @param cm CANON_C14N_NOC, CANON_C14N11_NOC or CANON_C14NE_NOC
+	 * @param inclusiveNamespaces For exclusive c14n, the expected
+	 * InclusiveNamespaces PrefixList (NULL for none)
+	 */
+
+	void setCanonicalizationMethod(canonicalizationMethod cm,
+		const char * inclusiveNamespaces = NULL);
+
+	/**
+	 * \brief Set the digest method the Reference is expected to use
+	 */
+
+	void setHashMethod(hashMethod hm);
+
+	//@}
+
+	/** @name Keys */
+	//@{
+
+	/**
+	 * \brief Set the key used to verify the SignedInfo
+	 *
+	 * As for DSIGSignature::setSigningKey().  The key is owned by the
+	 * verifier.
+	 */
+
+	void setSigningKey(XSECCryptoKey * k);
+
+	/**
+	 * \brief Set a resolver to find the key from the KeyInfo
+	 *
+	 * Used when no key has been set.  The resolver is cloned.
+	 */
+
+	void setKeyInfoResolver(XSECKeyInfoResolver * resolver);
+
+	//@}
+
+	/** @name Verification */
+	//@{
+
+	/**
+	 * \brief Verify the signature in a document
+	 *
+	 * @param is The document.  Adopted (and deleted) by the verifier.
+	 * @returns true if the Reference digest and the SignedInfo both
+	 * verified.  If false, the reasons can be found via getErrMsgs.
+	 * @throws XSECException if the document has no Signature, cannot be
+	 * parsed or the signature does not match the streaming profile.
+	 */
+
+	bool verify(XERCES_CPP_NAMESPACE_QUALIFIER InputSource * is);
+
+	/**
+	 * \brief Get the error messages from the last verify()
+	 */
+
+	const XMLCh * getErrMsgs(void) const;
+
+	//@}
+
+private:
+
+	void checkProfile(DSIGSignature * sig) const;
+	XSECCryptoHash::HashType getHashType(void) const;
+
+	canonicalizationMethod	me_canonicalizationMethod;
+	char					* mp_inclusiveNamespaces;
+	hashMethod				me_hashMethod;
+	XSECCryptoKey			* mp_signingKey;
+	XSECKeyInfoResolver		* mp_KeyInfoResolver;
+	safeBuffer				m_errStr;
+
+	// Unimplemented
+	DSIGStreamingVerifier(const DSIGStreamingVerifier &);
+	DSIGStreamingVerifier & operator = (const DSIGStreamingVerifier &);
+
+};
+
+#endif /* DSIGSTREAMINGVERIFIER_INCLUDE */
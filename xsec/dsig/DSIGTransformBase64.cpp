@@ -75,16 +75,8 @@ void DSIGTransformBase64::appendTransformer(TXFMChain * input) {
 
 		if (input->getLastTxfm()->getNodeType() != TXFMBase::DOM_NODE_XPATH_NODESET) {
 
-#ifdef XSEC_NO_XPATH
-
-			throw XSECException(XSECException::UnsupportedFunction,
-				"Unable to extract Base64 text from Nodes without XPath support");
-
-		}
-
-#else
-		
-			// Use an XPath transform to get "Self::text()" from the nodeset
+			// Use an XPath transform to get "Self::text()" from the nodeset.
+			// This is handled natively, so does not need Xalan
 		
 			TXFMXPath *x;
 		
@@ -100,7 +92,6 @@ void DSIGTransformBase64::appendTransformer(TXFMChain * input) {
 		
 		XSECnew(c, TXFMC14n(mp_txfmNode->getOwnerDocument()));
 		input->appendTxfm(c);
-#endif
 
 	}
 
@@ -213,7 +213,7 @@ void DSIGTransformC14n::load(void) {
 			atts = mp_inclNSNode->getAttributes();
 			safeBuffer inSB;
 
-			if (atts == 0 || ((att = atts->getNamedItem(MAKE_UNICODE_STRING("PrefixList"))) == NULL)) {
+			if (atts == 0 || ((att = atts->getNamedItem(DSIGConstants::s_unicodeStrPrefixList)) == NULL)) {
 				throw XSECException(XSECException::ExpectedDSIGChildNotFound,
 					"Expected PrefixList in InclusiveNamespaces");
 			}
@@ -260,7 +260,7 @@ void DSIGTransformC14n::setCanonicalizationMethod(canonicalizationMethod method)
 
 	// Now do the set.
 
-	((DOMElement *) mp_txfmNode)->setAttributeNS(NULL,MAKE_UNICODE_STRING("Algorithm"), m);
+	((DOMElement *) mp_txfmNode)->setAttributeNS(NULL,DSIGConstants::s_unicodeStrAlgorithm, m);
 	m_cMethod = method;
 
 }
@@ -329,8 +329,8 @@ void DSIGTransformC14n::setInclusiveNamespaces(const XMLCh * ns) {
 
 	// Now create the prefix list
 
-	mp_inclNSNode->setAttributeNS(NULL,MAKE_UNICODE_STRING("PrefixList"), ns);
-	mp_inclNSStr = mp_inclNSNode->getAttributes()->getNamedItem(MAKE_UNICODE_STRING("PrefixList"))->getNodeValue();
+	mp_inclNSNode->setAttributeNS(NULL,DSIGConstants::s_unicodeStrPrefixList, ns);
+	mp_inclNSStr = mp_inclNSNode->getAttributes()->getNamedItem(DSIGConstants::s_unicodeStrPrefixList)->getNodeValue();
 
 }
 
@@ -351,8 +351,8 @@ void DSIGTransformC14n::addInclusiveNamespace(const char * ns) {
 
 		// Now create the prefix list
 
-		mp_inclNSNode->setAttributeNS(NULL,MAKE_UNICODE_STRING("PrefixList"), MAKE_UNICODE_STRING(ns));
-		mp_inclNSStr = mp_inclNSNode->getAttributes()->getNamedItem(MAKE_UNICODE_STRING("PrefixList"))->getNodeValue();
+		mp_inclNSNode->setAttributeNS(NULL,DSIGConstants::s_unicodeStrPrefixList, MAKE_UNICODE_STRING(ns));
+		mp_inclNSStr = mp_inclNSNode->getAttributes()->getNamedItem(DSIGConstants::s_unicodeStrPrefixList)->getNodeValue();
 
 	}
 
@@ -364,8 +364,8 @@ void DSIGTransformC14n::addInclusiveNamespace(const char * ns) {
 		str << (*(mp_env->getSBFormatter()) << mp_inclNSStr);
 		str.sbStrcatIn(" ");
 		str.sbStrcatIn((char *) ns);
-		mp_inclNSNode->setAttributeNS(NULL,MAKE_UNICODE_STRING("PrefixList"), str.sbStrToXMLCh());
-		mp_inclNSStr = mp_inclNSNode->getAttributes()->getNamedItem(MAKE_UNICODE_STRING("PrefixList"))->getNodeValue();
+		mp_inclNSNode->setAttributeNS(NULL,DSIGConstants::s_unicodeStrPrefixList, str.sbStrToXMLCh());
+		mp_inclNSStr = mp_inclNSNode->getAttributes()->getNamedItem(DSIGConstants::s_unicodeStrPrefixList)->getNodeValue();
 
 	}
 
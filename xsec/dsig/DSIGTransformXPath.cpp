@@ -78,12 +78,8 @@ transformType DSIGTransformXPath::getTransformType() {
 
 void DSIGTransformXPath::appendTransformer(TXFMChain * input) {
 
-#ifdef XSEC_NO_XPATH
-
-	throw XSECException(XSECException::UnsupportedFunction,
-		"XPath transforms are not supported in this compilation of the XSEC library");
-
-#else
+	// Without Xalan only the common expressions recognised by TXFMXPath
+	// are available - anything else throws from evaluateExpr
 
 	TXFMXPath *x;
 	// XPath transform
@@ -95,8 +91,6 @@ void DSIGTransformXPath::appendTransformer(TXFMChain * input) {
 
 	x->setNameSpace(mp_NSMap);
 	x->evaluateExpr(mp_txfmNode, m_expr);
-	
-#endif /* NO_XPATH */
 
 }
 
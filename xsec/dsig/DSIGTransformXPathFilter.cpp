@@ -88,13 +88,6 @@ void DSIGTransformXPathFilter::appendTransformer(TXFMChain * input) {
 
 	}
 
-#ifdef XSEC_NO_XPATH
-
-	throw XSECException(XSECException::UnsupportedFunction,
-		"XPath transforms are not supported in this compilation of the XSEC library");
-
-#else
-
 	TXFMXPathFilter *xpf;
 	// XPath transform
 	XSECnew(xpf, TXFMXPathFilter(mp_txfmNode->getOwnerDocument()));
@@ -104,8 +97,6 @@ void DSIGTransformXPathFilter::appendTransformer(TXFMChain * input) {
 	// be cleaned up down the calling stack.
 
 	xpf->evaluateExprs(&m_exprs);
-	
-#endif /* NO_XPATH */
 
 }
 
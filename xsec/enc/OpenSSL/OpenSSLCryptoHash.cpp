@@ -32,6 +32,7 @@
 #if defined (XSEC_HAVE_OPENSSL)
 
 #include <xsec/enc/OpenSSL/OpenSSLCryptoHash.hpp>
+#include <xsec/enc/OpenSSL/OpenSSLCryptoProvider.hpp>
 #include <xsec/enc/XSECCryptoException.hpp>
 
 #include <memory.h>
@@ -54,17 +55,17 @@ OpenSSLCryptoHash::OpenSSLCryptoHash(HashType alg) :
 
     case (XSECCryptoHash::HASH_SHA1) :
     
-        mp_md = EVP_get_digestbyname("SHA1");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA1);
         break;
 
     case (XSECCryptoHash::HASH_MD5) :
     
-        mp_md = EVP_get_digestbyname("MD5");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_MD5);
         break;
 
     case (XSECCryptoHash::HASH_SHA224) :
     
-        mp_md = EVP_get_digestbyname("SHA224");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA224);
         if (mp_md == NULL) {
             throw XSECCryptoException(XSECCryptoException::MDError,
             "OpenSSL:Hash - SHA224 not supported by this version of OpenSSL"); 
@@ -74,7 +75,7 @@ OpenSSLCryptoHash::OpenSSLCryptoHash(HashType alg) :
 
     case (XSECCryptoHash::HASH_SHA256) :
     
-        mp_md = EVP_get_digestbyname("SHA256");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA256);
         if (mp_md == NULL) {
             throw XSECCryptoException(XSECCryptoException::MDError,
             "OpenSSL:Hash - SHA256 not supported by this version of OpenSSL"); 
@@ -84,7 +85,7 @@ OpenSSLCryptoHash::OpenSSLCryptoHash(HashType alg) :
 
     case (XSECCryptoHash::HASH_SHA384) :
     
-        mp_md = EVP_get_digestbyname("SHA384");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA384);
         if (mp_md == NULL) {
             throw XSECCryptoException(XSECCryptoException::MDError,
             "OpenSSL:Hash - SHA384 not supported by this version of OpenSSL"); 
@@ -94,7 +95,7 @@ OpenSSLCryptoHash::OpenSSLCryptoHash(HashType alg) :
 
     case (XSECCryptoHash::HASH_SHA512) :
     
-        mp_md = EVP_get_digestbyname("SHA512");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA512);
         if (mp_md == NULL) {
             throw XSECCryptoException(XSECCryptoException::MDError,
             "OpenSSL:Hash - SHA512 not supported by this version of OpenSSL"); 
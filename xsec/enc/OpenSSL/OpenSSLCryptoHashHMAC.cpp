@@ -33,6 +33,7 @@
 
 
 #include <xsec/enc/OpenSSL/OpenSSLCryptoHashHMAC.hpp>
+#include <xsec/enc/OpenSSL/OpenSSLCryptoProvider.hpp>
 #include <xsec/enc/XSECCryptoException.hpp>
 #include <xsec/enc/XSECCryptoKeyHMAC.hpp>
 
@@ -58,17 +59,17 @@ OpenSSLCryptoHashHMAC::OpenSSLCryptoHashHMAC(HashType alg) : m_mdLen(0),
 
     case (XSECCryptoHash::HASH_SHA1) :
     
-        mp_md = EVP_get_digestbyname("SHA1");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA1);
         break;
 
     case (XSECCryptoHash::HASH_MD5) :
     
-        mp_md = EVP_get_digestbyname("MD5");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_MD5);
         break;
 
     case (XSECCryptoHash::HASH_SHA224) :
     
-        mp_md = EVP_get_digestbyname("SHA224");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA224);
         if (mp_md == NULL) {
             throw XSECCryptoException(XSECCryptoException::MDError,
             "OpenSSL:Hash - SHA224 not supported by this version of OpenSSL"); 
@@ -78,7 +79,7 @@ OpenSSLCryptoHashHMAC::OpenSSLCryptoHashHMAC(HashType alg) : m_mdLen(0),
 
     case (XSECCryptoHash::HASH_SHA256) :
     
-        mp_md = EVP_get_digestbyname("SHA256");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA256);
         if (mp_md == NULL) {
             throw XSECCryptoException(XSECCryptoException::MDError,
             "OpenSSL:Hash - SHA256 not supported by this version of OpenSSL"); 
@@ -88,7 +89,7 @@ OpenSSLCryptoHashHMAC::OpenSSLCryptoHashHMAC(HashType alg) : m_mdLen(0),
 
     case (XSECCryptoHash::HASH_SHA384) :
     
-        mp_md = EVP_get_digestbyname("SHA384");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA384);
         if (mp_md == NULL) {
             throw XSECCryptoException(XSECCryptoException::MDError,
             "OpenSSL:Hash - SHA384 not supported by this version of OpenSSL"); 
@@ -98,7 +99,7 @@ OpenSSLCryptoHashHMAC::OpenSSLCryptoHashHMAC(HashType alg) : m_mdLen(0),
 
     case (XSECCryptoHash::HASH_SHA512) :
     
-        mp_md = EVP_get_digestbyname("SHA512");
+        mp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA512);
         if (mp_md == NULL) {
             throw XSECCryptoException(XSECCryptoException::MDError,
             "OpenSSL:Hash - SHA512 not supported by this version of OpenSSL"); 
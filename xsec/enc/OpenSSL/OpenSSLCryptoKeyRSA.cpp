@@ -33,6 +33,7 @@
 
 #include <xsec/enc/OpenSSL/OpenSSLCryptoKeyRSA.hpp>
 #include <xsec/enc/OpenSSL/OpenSSLCryptoBase64.hpp>
+#include <xsec/enc/OpenSSL/OpenSSLCryptoProvider.hpp>
 #include <xsec/enc/XSECCryptoException.hpp>
 #include <xsec/enc/XSECCryptoUtils.hpp>
 #include <xsec/framework/XSECError.hpp>
@@ -735,19 +736,19 @@ unsigned int OpenSSLCryptoKeyRSA::privateDecrypt(const unsigned char * inBuf,
 
             switch (hm) {
                 case HASH_SHA1:
-                    evp_md = EVP_get_digestbyname("SHA1");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA1);
                     break;
                 case HASH_SHA224:
-                    evp_md = EVP_get_digestbyname("SHA224");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA224);
                     break;
                 case HASH_SHA256:
-                    evp_md = EVP_get_digestbyname("SHA256");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA256);
                     break;
                 case HASH_SHA384:
-                    evp_md = EVP_get_digestbyname("SHA384");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA384);
                     break;
                 case HASH_SHA512:
-                    evp_md = EVP_get_digestbyname("SHA512");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA512);
                     break;
             }
 
@@ -758,19 +759,19 @@ unsigned int OpenSSLCryptoKeyRSA::privateDecrypt(const unsigned char * inBuf,
 
             switch (m_mgf) {
                 case MGF1_SHA1:
-                    mgf_md = EVP_get_digestbyname("SHA1");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA1);
                     break;
                 case MGF1_SHA224:
-                    mgf_md = EVP_get_digestbyname("SHA224");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA224);
                     break;
                 case MGF1_SHA256:
-                    mgf_md = EVP_get_digestbyname("SHA256");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA256);
                     break;
                 case MGF1_SHA384:
-                    mgf_md = EVP_get_digestbyname("SHA384");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA384);
                     break;
                 case MGF1_SHA512:
-                    mgf_md = EVP_get_digestbyname("SHA512");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA512);
                     break;
             }
 
@@ -903,19 +904,19 @@ unsigned int OpenSSLCryptoKeyRSA::publicEncrypt(const unsigned char * inBuf,
 
             switch (hm) {
                 case HASH_SHA1:
-                    evp_md = EVP_get_digestbyname("SHA1");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA1);
                     break;
                 case HASH_SHA224:
-                    evp_md = EVP_get_digestbyname("SHA224");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA224);
                     break;
                 case HASH_SHA256:
-                    evp_md = EVP_get_digestbyname("SHA256");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA256);
                     break;
                 case HASH_SHA384:
-                    evp_md = EVP_get_digestbyname("SHA384");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA384);
                     break;
                 case HASH_SHA512:
-                    evp_md = EVP_get_digestbyname("SHA512");
+                    evp_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA512);
                     break;
             }
 
@@ -926,19 +927,19 @@ unsigned int OpenSSLCryptoKeyRSA::publicEncrypt(const unsigned char * inBuf,
 
             switch (m_mgf) {
                 case MGF1_SHA1:
-                    mgf_md = EVP_get_digestbyname("SHA1");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA1);
                     break;
                 case MGF1_SHA224:
-                    mgf_md = EVP_get_digestbyname("SHA224");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA224);
                     break;
                 case MGF1_SHA256:
-                    mgf_md = EVP_get_digestbyname("SHA256");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA256);
                     break;
                 case MGF1_SHA384:
-                    mgf_md = EVP_get_digestbyname("SHA384");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA384);
                     break;
                 case MGF1_SHA512:
-                    mgf_md = EVP_get_digestbyname("SHA512");
+                    mgf_md = OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HASH_SHA512);
                     break;
             }
 
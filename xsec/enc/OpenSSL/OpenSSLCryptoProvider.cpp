@@ -58,93 +58,151 @@ XSEC_USING_XERCES(Janitor);
 #include <openssl/err.h>
 #include <openssl/obj_mac.h>
 
+#include <memory.h>
+#include <string.h>
+
+// --------------------------------------------------------------------------------
+//           Digest descriptors
+// --------------------------------------------------------------------------------
+
+const EVP_MD * OpenSSLCryptoProvider::getDigest(XSECCryptoHash::HashType type) {
+
+    // The EVP_MD objects are static in OpenSSL, so there is nothing to
+    // look up or cache
+
+    switch (type) {
+
+    case XSECCryptoHash::HASH_SHA1:
+        return EVP_sha1();
+#if !defined(OPENSSL_NO_MD5)
+    case XSECCryptoHash::HASH_MD5:
+        return EVP_md5();
+#endif
+#if defined(XSEC_OPENSSL_HAVE_SHA2) && !defined(OPENSSL_NO_SHA256)
+    case XSECCryptoHash::HASH_SHA224:
+        return EVP_sha224();
+    case XSECCryptoHash::HASH_SHA256:
+        return EVP_sha256();
+#endif
+#if defined(XSEC_OPENSSL_HAVE_SHA2) && !defined(OPENSSL_NO_SHA512)
+    case XSECCryptoHash::HASH_SHA384:
+        return EVP_sha384();
+    case XSECCryptoHash::HASH_SHA512:
+        return EVP_sha512();
+#endif
+    default:
+        return NULL;
+
+    }
+
+}
+
+#ifdef XSEC_OPENSSL_HAVE_EC
+// --------------------------------------------------------------------------------
+//           Named curves
+// --------------------------------------------------------------------------------
+
+struct OpenSSLNamedCurve {
+    const char * oid;
+    int nid;
+};
+
+static const OpenSSLNamedCurve s_namedCurves[] = {
+    { "urn:oid:1.3.132.0.6", NID_secp112r1 },
+    { "urn:oid:1.3.132.0.7", NID_secp112r2 },
+    { "urn:oid:1.3.132.0.28", NID_secp128r1 },
+    { "urn:oid:1.3.132.0.29", NID_secp128r2 },
+    { "urn:oid:1.3.132.0.9", NID_secp160k1 },
+    { "urn:oid:1.3.132.0.8", NID_secp160r1 },
+    { "urn:oid:1.3.132.0.30", NID_secp160r2 },
+    { "urn:oid:1.3.132.0.31", NID_secp192k1 },
+    { "urn:oid:1.3.132.0.32", NID_secp224k1 },
+    { "urn:oid:1.3.132.0.33", NID_secp224r1 },
+    { "urn:oid:1.3.132.0.10", NID_secp256k1 },
+    { "urn:oid:1.3.132.0.34", NID_secp384r1 },
+    { "urn:oid:1.3.132.0.35", NID_secp521r1 },
+
+    { "urn:oid:1.2.840.10045.3.1.1", NID_X9_62_prime192v1 },
+    { "urn:oid:1.2.840.10045.3.1.2", NID_X9_62_prime192v2 },
+    { "urn:oid:1.2.840.10045.3.1.3", NID_X9_62_prime192v3 },
+    { "urn:oid:1.2.840.10045.3.1.4", NID_X9_62_prime239v1 },
+    { "urn:oid:1.2.840.10045.3.1.5", NID_X9_62_prime239v2 },
+    { "urn:oid:1.2.840.10045.3.1.6", NID_X9_62_prime239v3 },
+    { "urn:oid:1.2.840.10045.3.1.7", NID_X9_62_prime256v1 },
+
+    { "urn:oid:1.3.132.0.4", NID_sect113r1 },
+    { "urn:oid:1.3.132.0.5", NID_sect113r2 },
+    { "urn:oid:1.3.132.0.22", NID_sect131r1 },
+    { "urn:oid:1.3.132.0.23", NID_sect131r2 },
+    { "urn:oid:1.3.132.0.1", NID_sect163k1 },
+    { "urn:oid:1.3.132.0.2", NID_sect163r1 },
+    { "urn:oid:1.3.132.0.15", NID_sect163r2 },
+    { "urn:oid:1.3.132.0.24", NID_sect193r1 },
+    { "urn:oid:1.3.132.0.25", NID_sect193r2 },
+    { "urn:oid:1.3.132.0.26", NID_sect233k1 },
+    { "urn:oid:1.3.132.0.27", NID_sect233r1 },
+    { "urn:oid:1.3.132.0.3", NID_sect239k1 },
+    { "urn:oid:1.3.132.0.16", NID_sect283k1 },
+    { "urn:oid:1.3.132.0.17", NID_sect283r1 },
+    { "urn:oid:1.3.132.0.36", NID_sect409k1 },
+    { "urn:oid:1.3.132.0.37", NID_sect409r1 },
+    { "urn:oid:1.3.132.0.38", NID_sect571k1 },
+    { "urn:oid:1.3.132.0.39", NID_sect571r1 },
+
+    { "urn:oid:1.2.840.10045.3.0.1", NID_X9_62_c2pnb163v1 },
+    { "urn:oid:1.2.840.10045.3.0.2", NID_X9_62_c2pnb163v2 },
+    { "urn:oid:1.2.840.10045.3.0.3", NID_X9_62_c2pnb163v3 },
+    { "urn:oid:1.2.840.10045.3.0.4", NID_X9_62_c2pnb176v1 },
+    { "urn:oid:1.2.840.10045.3.0.5", NID_X9_62_c2tnb191v1 },
+    { "urn:oid:1.2.840.10045.3.0.6", NID_X9_62_c2tnb191v2 },
+    { "urn:oid:1.2.840.10045.3.0.7", NID_X9_62_c2tnb191v3 },
+    { "urn:oid:1.2.840.10045.3.0.8", NID_X9_62_c2onb191v4 },
+    { "urn:oid:1.2.840.10045.3.0.9", NID_X9_62_c2onb191v5 },
+    { "urn:oid:1.2.840.10045.3.0.10", NID_X9_62_c2pnb208w1 },
+    { "urn:oid:1.2.840.10045.3.0.11", NID_X9_62_c2tnb239v1 },
+    { "urn:oid:1.2.840.10045.3.0.12", NID_X9_62_c2tnb239v2 },
+    { "urn:oid:1.2.840.10045.3.0.13", NID_X9_62_c2tnb239v3 },
+    { "urn:oid:1.2.840.10045.3.0.14", NID_X9_62_c2onb239v4 },
+    { "urn:oid:1.2.840.10045.3.0.15", NID_X9_62_c2onb239v5 },
+    { "urn:oid:1.2.840.10045.3.0.16", NID_X9_62_c2pnb272w1 },
+    { "urn:oid:1.2.840.10045.3.0.17", NID_X9_62_c2pnb304w1 },
+    { "urn:oid:1.2.840.10045.3.0.18", NID_X9_62_c2tnb359v1 },
+    { "urn:oid:1.2.840.10045.3.0.19", NID_X9_62_c2pnb368w1 },
+    { "urn:oid:1.2.840.10045.3.0.20", NID_X9_62_c2tnb431r1 },
+
+    { "urn:oid:2.23.43.1.4.1", NID_wap_wsg_idm_ecid_wtls1 },
+    { "urn:oid:2.23.43.1.4.3", NID_wap_wsg_idm_ecid_wtls3 },
+    { "urn:oid:2.23.43.1.4.4", NID_wap_wsg_idm_ecid_wtls4 },
+    { "urn:oid:2.23.43.1.4.5", NID_wap_wsg_idm_ecid_wtls5 },
+    { "urn:oid:2.23.43.1.4.6", NID_wap_wsg_idm_ecid_wtls6 },
+    { "urn:oid:2.23.43.1.4.7", NID_wap_wsg_idm_ecid_wtls7 },
+    { "urn:oid:2.23.43.1.4.8", NID_wap_wsg_idm_ecid_wtls8 },
+    { "urn:oid:2.23.43.1.4.9", NID_wap_wsg_idm_ecid_wtls9 },
+    { "urn:oid:2.23.43.1.4.10", NID_wap_wsg_idm_ecid_wtls10 },
+    { "urn:oid:2.23.43.1.4.11", NID_wap_wsg_idm_ecid_wtls11 },
+    { "urn:oid:2.23.43.1.4.12", NID_wap_wsg_idm_ecid_wtls12 },
+};
+
+#define XSEC_OPENSSL_CURVE_COUNT (sizeof(s_namedCurves) / sizeof(s_namedCurves[0]))
+#endif
+
 OpenSSLCryptoProvider::OpenSSLCryptoProvider() {
 
+#if (OPENSSL_VERSION_NUMBER < 0x10100000L)
     OpenSSL_add_all_algorithms();       // Initialise Openssl
     ERR_load_crypto_strings();
-
-    //SSLeay_add_all_algorithms();
-#ifdef XSEC_OPENSSL_HAVE_EC
-    // Populate curve names.
-    m_namedCurveMap["urn:oid:1.3.132.0.6"] = NID_secp112r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.7"] = NID_secp112r2;
-    m_namedCurveMap["urn:oid:1.3.132.0.28"] = NID_secp128r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.29"] = NID_secp128r2;
-    m_namedCurveMap["urn:oid:1.3.132.0.9"] = NID_secp160k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.8"] = NID_secp160r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.30"] = NID_secp160r2;
-    m_namedCurveMap["urn:oid:1.3.132.0.31"] = NID_secp192k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.32"] = NID_secp224k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.33"] = NID_secp224r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.10"] = NID_secp256k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.34"] = NID_secp384r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.35"] = NID_secp521r1;
-
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.1.1"] = NID_X9_62_prime192v1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.1.2"] = NID_X9_62_prime192v2;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.1.3"] = NID_X9_62_prime192v3;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.1.4"] = NID_X9_62_prime239v1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.1.5"] = NID_X9_62_prime239v2;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.1.6"] = NID_X9_62_prime239v3;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.1.7"] = NID_X9_62_prime256v1;
-
-    m_namedCurveMap["urn:oid:1.3.132.0.4"] = NID_sect113r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.5"] = NID_sect113r2;
-    m_namedCurveMap["urn:oid:1.3.132.0.22"] = NID_sect131r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.23"] = NID_sect131r2;
-    m_namedCurveMap["urn:oid:1.3.132.0.1"] = NID_sect163k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.2"] = NID_sect163r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.15"] = NID_sect163r2;
-    m_namedCurveMap["urn:oid:1.3.132.0.24"] = NID_sect193r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.25"] = NID_sect193r2;
-    m_namedCurveMap["urn:oid:1.3.132.0.26"] = NID_sect233k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.27"] = NID_sect233r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.3"] = NID_sect239k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.16"] = NID_sect283k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.17"] = NID_sect283r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.36"] = NID_sect409k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.37"] = NID_sect409r1;
-    m_namedCurveMap["urn:oid:1.3.132.0.38"] = NID_sect571k1;
-    m_namedCurveMap["urn:oid:1.3.132.0.39"] = NID_sect571r1;
-
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.1"] = NID_X9_62_c2pnb163v1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.2"] = NID_X9_62_c2pnb163v2;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.3"] = NID_X9_62_c2pnb163v3;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.4"] = NID_X9_62_c2pnb176v1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.5"] = NID_X9_62_c2tnb191v1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.6"] = NID_X9_62_c2tnb191v2;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.7"] = NID_X9_62_c2tnb191v3;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.8"] = NID_X9_62_c2onb191v4;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.9"] = NID_X9_62_c2onb191v5;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.10"] = NID_X9_62_c2pnb208w1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.11"] = NID_X9_62_c2tnb239v1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.12"] = NID_X9_62_c2tnb239v2;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.13"] = NID_X9_62_c2tnb239v3;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.14"] = NID_X9_62_c2onb239v4;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.15"] = NID_X9_62_c2onb239v5;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.16"] = NID_X9_62_c2pnb272w1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.17"] = NID_X9_62_c2pnb304w1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.18"] = NID_X9_62_c2tnb359v1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.19"] = NID_X9_62_c2pnb368w1;
-    m_namedCurveMap["urn:oid:1.2.840.10045.3.0.20"] = NID_X9_62_c2tnb431r1;
-
-    m_namedCurveMap["urn:oid:2.23.43.1.4.1"] = NID_wap_wsg_idm_ecid_wtls1;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.3"] = NID_wap_wsg_idm_ecid_wtls3;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.4"] = NID_wap_wsg_idm_ecid_wtls4;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.5"] = NID_wap_wsg_idm_ecid_wtls5;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.6"] = NID_wap_wsg_idm_ecid_wtls6;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.7"] = NID_wap_wsg_idm_ecid_wtls7;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.8"] = NID_wap_wsg_idm_ecid_wtls8;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.9"] = NID_wap_wsg_idm_ecid_wtls9;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.10"] = NID_wap_wsg_idm_ecid_wtls10;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.11"] = NID_wap_wsg_idm_ecid_wtls11;
-    m_namedCurveMap["urn:oid:2.23.43.1.4.12"] = NID_wap_wsg_idm_ecid_wtls12;
 #endif
+
+    // From 1.1.0 OpenSSL initialises itself on first use, and all the
+    // tables the provider needs are static data, so there is nothing
+    // else to set up.
+
 }
 
 
 OpenSSLCryptoProvider::~OpenSSLCryptoProvider() {
 
+#if (OPENSSL_VERSION_NUMBER < 0x10100000L)
     EVP_cleanup();
     ERR_free_strings();
     /* As suggested by Jesse Pelton */
@@ -154,16 +212,21 @@ OpenSSLCryptoProvider::~OpenSSLCryptoProvider() {
     RAND_cleanup();
     X509_TRUST_cleanup();
     ERR_remove_state(0);
+#endif
 }
 
 #ifdef XSEC_OPENSSL_HAVE_EC
 int OpenSSLCryptoProvider::curveNameToNID(const char* curveName) const {
 
-    std::map<std::string,int>::const_iterator i = m_namedCurveMap.find(curveName);
-    if (i == m_namedCurveMap.end())
-        throw XSECCryptoException(XSECCryptoException::UnsupportedError,
-            "OpenSSLCryptoProvider::curveNameToNID - curve name not recognized");
-    return i->second;
+    if (curveName != NULL) {
+        for (unsigned int i = 0; i < XSEC_OPENSSL_CURVE_COUNT; ++i) {
+            if (strcmp(s_namedCurves[i].oid, curveName) == 0)
+                return s_namedCurves[i].nid;
+        }
+    }
+
+    throw XSECCryptoException(XSECCryptoException::UnsupportedError,
+        "OpenSSLCryptoProvider::curveNameToNID - curve name not recognized");
 
 }
 #endif
@@ -264,6 +327,66 @@ XSECCryptoHash * OpenSSLCryptoProvider::hashHMACMD5() const {
 
 }
 
+void OpenSSLCryptoProvider::hashMultiple(XSECCryptoHash::HashType type,
+        unsigned int count,
+        const unsigned char * const * inputs,
+        const unsigned int * inputLengths,
+        unsigned char * const * outputs,
+        unsigned int maxOutputLen,
+        unsigned int * outputLengths) const {
+
+    const EVP_MD * md = getDigest(type);
+    if (md == NULL) {
+        throw XSECCryptoException(XSECCryptoException::UnsupportedError,
+            "OpenSSL:hashMultiple - unknown hash type");
+    }
+
+    if (count == 0)
+        return;
+
+#if (OPENSSL_VERSION_NUMBER < 0x10100000L)
+    EVP_MD_CTX * ctx = EVP_MD_CTX_create();
+#else
+    EVP_MD_CTX * ctx = EVP_MD_CTX_new();
+#endif
+    if (ctx == NULL) {
+        throw XSECCryptoException(XSECCryptoException::MDError,
+            "OpenSSL:hashMultiple - cannot allocate context");
+    }
+
+    unsigned char md_value[EVP_MAX_MD_SIZE];
+    unsigned int md_len;
+    bool ok = true;
+
+    for (unsigned int i = 0; ok && i < count; ++i) {
+
+        // Re-initialising an existing context keeps its allocations
+        if (EVP_DigestInit_ex(ctx, md, NULL) != 1 ||
+            EVP_DigestUpdate(ctx, inputs[i], inputLengths[i]) != 1 ||
+            EVP_DigestFinal_ex(ctx, md_value, &md_len) != 1) {
+
+            ok = false;
+            break;
+        }
+
+        outputLengths[i] = (md_len < maxOutputLen ? md_len : maxOutputLen);
+        memcpy(outputs[i], md_value, outputLengths[i]);
+
+    }
+
+#if (OPENSSL_VERSION_NUMBER < 0x10100000L)
+    EVP_MD_CTX_destroy(ctx);
+#else
+    EVP_MD_CTX_free(ctx);
+#endif
+
+    if (!ok) {
+        throw XSECCryptoException(XSECCryptoException::MDError,
+            "OpenSSL:hashMultiple - error calculating digest");
+    }
+
+}
+
 XSECCryptoKeyHMAC * OpenSSLCryptoProvider::keyHMAC(void) const {
 
     OpenSSLCryptoKeyHMAC * ret;
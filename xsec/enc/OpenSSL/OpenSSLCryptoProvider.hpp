@@ -34,11 +34,10 @@
 #include <xsec/framework/XSECDefs.hpp>
 #include <xsec/enc/XSECCryptoProvider.hpp>
 
-#include <map>
-#include <string>
-
 #if defined (XSEC_HAVE_OPENSSL)
 
+#include <openssl/evp.h>
+
 /**
  * @defgroup opensslcrypto OpenSSL Interface
  * @ingroup crypto
@@ -55,10 +54,6 @@
 
 class DSIG_EXPORT OpenSSLCryptoProvider : public XSECCryptoProvider {
 
-#ifdef XSEC_OPENSSL_HAVE_EC
-    std::map<std::string,int> m_namedCurveMap;
-#endif
-
 public :
 
 	/** @name Constructors and Destructors */
@@ -69,6 +64,23 @@ public :
 
 	//@}
 
+	/** @name Digest descriptors */
+	//@{
+
+	/**
+	 * \brief Find the OpenSSL digest for a hash type
+	 *
+	 * Returns OpenSSL's static descriptor directly, so it needs no
+	 * name lookup and can be used before a provider is constructed.
+	 *
+	 * @param type The hash algorithm
+	 * @returns The digest, or NULL if OpenSSL does not support it
+	 */
+
+	static const EVP_MD * getDigest(XSECCryptoHash::HashType type);
+
+	//@}
+
 	/** @name Hashing (Digest) Functions */
 	//@{
 
@@ -154,6 +166,23 @@ public :
 
 	virtual XSECCryptoHash			* hashHMACMD5() const;
 
+	/**
+	 * \brief Digest a batch of independent buffers
+	 *
+	 * Runs every input through a single EVP context, so the batch pays
+	 * for one context allocation rather than one per buffer.
+	 *
+	 * @see XSECCryptoProvider::hashMultiple
+	 */
+
+	virtual void hashMultiple(XSECCryptoHash::HashType type,
+		unsigned int count,
+		const unsigned char * const * inputs,
+		const unsigned int * inputLengths,
+		unsigned char * const * outputs,
+		unsigned int maxOutputLen,
+		unsigned int * outputLengths) const;
+
 	/**
 	 * \brief Return a HMAC key
 	 *
@@ -53,6 +53,7 @@ m_keyType(type),
 m_keyMode(MODE_NONE),
 m_keyBuf(""),
 m_tagBuf(""),
+m_tagSet(false),
 m_keyLen(0),
 #if (OPENSSL_VERSION_NUMBER < 0x10100000L)
 mp_ctx(&m_ctx_space),
@@ -212,19 +213,19 @@ int OpenSSLCryptoSymmetricKey::decryptCtxInit(const unsigned char* iv, const uns
 
             if (iv == NULL) {
                 // Just save off tag for later.
-                m_tagBuf.sbMemcpyIn(tag, taglen);
+                if (tag != NULL) {
+                    m_tagBuf.sbMemcpyIn(tag, taglen);
+                    m_tagSet = true;
+                }
                 return 0;
             }
 
-            if (m_tagBuf.sbRawBufferSize() == 0) {
-		        throw XSECCryptoException(XSECCryptoException::SymmetricError,
-			        "OpenSSL:SymmetricKey - Authentication tag not set"); 
-            }
-
-            // We have everything, so we can fully init.
+            // We have everything, so we can fully init.  If the tag is not
+            // known yet, it has to arrive via decryptSetTag before the finish.
             EVP_CipherInit_ex(mp_ctx, EVP_aes_128_gcm(), NULL, NULL, NULL, 0);
             EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_IVLEN, 12, NULL);
-            EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_TAG, 16, (void*)m_tagBuf.rawBuffer());
+            if (m_tagSet)
+                EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_TAG, 16, (void*)m_tagBuf.rawBuffer());
             EVP_CipherInit_ex(mp_ctx, NULL, NULL, m_keyBuf.rawBuffer(), iv, 0);
 		}
 #endif
@@ -264,19 +265,19 @@ int OpenSSLCryptoSymmetricKey::decryptCtxInit(const unsigned char* iv, const uns
 
             if (iv == NULL) {
                 // Just save off tag for later.
-                m_tagBuf.sbMemcpyIn(tag, taglen);
+                if (tag != NULL) {
+                    m_tagBuf.sbMemcpyIn(tag, taglen);
+                    m_tagSet = true;
+                }
                 return 0;
             }
 
-            if (m_tagBuf.sbRawBufferSize() == 0) {
-		        throw XSECCryptoException(XSECCryptoException::SymmetricError,
-			        "OpenSSL:SymmetricKey - Authentication tag not set"); 
-            }
-
-            // We have everything, so we can fully init.
+            // We have everything, so we can fully init.  If the tag is not
+            // known yet, it has to arrive via decryptSetTag before the finish.
             EVP_CipherInit_ex(mp_ctx, EVP_aes_192_gcm(), NULL, NULL, NULL, 0);
             EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_IVLEN, 12, NULL);
-            EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_TAG, 16, (void*)m_tagBuf.rawBuffer());
+            if (m_tagSet)
+                EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_TAG, 16, (void*)m_tagBuf.rawBuffer());
             EVP_CipherInit_ex(mp_ctx, NULL, NULL, m_keyBuf.rawBuffer(), iv, 0);
 
 		}
@@ -317,19 +318,19 @@ int OpenSSLCryptoSymmetricKey::decryptCtxInit(const unsigned char* iv, const uns
 
             if (iv == NULL) {
                 // Just save off tag for later.
-                m_tagBuf.sbMemcpyIn(tag, taglen);
+                if (tag != NULL) {
+                    m_tagBuf.sbMemcpyIn(tag, taglen);
+                    m_tagSet = true;
+                }
                 return 0;
             }
 
-            if (m_tagBuf.sbRawBufferSize() == 0) {
-		        throw XSECCryptoException(XSECCryptoException::SymmetricError,
-			        "OpenSSL:SymmetricKey - Authentication tag not set"); 
-            }
-
-            // We have everything, so we can fully init.
+            // We have everything, so we can fully init.  If the tag is not
+            // known yet, it has to arrive via decryptSetTag before the finish.
             EVP_CipherInit_ex(mp_ctx, EVP_aes_256_gcm(), NULL, NULL, NULL, 0);
             EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_IVLEN, 12, NULL);
-            EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_TAG, 16, (void*)m_tagBuf.rawBuffer());
+            if (m_tagSet)
+                EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_TAG, 16, (void*)m_tagBuf.rawBuffer());
             EVP_CipherInit_ex(mp_ctx, NULL, NULL, m_keyBuf.rawBuffer(), iv, 0);
 
 		}
@@ -403,11 +404,47 @@ bool OpenSSLCryptoSymmetricKey::decryptInit(bool doPad,
 	m_doPad = doPad;
 	m_keyMode = mode;
 	m_initialised = false;
+	m_tagSet = false;
 	decryptCtxInit(iv, tag, taglen);
 	return true;
 
 }
 
+bool OpenSSLCryptoSymmetricKey::supportsDeferredTag(void) const {
+
+#if defined (XSEC_OPENSSL_HAVE_GCM)
+	return true;
+#else
+	return false;
+#endif
+
+}
+
+bool OpenSSLCryptoSymmetricKey::decryptSetTag(const unsigned char* tag, unsigned int taglen) {
+
+#if defined (XSEC_OPENSSL_HAVE_GCM)
+
+	if (m_keyMode != MODE_GCM || tag == NULL || taglen != 16) {
+		throw XSECCryptoException(XSECCryptoException::SymmetricError,
+			"OpenSSL:SymmetricKey - Invalid authentication tag"); 
+	}
+
+	m_tagBuf.sbMemcpyIn(tag, taglen);
+	m_tagSet = true;
+
+	// OpenSSL only checks the tag in EVP_DecryptFinal, so it can be
+	// handed over at any point up to then.
+	if (m_initialised)
+		EVP_CIPHER_CTX_ctrl(mp_ctx, EVP_CTRL_GCM_SET_TAG, 16, (void*)m_tagBuf.rawBuffer());
+
+	return true;
+
+#else
+	return false;
+#endif
+
+}
+
 unsigned int OpenSSLCryptoSymmetricKey::decrypt(const unsigned char * inBuf, 
 								 unsigned char * plainBuf, 
 								 unsigned int inLength,
@@ -489,6 +526,11 @@ unsigned int OpenSSLCryptoSymmetricKey::decryptFinish(unsigned char * plainBuf,
 	int outl = maxOutLength;
 	m_initialised = false;
 
+	if (m_keyMode == MODE_GCM && !m_tagSet) {
+		throw XSECCryptoException(XSECCryptoException::SymmetricError,
+			"OpenSSL:SymmetricKey - Authentication tag not set"); 
+	}
+
 #if defined (XSEC_OPENSSL_CANSET_PADDING)
 
 	if (EVP_DecryptFinal(mp_ctx, plainBuf, &outl) == 0) {
@@ -204,6 +204,27 @@ public :
     virtual unsigned int decryptFinish(unsigned char * plainBuf,
                                        unsigned int maxOutLength);
 
+    /**
+     * \brief Can the authentication tag be supplied after decryption starts?
+     *
+     * @returns true if AES-GCM is available in this build
+     */
+
+    virtual bool supportsDeferredTag(void) const;
+
+    /**
+     * \brief Supply the authentication tag for a decryption in progress
+     *
+     * Used when streaming AES-GCM cipher text, where the tag is only
+     * found at the end of the stream.  Must be called before decryptFinish.
+     *
+     * @param tag Authentication tag
+     * @param taglen length of Authentication Tag (must be 16)
+     * @returns true if the tag was accepted
+     */
+
+    virtual bool decryptSetTag(const unsigned char* tag, unsigned int taglen);
+
     /**
      * \brief Initialise an encryption process
      *
@@ -313,6 +334,7 @@ private:
 #endif
     safeBuffer                      m_keyBuf;       // Holder of the key
     safeBuffer                      m_tagBuf;       // Holder of authentication tag
+    bool                            m_tagSet;       // Has the tag been supplied?
     unsigned int                    m_keyLen;
     bool                            m_initialised;  // Is the context ready to work?
     unsigned char                   m_lastBlock[MAX_BLOCK_SIZE];
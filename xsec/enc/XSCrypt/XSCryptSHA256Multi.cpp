@@ -0,0 +1,226 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSCryptSHA256Multi := Portable SHA-256 that digests several messages
+ *                       together
+ *
+ * $Id$
+ *
+ */
+
+#include <xsec/enc/XSCrypt/XSCryptSHA256Multi.hpp>
+
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+// --------------------------------------------------------------------------------
+//           Constants and helpers
+// --------------------------------------------------------------------------------
+
+static const XMLUInt32 s_K[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const XMLUInt32 s_H0[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+#define ROTR(x, n)	((((x) >> (n)) | ((x) << (32 - (n)))) & 0xffffffff)
+
+// Number of 64 byte blocks in a message of len bytes once padded
+
+static inline unsigned int paddedBlocks(unsigned int len) {
+
+	return (unsigned int) (((unsigned long) len + 8) / 64 + 1);
+
+}
+
+// Fill blk with block b of the padded form of the message
+
+static void paddedBlock(const unsigned char * in,
+						unsigned int len,
+						unsigned int b,
+						unsigned char * blk) {
+
+	unsigned long off = (unsigned long) b * 64;
+
+	if (off + 64 <= len) {
+		memcpy(blk, in + off, 64);
+		return;
+	}
+
+	memset(blk, 0, 64);
+
+	if (off <= len) {
+		unsigned int rem = (unsigned int) (len - off);
+		if (rem > 0)
+			memcpy(blk, in + off, rem);
+		blk[rem] = 0x80;
+	}
+
+	if (b == paddedBlocks(len) - 1) {
+
+		// Message length in bits, big endian
+		XMLUInt32 hi = (XMLUInt32) ((len >> 29) & 0x7);
+		XMLUInt32 lo = (XMLUInt32) ((len << 3) & 0xffffffff);
+
+		blk[56] = (unsigned char) (hi >> 24);
+		blk[57] = (unsigned char) (hi >> 16);
+		blk[58] = (unsigned char) (hi >> 8);
+		blk[59] = (unsigned char) hi;
+		blk[60] = (unsigned char) (lo >> 24);
+		blk[61] = (unsigned char) (lo >> 16);
+		blk[62] = (unsigned char) (lo >> 8);
+		blk[63] = (unsigned char) lo;
+
+	}
+
+}
+
+// --------------------------------------------------------------------------------
+//           Hash a batch
+// --------------------------------------------------------------------------------
+
+void XSCryptSHA256Multi::hash(unsigned int count,
+							  const unsigned char * const * inputs,
+							  const unsigned int * inputLengths,
+							  unsigned char * const * outputs) {
+
+	// State and schedule are held lane-minor so that each round is a
+	// loop over the lanes
+
+	XMLUInt32 H[8][LANES];
+	XMLUInt32 W[64][LANES];
+	XMLUInt32 v[8][LANES];
+	unsigned int nb[LANES];
+	unsigned char blk[64];
+
+	unsigned int first, l, t, i;
+
+	for (first = 0; first < count; first += LANES) {
+
+		unsigned int lanes = count - first;
+		if (lanes > LANES)
+			lanes = LANES;
+
+		unsigned int maxBlocks = 0;
+
+		for (l = 0; l < LANES; ++l) {
+
+			nb[l] = (l < lanes ? paddedBlocks(inputLengths[first + l]) : 0);
+			if (nb[l] > maxBlocks)
+				maxBlocks = nb[l];
+
+			for (i = 0; i < 8; ++i)
+				H[i][l] = s_H0[i];
+
+		}
+
+		for (unsigned int b = 0; b < maxBlocks; ++b) {
+
+			// Load the message schedule.  Lanes that have finished get a
+			// zero block, and their result is discarded below.
+
+			for (l = 0; l < LANES; ++l) {
+
+				if (b < nb[l])
+					paddedBlock(inputs[first + l], inputLengths[first + l], b, blk);
+				else
+					memset(blk, 0, 64);
+
+				for (t = 0; t < 16; ++t)
+					W[t][l] = ((XMLUInt32) blk[t * 4] << 24) |
+						((XMLUInt32) blk[t * 4 + 1] << 16) |
+						((XMLUInt32) blk[t * 4 + 2] << 8) |
+						((XMLUInt32) blk[t * 4 + 3]);
+
+			}
+
+			for (t = 16; t < 64; ++t) {
+				for (l = 0; l < LANES; ++l) {
+					XMLUInt32 w15 = W[t - 15][l];
+					XMLUInt32 w2 = W[t - 2][l];
+					XMLUInt32 s0 = ROTR(w15, 7) ^ ROTR(w15, 18) ^ (w15 >> 3);
+					XMLUInt32 s1 = ROTR(w2, 17) ^ ROTR(w2, 19) ^ (w2 >> 10);
+					W[t][l] = (W[t - 16][l] + s0 + W[t - 7][l] + s1) & 0xffffffff;
+				}
+			}
+
+			for (i = 0; i < 8; ++i)
+				for (l = 0; l < LANES; ++l)
+					v[i][l] = H[i][l];
+
+			for (t = 0; t < 64; ++t) {
+				for (l = 0; l < LANES; ++l) {
+
+					XMLUInt32 a = v[0][l], e = v[4][l];
+					XMLUInt32 S1 = ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25);
+					XMLUInt32 ch = (e & v[5][l]) ^ (~e & v[6][l]);
+					XMLUInt32 t1 = (v[7][l] + S1 + ch + s_K[t] + W[t][l]) & 0xffffffff;
+					XMLUInt32 S0 = ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22);
+					XMLUInt32 maj = (a & v[1][l]) ^ (a & v[2][l]) ^ (v[1][l] & v[2][l]);
+					XMLUInt32 t2 = (S0 + maj) & 0xffffffff;
+
+					v[7][l] = v[6][l];
+					v[6][l] = v[5][l];
+					v[5][l] = v[4][l];
+					v[4][l] = (v[3][l] + t1) & 0xffffffff;
+					v[3][l] = v[2][l];
+					v[2][l] = v[1][l];
+					v[1][l] = v[0][l];
+					v[0][l] = (t1 + t2) & 0xffffffff;
+
+				}
+			}
+
+			for (l = 0; l < LANES; ++l)
+				if (b < nb[l])
+					for (i = 0; i < 8; ++i)
+						H[i][l] = (H[i][l] + v[i][l]) & 0xffffffff;
+
+		}
+
+		for (l = 0; l < lanes; ++l) {
+
+			unsigned char * out = outputs[first + l];
+
+			for (i = 0; i < 8; ++i) {
+				out[i * 4] = (unsigned char) (H[i][l] >> 24);
+				out[i * 4 + 1] = (unsigned char) (H[i][l] >> 16);
+				out[i * 4 + 2] = (unsigned char) (H[i][l] >> 8);
+				out[i * 4 + 3] = (unsigned char) H[i][l];
+			}
+
+		}
+
+	}
+
+}
@@ -0,0 +1,83 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSCryptSHA256Multi := Portable SHA-256 that digests several messages
+ *                       together
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSCRYPTSHA256MULTI_INCLUDE
+#define XSCRYPTSHA256MULTI_INCLUDE
+
+#include <xsec/framework/XSECDefs.hpp>
+
+/**
+ * @ingroup xscryptcrypto
+ */
+
+/**
+ * \brief Interleaved SHA-256 over a batch of messages
+ *
+ * Runs the compression function for up to LANES messages in lock step,
+ * one round of every lane at a time, so a compiler can keep the lanes in
+ * vector registers.  This is the fallback used by
+ * XSECCryptoProvider::hashMultiple when the provider has no multi-stream
+ * digest of its own, and is aimed at batches of small messages where
+ * per-message setup dominates.
+ *
+ * Results are identical to hashing each message separately.
+ */
+
+class DSIG_EXPORT XSCryptSHA256Multi {
+
+public:
+
+	enum {
+		LANES = 4,					// Messages processed together
+		DIGEST_LENGTH = 32			// Bytes in each output
+	};
+
+	/**
+	 * \brief Digest a batch of messages
+	 *
+	 * @param count Number of messages
+	 * @param inputs Array of count pointers to message data
+	 * @param inputLengths Array of count message lengths
+	 * @param outputs Array of count buffers, each at least DIGEST_LENGTH
+	 * bytes long
+	 */
+
+	static void hash(unsigned int count,
+		const unsigned char * const * inputs,
+		const unsigned int * inputLengths,
+		unsigned char * const * outputs);
+
+private:
+
+	// Static only
+	XSCryptSHA256Multi();
+
+};
+
+#endif /* XSCRYPTSHA256MULTI_INCLUDE */
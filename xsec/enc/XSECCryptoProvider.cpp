@@ -30,9 +30,12 @@
 
 #include <xsec/enc/XSECCryptoProvider.hpp>
 #include <xsec/enc/XSECCryptoException.hpp>
+#include <xsec/enc/XSCrypt/XSCryptSHA256Multi.hpp>
 
 #include <xercesc/util/Janitor.hpp>
 
+XERCES_CPP_NAMESPACE_USE
+
 XSECCryptoKeyEC* XSECCryptoProvider::keyEC() const {
     throw XSECCryptoException(XSECCryptoException::UnsupportedError,
 		"XSECCryptoProvider - EC keys not supported");
@@ -42,3 +45,71 @@ XSECCryptoKey* XSECCryptoProvider::keyDER(const char* buf, unsigned long buflen,
     throw XSECCryptoException(XSECCryptoException::UnsupportedError,
 		"XSECCryptoProvider - DER-encoded keys not supported");
 }
+
+void XSECCryptoProvider::hashMultiple(XSECCryptoHash::HashType type,
+		unsigned int count,
+		const unsigned char * const * inputs,
+		const unsigned int * inputLengths,
+		unsigned char * const * outputs,
+		unsigned int maxOutputLen,
+		unsigned int * outputLengths) const {
+
+	// SHA-256 has a portable implementation that hashes several
+	// messages at once
+
+	if (type == XSECCryptoHash::HASH_SHA256 &&
+		maxOutputLen >= XSCryptSHA256Multi::DIGEST_LENGTH) {
+
+		XSCryptSHA256Multi::hash(count, inputs, inputLengths, outputs);
+		for (unsigned int i = 0; i < count; ++i)
+			outputLengths[i] = XSCryptSHA256Multi::DIGEST_LENGTH;
+		return;
+
+	}
+
+	XSECCryptoHash * h;
+
+	switch (type) {
+
+	case XSECCryptoHash::HASH_SHA1 :
+		h = hashSHA(160);
+		break;
+	case XSECCryptoHash::HASH_SHA224 :
+		h = hashSHA(224);
+		break;
+	case XSECCryptoHash::HASH_SHA256 :
+		h = hashSHA(256);
+		break;
+	case XSECCryptoHash::HASH_SHA384 :
+		h = hashSHA(384);
+		break;
+	case XSECCryptoHash::HASH_SHA512 :
+		h = hashSHA(512);
+		break;
+	case XSECCryptoHash::HASH_MD5 :
+		h = hashMD5();
+		break;
+	default :
+		throw XSECCryptoException(XSECCryptoException::UnsupportedError,
+			"XSECCryptoProvider::hashMultiple - unknown hash type");
+
+	}
+
+	if (h == NULL) {
+		throw XSECCryptoException(XSECCryptoException::MDError,
+			"XSECCryptoProvider::hashMultiple - provider returned no hash");
+	}
+
+	Janitor<XSECCryptoHash> j_h(h);
+
+	// One object for the whole batch - only the per-message state is reset
+
+	for (unsigned int i = 0; i < count; ++i) {
+
+		h->reset();
+		h->hash((unsigned char *) inputs[i], inputLengths[i]);
+		outputLengths[i] = h->finish(outputs[i], maxOutputLen);
+
+	}
+
+}
@@ -237,6 +237,37 @@ public :
 
 	virtual XSECCryptoHash			* hashHMACMD5() const = 0;
 
+	/**
+	 * \brief Digest a batch of independent buffers
+	 *
+	 * Used by the library when a number of small inputs (typically the
+	 * canonicalised content of several References) all need a plain
+	 * digest using the same algorithm.  Providers that can hash several
+	 * streams together (or simply avoid per-message setup) should
+	 * override this.  The default implementation digests SHA-256 with
+	 * the portable interleaved XSCryptSHA256Multi, and for any other
+	 * algorithm obtains a single hash object and resets it between
+	 * inputs.
+	 *
+	 * @param type The digest algorithm to use (must not be HASH_NONE)
+	 * @param count Number of buffers in the batch
+	 * @param inputs Array of count pointers to the data to hash
+	 * @param inputLengths Array of count lengths for the inputs
+	 * @param outputs Array of count buffers to receive the digests
+	 * @param maxOutputLen Size of each of the output buffers
+	 * @param outputLengths Array of count values set to the number of
+	 * bytes written to the matching output
+	 * @throws XSECCryptoException if the algorithm is not supported
+	 */
+
+	virtual void hashMultiple(XSECCryptoHash::HashType type,
+		unsigned int count,
+		const unsigned char * const * inputs,
+		const unsigned int * inputLengths,
+		unsigned char * const * outputs,
+		unsigned int maxOutputLen,
+		unsigned int * outputLengths) const;
+
 	/**
 	 * \brief Return a HMAC key
 	 *
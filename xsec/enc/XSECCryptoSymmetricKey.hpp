@@ -230,6 +230,34 @@ public :
 	virtual unsigned int decryptFinish(unsigned char * plainBuf,
 									   unsigned int maxOutLength) = 0;
 
+	/**
+	 * \brief Can the authentication tag be supplied after decryption starts?
+	 *
+	 * For AEAD ciphers the tag follows the cipher text, so a caller that
+	 * streams the data cannot provide it to decryptInit.  Implementations
+	 * that return true here allow decryptInit to be called without a tag,
+	 * with the tag later provided via decryptSetTag before decryptFinish.
+	 *
+	 * @returns true if decryptSetTag is supported
+	 */
+
+	virtual bool supportsDeferredTag(void) const {return false;}
+
+	/**
+	 * \brief Supply the authentication tag for a decryption in progress
+	 *
+	 * Only valid for AEAD modes, and only if supportsDeferredTag returns
+	 * true.  Must be called before decryptFinish, which is where the tag
+	 * is checked.  Any plain text returned by decrypt prior to a successful
+	 * decryptFinish has not been authenticated.
+	 *
+	 * @param tag Authentication tag
+	 * @param taglen length of Authentication Tag
+	 * @returns false if the implementation cannot accept a deferred tag
+	 */
+
+	virtual bool decryptSetTag(const unsigned char* tag, unsigned int taglen) {return false;}
+
 	/**
 	 * \brief Initialise an encryption process
 	 *
@@ -78,22 +78,13 @@ XSECCryptoKey * XSECKeyInfoResolverDefault::resolveKey(DSIGKeyInfoList * lst) {
 
 		case (DSIGKeyInfo::KEYINFO_X509) :
 		{
-			ret = NULL;
-			const XMLCh * x509Str;
-			XSECCryptoX509 * x509 = XSECPlatformUtils::g_cryptoProvider->X509();
-			Janitor<XSECCryptoX509> j_x509(x509);
-
-			x509Str = ((DSIGKeyInfoX509 *) lst->item(i))->getCertificateItem(0);
-			
-			if (x509Str != 0) {
-
-				// The crypto interface classes work UTF-8
-				safeBuffer transX509;
-
-				transX509 << (*mp_formatter << x509Str);
-				x509->loadX509Base64Bin(transX509.rawCharBuffer(), (unsigned int) strlen(transX509.rawCharBuffer()));
-				ret = x509->clonePublicKey();
-			}
+			// Use the certificate the KeyInfo has already parsed (or
+			// parses now) rather than decoding it again
+
+			XSECCryptoX509 * x509 =
+				((DSIGKeyInfoX509 *) lst->item(i))->getCertificateCryptoItem(0);
+
+			ret = (x509 != NULL ? x509->clonePublicKey() : NULL);
 
 			if (ret != NULL)
 				return ret;
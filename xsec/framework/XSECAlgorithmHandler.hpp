@@ -33,6 +33,7 @@
 // XSEC Includes
 
 #include <xsec/framework/XSECDefs.hpp>
+#include <xsec/enc/XSECCryptoHash.hpp>
 
 class TXFMChain;
 class XENCEncryptionMethod;
@@ -169,6 +170,10 @@ public:
 	 * processing object.  The Type value can then be read from the
 	 * EncryptionMethod object to determine what to do.
 	 *
+	 * For authenticated algorithms, the appended transformer may stream
+	 * plain text before the authentication tag has been checked, but must
+	 * throw from readBytes at the end of the stream if the check fails.
+	 *
 	 * @param cipherText Chain that will provide the cipherText.
 	 * Ownership remains with the caller - do not delete.
 	 * @param encryptionMethod Information about the algorithm to use
@@ -288,6 +293,26 @@ public:
 		const XMLCh * URI
 	) = 0;
 
+	/**
+	 * \brief Map a hash URI to a plain digest
+	 *
+	 * When a number of references are hashed together the library can
+	 * digest their content as a batch (see
+	 * XSECCryptoProvider::hashMultiple) rather than appending a hash
+	 * TXFM to each chain.  It will only do so for handlers that return
+	 * true here, so handlers that do anything more than a straight
+	 * digest should leave the default in place.
+	 *
+	 * @param URI Hash algorithm URI (as passed to appendHashTxfm)
+	 * @param type Set to the matching digest type if true is returned
+	 * @returns true if the URI is a plain digest the library may batch
+	 */
+
+	virtual bool mapHashURI(
+		const XMLCh * URI,
+		XSECCryptoHash::HashType & type
+	) {return false;}
+
 	//@}
 
 	
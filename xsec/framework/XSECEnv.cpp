@@ -150,6 +150,7 @@ XSECEnv::XSECEnv(DOMDocument *doc) {
 	m_prettyPrintFlag = true;
 
 	mp_URIResolver = NULL;
+	mp_URIPrefetcher = NULL;
 
 	// Set up our formatter
 	XSECnew(mp_formatter, XSECSafeBufferFormatter("UTF-8",XMLFormatter::NoEscapes, 
@@ -182,6 +183,8 @@ XSECEnv::XSECEnv(const XSECEnv & theOther) {
 	else
 		mp_URIResolver = NULL;
 
+	mp_URIPrefetcher = theOther.mp_URIPrefetcher;
+
 	// Set up our formatter
 	XSECnew(mp_formatter, XSECSafeBufferFormatter("UTF-8",XMLFormatter::NoEscapes, 
 												XMLFormatter::UnRep_CharRef));
@@ -41,6 +41,7 @@
 #include <xercesc/dom/DOM.hpp>
 
 class XSECURIResolver;
+class XSECURIPrefetcher;
 
 /**
  * @ingroup internal
@@ -340,6 +341,27 @@ public:
 
 	XSECURIResolver * getURIResolver(void) const;
 
+	/**
+	 * \brief Register a URIPrefetcher
+	 *
+	 * The prefetcher is not cloned - it remains owned by the caller,
+	 * and must outlive any use of this environment.
+	 *
+	 * @param prefetcher Prefetcher to use, or NULL to stop prefetching
+	 */
+
+	void setURIPrefetcher(XSECURIPrefetcher * prefetcher)
+		{mp_URIPrefetcher = prefetcher;}
+
+	/**
+	 * \brief Return the prefetcher being used
+	 *
+	 * @returns The registered prefetcher, or NULL if there is none
+	 */
+
+	XSECURIPrefetcher * getURIPrefetcher(void) const
+		{return mp_URIPrefetcher;}
+
 
 	//@}
 
@@ -553,6 +575,7 @@ private:
 
 	// Resolvers
 	XSECURIResolver				* mp_URIResolver;
+	XSECURIPrefetcher			* mp_URIPrefetcher;	// Not owned
 
 	// Flags
 	bool						m_prettyPrintFlag;
@@ -0,0 +1,110 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * XSEC
+ *
+ * XSECURIPrefetcher := Interface for classes that fetch external
+ *                      reference URIs ahead of their use
+ *
+ * $Id$
+ */
+
+#ifndef XSECURIPREFETCHER_INCLUDE
+#define XSECURIPREFETCHER_INCLUDE
+
+#include <xsec/framework/XSECDefs.hpp>
+
+XSEC_DECLARE_XERCES_CLASS(BinInputStream);
+
+class XSECURIResolver;
+
+/**
+ * @ingroup pubsig
+ */
+/*\@{*/
+
+/**
+ * @brief Interface class for prefetching external URIs.
+ *
+ * By default each external Reference URI is opened through the
+ * URIResolver only when the reference is digested, so a signature
+ * with many remote references pays the latency of each one in turn.
+ *
+ * If a prefetcher is registered with a signature, every external URI
+ * found when the signature is loaded is handed to prefetchURI().  When
+ * the reference is later digested the library first asks the
+ * prefetcher for the data via claimURI(), and only resolves the URI
+ * itself if the prefetcher has nothing for it.
+ *
+ * XSECURIPrefetcherThreaded is the implementation provided with the
+ * library.
+ */
+
+class DSIG_EXPORT XSECURIPrefetcher {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	XSECURIPrefetcher() {};
+	virtual ~XSECURIPrefetcher() {};
+
+	//@}
+
+	/** @name Interface Methods */
+	//@{
+
+	/**
+	 * \brief Start fetching a URI.
+	 *
+	 * Must not block on the fetch itself.  Calling this again for a URI
+	 * that is already pending has no effect.
+	 *
+	 * @param uri The URI to be fetched
+	 * @param resolver The resolver the signature would have used for
+	 * the URI.  Owned by the caller - clone it if it is needed once
+	 * this call returns.
+	 */
+
+	virtual void prefetchURI(const XMLCh * uri, XSECURIResolver * resolver) = 0;
+
+	/**
+	 * \brief Take the data for a prefetched URI.
+	 *
+	 * The returned stream may be handed out before the fetch has
+	 * finished, in which case reads block until more data arrives.
+	 * A URI can be claimed once - subsequent claims return NULL.
+	 *
+	 * @note The returned stream is "owned" by the caller, which
+	 * will delete it when processing is complete.
+	 * @param uri The URI that is about to be de-referenced
+	 * @returns A stream for the URI, or NULL if the caller should
+	 * resolve the URI itself.
+	 */
+
+	virtual XERCES_CPP_NAMESPACE_QUALIFIER BinInputStream *
+		claimURI(const XMLCh * uri) = 0;
+
+	//@}
+
+};
+
+
+#endif /* XSECURIPREFETCHER_INCLUDE */
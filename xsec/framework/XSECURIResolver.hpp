@@ -33,6 +33,9 @@
 
 XSEC_DECLARE_XERCES_CLASS(BinInputStream);
 
+class XSECBinMappedFileInputStream;
+class safeBuffer;
+
 /**
  * @ingroup pubsig
  */
@@ -102,6 +105,80 @@ public:
 
 	virtual XSECURIResolver * clone(void) = 0;
 
+	/**
+	 * \brief Resolve a URI to a memory mapped local file.
+	 *
+	 * Called by the library before resolveURI().  A resolver that can
+	 * map a URI onto a local file may return a mapped stream here, which
+	 * lets the library digest the file without copying it.  A stream
+	 * that turned out not to be mappable may also be returned, and is
+	 * then read like any other, which saves opening the file again.  If
+	 * NULL is returned (the default) resolveURI() is used as normal.
+	 *
+	 * @note The returned stream is owned by the caller.
+	 * @param uri The URI to be de-referenced.  NULL if this is an
+	 * anonymous reference.
+	 * @returns An open local file stream, or NULL.
+	 */
+
+	virtual XSECBinMappedFileInputStream *
+		resolveURIMapped(const XMLCh * uri) {return NULL;}
+
+	//@}
+
+	/** @name Caching support */
+	//@{
+
+	/**
+	 * \brief Find a validator for the current content of a URI.
+	 *
+	 * A validator is any string that changes when the content does
+	 * (a modification time, an entity tag).  Caching resolvers use it
+	 * to check that an expired entry is still good without fetching
+	 * it again.
+	 *
+	 * @param uri The URI to be checked
+	 * @param validator Set to the validator if one was found
+	 * @returns true if a validator is available (the default is false)
+	 */
+
+	virtual bool getValidator(const XMLCh * uri, safeBuffer & validator) {return false;}
+
+	/**
+	 * \brief Does this resolver remember digests?
+	 *
+	 * If true, DSIGReference looks up the digest of each external
+	 * reference with findDigestMemo() before dereferencing it, and
+	 * records digests it calculates with storeDigestMemo().
+	 */
+
+	virtual bool usesDigestMemo(void) const {return false;}
+
+	/**
+	 * \brief Look up a remembered digest.
+	 *
+	 * @param uri The reference URI
+	 * @param key Identifies the transforms and digest method applied
+	 * @param toFill Buffer for the digest
+	 * @param maxToFill Size of the buffer
+	 * @returns Length of the digest, or 0 if none is remembered
+	 */
+
+	virtual unsigned int findDigestMemo(const XMLCh * uri, const char * key,
+		XMLByte * toFill, unsigned int maxToFill) {return 0;}
+
+	/**
+	 * \brief Remember a digest calculated over data from this resolver.
+	 *
+	 * @param uri The reference URI
+	 * @param key Identifies the transforms and digest method applied
+	 * @param digest The digest value
+	 * @param digestLen Length of the digest
+	 */
+
+	virtual void storeDigestMemo(const XMLCh * uri, const char * key,
+		const XMLByte * digest, unsigned int digestLen) {}
+
 	//@}
 
 };
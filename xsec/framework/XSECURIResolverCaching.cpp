@@ -0,0 +1,598 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * XSEC
+ *
+ * XSECURIResolverCaching := URIResolver decorator that keeps the content
+ *                           of external references in a shared cache
+ *
+ * $Id$
+ *
+ */
+
+#include <xsec/framework/XSECDefs.hpp>
+#include <xsec/framework/XSECURIResolverCaching.hpp>
+#include <xsec/framework/XSECError.hpp>
+#include <xsec/utils/XSECSafeBuffer.hpp>
+
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/Janitor.hpp>
+#include <xercesc/util/Mutexes.hpp>
+
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+
+XERCES_CPP_NAMESPACE_USE
+
+#define XSEC_URICACHE_CHUNK		16384
+
+// --------------------------------------------------------------------------------
+//           Cache state
+// --------------------------------------------------------------------------------
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef list<XSECURICacheEntry *>					URICacheLRUType;
+typedef map<string, XSECURICacheEntry *>			URICacheMapType;
+typedef map<string, string>							URICacheMemoType;
+typedef vector<XMLByte>								URICacheDataType;
+#else
+typedef std::list<XSECURICacheEntry *>				URICacheLRUType;
+typedef std::map<std::string, XSECURICacheEntry *>	URICacheMapType;
+typedef std::map<std::string, std::string>			URICacheMemoType;
+typedef std::vector<XMLByte>						URICacheDataType;
+#endif
+
+struct XSECURICacheEntry {
+
+	std::string					m_key;			// URI the content came from
+	URICacheDataType			m_data;			// Never changed once cached
+	time_t						m_checked;		// Fetched or last revalidated
+	bool						m_hasValidator;
+	std::string					m_validator;
+	URICacheMemoType			m_memo;			// Digest memo key -> digest
+	unsigned int				m_refs;			// Cache, streams and resolvers
+	bool						m_current;		// Still held by the cache
+	URICacheLRUType::iterator	m_lru;
+
+};
+
+struct XSECURICacheState {
+
+	XMLMutex					m_mutex;
+	URICacheMapType				m_entries;
+	URICacheLRUType				m_lru;			// Most recently used first
+	xsecsize_t					m_maxBytes;
+	xsecsize_t					m_maxEntryBytes;
+	xsecsize_t					m_totalBytes;
+	unsigned int				m_maxAge;
+	unsigned int				m_hits;
+	unsigned int				m_misses;
+	bool						m_digestMemo;
+
+};
+
+struct XSECURIServedEntries {
+
+	URICacheMapType				m_entries;
+
+};
+
+static std::string uriKey(const XMLCh * uri) {
+
+	// The raw UTF-16 is used as the key - nothing is lost to transcoding
+	return std::string((const char *) uri, XMLString::stringLen(uri) * sizeof(XMLCh));
+
+}
+
+// All of the following are called with the cache mutex held
+
+static void releaseEntry(XSECURICacheEntry * entry) {
+
+	if (--entry->m_refs == 0)
+		delete entry;
+
+}
+
+static void removeEntry(XSECURICacheState * state, XSECURICacheEntry * entry) {
+
+	state->m_entries.erase(entry->m_key);
+	state->m_lru.erase(entry->m_lru);
+	state->m_totalBytes -= (xsecsize_t) entry->m_data.size();
+	entry->m_current = false;
+	releaseEntry(entry);
+
+}
+
+static bool isFresh(XSECURICacheState * state, XSECURICacheEntry * entry) {
+
+	return (time(NULL) - entry->m_checked) < (time_t) state->m_maxAge;
+
+}
+
+static void touchEntry(XSECURICacheState * state, XSECURICacheEntry * entry) {
+
+	state->m_lru.splice(state->m_lru.begin(), state->m_lru, entry->m_lru);
+
+}
+
+// --------------------------------------------------------------------------------
+//           Streams
+// --------------------------------------------------------------------------------
+
+// Reads the content of a cache entry.  The content of an entry is never
+// changed once it is in the cache, so reads need no lock.
+
+class URICacheInputStream : public BinInputStream {
+
+public:
+
+	URICacheInputStream(XSECURICacheState * state, XSECURICacheEntry * entry) :
+		mp_state(state), mp_entry(entry), m_pos(0) {
+
+		entry->m_refs++;
+
+	}
+
+	virtual ~URICacheInputStream() {
+
+		XMLMutexLock lock(&mp_state->m_mutex);
+		releaseEntry(mp_entry);
+
+	}
+
+#ifdef XSEC_XERCES_64BITSAFE
+	virtual XMLFilePos curPos() const {return m_pos;}
+#else
+	virtual unsigned int curPos() const {return (unsigned int) m_pos;}
+#endif
+
+	virtual xsecsize_t readBytes(XMLByte* const toFill, const xsecsize_t maxToRead) {
+
+		xsecsize_t avail = (xsecsize_t) mp_entry->m_data.size() - m_pos;
+		xsecsize_t n = (avail < maxToRead ? avail : maxToRead);
+
+		if (n > 0) {
+			memcpy(toFill, &mp_entry->m_data[m_pos], n);
+			m_pos += n;
+		}
+
+		return n;
+
+	}
+
+#ifdef XSEC_XERCES_INPUTSTREAM_HAS_CONTENTTYPE
+	virtual const XMLCh* getContentType() const {return NULL;}
+#endif
+
+private:
+
+	XSECURICacheState			* mp_state;
+	XSECURICacheEntry			* mp_entry;
+	xsecsize_t					m_pos;
+
+};
+
+// Used for documents too large to cache - replays what was read while
+// finding that out, then carries on with the original stream
+
+class URICacheReplayInputStream : public BinInputStream {
+
+public:
+
+	URICacheReplayInputStream(URICacheDataType & prefix, BinInputStream * is) :
+		mp_is(is), m_prefixPos(0), m_pos(0) {
+
+		m_prefix.swap(prefix);
+
+	}
+
+	virtual ~URICacheReplayInputStream() {
+
+		delete mp_is;
+
+	}
+
+#ifdef XSEC_XERCES_64BITSAFE
+	virtual XMLFilePos curPos() const {return m_pos;}
+#else
+	virtual unsigned int curPos() const {return (unsigned int) m_pos;}
+#endif
+
+	virtual xsecsize_t readBytes(XMLByte* const toFill, const xsecsize_t maxToRead) {
+
+		xsecsize_t n;
+		xsecsize_t avail = (xsecsize_t) m_prefix.size() - m_prefixPos;
+
+		if (avail > 0) {
+			n = (avail < maxToRead ? avail : maxToRead);
+			memcpy(toFill, &m_prefix[m_prefixPos], n);
+			m_prefixPos += n;
+		}
+		else {
+			n = mp_is->readBytes(toFill, maxToRead);
+		}
+
+		m_pos += n;
+		return n;
+
+	}
+
+#ifdef XSEC_XERCES_INPUTSTREAM_HAS_CONTENTTYPE
+	virtual const XMLCh* getContentType() const {return mp_is->getContentType();}
+#endif
+
+private:
+
+	BinInputStream				* mp_is;
+	URICacheDataType			m_prefix;
+	xsecsize_t					m_prefixPos;
+	xsecsize_t					m_pos;
+
+};
+
+// --------------------------------------------------------------------------------
+//           XSECURICache
+// --------------------------------------------------------------------------------
+
+XSECURICache::XSECURICache(xsecsize_t maxBytes,
+						   unsigned int maxAge,
+						   xsecsize_t maxEntryBytes) {
+
+	XSECnew(mp_state, XSECURICacheState);
+	mp_state->m_maxBytes = maxBytes;
+	mp_state->m_maxEntryBytes = (maxEntryBytes < maxBytes ? maxEntryBytes : maxBytes);
+	mp_state->m_totalBytes = 0;
+	mp_state->m_maxAge = maxAge;
+	mp_state->m_hits = 0;
+	mp_state->m_misses = 0;
+	mp_state->m_digestMemo = false;
+
+}
+
+XSECURICache::~XSECURICache() {
+
+	clear();
+	delete mp_state;
+
+}
+
+void XSECURICache::setDigestMemo(bool flag) {
+
+	XMLMutexLock lock(&mp_state->m_mutex);
+	mp_state->m_digestMemo = flag;
+
+}
+
+bool XSECURICache::getDigestMemo(void) const {
+
+	XMLMutexLock lock(&mp_state->m_mutex);
+	return mp_state->m_digestMemo;
+
+}
+
+void XSECURICache::clear(void) {
+
+	XMLMutexLock lock(&mp_state->m_mutex);
+
+	while (!mp_state->m_lru.empty())
+		removeEntry(mp_state, mp_state->m_lru.front());
+
+}
+
+unsigned int XSECURICache::getHits(void) const {
+
+	XMLMutexLock lock(&mp_state->m_mutex);
+	return mp_state->m_hits;
+
+}
+
+unsigned int XSECURICache::getMisses(void) const {
+
+	XMLMutexLock lock(&mp_state->m_mutex);
+	return mp_state->m_misses;
+
+}
+
+// --------------------------------------------------------------------------------
+//           Constructors and Destructors
+// --------------------------------------------------------------------------------
+
+XSECURIResolverCaching::XSECURIResolverCaching(XSECURIResolver * resolver,
+											   XSECURICache * cache) :
+mp_resolver(NULL),
+mp_cache(cache),
+mp_served(NULL) {
+
+	XSECnew(mp_served, XSECURIServedEntries);
+	mp_resolver = resolver->clone();
+
+}
+
+XSECURIResolverCaching::~XSECURIResolverCaching() {
+
+	{
+		XMLMutexLock lock(&mp_cache->mp_state->m_mutex);
+
+		URICacheMapType::iterator i;
+		for (i = mp_served->m_entries.begin(); i != mp_served->m_entries.end(); ++i)
+			releaseEntry(i->second);
+	}
+
+	delete mp_served;
+
+	if (mp_resolver != NULL)
+		delete mp_resolver;
+
+}
+
+// --------------------------------------------------------------------------------
+//           Interface Methods
+// --------------------------------------------------------------------------------
+
+void XSECURIResolverCaching::setServed(XSECURICacheEntry * entry) {
+
+	// Called with the cache mutex held
+
+	URICacheMapType::iterator i = mp_served->m_entries.find(entry->m_key);
+	if (i != mp_served->m_entries.end()) {
+		if (i->second == entry)
+			return;
+		releaseEntry(i->second);
+		i->second = entry;
+	}
+	else {
+		mp_served->m_entries[entry->m_key] = entry;
+	}
+
+	entry->m_refs++;
+
+}
+
+BinInputStream * XSECURIResolverCaching::resolveURI(const XMLCh * uri) {
+
+	if (uri == NULL)
+		return mp_resolver->resolveURI(uri);
+
+	XSECURICacheState * state = mp_cache->mp_state;
+	std::string key = uriKey(uri);
+	XSECURICacheEntry * stale = NULL;
+	URICacheInputStream * ret;
+
+	{
+		XMLMutexLock lock(&state->m_mutex);
+
+		URICacheMapType::iterator i = state->m_entries.find(key);
+		if (i != state->m_entries.end()) {
+
+			XSECURICacheEntry * e = i->second;
+
+			if (isFresh(state, e)) {
+
+				state->m_hits++;
+				touchEntry(state, e);
+				setServed(e);
+				XSECnew(ret, URICacheInputStream(state, e));
+				return ret;
+
+			}
+
+			// Hold on to it while the validator is checked
+			stale = e;
+			stale->m_refs++;
+
+		}
+	}
+
+	safeBuffer validator;
+
+	if (stale != NULL) {
+
+		bool unchanged = false;
+
+		try {
+			unchanged = stale->m_hasValidator && mp_resolver->getValidator(uri, validator) &&
+				validator.sbStrcmp(stale->m_validator.c_str()) == 0;
+		}
+		catch (...) {
+			// Treat as changed
+		}
+
+		XMLMutexLock lock(&state->m_mutex);
+
+		if (unchanged && stale->m_current) {
+
+			stale->m_checked = time(NULL);
+			state->m_hits++;
+			touchEntry(state, stale);
+			setServed(stale);
+			try {
+				XSECnew(ret, URICacheInputStream(state, stale));
+			}
+			catch (...) {
+				releaseEntry(stale);
+				throw;
+			}
+			releaseEntry(stale);
+			return ret;
+
+		}
+
+		if (stale->m_current)
+			removeEntry(state, stale);
+		releaseEntry(stale);
+
+	}
+
+	// Take the validator before the content, so a change while the
+	// content is being read shows up on the next revalidation
+
+	bool hasValidator = mp_resolver->getValidator(uri, validator);
+
+	BinInputStream * is = mp_resolver->resolveURI(uri);
+	if (is == NULL)
+		return NULL;
+
+	Janitor<BinInputStream> j_is(is);
+
+	URICacheDataType data;
+	XMLByte buf[XSEC_URICACHE_CHUNK];
+	xsecsize_t n;
+	xsecsize_t limit = state->m_maxEntryBytes;
+
+	while ((n = is->readBytes(buf, XSEC_URICACHE_CHUNK)) > 0) {
+
+		data.insert(data.end(), buf, buf + n);
+
+		if ((xsecsize_t) data.size() > limit) {
+
+			// Too large to keep
+			{
+				XMLMutexLock lock(&state->m_mutex);
+				state->m_misses++;
+			}
+
+			URICacheReplayInputStream * replay;
+			XSECnew(replay, URICacheReplayInputStream(data, is));
+			j_is.release();
+			return replay;
+
+		}
+
+	}
+
+	XSECURICacheEntry * entry;
+	XSECnew(entry, XSECURICacheEntry);
+	entry->m_key = key;
+	entry->m_data.swap(data);
+	entry->m_checked = time(NULL);
+	entry->m_hasValidator = hasValidator;
+	if (hasValidator)
+		entry->m_validator = validator.rawCharBuffer();
+	entry->m_refs = 1;
+	entry->m_current = true;
+
+	XMLMutexLock lock(&state->m_mutex);
+
+	state->m_misses++;
+
+	// Another thread may have fetched it at the same time
+	URICacheMapType::iterator i = state->m_entries.find(key);
+	if (i != state->m_entries.end())
+		removeEntry(state, i->second);
+
+	state->m_entries[key] = entry;
+	state->m_lru.push_front(entry);
+	entry->m_lru = state->m_lru.begin();
+	state->m_totalBytes += (xsecsize_t) entry->m_data.size();
+
+	while (state->m_totalBytes > state->m_maxBytes && state->m_lru.back() != entry)
+		removeEntry(state, state->m_lru.back());
+
+	setServed(entry);
+	XSECnew(ret, URICacheInputStream(state, entry));
+
+	return ret;
+
+}
+
+XSECURIResolver * XSECURIResolverCaching::clone(void) {
+
+	XSECURIResolverCaching * ret;
+	XSECnew(ret, XSECURIResolverCaching(mp_resolver, mp_cache));
+	return ret;
+
+}
+
+bool XSECURIResolverCaching::getValidator(const XMLCh * uri, safeBuffer & validator) {
+
+	return mp_resolver->getValidator(uri, validator);
+
+}
+
+// --------------------------------------------------------------------------------
+//           Digest memo
+// --------------------------------------------------------------------------------
+
+bool XSECURIResolverCaching::usesDigestMemo(void) const {
+
+	return mp_cache->getDigestMemo();
+
+}
+
+unsigned int XSECURIResolverCaching::findDigestMemo(const XMLCh * uri,
+													const char * key,
+													XMLByte * toFill,
+													unsigned int maxToFill) {
+
+	if (uri == NULL || key == NULL)
+		return 0;
+
+	XSECURICacheState * state = mp_cache->mp_state;
+	XMLMutexLock lock(&state->m_mutex);
+
+	if (!state->m_digestMemo)
+		return 0;
+
+	URICacheMapType::iterator i = state->m_entries.find(uriKey(uri));
+	if (i == state->m_entries.end() || !isFresh(state, i->second))
+		return 0;
+
+	URICacheMemoType::iterator m = i->second->m_memo.find(key);
+	if (m == i->second->m_memo.end() || m->second.size() > maxToFill)
+		return 0;
+
+	state->m_hits++;
+	touchEntry(state, i->second);
+
+	unsigned int len = (unsigned int) m->second.size();
+	memcpy(toFill, m->second.data(), len);
+
+	return len;
+
+}
+
+void XSECURIResolverCaching::storeDigestMemo(const XMLCh * uri,
+											 const char * key,
+											 const XMLByte * digest,
+											 unsigned int digestLen) {
+
+	if (uri == NULL || key == NULL)
+		return;
+
+	XSECURICacheState * state = mp_cache->mp_state;
+	XMLMutexLock lock(&state->m_mutex);
+
+	if (!state->m_digestMemo)
+		return;
+
+	// Only the entry this resolver served is known to hold the bytes
+	// that were digested
+	URICacheMapType::iterator i = mp_served->m_entries.find(uriKey(uri));
+	if (i == mp_served->m_entries.end() || !i->second->m_current)
+		return;
+
+	i->second->m_memo[key] = std::string((const char *) digest, digestLen);
+
+}
@@ -0,0 +1,209 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * XSEC
+ *
+ * XSECURIResolverCaching := URIResolver decorator that keeps the content
+ *                           of external references in a shared cache
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSECURIRESOLVERCACHING_INCLUDE
+#define XSECURIRESOLVERCACHING_INCLUDE
+
+#include <xsec/framework/XSECURIResolver.hpp>
+
+struct XSECURICacheState;
+struct XSECURICacheEntry;
+struct XSECURIServedEntries;
+
+/**
+ * @ingroup pubsig
+ */
+/*\@{*/
+
+/**
+ * @brief Store for the content of dereferenced URIs.
+ *
+ * Holds the bytes fetched for each URI, keyed on the URI string, for
+ * use by any number of XSECURIResolverCaching objects.  Signatures
+ * clone their resolvers, so the cache lives outside the resolver and
+ * is shared by every clone.  All methods are thread safe.
+ *
+ * The cache is bounded in total size (least recently used entries are
+ * dropped first) and in the size of any one entry (larger documents
+ * are streamed through without being kept).
+ *
+ * Entries older than the maximum age are revalidated before use.  If
+ * the underlying resolver can provide a validator (see
+ * XSECURIResolver::getValidator) and it has not changed, the entry is
+ * kept; otherwise the URI is fetched again.
+ *
+ * If the digest memo is enabled, the digests of external references
+ * are also remembered against the entry, keyed on the transforms and
+ * digest method, so verifying an identical reference again skips the
+ * transforms and hash as well as the fetch.  Memoised digests are
+ * dropped when the content is re-fetched, and are not passed through
+ * the reference logging sink.
+ *
+ * URIs are used as given, so a cache should only be shared between
+ * resolvers that resolve relative URIs against the same base.
+ */
+
+class DSIG_EXPORT XSECURICache {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	/**
+	 * \brief Constructor
+	 *
+	 * @param maxBytes Maximum total size of the cached content
+	 * @param maxAge Seconds before an entry is revalidated (0 to
+	 * revalidate on every use)
+	 * @param maxEntryBytes Largest document that will be cached
+	 */
+
+	XSECURICache(xsecsize_t maxBytes = 16777216,
+		unsigned int maxAge = 300,
+		xsecsize_t maxEntryBytes = 1048576);
+
+	~XSECURICache();
+
+	//@}
+
+	/** @name Configuration */
+	//@{
+
+	/**
+	 * \brief Remember digests of external references
+	 *
+	 * Off by default.
+	 */
+
+	void setDigestMemo(bool flag);
+
+	/**
+	 * \brief Is the digest memo enabled?
+	 */
+
+	bool getDigestMemo(void) const;
+
+	/**
+	 * \brief Drop every entry
+	 */
+
+	void clear(void);
+
+	//@}
+
+	/** @name Statistics */
+	//@{
+
+	/**
+	 * \brief Number of URIs served from the cache
+	 */
+
+	unsigned int getHits(void) const;
+
+	/**
+	 * \brief Number of URIs fetched from the underlying resolver
+	 */
+
+	unsigned int getMisses(void) const;
+
+	//@}
+
+private:
+
+	friend class XSECURIResolverCaching;
+
+	XSECURICacheState			* mp_state;
+
+	// Unimplemented
+	XSECURICache(const XSECURICache &);
+	XSECURICache & operator = (const XSECURICache &);
+
+};
+
+/**
+ * @brief URIResolver that serves repeated URIs from an XSECURICache.
+ *
+ * Wraps another resolver (for example XSECURIResolverXerces or
+ * XSECURIResolverGenericUnix).  URIs not in the cache, or whose entry
+ * is stale, are fetched through the wrapped resolver and added to the
+ * cache.
+ *
+ * Anonymous references (a NULL URI) are never cached.
+ */
+
+class DSIG_EXPORT XSECURIResolverCaching : public XSECURIResolver {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	/**
+	 * \brief Constructor
+	 *
+	 * @param resolver Resolver used to fetch URIs that are not cached.
+	 * It is cloned - the caller retains ownership of the original.
+	 * @param cache The cache to use.  Not owned - it must outlive this
+	 * resolver and all of its clones.
+	 */
+
+	XSECURIResolverCaching(XSECURIResolver * resolver, XSECURICache * cache);
+	virtual ~XSECURIResolverCaching();
+
+	//@}
+
+	/** @name Interface Methods */
+	//@{
+
+	virtual XERCES_CPP_NAMESPACE_QUALIFIER BinInputStream * resolveURI(const XMLCh * uri);
+	virtual XSECURIResolver * clone(void);
+	virtual bool getValidator(const XMLCh * uri, safeBuffer & validator);
+	virtual bool usesDigestMemo(void) const;
+	virtual unsigned int findDigestMemo(const XMLCh * uri, const char * key,
+		XMLByte * toFill, unsigned int maxToFill);
+	virtual void storeDigestMemo(const XMLCh * uri, const char * key,
+		const XMLByte * digest, unsigned int digestLen);
+
+	//@}
+
+private:
+
+	XSECURIResolver				* mp_resolver;		// Fetches uncached URIs
+	XSECURICache				* mp_cache;
+	XSECURIServedEntries		* mp_served;		// Entry last served for each URI
+
+	void setServed(XSECURICacheEntry * entry);
+
+	// Unimplemented
+	XSECURIResolverCaching(const XSECURIResolverCaching &);
+	XSECURIResolverCaching & operator = (const XSECURIResolverCaching &);
+
+};
+
+#endif /* XSECURIRESOLVERCACHING_INCLUDE */
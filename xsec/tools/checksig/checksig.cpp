@@ -28,6 +28,7 @@
 
 #include "AnonymousResolver.hpp"
 #include "InteropResolver.hpp"
+#include "../common/BatchRunner.hpp"
 
 // XSEC
 
@@ -53,6 +54,9 @@
 #include <memory.h>
 #include <string.h>
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <stdio.h>
 #include <stdlib.h>
 
 #if defined(HAVE_UNISTD_H)
@@ -138,7 +142,8 @@ std::ostream& operator<< (std::ostream& target, const XMLCh * s)
 
 void printUsage(void) {
 
-	cerr << "\nUsage: checksig [options] <input file name>\n\n";
+	cerr << "\nUsage: checksig [options] <input file name>\n";
+	cerr << "       checksig [options] --batch/-b <list file> | --dir <directory> ...\n\n";
 	cerr << "     Where options are :\n\n";
 	cerr << "     --skiprefs/-s\n";
 	cerr << "         Skip checking references - check signature only\n\n";
@@ -163,184 +168,55 @@ void printUsage(void) {
 	cerr << "         Use the Windows CAPI crypto provider and hash the <string>\n";
 	cerr << "         into a Windows key using SHA-1\n\n";
 #endif
-	cerr << "     Exits with codes :\n";
+	cerr << "     --batch/-b <list file>\n";
+	cerr << "         Check each file named in <list file> (one per line).  Use \"-\"\n";
+	cerr << "         to read names from stdin as they arrive\n\n";
+	cerr << "     --dir <directory>\n";
+	cerr << "         Check each file in <directory>\n\n";
+	cerr << "     --threads/-t <n>\n";
+	cerr << "         Check batch inputs using <n> threads\n\n";
+	cerr << "     --report/-r <file>\n";
+	cerr << "         Write the batch report to <file> rather than stdout\n\n";
+	cerr << "     In batch mode one line is reported per input :\n";
+	cerr << "         <exit code> TAB <file name> TAB <message>\n\n";
+	cerr << "     Exits with codes (in batch mode the highest seen) :\n";
 	cerr << "         0 = Signature OK\n";
 	cerr << "         1 = Signature Bad\n";
 	cerr << "         2 = Processing error\n";
 
 }
 
-int evaluate(int argc, char ** argv) {
-	
-	char					* filename = NULL;
-	char					* hmacKeyStr = NULL;
-	char					* useIdAttributeNS = NULL;
-	char					* useIdAttributeName = NULL;
-	XSECCryptoKey			* key = NULL;
-	bool					useXSECURIResolver = false;
-	bool                    useAnonymousResolver = false;
-	bool					useInteropResolver = false;
-#if defined (XSEC_HAVE_WINCAPI)
-	HCRYPTPROV				win32CSP = 0;
-#endif
-
-	bool skipRefs = false;
-
-	if (argc < 2) {
-
-		printUsage();
-		return 2;
-	}
-
-	// Run through parameters
-	int paramCount = 1;
-
-	while (paramCount < argc - 1) {
-
-		if (_stricmp(argv[paramCount], "--hmackey") == 0 || _stricmp(argv[paramCount], "-h") == 0) {
-			paramCount++;
-			hmacKeyStr = argv[paramCount++];
-		}
-		else if (_stricmp(argv[paramCount], "--skiprefs") == 0 || _stricmp(argv[paramCount], "-s") == 0) {
-			skipRefs = true;
-			paramCount++;
-		}
-		else if (_stricmp(argv[paramCount], "--xsecresolver") == 0 || _stricmp(argv[paramCount], "-x") == 0) {
-			useXSECURIResolver = true;
-			paramCount++;
-		}
-		else if (_stricmp(argv[paramCount], "--id") == 0) {
-			if (paramCount +1 >= argc) {
-				printUsage();
-				return 2;
-			}
-			paramCount++;
-			useIdAttributeName = argv[paramCount++];
-		}
-		else if (_stricmp(argv[paramCount], "--idns") == 0 || _stricmp(argv[paramCount], "-d") == 0) {
-			if (paramCount +2 >= argc) {
-				printUsage();
-				return 2;
-			}
-			paramCount++;
-			useIdAttributeNS = argv[paramCount++];
-			useIdAttributeName = argv[paramCount++];
-		}
-#if defined (XSEC_HAVE_OPENSSL)
-		else if (_stricmp(argv[paramCount], "--interop") == 0 || _stricmp(argv[paramCount], "-i") == 0) {
-			// Use the interop key resolver
-			useInteropResolver = true;
-			paramCount++;
-		}
-#endif
-		else if (_stricmp(argv[paramCount], "--anonymousresolver") == 0 || _stricmp(argv[paramCount], "-a") ==0) {
-			useAnonymousResolver = true;
-			paramCount++;
-		}
-#if defined (XSEC_HAVE_WINCAPI)
-		else if (_stricmp(argv[paramCount], "--wincapi") == 0 || _stricmp(argv[paramCount], "-w") == 0 ||
-			_stricmp(argv[paramCount], "--winhmackey") == 0 || _stricmp(argv[paramCount], "-wh") == 0) {
-
-			WinCAPICryptoProvider * cp = new WinCAPICryptoProvider();
-			XSECPlatformUtils::SetCryptoProvider(cp);
-
-			if (_stricmp(argv[paramCount], "--winhmackey") == 0 || _stricmp(argv[paramCount], "-wh") == 0) {
-
-				// Create a SHA-1 based key based on the <string> parameter
-
-				paramCount++;
-
-				if (!CryptAcquireContext(&win32CSP,
-					NULL,
-					NULL,
-					PROV_RSA_FULL,
-					CRYPT_VERIFYCONTEXT)) 
-				{
-					cerr << "Error obtaining default RSA_PROV" << endl;
-					return 2;
-				}
-
-				HCRYPTKEY k;
-				HCRYPTHASH h;
-				BOOL fResult = CryptCreateHash(
-					win32CSP,
-					CALG_SHA,
-					0,
-					0,
-					&h);
-
-				if (fResult == 0) {
-					cerr << "Error creating hash to create windows hmac key from password" << endl;
-					return 2;
-				}
-				fResult = CryptHashData(
-					h,
-					(unsigned char *) argv[paramCount],
-					(DWORD) strlen(argv[paramCount]),
-					0);
-				
-				if (fResult == 0) {
-					cerr << "Error hashing password to create windows hmac key" << endl;
-					return 2;
-				}
-
-				// Now create a key
-				fResult = CryptDeriveKey(
-					win32CSP,
-					CALG_RC2,
-					h,
-					CRYPT_EXPORTABLE,
-					&k);
-
-				if (fResult == 0) {
-					cerr << "Error deriving key from hash value" << endl;
-					return 2;
-				}
-
-				// Wrap in a WinCAPI object
-				WinCAPICryptoKeyHMAC * hk;
-				hk = new WinCAPICryptoKeyHMAC(win32CSP);
-				hk->setWinKey(k); 
-
-				key = hk;
-
-				CryptDestroyHash(h);
-
-			}
-
-			paramCount++;
+// ----------------------------------------------------------------------------
+//           Options shared by every file checked
+// ----------------------------------------------------------------------------
 
-		}
-#endif
-		else {
-			cerr << "Unknown option: " << argv[paramCount] << endl << endl;
-			printUsage();
-			return 2;
-		}
-	}
+struct CheckSigOptions {
 
-#if defined (XSEC_HAVE_WINCAPI) && !defined(XSEC_HAVE_OPENSSL)
+	char					* useIdAttributeNS;
+	char					* useIdAttributeName;
+	XSECCryptoKey			* key;					// Cloned into each signature
+	bool					useXSECURIResolver;
+	bool					useAnonymousResolver;
+	bool					useInteropResolver;
+	bool					skipRefs;
 
-	// Use default DSS provider
-	WinCAPICryptoProvider * cp = new WinCAPICryptoProvider();
-	XSECPlatformUtils::SetCryptoProvider(cp);
+};
 
-#endif
+static CheckSigOptions g_options;
 
-	if (paramCount >= argc) {
-		printUsage();
-		return 2;
-	}
+static void transcodeMessage(const XMLCh * src, std::string & msg) {
 
-	filename = argv[paramCount];
+	char * m = XMLString::transcode(src);
+	msg += m;
+	XSEC_RELEASE_XMLCH(m);
 
-	// Create and set up the parser
+}
 
-	XercesDOMParser * parser = new XercesDOMParser;
-	Janitor<XercesDOMParser> j_parser(parser);
+// ----------------------------------------------------------------------------
+//           Check a single file
+// ----------------------------------------------------------------------------
 
-	parser->setDoNamespaces(true);
-	parser->setCreateEntityReferenceNodes(true);
+int verifyFile(XercesDOMParser * parser, const char * filename, std::string & msg) {
 
 	// Now parse out file
 
@@ -356,22 +232,26 @@ int evaluate(int argc, char ** argv) {
 
     catch (const XMLException& e)
     {
-        cerr << "An error occured during parsing\n   Message: "
-             << e.getMessage() << endl;
+        msg = "An error occured during parsing\n   Message: ";
+        transcodeMessage(e.getMessage(), msg);
         errorsOccured = true;
     }
 
 
     catch (const DOMException& e)
     {
-       cerr << "A DOM error occured during parsing\n   DOMException code: "
-             << e.code << endl;
+        char code[20];
+        sprintf(code, "%d", (int) e.code);
+        msg = "A DOM error occured during parsing\n   DOMException code: ";
+        msg += code;
         errorsOccured = true;
     }
 
 	if (errorsOccured) {
 
-		cout << "Errors during parse" << endl;
+		if (msg.empty())
+			msg = "Errors during parse";
+		parser->resetDocumentPool();
 		return (2);
 
 	}
@@ -395,10 +275,16 @@ int evaluate(int argc, char ** argv) {
 
 	if (sigNode == 0) {
 
-		cerr << "Could not find <Signature> node in " << argv[argc-1] << endl;
+		msg = "Could not find <Signature> node in ";
+		msg += filename;
+		parser->resetDocumentPool();
 		return 2;
 	}
 
+	int retResult;
+
+	{
+
 	XSECProvider prov;
 	XSECKeyInfoResolverDefault theKeyInfoResolver;
 
@@ -410,22 +296,22 @@ int evaluate(int argc, char ** argv) {
 	sig->setKeyInfoResolver(&theKeyInfoResolver);
 
 	// Register defined attribute name
-	if (useIdAttributeName != NULL) {
+	if (g_options.useIdAttributeName != NULL) {
         sig->setIdByAttributeName(true);
-        if (useIdAttributeNS != NULL) {
-		    sig->registerIdAttributeNameNS(MAKE_UNICODE_STRING(useIdAttributeNS), 
-									       MAKE_UNICODE_STRING(useIdAttributeName));
+        if (g_options.useIdAttributeNS != NULL) {
+		    sig->registerIdAttributeNameNS(MAKE_UNICODE_STRING(g_options.useIdAttributeNS), 
+									       MAKE_UNICODE_STRING(g_options.useIdAttributeName));
         } else {
-            sig->registerIdAttributeName(MAKE_UNICODE_STRING(useIdAttributeName));
+            sig->registerIdAttributeName(MAKE_UNICODE_STRING(g_options.useIdAttributeName));
         }
     }
 
 	// Check whether we should use the internal resolver
 
 	
-	if (useXSECURIResolver == true || 
-		useAnonymousResolver == true ||
-		useInteropResolver == true) {
+	if (g_options.useXSECURIResolver == true || 
+		g_options.useAnonymousResolver == true ||
+		g_options.useInteropResolver == true) {
 
 #if defined(_WIN32)
 		XSECURIResolverGenericWin32 
@@ -479,18 +365,18 @@ int evaluate(int argc, char ** argv) {
 		free(baseURI);
 #endif
 
-		if (useAnonymousResolver == true) {
+		if (g_options.useAnonymousResolver == true) {
 			// AnonymousResolver takes precedence
 			theAnonymousResolver.setBaseURI(baseURIXMLCh);
 			sig->setURIResolver(&theAnonymousResolver);
 		}
-		else if (useXSECURIResolver == true) {
+		else if (g_options.useXSECURIResolver == true) {
 			theResolver.setBaseURI(baseURIXMLCh);
 			sig->setURIResolver(&theResolver);
 		}
 
 #if defined (XSEC_HAVE_OPENSSL)
-		if (useInteropResolver == true) {
+		if (g_options.useInteropResolver == true) {
 
 			InteropResolver ires(&(baseURIXMLCh[8]));
 			sig->setKeyInfoResolver(&ires);
@@ -507,82 +393,391 @@ int evaluate(int argc, char ** argv) {
 
 	try {
 
-		// Load a key if necessary
-		if (hmacKeyStr != NULL) {
+		// The key is shared by every file, so each signature gets a copy
+		if (g_options.key != NULL) {
 
-			XSECCryptoKeyHMAC * hmacKey = XSECPlatformUtils::g_cryptoProvider->keyHMAC();
-			hmacKey->setKey((unsigned char *) hmacKeyStr, (unsigned int) strlen(hmacKeyStr));
-			sig->setSigningKey(hmacKey);
-
-		}
-		else if (key != NULL) {
-
-			sig->setSigningKey(key);
+			sig->setSigningKey(g_options.key->clone());
 
 		}
 
 		sig->load();
-		if (skipRefs)
+		if (g_options.skipRefs)
 			result = sig->verifySignatureOnly();
 		else
 			result = sig->verify();
 	}
 
 	catch (XSECException &e) {
-		char * msg = XMLString::transcode(e.getMsg());
-		cerr << "An error occured during signature verification\n   Message: "
-		<< msg << endl;
-		XSEC_RELEASE_XMLCH(msg);
+		msg = "An error occured during signature verification\n   Message: ";
+		transcodeMessage(e.getMsg(), msg);
 		errorsOccured = true;
-		return 2;
+		result = false;
 	}
 	catch (XSECCryptoException &e) {
-		cerr << "An error occured during signature verification\n   Message: "
-		<< e.getMsg() << endl;
+		msg = "An error occured during signature verification\n   Message: ";
+		msg += e.getMsg();
 		errorsOccured = true;
+		result = false;
 
 #if defined (XSEC_HAVE_OPENSSL)
-		ERR_load_crypto_strings();
-		BIO * bio_err;
-		if ((bio_err=BIO_new(BIO_s_file())) != NULL)
-			BIO_set_fp(bio_err,stderr,BIO_NOCLOSE|BIO_FP_TEXT);
+		// Errors are queued per thread, so this only picks up our own
+		unsigned long err;
+		char errBuf[256];
+		while ((err = ERR_get_error()) != 0) {
+			ERR_error_string_n(err, errBuf, 256);
+			msg += "\n   ";
+			msg += errBuf;
+		}
+#endif
+	}
+
+	if (errorsOccured) {
+		retResult = 2;
+	}
+	else if (result) {
+		msg = "Signature verified OK!";
+		retResult = 0;
+	}
+	else {
+		msg = "Signature failed verification\n";
+		transcodeMessage(sig->getErrMsgs(), msg);
+		retResult = 1;
+	}
+
+	}
+
+	// Signature has gone with the provider - now drop the document
+	parser->resetDocumentPool();
+
+	return retResult;
+
+}
+
+// ----------------------------------------------------------------------------
+//           Batch mode
+// ----------------------------------------------------------------------------
+
+class CheckSigWorker : public BatchWorker {
+
+public:
+
+	CheckSigWorker() {
+
+		// One parser per thread, reused for every file it checks
+		mp_parser = new XercesDOMParser;
+		mp_parser->setDoNamespaces(true);
+		mp_parser->setCreateEntityReferenceNodes(true);
+
+	}
+
+	virtual ~CheckSigWorker() {
+
+		delete mp_parser;
+
+	}
+
+	virtual int process(const char * filename, std::string & message) {
+
+		return verifyFile(mp_parser, filename, message);
+
+	}
+
+private:
+
+	XercesDOMParser			* mp_parser;
+
+};
+
+class CheckSigWorkerFactory : public BatchWorkerFactory {
+
+public:
+
+	virtual BatchWorker * newWorker(void) {
+
+		return new CheckSigWorker;
+
+	}
+
+};
 
-		ERR_print_errors(bio_err);
+// ----------------------------------------------------------------------------
+//           Evaluate the command line
+// ----------------------------------------------------------------------------
+
+int evaluate(int argc, char ** argv) {
+	
+	char					* filename = NULL;
+	char					* hmacKeyStr = NULL;
+	char					* reportFile = NULL;
+	XSECCryptoKey			* key = NULL;
+	bool					batchMode = false;
+	unsigned int			threads = 1;
+#if defined (XSEC_HAVE_WINCAPI)
+	HCRYPTPROV				win32CSP = 0;
 #endif
+
+	CheckSigWorkerFactory	factory;
+	std::ofstream			reportStream;
+	BatchRunner				runner(&factory);
+
+	g_options.useIdAttributeNS = NULL;
+	g_options.useIdAttributeName = NULL;
+	g_options.key = NULL;
+	g_options.useXSECURIResolver = false;
+	g_options.useAnonymousResolver = false;
+	g_options.useInteropResolver = false;
+	g_options.skipRefs = false;
+
+	if (argc < 2) {
+
+		printUsage();
 		return 2;
 	}
 
-#if 0
-	catch (...) {
+	// Run through parameters.  In single file mode the last parameter
+	// is always the input file
+	int paramCount = 1;
 
-		cerr << "Unknown Exception type occured.  Cleaning up and exiting\n" << endl;
+	while (paramCount < argc) {
 
-		return 2;
+		if (paramCount == argc - 1 && !batchMode) {
+			filename = argv[paramCount++];
+		}
+		else if (_stricmp(argv[paramCount], "--hmackey") == 0 || _stricmp(argv[paramCount], "-h") == 0) {
+			if (paramCount +1 >= argc) {
+				printUsage();
+				return 2;
+			}
+			paramCount++;
+			hmacKeyStr = argv[paramCount++];
+		}
+		else if (_stricmp(argv[paramCount], "--skiprefs") == 0 || _stricmp(argv[paramCount], "-s") == 0) {
+			g_options.skipRefs = true;
+			paramCount++;
+		}
+		else if (_stricmp(argv[paramCount], "--xsecresolver") == 0 || _stricmp(argv[paramCount], "-x") == 0) {
+			g_options.useXSECURIResolver = true;
+			paramCount++;
+		}
+		else if (_stricmp(argv[paramCount], "--id") == 0) {
+			if (paramCount +1 >= argc) {
+				printUsage();
+				return 2;
+			}
+			paramCount++;
+			g_options.useIdAttributeName = argv[paramCount++];
+		}
+		else if (_stricmp(argv[paramCount], "--idns") == 0 || _stricmp(argv[paramCount], "-d") == 0) {
+			if (paramCount +2 >= argc) {
+				printUsage();
+				return 2;
+			}
+			paramCount++;
+			g_options.useIdAttributeNS = argv[paramCount++];
+			g_options.useIdAttributeName = argv[paramCount++];
+		}
+		else if (_stricmp(argv[paramCount], "--batch") == 0 || _stricmp(argv[paramCount], "-b") == 0) {
+			if (paramCount +1 >= argc) {
+				printUsage();
+				return 2;
+			}
+			paramCount++;
+			if (!runner.addList(argv[paramCount])) {
+				cerr << "Error opening list file " << argv[paramCount] << endl;
+				return 2;
+			}
+			paramCount++;
+			batchMode = true;
+		}
+		else if (_stricmp(argv[paramCount], "--dir") == 0) {
+			if (paramCount +1 >= argc) {
+				printUsage();
+				return 2;
+			}
+			paramCount++;
+			if (!runner.addDirectory(argv[paramCount])) {
+				cerr << "Error reading directory " << argv[paramCount] << endl;
+				return 2;
+			}
+			paramCount++;
+			batchMode = true;
+		}
+		else if (_stricmp(argv[paramCount], "--threads") == 0 || _stricmp(argv[paramCount], "-t") == 0) {
+			if (paramCount +1 >= argc) {
+				printUsage();
+				return 2;
+			}
+			paramCount++;
+			threads = atoi(argv[paramCount++]);
+		}
+		else if (_stricmp(argv[paramCount], "--report") == 0 || _stricmp(argv[paramCount], "-r") == 0) {
+			if (paramCount +1 >= argc) {
+				printUsage();
+				return 2;
+			}
+			paramCount++;
+			reportFile = argv[paramCount++];
+		}
+#if defined (XSEC_HAVE_OPENSSL)
+		else if (_stricmp(argv[paramCount], "--interop") == 0 || _stricmp(argv[paramCount], "-i") == 0) {
+			// Use the interop key resolver
+			g_options.useInteropResolver = true;
+			paramCount++;
+		}
+#endif
+		else if (_stricmp(argv[paramCount], "--anonymousresolver") == 0 || _stricmp(argv[paramCount], "-a") ==0) {
+			g_options.useAnonymousResolver = true;
+			paramCount++;
+		}
+#if defined (XSEC_HAVE_WINCAPI)
+		else if (_stricmp(argv[paramCount], "--wincapi") == 0 || _stricmp(argv[paramCount], "-w") == 0 ||
+			_stricmp(argv[paramCount], "--winhmackey") == 0 || _stricmp(argv[paramCount], "-wh") == 0) {
+
+			WinCAPICryptoProvider * cp = new WinCAPICryptoProvider();
+			XSECPlatformUtils::SetCryptoProvider(cp);
+
+			if (_stricmp(argv[paramCount], "--winhmackey") == 0 || _stricmp(argv[paramCount], "-wh") == 0) {
+
+				// Create a SHA-1 based key based on the <string> parameter
 
+				paramCount++;
+
+				if (!CryptAcquireContext(&win32CSP,
+					NULL,
+					NULL,
+					PROV_RSA_FULL,
+					CRYPT_VERIFYCONTEXT)) 
+				{
+					cerr << "Error obtaining default RSA_PROV" << endl;
+					return 2;
+				}
+
+				HCRYPTKEY k;
+				HCRYPTHASH h;
+				BOOL fResult = CryptCreateHash(
+					win32CSP,
+					CALG_SHA,
+					0,
+					0,
+					&h);
+
+				if (fResult == 0) {
+					cerr << "Error creating hash to create windows hmac key from password" << endl;
+					return 2;
+				}
+				fResult = CryptHashData(
+					h,
+					(unsigned char *) argv[paramCount],
+					(DWORD) strlen(argv[paramCount]),
+					0);
+				
+				if (fResult == 0) {
+					cerr << "Error hashing password to create windows hmac key" << endl;
+					return 2;
+				}
+
+				// Now create a key
+				fResult = CryptDeriveKey(
+					win32CSP,
+					CALG_RC2,
+					h,
+					CRYPT_EXPORTABLE,
+					&k);
+
+				if (fResult == 0) {
+					cerr << "Error deriving key from hash value" << endl;
+					return 2;
+				}
+
+				// Wrap in a WinCAPI object
+				WinCAPICryptoKeyHMAC * hk;
+				hk = new WinCAPICryptoKeyHMAC(win32CSP);
+				hk->setWinKey(k); 
+
+				key = hk;
+
+				CryptDestroyHash(h);
+
+			}
+
+			paramCount++;
+
+		}
+#endif
+		else {
+			cerr << "Unknown option: " << argv[paramCount] << endl << endl;
+			printUsage();
+			return 2;
+		}
 	}
+
+#if defined (XSEC_HAVE_WINCAPI) && !defined(XSEC_HAVE_OPENSSL)
+
+	// Use default DSS provider
+	WinCAPICryptoProvider * cp = new WinCAPICryptoProvider();
+	XSECPlatformUtils::SetCryptoProvider(cp);
+
 #endif
+
+	if (filename == NULL && !batchMode) {
+		printUsage();
+		return 2;
+	}
+
+	// Load the key once - each signature gets its own copy
+
+	if (hmacKeyStr != NULL) {
+
+		XSECCryptoKeyHMAC * hmacKey = XSECPlatformUtils::g_cryptoProvider->keyHMAC();
+		hmacKey->setKey((unsigned char *) hmacKeyStr, (unsigned int) strlen(hmacKeyStr));
+		delete key;
+		key = hmacKey;
+
+	}
+
+	g_options.key = key;
+
 	int retResult;
 
+	if (batchMode) {
+
+		if (reportFile != NULL) {
+			reportStream.open(reportFile);
+			if (!reportStream.is_open()) {
+				cerr << "Error opening report file " << reportFile << endl;
+				delete key;
+				return 2;
+			}
+			runner.setReport(&reportStream);
+		}
+
+		runner.setThreads(threads);
+		retResult = runner.run();
 
-	if (result) {
-		cout << "Signature verified OK!" << endl;
-		retResult = 0;
 	}
 	else {
-		cout << "Signature failed verification" << endl;
-		char * e = XMLString::transcode(sig->getErrMsgs());
-		cout << e << endl;
-		XSEC_RELEASE_XMLCH(e);
-		retResult = 1;
+
+		CheckSigWorker worker;
+		std::string msg;
+
+		retResult = worker.process(filename, msg);
+
+		if (retResult == 2)
+			cerr << msg << endl;
+		else
+			cout << msg << endl;
+
 	}
 
+	delete key;
+	g_options.key = NULL;
+
 #if defined (XSEC_HAVE_WINCAPI)
 	// Clean up the handle to the CSP
 	if (win32CSP != 0)
 		CryptReleaseContext(win32CSP, 0);
 #endif
 
-	// Janitor will clean up the parser
 	return retResult;
 
 }
@@ -41,6 +41,7 @@
 #include <xsec/xenc/XENCEncryptedKey.hpp>
 
 #include "XencInteropResolver.hpp"
+#include "../common/BatchRunner.hpp"
 
 // ugly :<
 
@@ -56,6 +57,8 @@
 #include <string.h>
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <stdio.h>
 #include <stdlib.h>
 
 #if defined(HAVE_UNISTD_H)
@@ -157,7 +160,8 @@ std::ostream& operator<< (std::ostream& target, const XMLCh * s)
 
 void printUsage(void) {
 
-    cerr << "\nUsage: cipher [options] <input file name>\n\n";
+    cerr << "\nUsage: cipher [options] <input file name>\n";
+    cerr << "       cipher [options] --batch/-b <list file> | --dir <directory> ...\n\n";
     cerr << "     Where options are :\n\n";
     cerr << "     --decrypt/-d\n";
     cerr << "         Operate in decrypt mode (default) - outputs the decrypted octet stream\n";
@@ -199,35 +203,433 @@ void printUsage(void) {
     cerr << "         Force use of NSS Crypto API\n";
 #endif
 
-    cerr << "\n     Exits with codes :\n";
+    cerr << "     --batch/-b <list file>\n";
+    cerr << "         Process each file named in <list file> (one per line).  Use \"-\"\n";
+    cerr << "         to read names from stdin as they arrive\n";
+    cerr << "     --dir <directory>\n";
+    cerr << "         Process each file in <directory>\n";
+    cerr << "     --threads/-t <n>\n";
+    cerr << "         Process batch inputs using <n> threads\n";
+    cerr << "     --report/-r <file>\n";
+    cerr << "         Write the batch report to <file> rather than stdout\n";
+    cerr << "     --out-suffix/-os <suffix>\n";
+    cerr << "         In batch mode the output for each input is written to the input\n";
+    cerr << "         file name with <suffix> appended (default \".out\")\n";
+    cerr << "\n     In batch mode one line is reported per input :\n";
+    cerr << "         <exit code> TAB <file name> TAB <output file or message>\n";
+
+    cerr << "\n     Exits with codes (in batch mode the highest seen) :\n";
     cerr << "         0 = Decrypt/Encrypt OK\n";
     cerr << "         1 = Decrypt/Encrypt failed\n";
     cerr << "         2 = Processing error\n";
 
 }
 
+// ----------------------------------------------------------------------------
+//           Options shared by every file processed
+// ----------------------------------------------------------------------------
+
+struct CipherOptions {
+
+    bool                    doDecrypt;
+    bool                    doDecryptElement;
+    bool                    useInteropResolver;
+    bool                    encryptFileAsData;
+    bool                    parseXMLInput;
+    bool                    doXMLOutput;
+    XSECCryptoKey           * kek;                  // Cloned into each cipher
+    XSECCryptoKey           * key;
+    encryptionMethod        kekAlg;
+    encryptionMethod        keyAlg;
+    const char              * outSuffix;            // Batch output naming
+
+};
+
+static CipherOptions g_options;
+
+static void transcodeMessage(const XMLCh * src, std::string & msg) {
+
+    char * m = XMLString::transcode(src);
+    msg += m;
+    XSEC_RELEASE_XMLCH(m);
+
+}
+
+// ----------------------------------------------------------------------------
+//           Process a single file
+// ----------------------------------------------------------------------------
+
+int processFile(XercesDOMParser * parser, const char * filename,
+                XMLFormatTarget * formatTarget, std::string & msg) {
+
+    bool                    errorsOccured = false;
+    unsigned char           * keyStr = NULL;
+    int                     keyLen = 0;
+    encryptionMethod        keyAlg = g_options.keyAlg;
+    unsigned char           keyBuf[24];
+    DOMDocument             *doc;
+
+    if (g_options.parseXMLInput) {
+
+        // Now parse out file
+
+        xsecsize_t errorCount = 0;
+        try
+        {
+            parser->parse(filename);
+            errorCount = parser->getErrorCount();
+            if (errorCount > 0)
+                errorsOccured = true;
+        }
+
+        catch (const XMLException& e)
+        {
+            msg = "An error occured during parsing\n   Message: ";
+            transcodeMessage(e.getMessage(), msg);
+            errorsOccured = true;
+        }
+
+
+        catch (const DOMException& e)
+        {
+            char code[20];
+            sprintf(code, "%d", (int) e.code);
+            msg = "A DOM error occured during parsing\n   DOMException code: ";
+            msg += code;
+            errorsOccured = true;
+        }
+
+        if (errorsOccured) {
+
+            if (msg.empty())
+                msg = "Errors during parse";
+            parser->resetDocumentPool();
+            return (2);
+
+        }
+
+        /*
+
+            Now that we have the parsed file, get the DOM document and start looking at it
+
+        */
+        
+        doc = parser->adoptDocument();
+    }
+
+    else {
+        // Create an empty document
+        XMLCh tempStr[100];
+        XMLString::transcode("Core", tempStr, 99);    
+        DOMImplementation *impl = DOMImplementationRegistry::getDOMImplementation(tempStr);
+        doc = impl->createDocument(
+            0,                    // root element namespace URI.
+            MAKE_UNICODE_STRING("ADoc"),            // root element name
+            NULL);// DOMDocumentType());  // document type object (DTD).
+    }
+
+
+    XSECProvider prov;
+    XENCCipher * cipher = prov.newCipher(doc);
+
+    // The keys are shared by every file, so each cipher gets a copy
+    if (g_options.kek != NULL)
+        cipher->setKEK(g_options.kek->clone());
+    if (g_options.key != NULL)
+        cipher->setKey(g_options.key->clone());
+
+    try {
+
+        if (g_options.doDecrypt) {
+
+            if (g_options.useInteropResolver == true) {
+
+                // Map out base path of the file
+#if XSEC_HAVE_GETCWD_DYN
+                char *path = getcwd(NULL, 0);
+                char *baseURI = (char*)malloc(strlen(path) + 8 + 1 + strlen(filename) + 1);
+#else
+                char path[PATH_MAX];
+                char baseURI[(PATH_MAX * 2) + 10];
+                getcwd(path, PATH_MAX);
+#endif
+                strcpy(baseURI, "file:///");        
+
+                // Ugly and nasty but quick
+                if (filename[0] != '\\' && filename[0] != '/' && filename[1] != ':') {
+                    strcat(baseURI, path);
+                    strcat(baseURI, "/");
+                } else if (path[1] == ':') {
+                    path[2] = '\0';
+                    strcat(baseURI, path);
+                }
+
+                strcat(baseURI, filename);
+
+                // Find any ':' and "\" characters
+                int lastSlash = 0;
+                for (unsigned int i = 8; i < strlen(baseURI); ++i) {
+                    if (baseURI[i] == '\\') {
+                        lastSlash = i;
+                        baseURI[i] = '/';
+                    }
+                    else if (baseURI[i] == '/')
+                        lastSlash = i;
+                }
+
+                // The last "\\" must prefix the filename
+                baseURI[lastSlash + 1] = '\0';
+
+                XMLCh * uriT = XMLString::transcode(baseURI);
+#if XSEC_HAVE_GETCWD_DYN
+                free(path);
+                free(baseURI);
+#endif
+
+                XencInteropResolver ires(doc, &(uriT[8]));
+                XSEC_RELEASE_XMLCH(uriT);
+                cipher->setKeyInfoResolver(&ires);
+
+            }
+            // Find the EncryptedData node
+            DOMNode * n = findXENCNode(doc, "EncryptedData");
+
+            if (g_options.doDecryptElement) {
+                while (n != NULL) {
+
+                    // decrypt
+                    cipher->decryptElement(static_cast<DOMElement *>(n));
+
+                    // Find the next EncryptedData node
+                    n = findXENCNode(doc, "EncryptedData");
+                }
+
+            }
+            else {
+                XSECBinTXFMInputStream * bis = cipher->decryptToBinInputStream(static_cast<DOMElement *>(n));
+                Janitor<XSECBinTXFMInputStream> j_bis(bis);
+    
+                XMLByte buf[1024];          
+                xsecsize_t read = bis->readBytes(buf, 1023);
+                while (read > 0) {
+                    formatTarget->writeChars(buf, read, NULL);
+                    read = bis->readBytes(buf, 1023);
+                }
+            }
+        }
+        else {
+
+            XENCEncryptedData *xenc = NULL;
+            // Encrypting
+            if (g_options.kek != NULL && g_options.key == NULL) {
+                XSECPlatformUtils::g_cryptoProvider->getRandom(keyBuf, 24);
+                XSECCryptoSymmetricKey * k = 
+                    XSECPlatformUtils::g_cryptoProvider->keySymmetric(XSECCryptoSymmetricKey::KEY_3DES_192);
+                k->setKey(keyBuf, 24);
+                cipher->setKey(k);
+                keyAlg = ENCRYPT_3DES_CBC;
+                keyStr = keyBuf;
+                keyLen = 24;
+            }
+
+            if (g_options.encryptFileAsData) {
+
+                // Create a BinInputStream
+#if defined(XSEC_XERCES_REQUIRES_MEMMGR)
+                BinFileInputStream * is = new BinFileInputStream(filename, XMLPlatformUtils::fgMemoryManager);
+#else
+                BinFileInputStream * is = new BinFileInputStream(filename);
+#endif
+                xenc = cipher->encryptBinInputStream(is, keyAlg);
+
+                // Replace the document element
+                DOMElement * elt = doc->getDocumentElement();
+                doc->replaceChild(xenc->getElement(), elt);
+                elt->release();
+            }
+            else {
+                // Document encryption
+                cipher->encryptElement(doc->getDocumentElement(), keyAlg);
+            }
+
+            // Do we encrypt a created key?
+            if (g_options.kek != NULL && xenc != NULL) {
+                XENCEncryptedKey *xkey = cipher->encryptKey(keyStr, keyLen, g_options.kekAlg);
+                // Add to the EncryptedData
+                xenc->appendEncryptedKey(xkey);
+            }
+        }
+
+        if (g_options.doXMLOutput) {
+            // Output the result
+
+            XMLCh core[] = {
+                XERCES_CPP_NAMESPACE_QUALIFIER chLatin_C,
+                XERCES_CPP_NAMESPACE_QUALIFIER chLatin_o,
+                XERCES_CPP_NAMESPACE_QUALIFIER chLatin_r,
+                XERCES_CPP_NAMESPACE_QUALIFIER chLatin_e,
+                XERCES_CPP_NAMESPACE_QUALIFIER chNull
+            };
+
+            DOMImplementation *impl = DOMImplementationRegistry::getDOMImplementation(core);
+
+#if defined (XSEC_XERCES_DOMLSSERIALIZER)
+            // DOM L3 version as per Xerces 3.0 API
+            DOMLSSerializer   *theSerializer = ((DOMImplementationLS*)impl)->createLSSerializer();
+            Janitor<DOMLSSerializer> j_theSerializer(theSerializer);
+            
+            // Get the config so we can set up pretty printing
+            DOMConfiguration *dc = theSerializer->getDomConfig();
+            dc->setParameter(XMLUni::fgDOMWRTFormatPrettyPrint, false);
+
+            // Now create an output object to format to UTF-8
+            DOMLSOutput *theOutput = ((DOMImplementationLS*)impl)->createLSOutput();
+            Janitor<DOMLSOutput> j_theOutput(theOutput);
+
+            theOutput->setEncoding(MAKE_UNICODE_STRING("UTF-8"));
+            theOutput->setByteStream(formatTarget);
+
+            theSerializer->write(doc, theOutput);
+
+#else           
+            DOMWriter         *theSerializer = ((DOMImplementationLS*)impl)->createDOMWriter();
+            Janitor<DOMWriter> j_theSerializer(theSerializer);
+
+            theSerializer->setEncoding(MAKE_UNICODE_STRING("UTF-8"));
+            if (theSerializer->canSetFeature(XMLUni::fgDOMWRTFormatPrettyPrint, false))
+                theSerializer->setFeature(XMLUni::fgDOMWRTFormatPrettyPrint, false);
+
+            theSerializer->writeNode(formatTarget, *doc);
+#endif  
+
+        }
+    }
+
+    catch (XSECException &e) {
+        msg = "An error occured during encryption/decryption operation\n   Message: ";
+        transcodeMessage(e.getMsg(), msg);
+        errorsOccured = true;
+    }
+    catch (XSECCryptoException &e) {
+        msg = "An error occured during encryption/decryption operation\n   Message: ";
+        msg += e.getMsg();
+        errorsOccured = true;
+
+#if defined (XSEC_HAVE_OPENSSL)
+        // Errors are queued per thread, so this only picks up our own
+        unsigned long err;
+        char errBuf[256];
+        while ((err = ERR_get_error()) != 0) {
+            ERR_error_string_n(err, errBuf, 256);
+            msg += "\n   ";
+            msg += errBuf;
+        }
+#endif
+    }
+    
+    doc->release();
+    return (errorsOccured ? 2 : 0);
+
+}
+
+// ----------------------------------------------------------------------------
+//           Batch mode
+// ----------------------------------------------------------------------------
+
+class CipherWorker : public BatchWorker {
+
+public:
+
+    CipherWorker() {
+
+        // One parser per thread, reused for every file it handles
+        mp_parser = new XercesDOMParser;
+        mp_parser->setDoNamespaces(true);
+        mp_parser->setCreateEntityReferenceNodes(true);
+
+    }
+
+    virtual ~CipherWorker() {
+
+        delete mp_parser;
+
+    }
+
+    virtual int process(const char * filename, std::string & message) {
+
+        // Each input is written alongside the original
+
+        std::string outName(filename);
+        outName += g_options.outSuffix;
+
+        LocalFileFormatTarget * formatTarget;
+        try {
+            formatTarget = new LocalFileFormatTarget(outName.c_str());
+        }
+        catch (const XMLException &) {
+            message = "Error opening output file ";
+            message += outName;
+            return 2;
+        }
+        Janitor<LocalFileFormatTarget> j_formatTarget(formatTarget);
+
+        int ret = processFile(mp_parser, filename, formatTarget, message);
+        if (ret == 0)
+            message = outName;
+
+        return ret;
+
+    }
+
+private:
+
+    XercesDOMParser         * mp_parser;
+
+};
+
+class CipherWorkerFactory : public BatchWorkerFactory {
+
+public:
+
+    virtual BatchWorker * newWorker(void) {
+
+        return new CipherWorker;
+
+    }
+
+};
+
+// ----------------------------------------------------------------------------
+//           Evaluate the command line
+// ----------------------------------------------------------------------------
+
 int evaluate(int argc, char ** argv) {
     
     char                    * filename = NULL;
     char                    * outfile = NULL;
-    unsigned char           * keyStr = NULL;
+    char                    * reportFile = NULL;
     bool                    doDecrypt = true;
-    bool                    errorsOccured = false;
     bool                    doDecryptElement = false;
     bool                    useInteropResolver = false;
     bool                    encryptFileAsData = false;
     bool                    parseXMLInput = true;
     bool                    doXMLOutput = false;
     bool                    isXKMSKey = false;
+    bool                    batchMode = false;
+    unsigned int            threads = 1;
     XSECCryptoKey           * kek = NULL;
     XSECCryptoKey           * key = NULL;
     int                     keyLen = 0;
     encryptionMethod        kekAlg = ENCRYPT_NONE;
     encryptionMethod        keyAlg = ENCRYPT_NONE;
-    DOMDocument             *doc;
-    unsigned char           keyBuf[24];
     XMLFormatTarget         *formatTarget ;
 
+    CipherWorkerFactory     factory;
+    std::ofstream           reportStream;
+    BatchRunner             runner(&factory);
+
+    g_options.outSuffix = ".out";
+
 #if defined(_WIN32) && defined (XSEC_HAVE_WINCAPI)
     HCRYPTPROV              win32DSSCSP = 0;        // Crypto Providers
     HCRYPTPROV              win32RSACSP = 0;
@@ -243,12 +645,16 @@ int evaluate(int argc, char ** argv) {
         return 2;
     }
 
-    // Run through parameters
+    // Run through parameters.  In single file mode the last parameter
+    // is always the input file
     int paramCount = 1;
 
-    while (paramCount < argc - 1) {
+    while (paramCount < argc) {
 
-        if (_stricmp(argv[paramCount], "--decrypt-element") == 0 || _stricmp(argv[paramCount], "-de") == 0) {
+        if (paramCount == argc - 1 && !batchMode) {
+            filename = argv[paramCount++];
+        }
+        else if (_stricmp(argv[paramCount], "--decrypt-element") == 0 || _stricmp(argv[paramCount], "-de") == 0) {
             paramCount++;
             doDecrypt = true;
             doDecryptElement = true;
@@ -268,26 +674,76 @@ int evaluate(int argc, char ** argv) {
             parseXMLInput = false;
             paramCount++;
         }
-        else if (_stricmp(argv[paramCount], "--encrypt-xml") == 0 || _stricmp(argv[paramCount], "-ex") == 0) {
-            // Us this file as an XML input file
-            doDecrypt = false;
-            encryptFileAsData = false;
-            doXMLOutput = true;
-            parseXMLInput = true;
+        else if (_stricmp(argv[paramCount], "--encrypt-xml") == 0 || _stricmp(argv[paramCount], "-ex") == 0) {
+            // Us this file as an XML input file
+            doDecrypt = false;
+            encryptFileAsData = false;
+            doXMLOutput = true;
+            parseXMLInput = true;
+            paramCount++;
+        }
+        else if (_stricmp(argv[paramCount], "--out-file") == 0 || _stricmp(argv[paramCount], "-o") == 0) {
+            if (paramCount +2 >= argc) {
+                printUsage();
+                return 1;
+            }
+            paramCount++;
+            outfile = argv[paramCount];
+            paramCount++;
+        }
+        else if (_stricmp(argv[paramCount], "--xkms") == 0 || _stricmp(argv[paramCount], "-x") == 0) {
+            paramCount++;
+            isXKMSKey = true;
+        }
+        else if (_stricmp(argv[paramCount], "--batch") == 0 || _stricmp(argv[paramCount], "-b") == 0) {
+            if (paramCount +1 >= argc) {
+                printUsage();
+                return 2;
+            }
+            paramCount++;
+            if (!runner.addList(argv[paramCount])) {
+                cerr << "Error opening list file " << argv[paramCount] << endl;
+                return 2;
+            }
+            paramCount++;
+            batchMode = true;
+        }
+        else if (_stricmp(argv[paramCount], "--dir") == 0) {
+            if (paramCount +1 >= argc) {
+                printUsage();
+                return 2;
+            }
+            paramCount++;
+            if (!runner.addDirectory(argv[paramCount])) {
+                cerr << "Error reading directory " << argv[paramCount] << endl;
+                return 2;
+            }
             paramCount++;
+            batchMode = true;
         }
-        else if (_stricmp(argv[paramCount], "--out-file") == 0 || _stricmp(argv[paramCount], "-o") == 0) {
-            if (paramCount +2 >= argc) {
+        else if (_stricmp(argv[paramCount], "--threads") == 0 || _stricmp(argv[paramCount], "-t") == 0) {
+            if (paramCount +1 >= argc) {
                 printUsage();
-                return 1;
+                return 2;
             }
             paramCount++;
-            outfile = argv[paramCount];
+            threads = atoi(argv[paramCount++]);
+        }
+        else if (_stricmp(argv[paramCount], "--report") == 0 || _stricmp(argv[paramCount], "-r") == 0) {
+            if (paramCount +1 >= argc) {
+                printUsage();
+                return 2;
+            }
             paramCount++;
+            reportFile = argv[paramCount++];
         }
-        else if (_stricmp(argv[paramCount], "--xkms") == 0 || _stricmp(argv[paramCount], "-x") == 0) {
+        else if (_stricmp(argv[paramCount], "--out-suffix") == 0 || _stricmp(argv[paramCount], "-os") == 0) {
+            if (paramCount +1 >= argc) {
+                printUsage();
+                return 2;
+            }
             paramCount++;
-            isXKMSKey = true;
+            g_options.outSuffix = argv[paramCount++];
         }
 
 #if defined (XSEC_HAVE_WINCAPI)
@@ -547,293 +1003,72 @@ int evaluate(int argc, char ** argv) {
         }
     }
 
-    if (paramCount >= argc) {
+    if (filename == NULL && !batchMode) {
         printUsage();
         return 2;
     }
 
-    if (outfile != NULL) {
-        formatTarget = new LocalFileFormatTarget(outfile);
-    }
-    else {
-        formatTarget = new StdOutFormatTarget();
-    }
-
-    filename = argv[paramCount];
-
-    if (parseXMLInput) {
-
-        XercesDOMParser * parser = new XercesDOMParser;
-        Janitor<XercesDOMParser> j_parser(parser);
-        
-        parser->setDoNamespaces(true);
-        parser->setCreateEntityReferenceNodes(true);
-
-        // Now parse out file
-
-        xsecsize_t errorCount = 0;
-        try
-        {
-            parser->parse(filename);
-            errorCount = parser->getErrorCount();
-            if (errorCount > 0)
-                errorsOccured = true;
-        }
+    g_options.doDecrypt = doDecrypt;
+    g_options.doDecryptElement = doDecryptElement;
+    g_options.useInteropResolver = useInteropResolver;
+    g_options.encryptFileAsData = encryptFileAsData;
+    g_options.parseXMLInput = parseXMLInput;
+    g_options.doXMLOutput = doXMLOutput;
+    g_options.kek = kek;
+    g_options.key = key;
+    g_options.kekAlg = kekAlg;
+    g_options.keyAlg = keyAlg;
 
-        catch (const XMLException& e)
-        {
-            cerr << "An error occured during parsing\n   Message: "
-                 << e.getMessage() << endl;
-            errorsOccured = true;
-        }
-
-
-        catch (const DOMException& e)
-        {
-           cerr << "A DOM error occured during parsing\n   DOMException code: "
-                 << e.code << endl;
-            errorsOccured = true;
-        }
-
-        if (errorsOccured) {
+    int retResult;
 
-            cout << "Errors during parse" << endl;
-            return (2);
+    if (batchMode) {
 
+        if (reportFile != NULL) {
+            reportStream.open(reportFile);
+            if (!reportStream.is_open()) {
+                cerr << "Error opening report file " << reportFile << endl;
+                delete kek;
+                delete key;
+                return 2;
+            }
+            runner.setReport(&reportStream);
         }
 
-        /*
-
-            Now that we have the parsed file, get the DOM document and start looking at it
+        runner.setThreads(threads);
+        retResult = runner.run();
 
-        */
-        
-        doc = parser->adoptDocument();
     }
-
     else {
-        // Create an empty document
-        XMLCh tempStr[100];
-        XMLString::transcode("Core", tempStr, 99);    
-        DOMImplementation *impl = DOMImplementationRegistry::getDOMImplementation(tempStr);
-        doc = impl->createDocument(
-            0,                    // root element namespace URI.
-            MAKE_UNICODE_STRING("ADoc"),            // root element name
-            NULL);// DOMDocumentType());  // document type object (DTD).
-    }
-
-
-    XSECProvider prov;
-    XENCCipher * cipher = prov.newCipher(doc);
-
-    if (kek != NULL)
-        cipher->setKEK(kek);
-    if (key != NULL)
-        cipher->setKey(key);
-
-    try {
-
-        if (doDecrypt) {
-
-            if (useInteropResolver == true) {
-
-                // Map out base path of the file
-#if XSEC_HAVE_GETCWD_DYN
-                char *path = getcwd(NULL, 0);
-                char *baseURI = (char*)malloc(strlen(path) + 8 + 1 + strlen(filename) + 1);
-#else
-                char path[PATH_MAX];
-                char baseURI[(PATH_MAX * 2) + 10];
-                getcwd(path, PATH_MAX);
-#endif
-                strcpy(baseURI, "file:///");        
-
-                // Ugly and nasty but quick
-                if (filename[0] != '\\' && filename[0] != '/' && filename[1] != ':') {
-                    strcat(baseURI, path);
-                    strcat(baseURI, "/");
-                } else if (path[1] == ':') {
-                    path[2] = '\0';
-                    strcat(baseURI, path);
-                }
-
-                strcat(baseURI, filename);
-
-                // Find any ':' and "\" characters
-                int lastSlash = 0;
-                for (unsigned int i = 8; i < strlen(baseURI); ++i) {
-                    if (baseURI[i] == '\\') {
-                        lastSlash = i;
-                        baseURI[i] = '/';
-                    }
-                    else if (baseURI[i] == '/')
-                        lastSlash = i;
-                }
-
-                // The last "\\" must prefix the filename
-                baseURI[lastSlash + 1] = '\0';
-
-                XMLCh * uriT = XMLString::transcode(baseURI);
-#if XSEC_HAVE_GETCWD_DYN
-                free(path);
-                free(baseURI);
-#endif
-
-                XencInteropResolver ires(doc, &(uriT[8]));
-                XSEC_RELEASE_XMLCH(uriT);
-                cipher->setKeyInfoResolver(&ires);
-
-            }
-            // Find the EncryptedData node
-            DOMNode * n = findXENCNode(doc, "EncryptedData");
-
-            if (doDecryptElement) {
-                while (n != NULL) {
-
-                    // decrypt
-                    cipher->decryptElement(static_cast<DOMElement *>(n));
 
-                    // Find the next EncryptedData node
-                    n = findXENCNode(doc, "EncryptedData");
-                }
-
-            }
-            else {
-                XSECBinTXFMInputStream * bis = cipher->decryptToBinInputStream(static_cast<DOMElement *>(n));
-                Janitor<XSECBinTXFMInputStream> j_bis(bis);
-    
-                XMLByte buf[1024];          
-                xsecsize_t read = bis->readBytes(buf, 1023);
-                while (read > 0) {
-                    formatTarget->writeChars(buf, read, NULL);
-                    read = bis->readBytes(buf, 1023);
-                }
-            }
+        if (outfile != NULL) {
+            formatTarget = new LocalFileFormatTarget(outfile);
         }
         else {
-
-            XENCEncryptedData *xenc = NULL;
-            // Encrypting
-            if (kek != NULL && key == NULL) {
-                XSECPlatformUtils::g_cryptoProvider->getRandom(keyBuf, 24);
-                XSECCryptoSymmetricKey * k = 
-                    XSECPlatformUtils::g_cryptoProvider->keySymmetric(XSECCryptoSymmetricKey::KEY_3DES_192);
-                k->setKey(keyBuf, 24);
-                cipher->setKey(k);
-                keyAlg = ENCRYPT_3DES_CBC;
-                keyStr = keyBuf;
-                keyLen = 24;
-            }
-
-            if (encryptFileAsData) {
-
-                // Create a BinInputStream
-#if defined(XSEC_XERCES_REQUIRES_MEMMGR)
-                BinFileInputStream * is = new BinFileInputStream(filename, XMLPlatformUtils::fgMemoryManager);
-#else
-                BinFileInputStream * is = new BinFileInputStream(filename);
-#endif
-                xenc = cipher->encryptBinInputStream(is, keyAlg);
-
-                // Replace the document element
-                DOMElement * elt = doc->getDocumentElement();
-                doc->replaceChild(xenc->getElement(), elt);
-                elt->release();
-            }
-            else {
-                // Document encryption
-                cipher->encryptElement(doc->getDocumentElement(), keyAlg);
-            }
-
-            // Do we encrypt a created key?
-            if (kek != NULL && xenc != NULL) {
-                XENCEncryptedKey *xkey = cipher->encryptKey(keyStr, keyLen, kekAlg);
-                // Add to the EncryptedData
-                xenc->appendEncryptedKey(xkey);
-            }
+            formatTarget = new StdOutFormatTarget();
         }
 
-        if (doXMLOutput) {
-            // Output the result
-
-            XMLCh core[] = {
-                XERCES_CPP_NAMESPACE_QUALIFIER chLatin_C,
-                XERCES_CPP_NAMESPACE_QUALIFIER chLatin_o,
-                XERCES_CPP_NAMESPACE_QUALIFIER chLatin_r,
-                XERCES_CPP_NAMESPACE_QUALIFIER chLatin_e,
-                XERCES_CPP_NAMESPACE_QUALIFIER chNull
-            };
-
-            DOMImplementation *impl = DOMImplementationRegistry::getDOMImplementation(core);
-
-#if defined (XSEC_XERCES_DOMLSSERIALIZER)
-            // DOM L3 version as per Xerces 3.0 API
-            DOMLSSerializer   *theSerializer = ((DOMImplementationLS*)impl)->createLSSerializer();
-            Janitor<DOMLSSerializer> j_theSerializer(theSerializer);
-            
-            // Get the config so we can set up pretty printing
-            DOMConfiguration *dc = theSerializer->getDomConfig();
-            dc->setParameter(XMLUni::fgDOMWRTFormatPrettyPrint, false);
-
-            // Now create an output object to format to UTF-8
-            DOMLSOutput *theOutput = ((DOMImplementationLS*)impl)->createLSOutput();
-            Janitor<DOMLSOutput> j_theOutput(theOutput);
-
-            theOutput->setEncoding(MAKE_UNICODE_STRING("UTF-8"));
-            theOutput->setByteStream(formatTarget);
-
-            theSerializer->write(doc, theOutput);
+        XercesDOMParser * parser = new XercesDOMParser;
+        Janitor<XercesDOMParser> j_parser(parser);
+        
+        parser->setDoNamespaces(true);
+        parser->setCreateEntityReferenceNodes(true);
 
-#else           
-            DOMWriter         *theSerializer = ((DOMImplementationLS*)impl)->createDOMWriter();
-            Janitor<DOMWriter> j_theSerializer(theSerializer);
+        std::string msg;
+        retResult = processFile(parser, filename, formatTarget, msg);
 
-            theSerializer->setEncoding(MAKE_UNICODE_STRING("UTF-8"));
-            if (theSerializer->canSetFeature(XMLUni::fgDOMWRTFormatPrettyPrint, false))
-                theSerializer->setFeature(XMLUni::fgDOMWRTFormatPrettyPrint, false);
+        delete formatTarget;
 
-            theSerializer->writeNode(formatTarget, *doc);
-#endif  
+        if (retResult != 0)
+            cerr << msg << endl;
+        else if (doXMLOutput)
             cout << endl;
 
-        }
-    }
-
-    catch (XSECException &e) {
-        char * msg = XMLString::transcode(e.getMsg());
-        cerr << "An error occured during encryption/decryption operation\n   Message: "
-        << msg << endl;
-        XSEC_RELEASE_XMLCH(msg);
-        errorsOccured = true;
-        if (formatTarget != NULL)
-            delete formatTarget;
-        doc->release();
-        return 2;
     }
-    catch (XSECCryptoException &e) {
-        cerr << "An error occured during encryption/decryption operation\n   Message: "
-        << e.getMsg() << endl;
-        errorsOccured = true;
-        if (formatTarget != NULL)
-            delete formatTarget;
-        doc->release();
-
-#if defined (XSEC_HAVE_OPENSSL)
-        ERR_load_crypto_strings();
-        BIO * bio_err;
-        if ((bio_err=BIO_new(BIO_s_file())) != NULL)
-            BIO_set_fp(bio_err,stderr,BIO_NOCLOSE|BIO_FP_TEXT);
 
-        ERR_print_errors(bio_err);
-#endif
-        return 2;
-    }
-    
-    if (formatTarget != NULL)
-        delete formatTarget;
+    delete kek;
+    delete key;
 
-    doc->release();
-    return 0;
+    return retResult;
 }
 
 
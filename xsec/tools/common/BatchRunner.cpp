@@ -0,0 +1,324 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * BatchRunner := Run a tool over many input files using a pool of
+ *                worker threads
+ *
+ * $Id$
+ *
+ */
+
+#include "BatchRunner.hpp"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#	include <windows.h>
+#else
+#	include <pthread.h>
+#	include <dirent.h>
+#	include <sys/stat.h>
+#endif
+
+XERCES_CPP_NAMESPACE_USE
+
+using std::cerr;
+using std::endl;
+
+// ----------------------------------------------------------------------------
+//           Thread entry point
+// ----------------------------------------------------------------------------
+
+#if defined(_WIN32)
+
+static DWORD WINAPI batchThread(LPVOID param) {
+
+	((BatchRunner *) param)->runWorker();
+	return 0;
+
+}
+
+#else
+
+extern "C" void * batchThread(void * param) {
+
+	((BatchRunner *) param)->runWorker();
+	return NULL;
+
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+//           Construction
+// ----------------------------------------------------------------------------
+
+BatchRunner::BatchRunner(BatchWorkerFactory * factory) :
+mp_factory(factory),
+mp_report(&std::cout),
+m_threads(1),
+m_nextName(0),
+m_nextList(0),
+m_result(0),
+m_count(0) {
+
+}
+
+BatchRunner::~BatchRunner() {
+
+	StreamVectorType::size_type i;
+	for (i = 0; i < m_lists.size(); ++i) {
+		if (m_lists[i] != &std::cin)
+			delete m_lists[i];
+	}
+
+}
+
+// ----------------------------------------------------------------------------
+//           Inputs
+// ----------------------------------------------------------------------------
+
+bool BatchRunner::addList(const char * listName) {
+
+	if (strcmp(listName, "-") == 0) {
+		m_lists.push_back(&std::cin);
+		return true;
+	}
+
+	std::ifstream * in = new std::ifstream(listName);
+	if (!in->is_open()) {
+		delete in;
+		return false;
+	}
+
+	m_lists.push_back(in);
+	return true;
+
+}
+
+bool BatchRunner::addDirectory(const char * dirName) {
+
+	std::string base(dirName);
+	if (!base.empty() && base[base.size() - 1] != '/' && base[base.size() - 1] != '\\')
+		base += "/";
+
+#if defined(_WIN32)
+
+	WIN32_FIND_DATAA fd;
+	HANDLE h = FindFirstFileA((base + "*").c_str(), &fd);
+	if (h == INVALID_HANDLE_VALUE)
+		return false;
+
+	do {
+		if ((fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+			m_names.push_back(base + fd.cFileName);
+	} while (FindNextFileA(h, &fd));
+
+	FindClose(h);
+
+#else
+
+	DIR * d = opendir(dirName);
+	if (d == NULL)
+		return false;
+
+	struct dirent * de;
+	struct stat st;
+	while ((de = readdir(d)) != NULL) {
+
+		std::string name = base + de->d_name;
+		if (stat(name.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+			m_names.push_back(name);
+
+	}
+
+	closedir(d);
+
+#endif
+
+	return true;
+
+}
+
+void BatchRunner::setReport(std::ostream * report) {
+
+	mp_report = report;
+
+}
+
+void BatchRunner::setThreads(unsigned int threads) {
+
+	m_threads = (threads == 0 ? 1 : threads);
+
+}
+
+bool BatchRunner::nextInput(std::string & name) {
+
+	XMLMutexLock lock(&m_inputMutex);
+
+	if (m_nextName < m_names.size()) {
+		name = m_names[m_nextName++];
+		return true;
+	}
+
+	while (m_nextList < m_lists.size()) {
+
+		std::istream * in = m_lists[m_nextList];
+
+		while (std::getline(*in, name)) {
+
+			// Allow for lists written on Windows
+			if (!name.empty() && name[name.size() - 1] == '\r')
+				name.erase(name.size() - 1);
+
+			if (!name.empty() && name[0] != '#')
+				return true;
+
+		}
+
+		++m_nextList;
+
+	}
+
+	return false;
+
+}
+
+// ----------------------------------------------------------------------------
+//           Processing
+// ----------------------------------------------------------------------------
+
+void BatchRunner::report(int code, const std::string & name, const std::string & message) {
+
+	// Keep each report on a single line
+
+	std::string msg(message);
+	std::string::size_type i;
+	for (i = 0; i < msg.size(); ++i) {
+		if (msg[i] == '\n' || msg[i] == '\r' || msg[i] == '\t')
+			msg[i] = ' ';
+	}
+	while (!msg.empty() && msg[msg.size() - 1] == ' ')
+		msg.erase(msg.size() - 1);
+
+	XMLMutexLock lock(&m_reportMutex);
+
+	*mp_report << code << '\t' << name << '\t' << msg << endl;
+
+	if (code > m_result)
+		m_result = code;
+	++m_count;
+
+}
+
+void BatchRunner::runWorker(void) {
+
+	BatchWorker * worker;
+
+	try {
+		worker = mp_factory->newWorker();
+	}
+	catch (...) {
+		cerr << "Error creating batch worker" << endl;
+		XMLMutexLock lock(&m_reportMutex);
+		m_result = 2;
+		return;
+	}
+
+	std::string name;
+	std::string message;
+	int code;
+
+	while (nextInput(name)) {
+
+		message.erase();
+
+		try {
+			code = worker->process(name.c_str(), message);
+		}
+		catch (...) {
+			code = 2;
+			message = "Unknown exception during processing";
+		}
+
+		report(code, name, message);
+
+	}
+
+	delete worker;
+
+}
+
+int BatchRunner::run(void) {
+
+	if (m_threads == 1) {
+
+		runWorker();
+
+	}
+	else {
+
+#if defined(_WIN32)
+
+		std::vector<HANDLE> threads;
+		unsigned int i;
+
+		for (i = 0; i < m_threads; ++i) {
+			HANDLE h = CreateThread(NULL, 0, batchThread, (LPVOID) this, 0, NULL);
+			if (h != NULL)
+				threads.push_back(h);
+		}
+
+		if (threads.empty())
+			runWorker();
+
+		for (i = 0; i < threads.size(); ++i) {
+			WaitForSingleObject(threads[i], INFINITE);
+			CloseHandle(threads[i]);
+		}
+
+#else
+
+		std::vector<pthread_t> threads;
+		unsigned int i;
+
+		for (i = 0; i < m_threads; ++i) {
+			pthread_t t;
+			if (pthread_create(&t, NULL, batchThread, (void *) this) == 0)
+				threads.push_back(t);
+		}
+
+		if (threads.empty())
+			runWorker();
+
+		for (i = 0; i < threads.size(); ++i)
+			pthread_join(threads[i], NULL);
+
+#endif
+
+	}
+
+	cerr << "Processed " << m_count << " input(s)" << endl;
+
+	return m_result;
+
+}
@@ -0,0 +1,153 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * BatchRunner := Run a tool over many input files using a pool of
+ *                worker threads
+ *
+ * $Id$
+ *
+ */
+
+#ifndef BATCHRUNNER_INCLUDE
+#define BATCHRUNNER_INCLUDE
+
+// XSEC
+
+#include <xsec/framework/XSECDefs.hpp>
+
+#include <xercesc/util/Mutexes.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+//           BatchWorker
+// ----------------------------------------------------------------------------
+
+/*
+ * A worker processes one input at a time.  One is created for each thread,
+ * so anything expensive to set up (parsers, keys) should be held here and
+ * reused for every file the worker is handed.
+ *
+ * process() returns the tool's exit code for the input (0 = OK,
+ * 1 = failed, 2 = processing error) and may set a one line message.
+ */
+
+class BatchWorker {
+
+public:
+
+	virtual ~BatchWorker() {}
+
+	virtual int process(const char * filename, std::string & message) = 0;
+
+};
+
+class BatchWorkerFactory {
+
+public:
+
+	virtual ~BatchWorkerFactory() {}
+
+	virtual BatchWorker * newWorker(void) = 0;
+
+};
+
+// ----------------------------------------------------------------------------
+//           BatchRunner
+// ----------------------------------------------------------------------------
+
+/*
+ * Inputs come from list files (one file name per line, blank lines and
+ * lines starting with '#' ignored) and directories.  A list named "-" is
+ * read from stdin as lines arrive, so the tool can be left running and fed
+ * requests by another process.
+ *
+ * One report line is written for each input as it completes :
+ *
+ *     <exit code> TAB <file name> TAB <message>
+ *
+ * Lines are flushed immediately.  With more than one thread the lines are
+ * in completion order rather than input order.
+ */
+
+class BatchRunner {
+
+public:
+
+	BatchRunner(BatchWorkerFactory * factory);
+	~BatchRunner();
+
+	// Where report lines go (default stdout)
+
+	void setReport(std::ostream * report);
+
+	// Inputs
+
+	bool addList(const char * listName);
+	bool addDirectory(const char * dirName);
+
+	void setThreads(unsigned int threads);
+
+	// Process everything - returns the highest exit code seen
+
+	int run(void);
+
+	// Used by the worker threads
+
+	void runWorker(void);
+
+private:
+
+	bool nextInput(std::string & name);
+	void report(int code, const std::string & name, const std::string & message);
+
+	typedef std::vector<std::string>	NameVectorType;
+	typedef std::vector<std::istream *>	StreamVectorType;
+
+	BatchWorkerFactory		* mp_factory;
+	std::ostream			* mp_report;
+	unsigned int			m_threads;
+
+	NameVectorType			m_names;		// Names found in directories
+	NameVectorType::size_type
+							m_nextName;
+	StreamVectorType		m_lists;		// List files (read lazily)
+	StreamVectorType::size_type
+							m_nextList;
+
+	XERCES_CPP_NAMESPACE_QUALIFIER XMLMutex
+							m_inputMutex;
+	XERCES_CPP_NAMESPACE_QUALIFIER XMLMutex
+							m_reportMutex;
+	int						m_result;
+	unsigned long			m_count;
+
+	// Unimplemented
+	BatchRunner(const BatchRunner &);
+	BatchRunner & operator = (const BatchRunner &);
+
+};
+
+#endif /* BATCHRUNNER_INCLUDE */
@@ -45,6 +45,7 @@
 
 #include <xsec/xkms/XKMSCompoundRequest.hpp>
 #include <xsec/xkms/XKMSCompoundResult.hpp>
+#include <xsec/xkms/XKMSCompoundProcessor.hpp>
 #include <xsec/xkms/XKMSPendingRequest.hpp>
 #include <xsec/xkms/XKMSMessageAbstractType.hpp>
 #include <xsec/xkms/XKMSLocateRequest.hpp>
@@ -4012,6 +4013,79 @@ int doMsgCreate(int argc, char ** argv, int paramCount) {
 }
 
 
+// --------------------------------------------------------------------------------
+//           In-process responder
+// --------------------------------------------------------------------------------
+
+// Answers requests without a service, so request building and the
+// CompoundRequest processor can be exercised end to end.  Locate and
+// Validate requests get an empty Success.NoMatch, anything else is
+// rejected as not supported.
+
+class LocalResponder : public XKMSRequestHandler {
+
+public:
+
+    XKMSResultType * processRequest(XKMSRequestAbstractType * request,
+                                    XKMSMessageFactory * factory,
+                                    DOMDocument * doc) {
+
+        switch (request->getMessageType()) {
+
+        case XKMSMessageAbstractType::LocateRequest :
+
+            return factory->createLocateResult((XKMSLocateRequest *) request, doc,
+                XKMSResultType::Success, XKMSResultType::NoMatch);
+
+        case XKMSMessageAbstractType::ValidateRequest :
+
+            return factory->createValidateResult((XKMSValidateRequest *) request, doc,
+                XKMSResultType::Success, XKMSResultType::NoMatch);
+
+        default :
+
+            return factory->createResult(request, doc,
+                XKMSResultType::Sender, XKMSResultType::MessageNotSupported);
+
+        }
+
+    }
+
+};
+
+DOMDocument * doLocalRequest(XKMSMessageFactory * f, XKMSMessageAbstractType * msg) {
+
+    XMLCh tempStr[100];
+    XMLString::transcode("Core", tempStr, 99);
+    DOMImplementation *impl = DOMImplementationRegistry::getDOMImplementation(tempStr);
+
+    DOMDocument * responseDoc = impl->createDocument();
+    LocalResponder responder;
+    XKMSResultType * r;
+
+    try {
+        if (msg->getMessageType() == XKMSMessageAbstractType::CompoundRequest) {
+
+            XKMSCompoundProcessor processor(&responder);
+            r = processor.process((XKMSCompoundRequest *) msg, f, responseDoc);
+
+        }
+        else {
+            r = responder.processRequest(f->toRequestAbstractType(msg), f, responseDoc);
+        }
+
+        responseDoc->appendChild(r->getElement());
+        delete r;
+    }
+    catch (...) {
+        responseDoc->release();
+        throw;
+    }
+
+    return responseDoc;
+
+}
+
 // --------------------------------------------------------------------------------
 //           Base request module
 // --------------------------------------------------------------------------------
@@ -4025,6 +4099,8 @@ void printDoRequestUsage(void) {
     cerr << "                   : Set two phase nonce value\n";
     cerr << "   --original-requestid/-o [id]\n";
     cerr << "                   : set OriginalRequestId attribute in request\n";
+    cerr << "   --local/-l      : Answer the request with a built in test responder\n";
+    cerr << "                     rather than sending it to the service\n";
     cerr << "   --envelope-type/-e [NONE|SOAP11|SOAP12]\n";
     cerr << "                   : Set envelope wrapper for request\n";
     cerr << "                         NONE   = No wrapper - straight HTTP request\n";
@@ -4050,6 +4126,7 @@ int doRequest(int argc, char ** argv, int paramCount) {
     XSECSOAPRequestorSimple::envelopeType et = XSECSOAPRequestorSimple::ENVELOPE_SOAP11;
 
     bool twoPhase = false;
+    bool local = false;
     bool parmsDone = false;
 
     char * nonce = NULL;
@@ -4069,6 +4146,13 @@ int doRequest(int argc, char ** argv, int paramCount) {
             twoPhase = true;
             paramCount++;
 
+        }
+        else if ((_stricmp(argv[paramCount], "--local") == 0) ||
+            (_stricmp(argv[paramCount], "-l") == 0)) {
+
+            local = true;
+            paramCount++;
+
         }
         else if ((_stricmp(argv[paramCount], "--nonce") == 0) ||
             (_stricmp(argv[paramCount], "-n") == 0)) {
@@ -4301,66 +4385,71 @@ int doRequest(int argc, char ** argv, int paramCount) {
     DOMDocument * responseDoc;
 
     try {
-        XSECSOAPRequestorSimple req(msg->getService());
+        if (local) {
+            responseDoc = doLocalRequest(f, msg);
+        }
+        else {
+            XSECSOAPRequestorSimple req(msg->getService());
 #if !defined(_WIN32)
-        struct timeval tv1, tv2;
-        gettimeofday(&tv1, NULL);
+            struct timeval tv1, tv2;
+            gettimeofday(&tv1, NULL);
 #endif
-        req.setEnvelopeType(et);
+            req.setEnvelopeType(et);
 
-        responseDoc = req.doRequest(doc);
+            responseDoc = req.doRequest(doc);
 #if !defined(_WIN32)
-        gettimeofday(&tv2, NULL);
-        long seconds = tv2.tv_sec - tv1.tv_sec;
-        long useconds;
-        if (seconds != 0) {
-            useconds = 1000000 - tv1.tv_usec + tv2.tv_usec;
-            seconds--;
-        }
-        else {
-            useconds = tv2.tv_usec - tv1.tv_usec;
-        }
-        if (useconds >= 1000000) {
-            useconds -= 1000000;
-            seconds++;
-        }
+            gettimeofday(&tv2, NULL);
+            long seconds = tv2.tv_sec - tv1.tv_sec;
+            long useconds;
+            if (seconds != 0) {
+                useconds = 1000000 - tv1.tv_usec + tv2.tv_usec;
+                seconds--;
+            }
+            else {
+                useconds = tv2.tv_usec - tv1.tv_usec;
+            }
+            if (useconds >= 1000000) {
+                useconds -= 1000000;
+                seconds++;
+            }
 
-        cout << "Time taken for request = " << seconds << " seconds, " << useconds << " useconds" << endl;
+            cout << "Time taken for request = " << seconds << " seconds, " << useconds << " useconds" << endl;
 #endif
-        /* If two-phase - re-do the request */
-        if (twoPhase) {
+            /* If two-phase - re-do the request */
+            if (twoPhase) {
 
-            XKMSResultType * r = f->toResultType(f->newMessageFromDOM(responseDoc->getDocumentElement()));
-            if (r->getResultMajor() == XKMSResultType::Represent) {
+                XKMSResultType * r = f->toResultType(f->newMessageFromDOM(responseDoc->getDocumentElement()));
+                if (r->getResultMajor() == XKMSResultType::Represent) {
 
-                cerr << "Intermediate response of a two phase sequence received\n\n";
+                    cerr << "Intermediate response of a two phase sequence received\n\n";
 
-                if (g_txtOut) {
-                    outputDoc(responseDoc);
-                }
-                doParsedMsgDump(responseDoc);
-
-                //XKMSRequestAbstractType * request = f->toRequestAbstractType(msg);
-                for (int k = 0; k < request->getResponseMechanismSize(); ++k) {
-                    if (strEquals(request->getResponseMechanismItemStr(k),
-                                  XKMSConstants::s_tagRepresent)) {
-                        request->removeResponseMechanismItem(k);
-                        break;
+                    if (g_txtOut) {
+                        outputDoc(responseDoc);
+                    }
+                    doParsedMsgDump(responseDoc);
+
+                    //XKMSRequestAbstractType * request = f->toRequestAbstractType(msg);
+                    for (int k = 0; k < request->getResponseMechanismSize(); ++k) {
+                        if (strEquals(request->getResponseMechanismItemStr(k),
+                                      XKMSConstants::s_tagRepresent)) {
+                            request->removeResponseMechanismItem(k);
+                            break;
+                        }
                     }
-                }
 
-                request->setNonce(r->getNonce());
-                request->setOriginalRequestId(request->getId());
-                XMLCh * myId = generateId();
+                    request->setNonce(r->getNonce());
+                    request->setOriginalRequestId(request->getId());
+                    XMLCh * myId = generateId();
 
-                request->setId(myId);
-                XSEC_RELEASE_XMLCH(myId);
+                    request->setId(myId);
+                    XSEC_RELEASE_XMLCH(myId);
 
-                responseDoc->release();
-                responseDoc = req.doRequest(doc);
+                    responseDoc->release();
+                    responseDoc = req.doRequest(doc);
 
+                }
+                delete r;
             }
-            delete r;
         }
 
     }
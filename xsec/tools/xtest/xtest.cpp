@@ -36,6 +36,7 @@
 #include <memory.h>
 #include <iostream>
 #include <stdlib.h>
+#include <time.h>
 
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/XMLUniDefs.hpp>
@@ -49,6 +50,7 @@
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/util/XMLException.hpp>
 #include <xercesc/util/Janitor.hpp>
+#include <xercesc/util/BinMemInputStream.hpp>
 
 #include <xsec/transformers/TXFMOutputFile.hpp>
 #include <xsec/dsig/DSIGTransformXPath.hpp>
@@ -76,9 +78,18 @@ XALAN_USING_XALAN(XalanTransformer)
 #include <xsec/dsig/DSIGReference.hpp>
 #include <xsec/framework/XSECError.hpp>
 #include <xsec/dsig/DSIGSignature.hpp>
+#include <xsec/dsig/DSIGSignatureTemplate.hpp>
+#include <xsec/dsig/DSIGStreamingVerifier.hpp>
 #include <xsec/utils/XSECNameSpaceExpander.hpp>
 #include <xsec/utils/XSECDOMUtils.hpp>
 #include <xsec/utils/XSECBinTXFMInputStream.hpp>
+#include <xsec/transformers/TXFMSB.hpp>
+#include <xsec/transformers/TXFMC14n.hpp>
+#include <xsec/transformers/TXFMChain.hpp>
+#include <xsec/utils/XSECURIPrefetcherThreaded.hpp>
+#include <xsec/framework/XSECURIResolver.hpp>
+#include <xsec/framework/XSECURIResolverCaching.hpp>
+#include <xsec/utils/XSECBinMappedFileInputStream.hpp>
 #include <xsec/enc/XSECCryptoException.hpp>
 #include <xsec/dsig/DSIGKeyInfoX509.hpp>
 #include <xsec/dsig/DSIGKeyInfoName.hpp>
@@ -89,6 +100,7 @@ XALAN_USING_XALAN(XalanTransformer)
 #include <xsec/xenc/XENCEncryptedData.hpp>
 #include <xsec/xenc/XENCEncryptedKey.hpp>
 #include <xsec/xenc/XENCEncryptionMethod.hpp>
+#include <xsec/xkms/XKMSConstants.hpp>
 
 #include <xsec/enc/XSECCryptoSymmetricKey.hpp>
 
@@ -549,7 +561,12 @@ bool reValidateSig(DOMImplementation *impl, DOMDocument * inDoc, XSECCryptoKey *
 		sig->load();
 		sig->setSigningKey(k);
 
-		bool ret = sig->verify();
+		// Hash the references before anything has built the Objects, so
+		// a "#id" reference to one of them relies on load() alone
+		safeBuffer refErrs;
+		bool ret = DSIGReference::verifyReferenceList(sig->getReferenceList(), refErrs);
+
+		ret = sig->verify() && ret;
 
 		doc->release();
 
@@ -802,6 +819,174 @@ void unitTestBase64NodeSignature(DOMImplementation * impl) {
 }
 
 
+void unitTestMultiHash(void) {
+
+	// Batched digests must match the same messages hashed one at a time
+
+	cerr << "Checking batched SHA-256 against single digests ... ";
+
+	static const unsigned int lens[] = {0, 1, 55, 56, 63, 64, 65, 119, 120, 1000, 7};
+	const unsigned int count = sizeof(lens) / sizeof(unsigned int);
+
+	unsigned char data[1000];
+	unsigned char digests[2][count][32];
+	unsigned char single[64];
+	const unsigned char * inputs[count];
+	unsigned char * outputs[2][count];
+	unsigned int outLens[count];
+	unsigned int i, j;
+
+	for (i = 0; i < sizeof(data); ++i)
+		data[i] = (unsigned char) (i * 7 + 3);
+
+	for (i = 0; i < count; ++i) {
+		inputs[i] = data + (i % 3);
+		outputs[0][i] = digests[0][i];
+		outputs[1][i] = digests[1][i];
+	}
+
+	try {
+
+		// The provider's own batch and the portable interleaved fallback
+
+		XSECPlatformUtils::g_cryptoProvider->hashMultiple(XSECCryptoHash::HASH_SHA256,
+			count, inputs, lens, outputs[0], 32, outLens);
+		XSECPlatformUtils::g_cryptoProvider->XSECCryptoProvider::hashMultiple(XSECCryptoHash::HASH_SHA256,
+			count, inputs, lens, outputs[1], 32, outLens);
+
+		XSECCryptoHash * h = XSECPlatformUtils::g_cryptoProvider->hashSHA(256);
+		Janitor<XSECCryptoHash> j_h(h);
+
+		for (i = 0; i < count; ++i) {
+
+			h->reset();
+			h->hash((unsigned char *) inputs[i], lens[i]);
+			if (h->finish(single, 64) != 32 || outLens[i] != 32) {
+				cerr << "bad digest length" << endl;
+				exit(1);
+			}
+
+			for (j = 0; j < 32; ++j) {
+				if (digests[0][i][j] != single[j] || digests[1][i][j] != single[j]) {
+					cerr << "bad digest for input of length " << lens[i] << endl;
+					exit(1);
+				}
+			}
+
+		}
+
+	}
+	catch (XSECCryptoException &e)
+	{
+		cerr << "A cryptographic error occured during batch hashing\n   Message: "
+		<< e.getMsg() << endl;
+		exit(1);
+	}
+
+	cerr << "OK" << endl;
+
+}
+
+void unitTestMappedFile(void) {
+
+	// A local file is digested straight from its mapping
+
+	cerr << "Digesting a memory mapped file ... ";
+
+	const char * name = "xtest-mapped.tmp";
+	unsigned char data[5000];
+	unsigned char expected[64];
+	unsigned char got[64];
+	unsigned int i;
+
+	for (i = 0; i < sizeof(data); ++i)
+		data[i] = (unsigned char) (i * 13 + 1);
+
+	FILE * f = fopen(name, "wb");
+	if (f == NULL || fwrite(data, 1, sizeof(data), f) != sizeof(data)) {
+		cerr << "unable to create " << name << endl;
+		exit(1);
+	}
+	fclose(f);
+
+	try {
+
+		XSECCryptoHash * h = XSECPlatformUtils::g_cryptoProvider->hashSHA(256);
+		Janitor<XSECCryptoHash> j_h(h);
+
+		h->hash(data, sizeof(data));
+		h->finish(expected, 64);
+
+		XSECBinMappedFileInputStream * strm;
+		XSECnew(strm, XSECBinMappedFileInputStream(MAKE_UNICODE_STRING(name)));
+		Janitor<XSECBinMappedFileInputStream> j_strm(strm);
+
+		xsecsize_t len = 0;
+		const XMLByte * mapped = strm->consumeMapped(len);
+
+#if !defined(_WIN32)
+		if (mapped == NULL) {
+			cerr << "file was not mapped" << endl;
+			exit(1);
+		}
+#endif
+
+		if (mapped != NULL) {
+
+			if (len != sizeof(data)) {
+				cerr << "bad mapped length " << len << endl;
+				exit(1);
+			}
+
+			h->reset();
+			h->hash((unsigned char *) mapped, len);
+
+		}
+		else {
+
+			// No mmap on this platform - read it instead
+			XMLByte buf[512];
+			xsecsize_t n;
+			h->reset();
+			while ((n = strm->readBytes(buf, 512)) > 0)
+				h->hash(buf, n);
+
+		}
+
+		h->finish(got, 64);
+
+		if (memcmp(got, expected, 32) != 0) {
+			cerr << "bad digest" << endl;
+			exit(1);
+		}
+
+		XMLByte b;
+		if (strm->readBytes(&b, 1) != 0) {
+			cerr << "data left after the mapping was consumed" << endl;
+			exit(1);
+		}
+
+	}
+	catch (XSECException &e)
+	{
+		cerr << "An error occured reading the mapped file\n   Message: ";
+		char * ce = XMLString::transcode(e.getMsg());
+		cerr << ce << endl;
+		XSEC_RELEASE_XMLCH(ce);
+		exit(1);
+	}
+	catch (XSECCryptoException &e)
+	{
+		cerr << "A cryptographic error occured digesting the mapped file\n   Message: "
+		<< e.getMsg() << endl;
+		exit(1);
+	}
+
+	remove(name);
+	cerr << "OK" << endl;
+
+}
+
 void unitTestLongSHA(DOMImplementation * impl) {
 	
 	// This tests an enveloping signature as the root node, using SHA224/256/384/512
@@ -970,101 +1155,1079 @@ void unitTestLongSHA(DOMImplementation * impl) {
 
 }
 
-void unitTestRSASig(DOMImplementation * impl, XSECCryptoKeyRSA * k, const XMLCh * AlgURI) {
+void unitTestRSASig(DOMImplementation * impl, XSECCryptoKeyRSA * k, const XMLCh * AlgURI) {
+
+	// Given a specific RSA key and particular algorithm URI, sign and validate a document
+
+	try {
+		
+		// Create a document
+    
+		DOMDocument * doc = impl->createDocument();
+
+		// Create the signature
+
+		XSECProvider prov;
+		DSIGSignature *sig;
+		DOMElement *sigNode;
+		DSIGReference *ref[4];
+		
+		sig = prov.newSignature();
+		sig->setDSIGNSPrefix(MAKE_UNICODE_STRING("ds"));
+		sig->setPrettyPrint(true);
+
+		sigNode = sig->createBlankSignature(doc, 
+			DSIGConstants::s_unicodeStrURIC14N_COM,
+			AlgURI);
+
+		doc->appendChild(sigNode);
+
+		// Add an object
+		DSIGObject * obj = sig->appendObject();
+		obj->setId(MAKE_UNICODE_STRING("ObjectId"));
+
+		// Create a text node
+		DOMText * txt= doc->createTextNode(MAKE_UNICODE_STRING("A test string"));
+		obj->appendChild(txt);
+
+		// Add a Reference
+		ref[0] = sig->createReference(MAKE_UNICODE_STRING("#ObjectId"), 
+			DSIGConstants::s_unicodeStrURISHA1);
+
+		// Get a key
+		cerr << "signing ... ";
+
+		sig->setSigningKey(k->clone());
+		sig->sign();
+
+		cerr << "OK ... ";
+
+		cerr << "validating ... ";
+		if (!sig->verify()) {
+			cerr << "bad verify!" << endl;
+			exit(1);
+		}
+
+		cerr << "OK ... serialise and re-verify ... ";
+		if (!reValidateSig(impl, doc, k)) {
+
+			cerr << "bad verify!" << endl;
+			exit(1);
+
+		}
+
+		cerr << "OK";
+
+#if 0
+#if defined XSEC_HAVE_OPENSSL
+
+		if (g_useWinCAPI || g_useNSS) {
+
+			cerr << " ... validate against OpenSSL" << endl;
+
+			BIO * bioMem = BIO_new(BIO_s_mem());
+			BIO_puts(bioMem, s_tstRSAPrivateKey);
+			EVP_PKEY * pk = PEM_read_bio_PrivateKey(bioMem, NULL, NULL, NULL);
+
+			OpenSSLCryptoKeyRSA * rsaKey = new OpenSSLCryptoKeyRSA(pk);
+
+			sig->setSigningKey(rsaKey);
+			if (!sig->verify()) {
+				cerr << "bad verify!" << endl;
+				exit (1);
+			}
+
+			cerr << "OK";
+
+			BIO_free(bioMem);
+			EVP_PKEY_free(pk);
+		}
+#endif
+#endif
+
+		cerr << "\n";	
+
+		outputDoc(impl, doc);
+		doc->release();
+		
+
+	}
+
+	catch (XSECException &e)
+	{
+		cerr << "An error occured during signature processing\n   Message: ";
+		char * ce = XMLString::transcode(e.getMsg());
+		cerr << ce << endl;
+		delete ce;
+		exit(1);
+		
+	}	
+	catch (XSECCryptoException &e)
+	{
+		cerr << "A cryptographic error occured during signature processing\n   Message: "
+		<< e.getMsg() << endl;
+		exit(1);
+	}
+
+}
+
+
+void unitTestRSA(DOMImplementation * impl) {
+
+	/* First we load some keys to use! */
+
+	XSECCryptoKeyRSA * rsaKey;
+
+#if defined (XSEC_HAVE_OPENSSL)
+	if (!g_useWinCAPI && !g_useNSS) {
+		// Load the key
+		BIO * bioMem = BIO_new(BIO_s_mem());
+		BIO_puts(bioMem, s_tstRSAPrivateKey);
+		EVP_PKEY * pk = PEM_read_bio_PrivateKey(bioMem, NULL, NULL, NULL);
+
+		rsaKey = new OpenSSLCryptoKeyRSA(pk);
+
+		BIO_free(bioMem);
+		EVP_PKEY_free(pk);
+	}
+#endif
+
+#if defined (XSEC_HAVE_WINCAPI)
+	if (g_useWinCAPI) {
+
+		// Use the internal key
+		WinCAPICryptoProvider *cp = (WinCAPICryptoProvider *) (XSECPlatformUtils::g_cryptoProvider);
+		HCRYPTPROV p = cp->getApacheKeyStore();
+			
+		rsaKey = new WinCAPICryptoKeyRSA(p, AT_KEYEXCHANGE, true);
+	}
+
+#endif
+
+#if defined (XSEC_HAVE_NSS)
+	if (g_useNSS) {
+		// Heavily based on Mozilla example code
+		SECKEYPrivateKey *prvKey = 0;
+		SECKEYPublicKey *pubKey = 0;
+		PK11SlotInfo *slot = 0;
+		PK11RSAGenParams rsaParams;
+
+		// Use a bog standard key size
+		rsaParams.keySizeInBits = 1024;
+		rsaParams.pe = 65537;
+		
+		// We need somewhere to temporarily store a generated key
+		slot = PK11_GetInternalKeySlot();
+		if (!slot) { 
+			cerr << "Error generating key - can't get NSS slot\n";
+			exit (1);
+		}
+		
+		// Do the generate
+		prvKey = PK11_GenerateKeyPair(slot, CKM_RSA_PKCS_KEY_PAIR_GEN, &rsaParams,
+			&pubKey, PR_FALSE, PR_TRUE, 0);
+		
+		if (!prvKey) {
+			if (slot)
+				PK11_FreeSlot(slot);
+			cerr << "Error generating key within NSS\n";
+			exit (1);
+		}
+		
+		// Now use the key!
+		rsaKey = new NSSCryptoKeyRSA(pubKey, prvKey);
+
+	}
+#endif
+
+	cerr << "Unit testing RSA-SHA1 signature ... ";
+	unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA1);
+
+	if (XSECPlatformUtils::g_cryptoProvider->algorithmSupported(XSECCryptoHash::HASH_SHA512)) {
+		cerr << "Unit testing RSA-SHA224 signature ... ";
+		unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA224);
+		cerr << "Unit testing RSA-SHA256 signature ... ";
+		unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA256);
+		cerr << "Unit testing RSA-SHA384 signature ... ";
+		unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA384);
+		cerr << "Unit testing RSA-SHA512 signature ... ";
+		unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA512);
+	}
+	else
+		cerr << "Skipping non SHA 224/256/384/512 RSA signatures" << endl;
+
+	cerr << "Unit testing RSA-MD5 signature ... ";
+	unitTestRSASig(impl, rsaKey, DSIGConstants::s_unicodeStrURIRSA_MD5);
+	
+		
+}
+void unitTestSignAndSerialise(DOMImplementation * impl, bool largeTail) {
+
+	// Sign an enveloped document and serialise it in one pass.  With a
+	// large tail, more follows the signature than is held in memory.
+
+	cerr << "Sign and serialise enveloped signature "
+		<< (largeTail ? "(large tail) " : "") << "... ";
+
+	try {
+
+		DOMDocument * doc = createTestDoc(impl);
+		DOMElement * rootElem = doc->getDocumentElement();
+
+		XSECProvider prov;
+		DSIGSignature *sig;
+		DOMElement *sigNode;
+
+		sig = prov.newSignature();
+		sig->setDSIGNSPrefix(MAKE_UNICODE_STRING("ds"));
+		sig->setPrettyPrint(true);
+
+		sigNode = sig->createBlankSignature(doc,
+			DSIGConstants::s_unicodeStrURIC14N_NOC,
+			DSIGConstants::s_unicodeStrURIHMAC_SHA1);
+
+		// Put the signature between the two children so there is
+		// content on both sides of it
+		rootElem->insertBefore(sigNode, rootElem->getLastChild());
+
+		if (largeTail) {
+
+			safeBuffer tail;
+			for (int i = 0; i < 20000; ++i)
+				tail.sbMemcpyIn(i * 10, "0123456789", 10);
+			tail[200000] = '\0';
+			tail.setBufferType(safeBuffer::BUFFER_CHAR);
+
+			DOMElement * tailElt = doc->createElementNS(NULL, MAKE_UNICODE_STRING("Tail"));
+			tailElt->appendChild(doc->createTextNode(MAKE_UNICODE_STRING(tail.rawCharBuffer())));
+			rootElem->appendChild(tailElt);
+
+		}
+
+		DSIGReference * ref = sig->createReference(MAKE_UNICODE_STRING(""),
+			DSIGConstants::s_unicodeStrURISHA1);
+		ref->appendEnvelopedSignatureTransform();
+		ref->appendCanonicalizationTransform(CANON_C14N_NOC);
+
+		sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+
+		MemBufFormatTarget formatTarget;
+		sig->signAndSerialise(&formatTarget);
+
+		cerr << "validating ... ";
+		if (!sig->verify()) {
+			cerr << "bad verify!" << endl;
+			exit(1);
+		}
+
+		cerr << "OK ... re-parse output and verify ... ";
+
+		XercesDOMParser parser;
+		parser.setDoNamespaces(true);
+
+		MemBufInputSource memIS(formatTarget.getRawBuffer(),
+			formatTarget.getLen(), "XSECMem");
+
+		parser.parse(memIS);
+		DOMDocument * outDoc = parser.adoptDocument();
+
+		if (outDoc == NULL || parser.getErrorCount() > 0) {
+			cerr << "bad parse!" << endl;
+			exit(1);
+		}
+
+		DSIGSignature * outSig = prov.newSignatureFromDOM(outDoc);
+		outSig->load();
+		outSig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+
+		if (!outSig->verify()) {
+			cerr << "bad verify!" << endl;
+			exit(1);
+		}
+
+		cerr << "OK" << endl;
+
+		prov.releaseSignature(outSig);
+		outDoc->release();
+		doc->release();
+
+	}
+
+	catch (XSECException &e)
+	{
+		cerr << "An error occured during signature processing\n   Message: ";
+		char * ce = XMLString::transcode(e.getMsg());
+		cerr << ce << endl;
+		delete ce;
+		exit(1);
+		
+	}	
+	catch (XSECCryptoException &e)
+	{
+		cerr << "A cryptographic error occured during signature processing\n   Message: "
+		<< e.getMsg() << endl;
+		exit(1);
+	}
+
+}
+
+// Sign a message with a compiled template and check the result is the
+// same as signing it from the DOM
+
+DSIGSignature * templateMessage(XSECProvider & prov, DOMDocument * doc,
+								DOMNode * tmplNode, const char * product) {
+
+	DOMElement * rootElem = doc->getDocumentElement();
+	rootElem->getFirstChild()->getFirstChild()->setNodeValue(MAKE_UNICODE_STRING(product));
+
+	DOMNode * sigNode = doc->importNode(tmplNode, true);
+	rootElem->appendChild(sigNode);
+
+	DSIGSignature * sig = prov.newSignatureFromDOM(doc, sigNode);
+	sig->load();
+	sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+
+	return sig;
+
+}
+
+// As templateMessage(), but created by the template
+
+DSIGSignature * instantiatedMessage(XSECProvider & prov, DOMDocument * doc,
+								DSIGSignatureTemplate & tmpl, const char * product) {
+
+	DOMElement * rootElem = doc->getDocumentElement();
+	rootElem->getFirstChild()->getFirstChild()->setNodeValue(MAKE_UNICODE_STRING(product));
+
+	DSIGSignature * sig = tmpl.instantiate(prov, rootElem);
+	sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+
+	return sig;
+
+}
+
+// As templateMessage(), but with the SignedInfo altered before it is loaded
+
+DSIGSignature * changedTemplateMessage(XSECProvider & prov, DOMDocument * doc,
+								DOMNode * tmplNode, const XMLCh * c14nURI, const XMLCh * refURI) {
+
+	DOMElement * rootElem = doc->getDocumentElement();
+	rootElem->getFirstChild()->getFirstChild()->setNodeValue(MAKE_UNICODE_STRING("XMLSecurityC"));
+
+	DOMElement * sigNode = (DOMElement *) doc->importNode(tmplNode, true);
+	rootElem->appendChild(sigNode);
+
+	DOMElement * c14n = (DOMElement *) sigNode->getElementsByTagNameNS(DSIGConstants::s_unicodeStrURIDSIG,
+		MAKE_UNICODE_STRING("CanonicalizationMethod"))->item(0);
+	c14n->setAttributeNS(NULL, DSIGConstants::s_unicodeStrAlgorithm, c14nURI);
+
+	DOMElement * r = (DOMElement *) sigNode->getElementsByTagNameNS(DSIGConstants::s_unicodeStrURIDSIG,
+		MAKE_UNICODE_STRING("Reference"))->item(0);
+	r->setAttributeNS(NULL, MAKE_UNICODE_STRING("URI"), refURI);
+
+	DSIGSignature * sig = prov.newSignatureFromDOM(doc, sigNode);
+	sig->load();
+	sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+
+	return sig;
+
+}
+
+void unitTestSignatureTemplate(DOMImplementation * impl, const XMLCh * c14nURI) {
+
+	cerr << "Sign from compiled template ... ";
+
+	try {
+
+		XSECProvider prov;
+		DOMDocument * tmplDoc = createTestDoc(impl);
+
+		DSIGSignature * tmplSig = prov.newSignature();
+		tmplSig->setDSIGNSPrefix(MAKE_UNICODE_STRING("ds"));
+		tmplSig->setPrettyPrint(true);
+
+		DOMElement * tmplNode = tmplSig->createBlankSignature(tmplDoc, c14nURI,
+			DSIGConstants::s_unicodeStrURIHMAC_SHA1);
+		tmplDoc->getDocumentElement()->appendChild(tmplNode);
+
+		DSIGReference * ref = tmplSig->createReference(MAKE_UNICODE_STRING(""),
+			DSIGConstants::s_unicodeStrURISHA1);
+		ref->appendEnvelopedSignatureTransform();
+
+		DSIGSignatureTemplate tmpl;
+		tmpl.compile(tmplSig);
+
+		const char * products[] = {"XMLSecurityC", "Apache Santuario", NULL};
+
+		for (int i = 0; products[i] != NULL; ++i) {
+
+			// The first is created by the template, the second has its
+			// SignedInfo compared with the template's
+
+			DOMDocument * doc = createTestDoc(impl);
+			DSIGSignature * sig = (i == 0 ?
+				instantiatedMessage(prov, doc, tmpl, products[i]) :
+				templateMessage(prov, doc, tmplNode, products[i]));
+
+			if (!tmpl.sign(sig)) {
+				cerr << "template not used!" << endl;
+				exit(1);
+			}
+
+			if (!sig->verify()) {
+				cerr << "bad verify!" << endl;
+				exit(1);
+			}
+
+			DOMDocument * domDoc = createTestDoc(impl);
+			DSIGSignature * domSig = templateMessage(prov, domDoc, tmplNode, products[i]);
+			domSig->sign();
+
+			if (!strEquals(sig->getSignatureValue(), domSig->getSignatureValue())) {
+				cerr << "signature differs from DOM signature!" << endl;
+				exit(1);
+			}
+
+			prov.releaseSignature(domSig);
+			domDoc->release();
+			prov.releaseSignature(sig);
+			doc->release();
+
+		}
+
+		// A message with different namespaces in scope can't use the
+		// compiled form when canonicalisation is inclusive
+
+		cerr << "changed context ... ";
+
+		DOMDocument * doc = createTestDoc(impl);
+		doc->getDocumentElement()->setAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS,
+			MAKE_UNICODE_STRING("xmlns:bar"), MAKE_UNICODE_STRING("http://www.bar.org"));
+		DSIGSignature * sig = templateMessage(prov, doc, tmplNode, "XMLSecurityC");
+
+		bool used = tmpl.sign(sig);
+		if (used != strEquals(c14nURI, DSIGConstants::s_unicodeStrURIEXC_C14N_NOC)) {
+			cerr << "wrong signing path!" << endl;
+			exit(1);
+		}
+
+		if (!sig->verify()) {
+			cerr << "bad verify!" << endl;
+			exit(1);
+		}
+
+		prov.releaseSignature(sig);
+		doc->release();
+
+		// Nor can a message whose SignedInfo differs from the template
+
+		cerr << "changed SignedInfo ... ";
+
+		const XMLCh * otherC14N = (strEquals(c14nURI, DSIGConstants::s_unicodeStrURIC14N11_NOC) ?
+			DSIGConstants::s_unicodeStrURIC14N_NOC : DSIGConstants::s_unicodeStrURIC14N11_NOC);
+
+		XMLT emptyURI("");
+		XMLT xpointerURI("#xpointer(/)");
+
+		const XMLCh * c14ns[] = {otherC14N, c14nURI};
+		const XMLCh * refURIs[] = {emptyURI.getUnicodeStr(), xpointerURI.getUnicodeStr()};
+
+		for (int i = 0; i < 2; ++i) {
+
+			doc = createTestDoc(impl);
+			sig = changedTemplateMessage(prov, doc, tmplNode, c14ns[i], refURIs[i]);
+
+			if (tmpl.sign(sig)) {
+				cerr << "template used!" << endl;
+				exit(1);
+			}
+
+			if (!sig->verify()) {
+				cerr << "bad verify!" << endl;
+				exit(1);
+			}
+
+			prov.releaseSignature(sig);
+			doc->release();
+
+		}
+
+		cerr << "OK" << endl;
+
+		prov.releaseSignature(tmplSig);
+		tmplDoc->release();
+
+	}
+
+	catch (XSECException &e)
+	{
+		cerr << "An error occured during signature processing\n   Message: ";
+		char * ce = XMLString::transcode(e.getMsg());
+		cerr << ce << endl;
+		delete ce;
+		exit(1);
+		
+	}	
+	catch (XSECCryptoException &e)
+	{
+		cerr << "A cryptographic error occured during signature processing\n   Message: "
+		<< e.getMsg() << endl;
+		exit(1);
+	}
+
+}
+
+void unitTestSignatureTemplatePrefixList(DOMImplementation * impl) {
+
+	// With exclusive canonicalisation, the prefixes in an
+	// InclusiveNamespaces PrefixList are rendered from the ancestors
+
+	cerr << "Sign from compiled template with PrefixList ... ";
+
+	try {
+
+		XSECProvider prov;
+		DOMDocument * tmplDoc = createTestDoc(impl);
+		tmplDoc->getDocumentElement()->setAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS,
+			MAKE_UNICODE_STRING("xmlns:soap"), MAKE_UNICODE_STRING("urn:soap-a"));
+
+		DSIGSignature * tmplSig = prov.newSignature();
+		tmplSig->setDSIGNSPrefix(MAKE_UNICODE_STRING("ds"));
+
+		DOMElement * tmplNode = tmplSig->createBlankSignature(tmplDoc,
+			DSIGConstants::s_unicodeStrURIEXC_C14N_NOC,
+			DSIGConstants::s_unicodeStrURIHMAC_SHA1);
+		tmplDoc->getDocumentElement()->appendChild(tmplNode);
+
+		DSIGReference * ref = tmplSig->createReference(MAKE_UNICODE_STRING(""),
+			DSIGConstants::s_unicodeStrURISHA1);
+		ref->appendEnvelopedSignatureTransform();
+
+		DOMElement * inc = tmplDoc->createElementNS(DSIGConstants::s_unicodeStrURIEC,
+			MAKE_UNICODE_STRING("ec:InclusiveNamespaces"));
+		inc->setAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS,
+			MAKE_UNICODE_STRING("xmlns:ec"), DSIGConstants::s_unicodeStrURIEC);
+		inc->setAttributeNS(NULL, DSIGConstants::s_unicodeStrPrefixList, MAKE_UNICODE_STRING("soap"));
+		tmplNode->getElementsByTagNameNS(DSIGConstants::s_unicodeStrURIDSIG,
+			MAKE_UNICODE_STRING("CanonicalizationMethod"))->item(0)->appendChild(inc);
+
+		DSIGSignatureTemplate tmpl;
+		tmpl.compile(tmplSig);
+
+		// Only a message that binds soap the same way can use the
+		// compiled form
+
+		const char * soapURIs[] = {"urn:soap-a", "urn:soap-b"};
+
+		for (int i = 0; i < 2; ++i) {
+
+			DOMDocument * doc = createTestDoc(impl);
+			doc->getDocumentElement()->setAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS,
+				MAKE_UNICODE_STRING("xmlns:soap"), MAKE_UNICODE_STRING(soapURIs[i]));
+
+			DSIGSignature * sig = instantiatedMessage(prov, doc, tmpl, "XMLSecurityC");
+
+			if (tmpl.sign(sig) != (i == 0)) {
+				cerr << "wrong signing path!" << endl;
+				exit(1);
+			}
+
+			if (!sig->verify()) {
+				cerr << "bad verify!" << endl;
+				exit(1);
+			}
+
+			prov.releaseSignature(sig);
+			doc->release();
+
+		}
+
+		cerr << "OK" << endl;
+
+		prov.releaseSignature(tmplSig);
+		tmplDoc->release();
+
+	}
+
+	catch (XSECException &e)
+	{
+		cerr << "An error occured during signature processing\n   Message: ";
+		char * ce = XMLString::transcode(e.getMsg());
+		cerr << ce << endl;
+		delete ce;
+		exit(1);
+		
+	}	
+	catch (XSECCryptoException &e)
+	{
+		cerr << "A cryptographic error occured during signature processing\n   Message: "
+		<< e.getMsg() << endl;
+		exit(1);
+	}
+
+}
+
+// Resolver that makes up a document for each URI, so the prefetch test
+// needs no network.  Each document is the URI repeated to a few hundred
+// KB so it is fetched in several pieces.
+
+static bool g_loopbackTamper = false;
+
+class LoopbackURIResolver : public XSECURIResolver {
+
+public:
+
+	virtual BinInputStream * resolveURI(const XMLCh * uri) {
+
+		char * u = XMLString::transcode(uri);
+		ArrayJanitor<char> j_u(u);
+
+		unsigned int ulen = (unsigned int) strlen(u);
+		unsigned int count = 20000;
+		XMLByte * buf = new XMLByte[ulen * count];
+		for (unsigned int i = 0; i < count; ++i)
+			memcpy(&buf[i * ulen], u, ulen);
+
+		if (g_loopbackTamper)
+			buf[ulen * count / 2] ^= 1;
+
+		return new BinMemInputStream(buf, ulen * count, BinMemInputStream::BufOpt_Adopt);
+
+	}
+
+	virtual XSECURIResolver * clone(void) {
+		return new LoopbackURIResolver();
+	}
+
+};
+
+void unitTestPrefetchedReferences(DOMImplementation * impl) {
+
+	// Verify a signature over external references fetched by the
+	// threaded prefetcher
+
+	cerr << "Creating signature with external references ... ";
+
+	try {
+
+		DOMDocument * doc = impl->createDocument();
+
+		XSECProvider prov;
+		LoopbackURIResolver resolver;
+		DSIGSignature *sig = prov.newSignature();
+		sig->setURIResolver(&resolver);
+
+		DOMElement * sigNode = sig->createBlankSignature(doc,
+			DSIGConstants::s_unicodeStrURIC14N_COM,
+			DSIGConstants::s_unicodeStrURIHMAC_SHA1);
+		doc->appendChild(sigNode);
+
+		sig->createReference(MAKE_UNICODE_STRING("http://loopback.invalid/one"),
+			DSIGConstants::s_unicodeStrURISHA1);
+		sig->createReference(MAKE_UNICODE_STRING("http://loopback.invalid/two"),
+			DSIGConstants::s_unicodeStrURISHA1);
+		sig->createReference(MAKE_UNICODE_STRING("http://loopback.invalid/three"),
+			DSIGConstants::s_unicodeStrURISHA1);
+
+		cerr << "signing ... ";
+		sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+		sig->sign();
+		prov.releaseSignature(sig);
+
+		for (int pass = 0; pass < 2; ++pass) {
+
+			g_loopbackTamper = (pass == 1);
+			cerr << (pass == 0 ? "prefetch and verify ... " : "prefetch tampered data ... ");
+
+			// Small buffer limit, so the workers have to wait for the
+			// verifier to catch up
+			XSECURIPrefetcherThreaded prefetcher(2, 4096);
+
+			sig = prov.newSignatureFromDOM(doc, sigNode);
+			sig->setURIResolver(&resolver);
+			sig->setURIPrefetcher(&prefetcher);
+			sig->load();
+			sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+
+			bool result = sig->verify();
+			prov.releaseSignature(sig);
+
+			if (result != (pass == 0)) {
+				cerr << "bad verify!" << endl;
+				exit(1);
+			}
+
+		}
+
+		g_loopbackTamper = false;
+
+		cerr << "OK ... abandon unclaimed fetches ... ";
+		{
+			XSECURIPrefetcherThreaded prefetcher(1, 4096);
+			prefetcher.prefetchURI(MAKE_UNICODE_STRING("http://loopback.invalid/one"), &resolver);
+			prefetcher.prefetchURI(MAKE_UNICODE_STRING("http://loopback.invalid/two"), &resolver);
+			if (prefetcher.claimURI(MAKE_UNICODE_STRING("http://loopback.invalid/none")) != NULL) {
+				cerr << "claimed a URI that was never prefetched!" << endl;
+				exit(1);
+			}
+		}
+
+		cerr << "OK" << endl;
+		doc->release();
+
+	}
+
+	catch (XSECException &e)
+	{
+		cerr << "An error occured during signature processing\n   Message: ";
+		char * ce = XMLString::transcode(e.getMsg());
+		cerr << ce << endl;
+		delete ce;
+		exit(1);
+
+	}
+	catch (XSECCryptoException &e)
+	{
+		cerr << "A cryptographic error occured during signature processing\n   Message: "
+		<< e.getMsg() << endl;
+		exit(1);
+	}
+
+}
+
+bool verifyWithResolver(DSIGSignature * sig, XSECURIResolver * resolver) {
+
+	sig->setURIResolver(resolver);
+	sig->load();
+	sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+	return sig->verify();
+
+}
+
+void unitTestCachedReferences(DOMImplementation * impl) {
+
+	// Repeated verification of the same external references through
+	// a caching resolver
+
+	cerr << "Creating signature with cached external references ... ";
+
+	try {
+
+		DOMDocument * doc = impl->createDocument();
+
+		XSECProvider prov;
+		LoopbackURIResolver loopback;
+		XSECURICache cache;
+		cache.setDigestMemo(true);
+		XSECURIResolverCaching resolver(&loopback, &cache);
+
+		DSIGSignature *sig = prov.newSignature();
+		sig->setURIResolver(&resolver);
+
+		DOMElement * sigNode = sig->createBlankSignature(doc,
+			DSIGConstants::s_unicodeStrURIC14N_COM,
+			DSIGConstants::s_unicodeStrURIHMAC_SHA1);
+		doc->appendChild(sigNode);
+
+		sig->createReference(MAKE_UNICODE_STRING("http://loopback.invalid/one"),
+			DSIGConstants::s_unicodeStrURISHA1);
+		sig->createReference(MAKE_UNICODE_STRING("http://loopback.invalid/two"),
+			DSIGConstants::s_unicodeStrURISHA1);
+
+		cerr << "signing ... ";
+		sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+		sig->sign();
+		prov.releaseSignature(sig);
+
+		cerr << "verify from memo ... ";
+		for (int i = 0; i < 2; ++i) {
+			sig = prov.newSignatureFromDOM(doc, sigNode);
+			bool result = verifyWithResolver(sig, &resolver);
+			prov.releaseSignature(sig);
+			if (!result) {
+				cerr << "bad verify!" << endl;
+				exit(1);
+			}
+		}
+
+		if (cache.getMisses() != 2 || cache.getHits() != 4) {
+			cerr << "expected 2 fetches and 4 memo hits!" << endl;
+			exit(1);
+		}
+
+		cerr << "verify from cached content ... ";
+		cache.setDigestMemo(false);
+		sig = prov.newSignatureFromDOM(doc, sigNode);
+		bool result = verifyWithResolver(sig, &resolver);
+		prov.releaseSignature(sig);
+		if (!result || cache.getMisses() != 2) {
+			cerr << "bad verify!" << endl;
+			exit(1);
+		}
+
+		cerr << "refetch changed content ... ";
+		g_loopbackTamper = true;
+		cache.clear();
+		sig = prov.newSignatureFromDOM(doc, sigNode);
+		result = verifyWithResolver(sig, &resolver);
+		prov.releaseSignature(sig);
+		g_loopbackTamper = false;
+
+		if (result || cache.getMisses() != 4) {
+			cerr << "bad - should have failed!" << endl;
+			exit(1);
+		}
+
+		cerr << "OK" << endl;
+		doc->release();
+
+	}
+
+	catch (XSECException &e)
+	{
+		cerr << "An error occured during signature processing\n   Message: ";
+		char * ce = XMLString::transcode(e.getMsg());
+		cerr << ce << endl;
+		delete ce;
+		exit(1);
+
+	}
+	catch (XSECCryptoException &e)
+	{
+		cerr << "A cryptographic error occured during signature processing\n   Message: "
+		<< e.getMsg() << endl;
+		exit(1);
+	}
+
+}
+
+// Byte stream canonicalisation
+
+const char * s_streamC14nInput =
+	"<?xml version=\"1.0\"?>\n<?pi data?>\n<!-- c -->\n"
+	"<a:doc xmlns:a=\"urn:a\" xmlns:b=\"urn:b\" xmlns=\"urn:d\" z=\"1\" b:y=\"2\" a:x=\"&lt;&quot;\">"
+	"<e xmlns:a=\"urn:a\">t &amp; &gt;</e><b:f/></a:doc>\n<!-- after -->\n";
+
+bool streamC14nMatches(DOMImplementation * impl, bool comments, bool exclusive,
+					   const char * expected) {
+
+	DOMDocument * doc = impl->createDocument();
+
+	safeBuffer in;
+	in.sbStrcpyIn(s_streamC14nInput);
+
+	TXFMSB * sb;
+	XSECnew(sb, TXFMSB(doc));
+	sb->setInput(in);
+
+	TXFMChain chain(sb);
+
+	TXFMC14n * c14n;
+	XSECnew(c14n, TXFMC14n(doc));
+	chain.appendTxfm(c14n);
+
+	if (comments)
+		c14n->activateComments();
+	if (exclusive)
+		c14n->setExclusive();
+
+	safeBuffer out;
+	out << chain.getLastTxfm();
+
+	doc->release();
+
+	return strcmp(out.rawCharBuffer(), expected) == 0;
+
+}
+
+void unitTestStreamC14n(DOMImplementation * impl) {
+
+	// Canonicalise a byte stream without parsing it into a DOM
+
+	cerr << "Canonicalising a byte stream ... ";
+
+	try {
+
+		cerr << "inclusive ... ";
+		if (!streamC14nMatches(impl, false, false,
+			"<?pi data?>\n<a:doc xmlns=\"urn:d\" xmlns:a=\"urn:a\" xmlns:b=\"urn:b\" "
+			"z=\"1\" a:x=\"&lt;&quot;\" b:y=\"2\"><e>t &amp; &gt;</e><b:f></b:f></a:doc>")) {
+			cerr << "bad output!" << endl;
+			exit(1);
+		}
+
+		cerr << "with comments ... ";
+		if (!streamC14nMatches(impl, true, false,
+			"<?pi data?>\n<!-- c -->\n<a:doc xmlns=\"urn:d\" xmlns:a=\"urn:a\" xmlns:b=\"urn:b\" "
+			"z=\"1\" a:x=\"&lt;&quot;\" b:y=\"2\"><e>t &amp; &gt;</e><b:f></b:f></a:doc>\n<!-- after -->")) {
+			cerr << "bad output!" << endl;
+			exit(1);
+		}
+
+		cerr << "exclusive ... ";
+		if (!streamC14nMatches(impl, false, true,
+			"<?pi data?>\n<a:doc xmlns:a=\"urn:a\" xmlns:b=\"urn:b\" "
+			"z=\"1\" a:x=\"&lt;&quot;\" b:y=\"2\"><e xmlns=\"urn:d\">t &amp; &gt;</e><b:f></b:f></a:doc>")) {
+			cerr << "bad output!" << endl;
+			exit(1);
+		}
+
+		cerr << "OK" << endl;
+
+	}
+
+	catch (XSECException &e)
+	{
+		cerr << "An error occured during canonicalisation\n   Message: ";
+		char * ce = XMLString::transcode(e.getMsg());
+		cerr << ce << endl;
+		delete ce;
+		exit(1);
+
+	}
+
+}
+
+// Verify an enveloped signature without a DOM of the document
 
-	// Given a specific RSA key and particular algorithm URI, sign and validate a document
+void unitTestStreamingVerifier(DOMImplementation * impl) {
+
+	cerr << "Streaming verification of enveloped signature ... ";
 
 	try {
-		
-		// Create a document
-    
-		DOMDocument * doc = impl->createDocument();
 
-		// Create the signature
+		DOMDocument * doc = createTestDoc(impl);
+		DOMElement * rootElem = doc->getDocumentElement();
 
 		XSECProvider prov;
-		DSIGSignature *sig;
-		DOMElement *sigNode;
-		DSIGReference *ref[4];
-		
-		sig = prov.newSignature();
+		DSIGSignature * sig = prov.newSignature();
 		sig->setDSIGNSPrefix(MAKE_UNICODE_STRING("ds"));
-		sig->setPrettyPrint(true);
 
-		sigNode = sig->createBlankSignature(doc, 
-			DSIGConstants::s_unicodeStrURIC14N_COM,
-			AlgURI);
+		DOMElement * sigNode = sig->createBlankSignature(doc,
+			DSIGConstants::s_unicodeStrURIEXC_C14N_NOC,
+			DSIGConstants::s_unicodeStrURIHMAC_SHA1);
+		rootElem->insertBefore(sigNode, rootElem->getLastChild());
 
-		doc->appendChild(sigNode);
+		DSIGReference * ref = sig->createReference(MAKE_UNICODE_STRING(""),
+			DSIGConstants::s_unicodeStrURISHA256);
+		ref->appendEnvelopedSignatureTransform();
+		ref->appendCanonicalizationTransform(CANON_C14NE_NOC);
 
-		// Add an object
-		DSIGObject * obj = sig->appendObject();
-		obj->setId(MAKE_UNICODE_STRING("ObjectId"));
+		sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+		sig->sign();
+		prov.releaseSignature(sig);
 
-		// Create a text node
-		DOMText * txt= doc->createTextNode(MAKE_UNICODE_STRING("A test string"));
-		obj->appendChild(txt);
+		// The canonical form serves as the serialised document
 
-		// Add a Reference
-		ref[0] = sig->createReference(MAKE_UNICODE_STRING("#ObjectId"), 
-			DSIGConstants::s_unicodeStrURISHA1);
+		safeBuffer out;
+		xsecsize_t outLen = 0;
 
-		// Get a key
-		cerr << "signing ... ";
+		XSECC14n20010315 c14n(doc);
+		unsigned char buf[1024];
+		xsecsize_t len;
 
-		sig->setSigningKey(k->clone());
-		sig->sign();
+		while ((len = c14n.outputBuffer(buf, 1024)) > 0) {
+			out.sbMemcpyIn(outLen, buf, len);
+			outLen += len;
+		}
+		out[outLen] = '\0';
+		out.setBufferType(safeBuffer::BUFFER_CHAR);
 
-		cerr << "OK ... ";
+		doc->release();
 
-		cerr << "validating ... ";
-		if (!sig->verify()) {
+		cerr << "verify ... ";
+
+		DSIGStreamingVerifier verifier;
+		verifier.setSigningKey(createHMACKey((unsigned char *) "secret"));
+
+		if (!verifier.verify(new MemBufInputSource((const XMLByte *) out.rawBuffer(),
+				outLen, "XSECMem"))) {
 			cerr << "bad verify!" << endl;
 			exit(1);
 		}
 
-		cerr << "OK ... serialise and re-verify ... ";
-		if (!reValidateSig(impl, doc, k)) {
+		cerr << "tampered ... ";
 
-			cerr << "bad verify!" << endl;
+		out[out.sbStrstr("XMLSecurityC")] = 'x';
+
+		if (verifier.verify(new MemBufInputSource((const XMLByte *) out.rawBuffer(),
+				outLen, "XSECMem"))) {
+			cerr << "bad - should have failed!" << endl;
 			exit(1);
+		}
 
+		cerr << "profile mismatch ... ";
+
+		verifier.setHashMethod(HASH_SHA1);
+		bool rejected = false;
+
+		try {
+			verifier.verify(new MemBufInputSource((const XMLByte *) out.rawBuffer(),
+				outLen, "XSECMem"));
+		}
+		catch (XSECException &) {
+			rejected = true;
 		}
 
-		cerr << "OK";
+		if (!rejected) {
+			cerr << "bad - should have been rejected!" << endl;
+			exit(1);
+		}
 
-#if 0
-#if defined XSEC_HAVE_OPENSSL
+		// Inclusive canonicalisation of the SignedInfo takes in the
+		// xml: attributes of the Signature's ancestors and (with comments)
+		// any comment in it, neither of which is in the Signature when
+		// it is parsed on its own
 
-		if (g_useWinCAPI || g_useNSS) {
+		cerr << "inclusive SignedInfo ... ";
 
-			cerr << " ... validate against OpenSSL" << endl;
+		doc = createTestDoc(impl);
+		rootElem = doc->getDocumentElement();
+		rootElem->setAttributeNS(XMLUni::fgXMLURIName,
+			MAKE_UNICODE_STRING("xml:lang"), MAKE_UNICODE_STRING("en"));
 
-			BIO * bioMem = BIO_new(BIO_s_mem());
-			BIO_puts(bioMem, s_tstRSAPrivateKey);
-			EVP_PKEY * pk = PEM_read_bio_PrivateKey(bioMem, NULL, NULL, NULL);
+		sig = prov.newSignature();
+		sig->setDSIGNSPrefix(MAKE_UNICODE_STRING("ds"));
 
-			OpenSSLCryptoKeyRSA * rsaKey = new OpenSSLCryptoKeyRSA(pk);
+		sigNode = sig->createBlankSignature(doc,
+			DSIGConstants::s_unicodeStrURIC14N_COM,
+			DSIGConstants::s_unicodeStrURIHMAC_SHA1);
+		rootElem->insertBefore(sigNode, rootElem->getLastChild());
 
-			sig->setSigningKey(rsaKey);
-			if (!sig->verify()) {
-				cerr << "bad verify!" << endl;
-				exit (1);
-			}
+		ref = sig->createReference(MAKE_UNICODE_STRING(""),
+			DSIGConstants::s_unicodeStrURISHA256);
+		ref->appendEnvelopedSignatureTransform();
+		ref->appendCanonicalizationTransform(CANON_C14NE_NOC);
 
-			cerr << "OK";
+		sigNode->getElementsByTagNameNS(DSIGConstants::s_unicodeStrURIDSIG,
+			MAKE_UNICODE_STRING("SignedInfo"))->item(0)->appendChild(
+			doc->createComment(MAKE_UNICODE_STRING(" signed ")));
 
-			BIO_free(bioMem);
-			EVP_PKEY_free(pk);
-		}
-#endif
-#endif
+		sig->setSigningKey(createHMACKey((unsigned char *) "secret"));
+		sig->sign();
+		prov.releaseSignature(sig);
 
-		cerr << "\n";	
+		XSECC14n20010315 c14n2(doc);
+		outLen = 0;
+
+		while ((len = c14n2.outputBuffer(buf, 1024)) > 0) {
+			out.sbMemcpyIn(outLen, buf, len);
+			outLen += len;
+		}
+		out[outLen] = '\0';
+		out.setBufferType(safeBuffer::BUFFER_CHAR);
 
-		outputDoc(impl, doc);
 		doc->release();
-		
+
+		verifier.setHashMethod(HASH_SHA256);
+
+		if (!verifier.verify(new MemBufInputSource((const XMLByte *) out.rawBuffer(),
+				outLen, "XSECMem"))) {
+			cerr << "bad verify!" << endl;
+			exit(1);
+		}
+
+		cerr << "OK" << endl;
 
 	}
 
@@ -1075,8 +2238,8 @@ void unitTestRSASig(DOMImplementation * impl, XSECCryptoKeyRSA * k, const XMLCh
 		cerr << ce << endl;
 		delete ce;
 		exit(1);
-		
-	}	
+
+	}
 	catch (XSECCryptoException &e)
 	{
 		cerr << "A cryptographic error occured during signature processing\n   Message: "
@@ -1086,105 +2249,23 @@ void unitTestRSASig(DOMImplementation * impl, XSECCryptoKeyRSA * k, const XMLCh
 
 }
 
-
-void unitTestRSA(DOMImplementation * impl) {
-
-	/* First we load some keys to use! */
-
-	XSECCryptoKeyRSA * rsaKey;
-
-#if defined (XSEC_HAVE_OPENSSL)
-	if (!g_useWinCAPI && !g_useNSS) {
-		// Load the key
-		BIO * bioMem = BIO_new(BIO_s_mem());
-		BIO_puts(bioMem, s_tstRSAPrivateKey);
-		EVP_PKEY * pk = PEM_read_bio_PrivateKey(bioMem, NULL, NULL, NULL);
-
-		rsaKey = new OpenSSLCryptoKeyRSA(pk);
-
-		BIO_free(bioMem);
-		EVP_PKEY_free(pk);
-	}
-#endif
-
-#if defined (XSEC_HAVE_WINCAPI)
-	if (g_useWinCAPI) {
-
-		// Use the internal key
-		WinCAPICryptoProvider *cp = (WinCAPICryptoProvider *) (XSECPlatformUtils::g_cryptoProvider);
-		HCRYPTPROV p = cp->getApacheKeyStore();
-			
-		rsaKey = new WinCAPICryptoKeyRSA(p, AT_KEYEXCHANGE, true);
-	}
-
-#endif
-
-#if defined (XSEC_HAVE_NSS)
-	if (g_useNSS) {
-		// Heavily based on Mozilla example code
-		SECKEYPrivateKey *prvKey = 0;
-		SECKEYPublicKey *pubKey = 0;
-		PK11SlotInfo *slot = 0;
-		PK11RSAGenParams rsaParams;
-
-		// Use a bog standard key size
-		rsaParams.keySizeInBits = 1024;
-		rsaParams.pe = 65537;
-		
-		// We need somewhere to temporarily store a generated key
-		slot = PK11_GetInternalKeySlot();
-		if (!slot) { 
-			cerr << "Error generating key - can't get NSS slot\n";
-			exit (1);
-		}
-		
-		// Do the generate
-		prvKey = PK11_GenerateKeyPair(slot, CKM_RSA_PKCS_KEY_PAIR_GEN, &rsaParams,
-			&pubKey, PR_FALSE, PR_TRUE, 0);
-		
-		if (!prvKey) {
-			if (slot)
-				PK11_FreeSlot(slot);
-			cerr << "Error generating key within NSS\n";
-			exit (1);
-		}
-		
-		// Now use the key!
-		rsaKey = new NSSCryptoKeyRSA(pubKey, prvKey);
-
-	}
-#endif
-
-	cerr << "Unit testing RSA-SHA1 signature ... ";
-	unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA1);
-
-	if (XSECPlatformUtils::g_cryptoProvider->algorithmSupported(XSECCryptoHash::HASH_SHA512)) {
-		cerr << "Unit testing RSA-SHA224 signature ... ";
-		unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA224);
-		cerr << "Unit testing RSA-SHA256 signature ... ";
-		unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA256);
-		cerr << "Unit testing RSA-SHA384 signature ... ";
-		unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA384);
-		cerr << "Unit testing RSA-SHA512 signature ... ";
-		unitTestRSASig(impl, (XSECCryptoKeyRSA *) rsaKey->clone(), DSIGConstants::s_unicodeStrURIRSA_SHA512);
-	}
-	else
-		cerr << "Skipping non SHA 224/256/384/512 RSA signatures" << endl;
-
-	cerr << "Unit testing RSA-MD5 signature ... ";
-	unitTestRSASig(impl, rsaKey, DSIGConstants::s_unicodeStrURIRSA_MD5);
-	
-		
-}
 void unitTestSignature(DOMImplementation * impl) {
 
 	// Test an enveloping signature
 	unitTestEnvelopingSignature(impl);
-#ifndef XSEC_NO_XALAN
 	unitTestBase64NodeSignature(impl);
-#else
-	cerr << "Skipping base64 node test (Requires XPath)" << endl;
-#endif
+	unitTestSignAndSerialise(impl, false);
+	unitTestSignAndSerialise(impl, true);
+	unitTestSignatureTemplate(impl, DSIGConstants::s_unicodeStrURIC14N_NOC);
+	unitTestSignatureTemplate(impl, DSIGConstants::s_unicodeStrURIEXC_C14N_NOC);
+	unitTestSignatureTemplate(impl, DSIGConstants::s_unicodeStrURIC14N11_NOC);
+	unitTestSignatureTemplatePrefixList(impl);
+	unitTestPrefetchedReferences(impl);
+	unitTestCachedReferences(impl);
+	unitTestStreamC14n(impl);
+	unitTestStreamingVerifier(impl);
+	unitTestMultiHash();
+	unitTestMappedFile();
 
 	// Test "long" sha hashes
 	if (XSECPlatformUtils::g_cryptoProvider->algorithmSupported(XSECCryptoHash::HASH_SHA512))
@@ -1280,16 +2361,16 @@ void testSignature(DOMImplementation *impl) {
 			DSIGConstants::s_unicodeStrURIEXC_C14N_COM);
 		ce->addInclusiveNamespace("foo");
 
-#ifdef XSEC_NO_XALAN
-
-		cerr << "WARNING : No testing of XPath being performed as Xalan not present" << endl;
-		refCount = 7;
-
-#else
 		/*
 		 * Create some XPath/XPathFilter references
 		 */
 
+#ifdef XSEC_NO_XALAN
+
+		cerr << "WARNING : No testing of XPath Filter being performed as Xalan not present" << endl;
+		ref[7] = NULL;
+
+#else
 
 		ref[7] = sig->createReference(MAKE_UNICODE_STRING(""),
 			DSIGConstants::s_unicodeStrURISHA1);
@@ -1297,6 +2378,11 @@ void testSignature(DOMImplementation *impl) {
 		DSIGTransformXPathFilter * xpf = ref[7]->appendXPathFilterTransform();
 		xpf->appendFilter(FILTER_INTERSECT, MAKE_UNICODE_STRING("//ADoc/category"));
 
+#endif
+
+		// The enveloped signature expression is evaluated natively, so
+		// does not need Xalan
+
 		ref[8] = sig->createReference(MAKE_UNICODE_STRING(""),
 			DSIGConstants::s_unicodeStrURISHA1);
 		/*		ref[5]->appendXPathTransform("ancestor-or-self::dsig:Signature", 
@@ -1308,8 +2394,6 @@ count(ancestor-or-self::dsig:Signature)");
 		x->setNamespace("dsig", "http://www.w3.org/2000/09/xmldsig#");
 
 		refCount = 9;
-
-#endif
 	
 		/*
 		 * Sign the document, using an HMAC algorithm and the key "secret"
@@ -1351,6 +2435,9 @@ count(ancestor-or-self::dsig:Signature)");
 		int i;
 		for (i = 0; i < refCount; ++i) {
 
+			if (ref[i] == NULL)
+				continue;
+
 			cerr << "Calculating hash for reference " << i << " ... ";
 
 			len = (int) ref[i]->calculateHash(buf, 128);
@@ -2171,6 +3258,20 @@ void unitTestEncrypt(DOMImplementation *impl) {
 			cerr << "Unit testing AES 256 bit CBC encryption" << endl;
 			unitTestElementContentEncrypt(impl, ks->clone(), ENCRYPT_AES256_CBC, false);
 			unitTestElementContentEncrypt(impl, ks, ENCRYPT_AES256_CBC, true);
+
+			// GCM (streamed decrypt, tag checked at end of cipher text)
+			ks = XSECPlatformUtils::g_cryptoProvider->keySymmetric(XSECCryptoSymmetricKey::KEY_AES_128);
+			ks->setKey((unsigned char *) s_keyStr, 16);
+
+			if (ks->supportsDeferredTag()) {
+				cerr << "Unit testing AES 128 bit GCM encryption" << endl;
+				unitTestElementContentEncrypt(impl, ks->clone(), ENCRYPT_AES128_GCM, false);
+				unitTestElementContentEncrypt(impl, ks, ENCRYPT_AES128_GCM, true);
+			}
+			else {
+				delete ks;
+				cerr << "Skipped AES GCM streaming tests" << endl;
+			}
 		}
 
 		else
@@ -2493,7 +3594,152 @@ void testXKMS(DOMImplementation *impl) {
 	doc->release();
 }
 #endif
-	
+
+// --------------------------------------------------------------------------------
+//           Startup cost
+// --------------------------------------------------------------------------------
+
+void testConstants(void) {
+
+	// The constant strings are static XMLCh tables written out by hand -
+	// check every one against the char definition it stands for
+
+	cerr << "Checking static constant strings ... ";
+
+	struct {
+		const XMLCh		* str;
+		const char		* expected;
+	} constants[] = {
+
+		{DSIGConstants::s_unicodeStrEmpty, ""},
+		{DSIGConstants::s_unicodeStrNL, "\n"},
+		{DSIGConstants::s_unicodeStrXmlns, "xmlns"},
+		{DSIGConstants::s_unicodeStrURI, "URI"},
+		{DSIGConstants::s_unicodeStrAlgorithm, "Algorithm"},
+		{DSIGConstants::s_unicodeStrPrefixList, "PrefixList"},
+		{DSIGConstants::s_unicodeStrURIDSIG, URI_ID_DSIG},
+		{DSIGConstants::s_unicodeStrURIDSIG11, URI_ID_DSIG11},
+		{DSIGConstants::s_unicodeStrURIEC, URI_ID_EC},
+		{DSIGConstants::s_unicodeStrURIXPF, URI_ID_XPF},
+		{DSIGConstants::s_unicodeStrURIXENC, URI_ID_XENC},
+		{DSIGConstants::s_unicodeStrURIXENC11, URI_ID_XENC11},
+		{DSIGConstants::s_unicodeStrURISIGBASE, URI_ID_SIG_BASE},
+		{DSIGConstants::s_unicodeStrURISIGBASEMORE, URI_ID_SIG_BASEMORE},
+		{DSIGConstants::s_unicodeStrURISIGBASE11, URI_ID_SIG_BASE11},
+		{DSIGConstants::s_unicodeStrURIRawX509, URI_ID_RAWX509},
+		{DSIGConstants::s_unicodeStrURISHA1, URI_ID_SHA1},
+		{DSIGConstants::s_unicodeStrURISHA224, URI_ID_SHA224},
+		{DSIGConstants::s_unicodeStrURISHA256, URI_ID_SHA256},
+		{DSIGConstants::s_unicodeStrURISHA384, URI_ID_SHA384},
+		{DSIGConstants::s_unicodeStrURISHA512, URI_ID_SHA512},
+		{DSIGConstants::s_unicodeStrURIMD5, URI_ID_MD5},
+		{DSIGConstants::s_unicodeStrURIBASE64, URI_ID_BASE64},
+		{DSIGConstants::s_unicodeStrURIXPATH, URI_ID_XPATH},
+		{DSIGConstants::s_unicodeStrURIXSLT, URI_ID_XSLT},
+		{DSIGConstants::s_unicodeStrURIENVELOPE, URI_ID_ENVELOPE},
+		{DSIGConstants::s_unicodeStrURIC14N_NOC, URI_ID_C14N_NOC},
+		{DSIGConstants::s_unicodeStrURIC14N_COM, URI_ID_C14N_COM},
+		{DSIGConstants::s_unicodeStrURIC14N11_NOC, URI_ID_C14N11_NOC},
+		{DSIGConstants::s_unicodeStrURIC14N11_COM, URI_ID_C14N11_COM},
+		{DSIGConstants::s_unicodeStrURIEXC_C14N_NOC, URI_ID_EXC_C14N_NOC},
+		{DSIGConstants::s_unicodeStrURIEXC_C14N_COM, URI_ID_EXC_C14N_COM},
+		{DSIGConstants::s_unicodeStrURIDSA_SHA1, URI_ID_DSA_SHA1},
+		{DSIGConstants::s_unicodeStrURIDSA_SHA256, URI_ID_DSA_SHA256},
+		{DSIGConstants::s_unicodeStrURIRSA_MD5, URI_ID_RSA_MD5},
+		{DSIGConstants::s_unicodeStrURIRSA_SHA1, URI_ID_RSA_SHA1},
+		{DSIGConstants::s_unicodeStrURIRSA_SHA224, URI_ID_RSA_SHA224},
+		{DSIGConstants::s_unicodeStrURIRSA_SHA256, URI_ID_RSA_SHA256},
+		{DSIGConstants::s_unicodeStrURIRSA_SHA384, URI_ID_RSA_SHA384},
+		{DSIGConstants::s_unicodeStrURIRSA_SHA512, URI_ID_RSA_SHA512},
+		{DSIGConstants::s_unicodeStrURIECDSA_SHA1, URI_ID_ECDSA_SHA1},
+		{DSIGConstants::s_unicodeStrURIECDSA_SHA224, URI_ID_ECDSA_SHA224},
+		{DSIGConstants::s_unicodeStrURIECDSA_SHA256, URI_ID_ECDSA_SHA256},
+		{DSIGConstants::s_unicodeStrURIECDSA_SHA384, URI_ID_ECDSA_SHA384},
+		{DSIGConstants::s_unicodeStrURIECDSA_SHA512, URI_ID_ECDSA_SHA512},
+		{DSIGConstants::s_unicodeStrURIHMAC_SHA1, URI_ID_HMAC_SHA1},
+		{DSIGConstants::s_unicodeStrURIHMAC_SHA224, URI_ID_HMAC_SHA224},
+		{DSIGConstants::s_unicodeStrURIHMAC_SHA256, URI_ID_HMAC_SHA256},
+		{DSIGConstants::s_unicodeStrURIHMAC_SHA384, URI_ID_HMAC_SHA384},
+		{DSIGConstants::s_unicodeStrURIHMAC_SHA512, URI_ID_HMAC_SHA512},
+		{DSIGConstants::s_unicodeStrURIXMLNS, URI_ID_XMLNS},
+		{DSIGConstants::s_unicodeStrURIMANIFEST, URI_ID_MANIFEST},
+		{DSIGConstants::s_unicodeStrURI3DES_CBC, URI_ID_3DES_CBC},
+		{DSIGConstants::s_unicodeStrURIAES128_CBC, URI_ID_AES128_CBC},
+		{DSIGConstants::s_unicodeStrURIAES192_CBC, URI_ID_AES192_CBC},
+		{DSIGConstants::s_unicodeStrURIAES256_CBC, URI_ID_AES256_CBC},
+		{DSIGConstants::s_unicodeStrURIAES128_GCM, URI_ID_AES128_GCM},
+		{DSIGConstants::s_unicodeStrURIAES192_GCM, URI_ID_AES192_GCM},
+		{DSIGConstants::s_unicodeStrURIAES256_GCM, URI_ID_AES256_GCM},
+		{DSIGConstants::s_unicodeStrURIKW_3DES, URI_ID_KW_3DES},
+		{DSIGConstants::s_unicodeStrURIKW_AES128, URI_ID_KW_AES128},
+		{DSIGConstants::s_unicodeStrURIKW_AES192, URI_ID_KW_AES192},
+		{DSIGConstants::s_unicodeStrURIKW_AES256, URI_ID_KW_AES256},
+		{DSIGConstants::s_unicodeStrURIKW_AES128_PAD, URI_ID_KW_AES128_PAD},
+		{DSIGConstants::s_unicodeStrURIKW_AES192_PAD, URI_ID_KW_AES192_PAD},
+		{DSIGConstants::s_unicodeStrURIKW_AES256_PAD, URI_ID_KW_AES256_PAD},
+		{DSIGConstants::s_unicodeStrURIRSA_1_5, URI_ID_RSA_1_5},
+		{DSIGConstants::s_unicodeStrURIRSA_OAEP_MGFP1, URI_ID_RSA_OAEP_MGFP1},
+		{DSIGConstants::s_unicodeStrURIRSA_OAEP, URI_ID_RSA_OAEP},
+		{DSIGConstants::s_unicodeStrURIMGF1_BASE, URI_ID_MGF1_BASE},
+		{DSIGConstants::s_unicodeStrURIMGF1_SHA1, URI_ID_MGF1_SHA1},
+		{DSIGConstants::s_unicodeStrURIMGF1_SHA224, URI_ID_MGF1_SHA224},
+		{DSIGConstants::s_unicodeStrURIMGF1_SHA256, URI_ID_MGF1_SHA256},
+		{DSIGConstants::s_unicodeStrURIMGF1_SHA384, URI_ID_MGF1_SHA384},
+		{DSIGConstants::s_unicodeStrURIMGF1_SHA512, URI_ID_MGF1_SHA512},
+		{DSIGConstants::s_unicodeStrURIXENC_ELEMENT, URI_ID_XENC_ELEMENT},
+		{DSIGConstants::s_unicodeStrURIXENC_CONTENT, URI_ID_XENC_CONTENT},
+		{DSIGConstants::s_unicodeStrPROVOpenSSL, PROV_OPENSSL},
+		{DSIGConstants::s_unicodeStrPROVWinCAPI, PROV_WINCAPI},
+		{DSIGConstants::s_unicodeStrPROVNSS, PROV_NSS},
+		{XKMSConstants::s_unicodeStrURIXKMS, URI_ID_XKMS},
+		{XKMSConstants::s_unicodeStrURISOAP11, URI_ID_SOAP11},
+		{XKMSConstants::s_unicodeStrURISOAP12, URI_ID_SOAP12},
+		{NULL, NULL}
+
+	};
+
+	for (int i = 0; constants[i].str != NULL; ++i) {
+
+		if (!strEquals(constants[i].str, constants[i].expected)) {
+
+			cerr << "Bad constant : " << constants[i].expected << endl;
+			exit(1);
+
+		}
+
+	}
+
+	cerr << "OK" << endl;
+
+}
+
+void testStartup(void) {
+
+	// Time full Terminate/Initialise cycles.  The library is left
+	// initialised, as main() expects.
+
+	const int cycles = 1000;
+
+	cerr << "Timing " << cycles << " Terminate/Initialise cycles ... ";
+
+	clock_t start = clock();
+
+	for (int i = 0; i < cycles; ++i) {
+
+		XSECPlatformUtils::Terminate();
+		XSECPlatformUtils::Initialise();
+
+	}
+
+	clock_t elapsed = clock() - start;
+
+	cerr << "OK" << endl;
+	cerr << "Initialise/Terminate cost : "
+		 << ((double) elapsed * 1000000.0 / CLOCKS_PER_SEC / cycles)
+		 << " us per cycle" << endl;
+
+}
+
 // --------------------------------------------------------------------------------
 //           Print usage instructions
 // --------------------------------------------------------------------------------
@@ -2522,6 +3768,8 @@ void printUsage(void) {
 	cerr << "         Only run basic encryption test\n\n";
 	cerr << "     --encryption-unit-only/-u\n";
 	cerr << "         Only run encryption unit tests\n\n";
+	cerr << "     --startup-only/-i\n";
+	cerr << "         Only time library start up\n\n";
 //	cerr << "     --xkms-only/-x\n";
 //	cerr << "         Only run basic XKMS test\n\n";
 
@@ -2546,6 +3794,7 @@ int main(int argc, char **argv) {
 	bool		doSignatureTest = true;
 	bool		doSignatureUnitTests = true;
 	bool		doXKMSTest = true;
+	bool		doStartupTest = false;
 
 	// Testing for which Crypto API to use by default - only really useful on windows
 #if !defined(XSEC_HAVE_OPENSSL)
@@ -2607,6 +3856,15 @@ int main(int argc, char **argv) {
 			doXKMSTest = false;
 			paramCount++;
 		}
+		else if (_stricmp(argv[paramCount], "--startup-only") == 0 || _stricmp(argv[paramCount], "-i") == 0) {
+			doEncryptionTest = false;
+			doSignatureTest = false;
+			doEncryptionUnitTests = false;
+			doSignatureUnitTests = false;
+			doXKMSTest = false;
+			doStartupTest = true;
+			paramCount++;
+		}
 /*		else if (stricmp(argv[paramCount], "--xkms-only") == 0 || stricmp(argv[paramCount], "-x") == 0) {
 			doEncryptionTest = false;
 			doSignatureTest = false;
@@ -2691,6 +3949,19 @@ int main(int argc, char **argv) {
 		cerr << "Crypto Provider string : " << provName << endl;
 		XSEC_RELEASE_XMLCH(provName);
 
+		// The constant tables underlie everything else
+		testConstants();
+
+		// Library start up
+		if (doStartupTest) {
+			cerr << endl << "====================================";
+			cerr << endl << "Testing Library Startup";
+			cerr << endl << "====================================";
+			cerr << endl << endl;
+
+			testStartup();
+		}
+
 		// Test signature functions
 		if (doSignatureTest) {
 			cerr << endl << "====================================";
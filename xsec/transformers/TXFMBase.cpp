@@ -69,7 +69,19 @@ void TXFMBase::expandNameSpaces(void) {
 
 	if (mp_nse != NULL || (input != NULL && input->nameSpacesExpanded()))
 		return;		// Already done
-	
+
+	// If the nodes we pass on come from a different document (e.g. one
+	// created by a parser further up the chain), the expansion belongs
+	// to the transform that owns that document.
+
+	if (input != NULL && input->getDocument() != NULL &&
+		input->getDocument() != mp_expansionDoc) {
+
+		input->expandNameSpaces();
+		return;
+
+	}
+
 	XSECnew(mp_nse, XSECNameSpaceExpander(mp_expansionDoc));
 
 	mp_nse->expandNameSpaces();
@@ -130,6 +130,11 @@ public:
 	// BinInputStream methods:
 
 	virtual unsigned int readBytes(XMLByte * const toFill, const unsigned int maxToFill) = 0;
+
+	// Hand over all remaining output as one block of memory (if the
+	// transform happens to hold it that way) so it can be hashed without
+	// being copied.  The bytes count as read.  Default is not available.
+	virtual const XMLByte * consumeOutput(xsecsize_t & length) {length = 0; return NULL;}
 	virtual XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument *getDocument() = 0;
 	virtual XERCES_CPP_NAMESPACE_QUALIFIER DOMNode *getFragmentNode() = 0;
 	virtual const XMLCh * getFragmentId() = 0;
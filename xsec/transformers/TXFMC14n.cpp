@@ -30,14 +30,29 @@
 
 #include <xsec/transformers/TXFMC14n.hpp>
 #include <xsec/framework/XSECException.hpp>
-#include <xsec/transformers/TXFMParser.hpp>
+#include <xsec/transformers/TXFMChain.hpp>
 #include <xsec/framework/XSECError.hpp>
+#include <xsec/canon/XSECC14nSAX.hpp>
+#include <xsec/utils/XSECTXFMInputSource.hpp>
+
+#include <xercesc/framework/XMLFormatter.hpp>
 
 XERCES_CPP_NAMESPACE_USE
 
+// Output held back after the excluded node is kept in memory up to this
+// many bytes, then spooled to a temporary file
+
+#define TXFMC14N_HOLD_LIMIT		65536
+
 TXFMC14n::TXFMC14n(DOMDocument *doc) : TXFMBase(doc) {
 
 	mp_c14n = NULL;
+	mp_saxC14n = NULL;
+	mp_inputChain = NULL;
+	mp_target = NULL;
+	m_heldLength = 0;
+	mp_spool = NULL;
+	m_outputCount = 0;
 
 }
 TXFMC14n::~TXFMC14n() {
@@ -46,35 +61,49 @@ TXFMC14n::~TXFMC14n() {
 		delete mp_c14n;
 	}
 
+	// The canonicaliser's parser reads through the chain
+	if (mp_saxC14n != NULL) {
+		delete mp_saxC14n;
+	}
+
+	if (mp_inputChain != NULL) {
+		delete mp_inputChain;
+	}
+
+	if (mp_spool != NULL) {
+		fclose(mp_spool);
+	}
+
 }
 
 // Methods to set the inputs
 
 void TXFMC14n::setInput(TXFMBase *newInput) {
 
+	input = newInput;
+
+	// Set up for comments  - by default we ALWAYS strip comments
+
+	keepComments = false;
+
 	if (newInput->getOutputType() == TXFMBase::BYTE_STREAM) {
 
-		//throw XSECException(XSECException::TransformInputOutputFail, "C14n canonicalisation transform requires DOM_NODES input");
-		// Need to parse into DOM_NODES
-		TXFMParser * parser;
-		XSECnew(parser, TXFMParser(mp_expansionDoc));
-		try{
-			parser->setInput(newInput);
-		}
-		catch (...) {
-			delete parser;
-			input = newInput;		// Ensure chain will be deleted.
-			throw;
-		}
+		// A byte stream is a complete document.  Rather than parse it into
+		// a DOM, canonicalise straight from the parser's events as the
+		// bytes are read.  The chain is only a wrapper here - the
+		// transforms are still owned by whoever owns this transform.
 
-		input = parser;
-	}
-	else
-		input = newInput;
+		XSECTXFMInputSource * is;
 
-	// Set up for comments  - by default we ALWAYS strip comments
+		XSECnew(mp_inputChain, TXFMChain(newInput, false));
+		XSECnew(is, XSECTXFMInputSource(mp_inputChain, false));
+		XSECnew(mp_saxC14n, XSECC14nSAX(is));
 
-	keepComments = false;
+		mp_saxC14n->setCommentsProcessing(keepComments);
+
+		return;
+
+	}
 
 	TXFMBase::nodeType type = input->getNodeType();
 
@@ -122,6 +151,8 @@ void TXFMC14n::activateComments(void) {
 
 	if (mp_c14n != NULL)
 		mp_c14n->setCommentsProcessing(keepComments);
+	if (mp_saxC14n != NULL)
+		mp_saxC14n->setCommentsProcessing(keepComments);
 
 }
 
@@ -129,6 +160,8 @@ void TXFMC14n::setExclusive() {
 
 	if (mp_c14n != NULL)
 		mp_c14n->setExclusive();
+	if (mp_saxC14n != NULL)
+		mp_saxC14n->setExclusive();
 
 }
 
@@ -136,6 +169,8 @@ void TXFMC14n::setExclusive(safeBuffer & NSList) {
 
 	if (mp_c14n != NULL)
 		mp_c14n->setExclusive((char *) NSList.rawBuffer());
+	if (mp_saxC14n != NULL)
+		mp_saxC14n->setExclusive((char *) NSList.rawBuffer());
 
 }
 
@@ -143,6 +178,128 @@ void TXFMC14n::setInclusive11() {
 
     if (mp_c14n != NULL)
         mp_c14n->setInclusive11();
+    if (mp_saxC14n != NULL)
+        mp_saxC14n->setInclusive11();
+
+}
+
+// Output target
+
+void TXFMC14n::setOutputTarget(XMLFormatTarget * target, DOMNode * excluded) {
+
+	if (mp_c14n == NULL && mp_saxC14n == NULL) {
+		throw XSECException(XSECException::TransformError,
+			"TXFMC14n::setOutputTarget called before setInput");
+	}
+
+	// A byte stream has no nodes to exclude
+	if (mp_c14n == NULL && excluded != NULL) {
+		throw XSECException(XSECException::TransformError,
+			"TXFMC14n::setOutputTarget cannot exclude a node from a byte stream");
+	}
+
+	mp_target = target;
+	if (mp_c14n != NULL)
+		mp_c14n->setExcludedNode(excluded);
+
+}
+
+void TXFMC14n::writeOutput(const XMLByte * buf, unsigned int len) {
+
+	// Everything before the excluded node goes straight out, everything
+	// after it is held for writeHeldOutput().  The offset is only known once
+	// the canonicaliser has passed the node, but no byte beyond it can have
+	// been read before then.
+
+	unsigned int direct = len;
+	xsecsize_t offset;
+
+	if (mp_c14n != NULL && mp_c14n->getExcludedNodeOffset(offset)) {
+
+		if (m_outputCount >= offset)
+			direct = 0;
+		else if (m_outputCount + len > offset)
+			direct = (unsigned int) (offset - m_outputCount);
+
+	}
+
+	if (direct > 0)
+		mp_target->writeChars(buf, direct, NULL);
+
+	if (direct < len)
+		holdOutput(&buf[direct], len - direct);
+
+	m_outputCount += len;
+
+}
+
+void TXFMC14n::holdOutput(const XMLByte * buf, unsigned int len) {
+
+	// An enveloped signature is usually near the start of the document,
+	// so almost all of it can follow.  Only a bounded amount is kept in
+	// memory.
+
+	if (mp_spool == NULL && m_heldLength + len <= TXFMC14N_HOLD_LIMIT) {
+		m_held.sbMemcpyIn(m_heldLength, buf, len);
+		m_heldLength += len;
+		return;
+	}
+
+	if (mp_spool == NULL) {
+
+		mp_spool = tmpfile();
+		if (mp_spool == NULL) {
+			throw XSECException(XSECException::TransformError,
+				"TXFMC14n - unable to create a temporary file for held output");
+		}
+
+		if (m_heldLength > 0 &&
+			fwrite(m_held.rawBuffer(), 1, m_heldLength, mp_spool) != (size_t) m_heldLength) {
+			throw XSECException(XSECException::TransformError,
+				"TXFMC14n - error writing held output to a temporary file");
+		}
+
+		m_heldLength = 0;
+
+	}
+
+	if (fwrite(buf, 1, len, mp_spool) != (size_t) len) {
+		throw XSECException(XSECException::TransformError,
+			"TXFMC14n - error writing held output to a temporary file");
+	}
+
+}
+
+void TXFMC14n::writeHeldOutput(void) {
+
+	if (mp_spool != NULL) {
+
+		rewind(mp_spool);
+
+		XMLByte buf[4096];
+		size_t len;
+
+		while ((len = fread(buf, 1, 4096, mp_spool)) > 0) {
+			if (mp_target != NULL)
+				mp_target->writeChars(buf, (XMLSize_t) len, NULL);
+		}
+
+		bool failed = (ferror(mp_spool) != 0);
+
+		fclose(mp_spool);
+		mp_spool = NULL;
+
+		if (failed) {
+			throw XSECException(XSECException::TransformError,
+				"TXFMC14n - error reading held output from a temporary file");
+		}
+
+	}
+
+	else if (mp_target != NULL && m_heldLength > 0)
+		mp_target->writeChars(m_held.rawBuffer(), m_heldLength, NULL);
+
+	m_heldLength = 0;
 
 }
 
@@ -170,11 +327,19 @@ TXFMBase::nodeType TXFMC14n::getNodeType(void) {
 
 unsigned int TXFMC14n::readBytes(XMLByte * const toFill, unsigned int maxToFill) {
 
-	if (mp_c14n == NULL)
+	unsigned int ret;
 
+	if (mp_c14n != NULL)
+		ret = (unsigned int) mp_c14n->outputBuffer(toFill, maxToFill);
+	else if (mp_saxC14n != NULL)
+		ret = (unsigned int) mp_saxC14n->outputBuffer(toFill, maxToFill);
+	else
 		return 0;
 
-	return (unsigned int) mp_c14n->outputBuffer(toFill, maxToFill);
+	if (mp_target != NULL && ret > 0)
+		writeOutput(toFill, ret);
+
+	return ret;
 
 }
 
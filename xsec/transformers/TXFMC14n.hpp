@@ -31,9 +31,27 @@
 #include <xsec/canon/XSECC14n20010315.hpp>
 #include <xsec/utils/XSECNameSpaceExpander.hpp>
 
+#include <stdio.h>
+
+XSEC_DECLARE_XERCES_CLASS(XMLFormatTarget);
+
+class XSECC14nSAX;
+class TXFMChain;
+
 /**
  * \brief Transformer to handle canonicalisation transforms
  * @ingroup internal
+ *
+ * When an output target is set, every byte read through the transform is
+ * also written to the target, so a document can be digested and
+ * serialised in the same walk.  An excluded node (an enveloped signature)
+ * is skipped in the canonical output; anything that follows it is held
+ * back until writeHeldOutput() is called, so the caller can write the
+ * excluded node in between.  Held output beyond 64K is spooled to a
+ * temporary file rather than kept in memory.
+ *
+ * Byte stream input is canonicalised from SAX2 events as it is parsed,
+ * rather than being parsed into a DOM first.
  */
 
 class DSIG_EXPORT TXFMC14n : public TXFMBase {
@@ -41,6 +59,19 @@ class DSIG_EXPORT TXFMC14n : public TXFMBase {
 private:
 
 	XSECC14n20010315		* mp_c14n;			// The actual canonicaliser
+	XSECC14nSAX				* mp_saxC14n;		// Used instead for byte stream input
+	TXFMChain				* mp_inputChain;	// Wraps the input for mp_saxC14n
+
+	// Output target handling
+	XERCES_CPP_NAMESPACE_QUALIFIER XMLFormatTarget
+							* mp_target;		// Where a copy of the output goes
+	safeBuffer				m_held;				// Output following the excluded node
+	xsecsize_t				m_heldLength;
+	FILE					* mp_spool;			// Held output past the in-memory limit
+	xsecsize_t				m_outputCount;		// Bytes read so far
+
+	void writeOutput(const XMLByte * buf, unsigned int len);
+	void holdOutput(const XMLByte * buf, unsigned int len);
 
 public:
 
@@ -67,6 +98,11 @@ public:
 	// Set inclusive 1.1
 	virtual void setInclusive11();
 
+	// Copy output to a target, leaving out an excluded node
+	void setOutputTarget(XERCES_CPP_NAMESPACE_QUALIFIER XMLFormatTarget * target,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * excluded);
+	void writeHeldOutput(void);
+
 	// Methods to get output data
 
 	virtual unsigned int readBytes(XMLByte * const toFill, const unsigned int maxToFill);
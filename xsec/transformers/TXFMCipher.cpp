@@ -44,7 +44,8 @@ TXFMBase(doc),
 m_doEncrypt(encrypt),
 m_taglen(taglen),
 mp_cipher(NULL),
-m_remaining(0) {
+m_remaining(0),
+m_held(0) {
 
     if (key && key->getKeyType() == XSECCryptoKey::KEY_SYMMETRIC)
 	    mp_cipher = key->clone();
@@ -56,6 +57,23 @@ m_remaining(0) {
 
 	m_complete = false;
 
+	if (!m_doEncrypt && m_taglen > 0 &&
+		!((XSECCryptoSymmetricKey *) mp_cipher)->supportsDeferredTag()) {
+
+		delete mp_cipher;
+		mp_cipher = NULL;
+		throw XSECException(XSECException::CipherError, 
+				"TXFMCipher - crypto provider cannot stream authenticated decryption");
+	}
+
+	if (m_taglen > 1024) {
+
+		delete mp_cipher;
+		mp_cipher = NULL;
+		throw XSECException(XSECException::CipherError, 
+				"TXFMCipher - authentication tag length out of range");
+	}
+
 	try {
 		if (m_doEncrypt)
 			((XSECCryptoSymmetricKey *) (mp_cipher))->encryptInit((mode != XSECCryptoSymmetricKey::MODE_GCM), mode);
@@ -137,12 +155,12 @@ unsigned int TXFMCipher::readBytes(XMLByte * const toFill, unsigned int maxToFil
 
 		if (m_complete == false && m_remaining == 0) {
 
-			unsigned int sz = input->readBytes(m_inputBuffer, 2048);
-		
 			XSECCryptoSymmetricKey * symCipher = 
 				(XSECCryptoSymmetricKey*) mp_cipher;
 			if (m_doEncrypt) {
 					
+				unsigned int sz = input->readBytes(m_inputBuffer, 2048);
+
 				if (sz == 0) {
 					m_complete = true;
 					m_remaining = symCipher->encryptFinish(m_outputBuffer, 3072, m_taglen);
@@ -150,7 +168,9 @@ unsigned int TXFMCipher::readBytes(XMLByte * const toFill, unsigned int maxToFil
 				else
 					m_remaining = symCipher->encrypt(m_inputBuffer, m_outputBuffer, sz, 3072);
 			}
-			else {
+			else if (m_taglen == 0) {
+
+				unsigned int sz = input->readBytes(m_inputBuffer, 2048);
 
 				if (sz == 0) {
 					m_complete = true;
@@ -159,6 +179,34 @@ unsigned int TXFMCipher::readBytes(XMLByte * const toFill, unsigned int maxToFil
 				else
 					m_remaining = symCipher->decrypt(m_inputBuffer, m_outputBuffer, sz, 3072);
 			}
+			else {
+
+				// The tag sits at the end of the cipher text, so the last m_taglen
+				// bytes seen are kept at the front of the input buffer until
+				// we know whether or not there is more to come.
+
+				unsigned int sz = input->readBytes(&m_inputBuffer[m_held], 2048 - m_held);
+
+				if (sz == 0) {
+					m_complete = true;
+					if (m_held < m_taglen) {
+						throw XSECException(XSECException::CipherError, 
+							"TXFMCipher - cipher text not large enough to include authentication tag");
+					}
+					symCipher->decryptSetTag(m_inputBuffer, m_taglen);
+					m_remaining = symCipher->decryptFinish(m_outputBuffer, 3072);
+				}
+				else {
+					sz += m_held;
+					if (sz > m_taglen) {
+						m_remaining = symCipher->decrypt(m_inputBuffer, m_outputBuffer, sz - m_taglen, 3072);
+						memmove(m_inputBuffer, &m_inputBuffer[sz - m_taglen], m_taglen);
+						m_held = m_taglen;
+					}
+					else
+						m_held = sz;
+				}
+			}
 		}
 
 	}
@@ -39,6 +39,12 @@
  *
  * Note that there is no particular XML DSIG/XENC transform associated
  * with encryption, but this is a convenient way to handle this process.
+ *
+ * For AEAD decryption (AES-GCM) the authentication tag trails the cipher
+ * text, so the final taglen bytes read are always held back and handed
+ * to the key when the input is exhausted.  Output is streamed as it is
+ * decrypted, which means it is not authenticated until the final
+ * readBytes call returns without throwing.
  * @ingroup internal
  */
 
@@ -86,6 +92,7 @@ private:
 	unsigned char			m_inputBuffer[2050];
 	unsigned char			m_outputBuffer[3072];	// Always keep 2K of data
 	unsigned int			m_remaining;		// Amount remaining in output
+	unsigned int			m_held;				// Trailing input held back as a possible tag
 
 };
 
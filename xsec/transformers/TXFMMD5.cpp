@@ -30,6 +30,7 @@
 
 #include <xsec/transformers/TXFMMD5.hpp>
 #include <xsec/utils/XSECPlatformUtils.hpp>
+#include <xsec/utils/XSECHashPool.hpp>
 #include <xsec/framework/XSECException.hpp>
 
 XERCES_CPP_NAMESPACE_USE
@@ -41,9 +42,11 @@ TXFMMD5::TXFMMD5(DOMDocument *doc,
 
 	toOutput = 0;					// Nothing yet to output
 
+	m_pooled = (key == NULL);
+
 	if (key == NULL)
-		// Get a MD5 worker
-		mp_h = XSECPlatformUtils::g_cryptoProvider->hashMD5();
+		// Borrow a MD5 worker
+		mp_h = XSECHashPool::getHash(XSECCryptoHash::HASH_MD5);
 	else {
 		// Get an HMAC MD5
 		
@@ -65,8 +68,12 @@ TXFMMD5::TXFMMD5(DOMDocument *doc,
 TXFMMD5::~TXFMMD5() {
 
 	// Clean up
-	if (mp_h)
-		delete mp_h;
+	if (mp_h) {
+		if (m_pooled)
+			XSECHashPool::releaseHash(mp_h);
+		else
+			delete mp_h;
+	}
 
 };
 
@@ -102,6 +109,17 @@ void TXFMMD5::setInput(TXFMBase * inputT) {
 
 	keepComments = input->getCommentsStatus();
 
+	// A mapped input can be hashed in place (in pieces the hash
+	// interface can take)
+	xsecsize_t spanLen;
+	const XMLByte * span = input->consumeOutput(spanLen);
+	while (spanLen > 0) {
+		unsigned int n = (spanLen > 0x40000000 ? 0x40000000 : (unsigned int) spanLen);
+		mp_h->hash((unsigned char *) span, n);
+		span += n;
+		spanLen -= n;
+	}
+
 	// Now run through the data
 	unsigned char buffer[1024];
 	unsigned int size;
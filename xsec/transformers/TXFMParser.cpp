@@ -33,9 +33,9 @@
 #include <xsec/utils/XSECPlatformUtils.hpp>
 #include <xsec/framework/XSECError.hpp>
 #include <xsec/utils/XSECTXFMInputSource.hpp>
+#include <xsec/utils/XSECParserPool.hpp>
 
 #include <xercesc/parsers/XercesDOMParser.hpp>
-#include <xercesc/framework/MemBufInputSource.hpp>
 #include <xercesc/util/Janitor.hpp>
 
 XERCES_CPP_NAMESPACE_USE
@@ -110,23 +110,26 @@ void TXFMParser::setInput(TXFMBase *newInput) {
 
 	XSECTXFMInputSource is(chain, false);
 
-	// Create a XercesParser and parse!
-	XercesDOMParser parser;
+	// Borrow a parser from the pool and parse!
+	XercesDOMParser * parser = XSECParserPool::getDOMParser();
+	xsecsize_t errorCount;
 
-	parser.setDoNamespaces(true);
-	parser.setLoadExternalDTD(false);
+	try {
+		parser->parse(is);
+		errorCount = parser->getErrorCount();
+		if (errorCount == 0)
+			mp_parsedDoc = parser->adoptDocument();
+	}
+	catch (...) {
+		XSECParserPool::releaseDOMParser(parser);
+		throw;
+	}
 
-	SecurityManager securityManager;
-	securityManager.setEntityExpansionLimit(XSEC_ENTITY_EXPANSION_LIMIT);
-	parser.setSecurityManager(&securityManager);
+	XSECParserPool::releaseDOMParser(parser);
 
-	parser.parse(is);
-    xsecsize_t errorCount = parser.getErrorCount();
     if (errorCount > 0)
 		throw XSECException(XSECException::XSLError, "Errors occured parsing BYTE STREAM");
 
-    mp_parsedDoc = parser.adoptDocument();
-
 	// Clean up
 
 	keepComments = newInput->getCommentsStatus();
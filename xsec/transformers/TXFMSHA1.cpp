@@ -30,6 +30,7 @@
 
 #include <xsec/transformers/TXFMSHA1.hpp>
 #include <xsec/utils/XSECPlatformUtils.hpp>
+#include <xsec/utils/XSECHashPool.hpp>
 #include <xsec/framework/XSECException.hpp>
 
 XERCES_CPP_NAMESPACE_USE
@@ -39,27 +40,35 @@ TXFMSHA1::TXFMSHA1(DOMDocument *doc, hashMethod hm,
 
 	toOutput = 0;					// Nothing yet to output
 	int hashLen = 0;
+	XSECCryptoHash::HashType type;
 
 	switch (hm) {
 	case HASH_SHA224 :
 		hashLen = 224;
+		type = XSECCryptoHash::HASH_SHA224;
 		break;
 	case HASH_SHA256 :
 		hashLen = 256;
+		type = XSECCryptoHash::HASH_SHA256;
 		break;
 	case HASH_SHA384 :
 		hashLen = 384;
+		type = XSECCryptoHash::HASH_SHA384;
 		break;
 	case HASH_SHA512 :
 		hashLen = 512;
+		type = XSECCryptoHash::HASH_SHA512;
 		break;
 	default:
 		hashLen = 160;
+		type = XSECCryptoHash::HASH_SHA1;
 	}
 
+	m_pooled = (key == NULL);
+
 	if (key == NULL)
-		// Get a SHA1 worker
-		mp_h = XSECPlatformUtils::g_cryptoProvider->hashSHA(hashLen);
+		// Borrow a SHA worker
+		mp_h = XSECHashPool::getHash(type);
 	else {
 		// Get an HMAC Sha1
 		
@@ -87,8 +96,12 @@ TXFMSHA1::TXFMSHA1(DOMDocument *doc, hashMethod hm,
 TXFMSHA1::~TXFMSHA1() {
 
 	// Clean up
-	if (mp_h)
-		delete mp_h;
+	if (mp_h) {
+		if (m_pooled)
+			XSECHashPool::releaseHash(mp_h);
+		else
+			delete mp_h;
+	}
 
 };
 
@@ -124,6 +137,17 @@ void TXFMSHA1::setInput(TXFMBase * inputT) {
 
 	keepComments = input->getCommentsStatus();
 
+	// A mapped input can be hashed in place (in pieces the hash
+	// interface can take)
+	xsecsize_t spanLen;
+	const XMLByte * span = input->consumeOutput(spanLen);
+	while (spanLen > 0) {
+		unsigned int n = (spanLen > 0x40000000 ? 0x40000000 : (unsigned int) spanLen);
+		mp_h->hash((unsigned char *) span, n);
+		span += n;
+		spanLen -= n;
+	}
+
 	// Now run through the data
 	unsigned char buffer[1024];
 	unsigned int size;
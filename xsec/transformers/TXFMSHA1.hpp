@@ -41,6 +41,7 @@ class DSIG_EXPORT TXFMSHA1 : public TXFMBase {
 private:
 
 	XSECCryptoHash		* mp_h;							// To hold the hash
+	bool				m_pooled;						// Was mp_h taken from XSECHashPool?
 	unsigned char		md_value[CRYPTO_MAX_HASH_SIZE];	// Final output
 	unsigned int		md_len;							// Length of digest
 
@@ -28,6 +28,7 @@
 
 #include <xsec/transformers/TXFMURL.hpp>
 #include <xsec/framework/XSECError.hpp>
+#include <xsec/utils/XSECBinMappedFileInputStream.hpp>
 
 // To catch exceptions
 
@@ -42,6 +43,7 @@ XERCES_CPP_NAMESPACE_USE
 TXFMURL::TXFMURL(DOMDocument *doc, XSECURIResolver * resolver) : TXFMBase(doc) {
 
 	is = NULL;			// To ensure later able to delete if not used properly
+	mp_mapped = NULL;
 
 	mp_resolver = resolver;
 
@@ -70,8 +72,18 @@ void TXFMURL::setInput(const XMLCh * URL) {
 	// Assume we have already checked that this is a valid URL
 
 
-	if (mp_resolver != NULL)
-		is = mp_resolver->resolveURI(URL);
+	// Prefer a mapped local file, so digests can be taken straight
+	// from memory
+
+	if (mp_resolver != NULL) {
+
+		mp_mapped = mp_resolver->resolveURIMapped(URL);
+		if (mp_mapped != NULL)
+			is = mp_mapped;
+		else
+			is = mp_resolver->resolveURI(URL);
+
+	}
 
 	if (is == NULL) {
 
@@ -88,6 +100,7 @@ void TXFMURL::setInput(BinInputStream * inputStream) {
 		delete is;
 
 	is = inputStream;
+	mp_mapped = NULL;
 
 }
 
@@ -142,6 +155,18 @@ unsigned int TXFMURL::readBytes(XMLByte * const toFill, unsigned int maxToFill)
 
 }
 
+const XMLByte * TXFMURL::consumeOutput(xsecsize_t & length) {
+
+	if (done || mp_mapped == NULL || !mp_mapped->isMapped()) {
+		length = 0;
+		return NULL;
+	}
+
+	done = true;
+	return mp_mapped->consumeMapped(length);
+
+}
+
 DOMDocument *TXFMURL::getDocument() {
 
 	return NULL;
@@ -33,6 +33,8 @@
 
 #include <xercesc/util/BinInputStream.hpp>
 
+class XSECBinMappedFileInputStream;
+
 /**
  * \brief Base transformer for URL inputs to chains.  Also used to
  * provide a method to provide a BinInputStream as an input method
@@ -47,6 +49,8 @@ private:
 	XSECURIResolver			* mp_resolver;	// Resolver passed in
 	XERCES_CPP_NAMESPACE_QUALIFIER BinInputStream			
 							* is;		// To handle the actual input
+	XSECBinMappedFileInputStream
+							* mp_mapped;	// is, if the input is mapped
 
 	bool					done;
 
@@ -71,6 +75,7 @@ public:
 	// Methods to get output data
 
 	virtual unsigned int readBytes(XMLByte * const toFill, const unsigned int maxToFill);
+	virtual const XMLByte * consumeOutput(xsecsize_t & length);
 	virtual XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument *getDocument();
 	virtual XERCES_CPP_NAMESPACE_QUALIFIER DOMNode *getFragmentNode();
 	virtual const XMLCh * getFragmentId();
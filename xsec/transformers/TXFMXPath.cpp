@@ -30,7 +30,10 @@
 #include <xsec/transformers/TXFMXPath.hpp>
 #include <xsec/transformers/TXFMParser.hpp>
 #include <xsec/dsig/DSIGConstants.hpp>
+#include <xsec/utils/XSECXPathPattern.hpp>
 #include <xsec/utils/XSECDOMUtils.hpp>
+#include <xsec/utils/XSECExpandedDocument.hpp>
+#include <xsec/utils/XSECXPathPrefixResolver.hpp>
 #include <xsec/framework/XSECError.hpp>
 
 #ifndef XSEC_NO_XALAN
@@ -61,7 +64,6 @@ XALAN_USING_XALAN(XalanDOMChar)
 XALAN_USING_XALAN(XPathEnvSupportDefault)
 XALAN_USING_XALAN(XObjectFactoryDefault)
 XALAN_USING_XALAN(XPathExecutionContextDefault)
-XALAN_USING_XALAN(ElementPrefixResolverProxy)
 XALAN_USING_XALAN(XPath)
 XALAN_USING_XALAN(NodeRefListBase)
 XALAN_USING_XALAN(XSLTResultTarget)
@@ -71,119 +73,20 @@ XALAN_USING_XALAN(XSLException)
 
 XERCES_CPP_NAMESPACE_USE
 
-#if !defined(XSEC_NO_XPATH)
-
 #include <iostream>
 
-#define KLUDGE_PREFIX "berindsig"
-
-// Helper function
-
-void setXPathNS(DOMDocument *d, 
-				DOMNamedNodeMap *xAtts, 
-			    XSECXPathNodeList &addedNodes,
-				XSECSafeBufferFormatter *formatter,
-				XSECNameSpaceExpander * nse) {
-
-	// if set then set the name spaces in the attribute list else clear them
-
-	DOMElement * e = d->getDocumentElement();
-
-	if (e == NULL) {
-
-		throw XSECException(XSECException::XPathError, "Element node not found in Document");
-
-	}
-
-	if (xAtts != 0) {
-
-		int xAttsCount = xAtts->getLength();	
-
-		// Check all is OK with the Xalan Document and first element
-
-		if (d == NULL) {
-
-			throw XSECException(XSECException::XPathError, "Attempt to define XPath Name Space before setInput called");
-
-		}
-
-		// Run through each attribute looking for name spaces
-		const XMLCh *xpName;
-		safeBuffer xpNameSB;
-		const XMLCh *xpLocalName;
-		const XMLCh *xpValue;
-
-		for (int xCounter = 0; xCounter < xAttsCount; ++xCounter) {
-
-			if (nse == NULL || !nse->nodeWasAdded(xAtts->item(xCounter))) {
-				
-				xpName = xAtts->item(xCounter)->getNodeName();
-				xpNameSB << (*formatter << xpName);
-				
-				if (xpNameSB.sbStrncmp("xmlns", 5) == 0) {
-
-					// Check whether a node of this name already exists
-					xpLocalName = xAtts->item(xCounter)->getLocalName();
-					xpValue = xAtts->item(xCounter)->getNodeValue();
-					if (e->hasAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS, xpLocalName) == false) {
-
-						// Nope
-	
-						e->setAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS, xpName, xpValue);
-						addedNodes.addNode(e->getAttributeNodeNS(DSIGConstants::s_unicodeStrURIXMLNS, xpLocalName));
-					}
-
-				}
-
-			}
-
-		}
-
-	}
-
-	// Insert the kludge namespace
-	safeBuffer k("xmlns:");
-	k.sbStrcatIn(KLUDGE_PREFIX);
-
-	e->setAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS,
-					 MAKE_UNICODE_STRING(k.rawCharBuffer()),
-					 DSIGConstants::s_unicodeStrURIDSIG);
-}
-
-void clearXPathNS(DOMDocument *d, 
-				  XSECXPathNodeList &toRemove,
-				  XSECSafeBufferFormatter *formatter,
-				  XSECNameSpaceExpander * nse) {
-
-	// Clear the XPath name spaces in the document element attribute list
-
-	DOMElement * e = d->getDocumentElement();
-
-	if (e == NULL) {
-
-		throw XSECException(XSECException::XPathError, "Element node not found in Document");
-
-	}
-
-	// Run through each node in the added nodes
-
-	const DOMNode * r = toRemove.getFirstNode();
-	while (r != NULL) {
-		e->removeAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS, 
-					r->getLocalName());
-		r = toRemove.getNextNode();
-	}
+#if !defined(XSEC_NO_XPATH)
 
-	e->removeAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS,
-					 MAKE_UNICODE_STRING(KLUDGE_PREFIX));
+#define KLUDGE_PREFIX "berindsig"
 
-}
+#endif /* NO_XPATH */
 
 TXFMXPath::TXFMXPath(DOMDocument *doc) : 
 	TXFMBase(doc) {
 
 	document = NULL;
 	XPathAtts = NULL;
+	mp_expanded = NULL;
 
 	// Formatter is used for handling attribute name space inputs
 
@@ -196,6 +99,9 @@ TXFMXPath::~TXFMXPath() {
 
 	if (formatter != NULL) 
 		delete formatter;
+
+	if (mp_expanded != NULL)
+		delete mp_expanded;
 	
 }
 
@@ -227,7 +133,6 @@ void TXFMXPath::setInput(TXFMBase *newInput) {
 		}
 
 		input = parser;
-		parser->expandNameSpaces();
 	}
 	else
 		input = newInput;
@@ -235,13 +140,14 @@ void TXFMXPath::setInput(TXFMBase *newInput) {
 	// Set up for the new document
 	document = input->getDocument();
 
-	// Expand if necessary
-	this->expandNameSpaces();
+	// Name spaces are only expanded if the expression has to go to Xalan
 
 	keepComments = input->getCommentsStatus();
 
 }
 
+#if !defined(XSEC_NO_XPATH)
+
 bool separator(unsigned char c) {
 
 	if (c >= 'a' && c <= 'z')
@@ -275,15 +181,66 @@ XalanNode * findHereNodeFromXalan(XercesWrapperNavigator * xwn, XalanNode * n, D
 
 	return 0;
 }
-		
 
+#endif /* NO_XPATH */
 
 void TXFMXPath::evaluateExpr(DOMNode *h, safeBuffer inexpr) {
 
-	// Temporarily add any necessary name spaces into the document
+	// First see if this is something we can do without an XPath engine
+
+	XSECXPathPattern pattern;
+
+	if (pattern.compile(inexpr.rawCharBuffer(), document, XPathAtts) &&
+		pattern.isPredicate() &&
+		(pattern.getPatternType() != XSECXPathPattern::PATTERN_NOT_HERE_ANCESTOR ||
+		 h->getOwnerDocument() == document)) {
+
+		DOMNode * start;
+		const XSECXPathNodeList * inputList = NULL;
 
-	XSECXPathNodeList addedNodes;
-	setXPathNS(document, XPathAtts, addedNodes, formatter, mp_nse);
+		switch (input->getNodeType()) {
+
+		case DOM_NODE_DOCUMENT :
+
+			start = document;
+			break;
+
+		case DOM_NODE_DOCUMENT_FRAGMENT :
+
+			start = input->getFragmentNode();
+			break;
+
+		case DOM_NODE_XPATH_NODESET :
+
+			start = document;
+			inputList = &(input->getXPathNodeList());
+			break;
+
+		default :
+
+			throw XSECException(XSECException::XPathError);	// Should never get here
+
+		}
+
+		pattern.evaluatePredicate(start, h, inputList, !nameSpacesExpanded(), m_XPathMap);
+		return;
+
+	}
+
+#if defined(XSEC_NO_XPATH)
+
+	throw XSECException(XSECException::UnsupportedFunction,
+		"XPath expression requires Xalan, which is not available in this compilation of the XSEC library");
+
+#else
+
+	// Xalan needs the name spaces expanded.  That is done once, on a
+	// private copy, so the caller's document is never modified.
+
+	if (mp_expanded == NULL)
+		XSECnew(mp_expanded, XSECExpandedDocument(document));
+
+	DOMDocument * xdoc = mp_expanded->getDocument();
 
 	XPathProcessorImpl	xppi;					// The processor
 	XercesParserLiaison xpl;
@@ -304,7 +261,7 @@ void TXFMXPath::evaluateExpr(DOMNode *h, safeBuffer inexpr) {
 	try {
 	
 		// Map to Xalan
-		xd = xpl.createDocument(document);
+		xd = xpl.createDocument(xdoc);
 
 		// For performing mapping
 		XercesDocumentWrapper *xdw = xpl.mapDocumentToWrapper(xd);
@@ -316,11 +273,12 @@ void TXFMXPath::evaluateExpr(DOMNode *h, safeBuffer inexpr) {
 
 		if (h->getOwnerDocument() == document) {
 			
-			hereNode = xwn.mapNode(h);
+			DOMNode * xh = mp_expanded->toCopy(h);
+			hereNode = xwn.mapNode(xh);
 
 			if (hereNode == NULL) {
 
-				hereNode = findHereNodeFromXalan(&xwn, xd, h);
+				hereNode = findHereNodeFromXalan(&xwn, xd, xh);
 
 				if (hereNode == NULL) {
 
@@ -385,13 +343,13 @@ void TXFMXPath::evaluateExpr(DOMNode *h, safeBuffer inexpr) {
 
 					if (contextNode == NULL) {
 						// Last Ditch
-						contextNode = xwn.mapNode(input->getFragmentNode());
+						contextNode = xwn.mapNode(mp_expanded->toCopy(input->getFragmentNode()));
 
 					}
 
 				}
 				else
-					contextNode = xwn.mapNode(input->getFragmentNode());
+					contextNode = xwn.mapNode(mp_expanded->toCopy(input->getFragmentNode()));
 
 				if (contextNode == NULL) {
 
@@ -414,7 +372,11 @@ void TXFMXPath::evaluateExpr(DOMNode *h, safeBuffer inexpr) {
 		XObjectFactoryDefault			xof;
 		XPathExecutionContextDefault	xpec(xpesd, xds, xof);
 
-		ElementPrefixResolverProxy pr(xd->getDocumentElement(), xpesd, xds);
+		// Prefixes come from the XPath element and the declarations in
+		// scope at the Transform that holds it
+
+		XSECXPathPrefixResolver pr(XPathAtts, h);
+		pr.addBinding(XalanDOMString(KLUDGE_PREFIX), XalanDOMString(URI_ID_DSIG));
 
 		// Work around the fact that the XPath implementation is designed for XSLT, so does
 		// not allow here() as a NCName.
@@ -474,8 +436,11 @@ void TXFMXPath::evaluateExpr(DOMNode *h, safeBuffer inexpr) {
 			if (lst.item(i) == xd)
 				m_XPathMap.addNode(document);
 			else {
-				item = xwn.mapNode(lst.item(i));
-				m_XPathMap.addNode(item);
+				// Back to the caller's document.  Declarations that only
+				// exist in the copy map to the one in scope.
+				item = mp_expanded->toOriginal(xwn.mapNode(lst.item(i)));
+				if (item != NULL)
+					m_XPathMap.addNode(item);
 			}
 		}
 
@@ -490,9 +455,6 @@ void TXFMXPath::evaluateExpr(DOMNode *h, safeBuffer inexpr) {
 
 		safeBuffer msg;
 
-		// Whatever happens - fix any changes to the original document
-		clearXPathNS(document, addedNodes, formatter, mp_nse);
-	
 		// Collate the exception message into an XSEC message.		
 		msg.sbTranscodeIn("Xalan Exception : ");
 #if defined (XSEC_XSLEXCEPTION_RETURNS_DOMSTRING)
@@ -506,8 +468,8 @@ void TXFMXPath::evaluateExpr(DOMNode *h, safeBuffer inexpr) {
 		throw XSECException(XSECException::XPathError,
 			msg.rawXMLChBuffer());
 	}
-	
-	clearXPathNS(document, addedNodes, formatter, mp_nse);
+
+#endif /* NO_XPATH */
 
 }
 
@@ -596,5 +558,3 @@ XSECXPathNodeList	& TXFMXPath::getXPathNodeList() {
 	return m_XPathMap;
 
 }
-
-#endif /* NO_XPATH */
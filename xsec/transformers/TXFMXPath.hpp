@@ -58,10 +58,16 @@ XSEC_DECLARE_XERCES_CLASS(DOMNamedNodeMap);
 
 #endif
 
-#ifndef XSEC_NO_XPATH
+// Only defined when XPath is available
+class DSIGXPathHere;
+class XSECExpandedDocument;
 
 /**
  * \brief Transformer to handle XPath transforms
+ *
+ * Common expressions are recognised and evaluated natively by
+ * XSECXPathPattern.  Everything else is handed to Xalan (if available).
+ *
  * @ingroup internal
  */
 
@@ -79,6 +85,7 @@ private:
 
 	DSIGXPathHere		* here;			// The function to implement here()
 	XSECSafeBufferFormatter * formatter;
+	XSECExpandedDocument	* mp_expanded;	// Name space expanded copy for Xalan
 
 public:
 
@@ -113,5 +120,3 @@ private:
 };
 
 #endif
-
-#endif
@@ -34,6 +34,9 @@
 #include <xsec/framework/XSECError.hpp>
 #include <xsec/dsig/DSIGXPathFilterExpr.hpp>
 #include <xsec/dsig/DSIGXPathHere.hpp>
+#include <xsec/utils/XSECXPathPattern.hpp>
+#include <xsec/utils/XSECExpandedDocument.hpp>
+#include <xsec/utils/XSECXPathPrefixResolver.hpp>
 
 #include <xercesc/util/Janitor.hpp>
 
@@ -56,7 +59,6 @@ XERCES_CPP_NAMESPACE_USE
 #include <xalanc/XPath/NodeRefList.hpp>
 #include <xalanc/XPath/XPathEnvSupportDefault.hpp>
 #include <xalanc/XPath/XPathConstructionContextDefault.hpp>
-#include <xalanc/XPath/ElementPrefixResolverProxy.hpp>
 #include <xalanc/XPath/XObjectFactoryDefault.hpp>
 #include <xalanc/XPath/XPathExecutionContextDefault.hpp>
 #include <xalanc/XSLT/XSLTResultTarget.hpp>
@@ -82,7 +84,6 @@ XALAN_USING_XALAN(XPathEnvSupportDefault)
 XALAN_USING_XALAN(XObjectFactoryDefault)
 XALAN_USING_XALAN(XObjectPtr)
 XALAN_USING_XALAN(XPathExecutionContextDefault)
-XALAN_USING_XALAN(ElementPrefixResolverProxy)
 XALAN_USING_XALAN(XPath)
 XALAN_USING_XALAN(NodeRefListBase)
 XALAN_USING_XALAN(XSLTResultTarget)
@@ -90,34 +91,26 @@ XALAN_USING_XALAN(XSLException)
 
 #endif
 
-#if !defined(XSEC_NO_XPATH)
-
 #include <iostream>
 
+#if !defined(XSEC_NO_XPATH)
+
 #define KLUDGE_PREFIX "berindsig"
 
 // Helper functions - come from DSIGXPath
 
-void setXPathNS(DOMDocument *d, 
-				DOMNamedNodeMap *xAtts, 
-			    XSECXPathNodeList &addedNodes,
-				XSECSafeBufferFormatter *formatter,
-				XSECNameSpaceExpander * nse);
-
-void clearXPathNS(DOMDocument *d, 
-				  XSECXPathNodeList &toRemove,
-				  XSECSafeBufferFormatter *formatter,
-				  XSECNameSpaceExpander * nse);
-
 bool separator(unsigned char c);
 XalanNode * findHereNodeFromXalan(XercesWrapperNavigator * xwn, XalanNode * n, DOMNode *h);
 
+#endif /* NO_XPATH */
 
 
 TXFMXPathFilter::TXFMXPathFilter(DOMDocument *doc) : 
 	TXFMBase(doc) {
 
 	document = NULL;
+	mp_expanded = NULL;
+	m_addParentNS = false;
 	XSECnew(mp_formatter, XSECSafeBufferFormatter("UTF-8",XMLFormatter::NoEscapes, 
 												XMLFormatter::UnRep_CharRef));
 
@@ -139,6 +132,9 @@ TXFMXPathFilter::~TXFMXPathFilter() {
 	if (mp_formatter != NULL) 
 		delete mp_formatter;
 
+	if (mp_expanded != NULL)
+		delete mp_expanded;
+
 	
 }
 
@@ -162,7 +158,6 @@ void TXFMXPathFilter::setInput(TXFMBase *newInput) {
 		}
 
 		input = parser;
-		parser->expandNameSpaces();
 	}
 	else
 		input = newInput;
@@ -170,8 +165,7 @@ void TXFMXPathFilter::setInput(TXFMBase *newInput) {
 	// Set up for the new document
 	document = input->getDocument();
 
-	// Expand if necessary
-	this->expandNameSpaces();
+	// Name spaces are only expanded if an expression has to go to Xalan
 
 	keepComments = input->getCommentsStatus();
 
@@ -182,8 +176,40 @@ XSECXPathNodeList * TXFMXPathFilter::evaluateSingleExpr(DSIGXPathFilterExpr *exp
 	// Have a single expression that we wish to find the resultant nodeset
 	// for
 
-	XSECXPathNodeList addedNodes;
-	setXPathNS(document, expr->mp_NSMap, addedNodes, mp_formatter, mp_nse);
+	// First see if this is something we can do without an XPath engine
+	XSECXPathPattern pattern;
+	safeBuffer patternSB;
+	patternSB << (*mp_formatter << expr->m_expr.rawXMLChBuffer());
+
+	if (pattern.compile(patternSB.rawCharBuffer(), document, expr->mp_NSMap) &&
+		!pattern.isPredicate()) {
+
+		XSECXPathNodeList * ret;
+		XSECnew(ret, XSECXPathNodeList);
+		Janitor<XSECXPathNodeList> j_ret(ret);
+
+		pattern.selectNodes(document, expr->mp_xpathFilterNode, *ret);
+
+		j_ret.release();
+		return ret;
+
+	}
+
+#if defined(XSEC_NO_XPATH)
+
+	throw XSECException(XSECException::UnsupportedFunction,
+		"XPath expression requires Xalan, which is not available in this compilation of the XSEC library");
+
+#else
+
+	// Xalan needs the name spaces expanded.  Work on a private copy so
+	// the caller's document is never modified.  The copy is shared by
+	// every expression of the transform.
+
+	if (mp_expanded == NULL)
+		XSECnew(mp_expanded, XSECExpandedDocument(document));
+
+	DOMDocument * xdoc = mp_expanded->getDocument();
 
 	XPathProcessorImpl	xppi;					// The processor
 	XercesParserLiaison xpl;
@@ -204,7 +230,7 @@ XSECXPathNodeList * TXFMXPathFilter::evaluateSingleExpr(DSIGXPathFilterExpr *exp
 	try {
 	
 		// Map to Xalan
-		xd = xpl.createDocument(document);
+		xd = xpl.createDocument(xdoc);
 
 		// For performing mapping
 		XercesDocumentWrapper *xdw = xpl.mapDocumentToWrapper(xd);
@@ -214,11 +240,11 @@ XSECXPathNodeList * TXFMXPathFilter::evaluateSingleExpr(DSIGXPathFilterExpr *exp
 
 		XalanNode * hereNode = NULL;
 
-		hereNode = xwn.mapNode(expr->mp_xpathFilterNode);
+		hereNode = xwn.mapNode(mp_expanded->toCopy(expr->mp_xpathFilterNode));
 
 		if (hereNode == NULL) {
 
-			hereNode = findHereNodeFromXalan(&xwn, xd, expr->mp_exprTextNode);
+			hereNode = findHereNodeFromXalan(&xwn, xd, mp_expanded->toCopy(expr->mp_exprTextNode));
 
 			if (hereNode == NULL) {
 
@@ -246,7 +272,10 @@ XSECXPathNodeList * TXFMXPathFilter::evaluateSingleExpr(DSIGXPathFilterExpr *exp
 		XObjectFactoryDefault			xof;
 		XPathExecutionContextDefault	xpec(xpesd, xds, xof);
 
-		ElementPrefixResolverProxy pr(xd->getDocumentElement(), xpesd, xds);
+		// Prefixes are those in scope at the XPath element
+
+		XSECXPathPrefixResolver pr(NULL, expr->mp_xpathFilterNode);
+		pr.addBinding(XalanDOMString(KLUDGE_PREFIX), XalanDOMString(URI_ID_DSIG));
 
 		// Work around the fact that the XPath implementation is designed for XSLT, so does
 		// not allow here() as a NCName.
@@ -310,15 +339,16 @@ XSECXPathNodeList * TXFMXPathFilter::evaluateSingleExpr(DSIGXPathFilterExpr *exp
 			if (lst.item(i) == xd)
 				ret->addNode(document);
 			else {
-				item = xwn.mapNode(lst.item(i));
-				ret->addNode(item);
+				// Declarations that only exist in the copy map to the
+				// one in scope in the caller's document
+				item = mp_expanded->toOriginal(xwn.mapNode(lst.item(i)));
+				if (item != NULL)
+					ret->addNode(item);
 			}
 		}
 
 		xpesd.uninstallExternalFunctionGlobal(XalanDOMString(URI_ID_DSIG), XalanDOMString("here"));
 
-		clearXPathNS(document, addedNodes, mp_formatter, mp_nse);
-
 		j_ret.release();
 		return ret;
 
@@ -328,9 +358,6 @@ XSECXPathNodeList * TXFMXPathFilter::evaluateSingleExpr(DSIGXPathFilterExpr *exp
 
 		safeBuffer msg;
 
-		// Whatever happens - fix any changes to the original document
-		clearXPathNS(document, addedNodes, mp_formatter, mp_nse);
-	
 		// Collate the exception message into an XSEC message.		
 		msg.sbTranscodeIn("Xalan Exception : ");
 #if defined (XSEC_XSLEXCEPTION_RETURNS_DOMSTRING)
@@ -346,12 +373,10 @@ XSECXPathNodeList * TXFMXPathFilter::evaluateSingleExpr(DSIGXPathFilterExpr *exp
 
 	}
 
-	catch (...) {
-		clearXPathNS(document, addedNodes, mp_formatter, mp_nse);
-		throw;
-	}
-
 	return NULL;
+
+#endif /* NO_XPATH */
+
 }
 
 bool TXFMXPathFilter::checkNodeInInput(DOMNode * n, DOMNode * attParent) {
@@ -500,6 +525,21 @@ void TXFMXPathFilter::walkDocument(DOMNode * n) {
 			if (checkNodeInScope(current) && 
 				checkNodeInInput(current, (atts != NULL ? attParent : NULL))) {
 
+				// Without expansion, the top of each selected sub-tree needs
+				// the declarations it inherits so the c14n name space stack
+				// can see them
+
+				if (m_addParentNS && atts == NULL &&
+					current->getNodeType() == DOMNode::ELEMENT_NODE) {
+
+					DOMNode * p = current->getParentNode();
+
+					if (p != NULL && p->getNodeType() == DOMNode::ELEMENT_NODE &&
+						!m_xpathFilterMap.hasNode(p))
+						XSECXPathPattern::addAncestorNSNodes(p, mp_inputList, m_xpathFilterMap);
+
+				}
+
 				m_xpathFilterMap.addNode(current);
 
 			}
@@ -646,6 +686,12 @@ void TXFMXPathFilter::evaluateExprs(DSIGTransformXPathFilter::exprVectorType * e
 
 	DSIGTransformXPathFilter::exprVectorType::iterator i;
 
+	// The document is not expanded (Xalan works on its own copy), so
+	// inherited declarations are added to the result sets as they are
+	// walked
+
+	m_addParentNS = !nameSpacesExpanded();
+
 	for (i = exprs->begin(); i != exprs->end(); ++i) {
 
 		XSECXPathNodeList * lst = evaluateSingleExpr(*i);
@@ -753,7 +799,5 @@ XSECXPathNodeList	& TXFMXPathFilter::getXPathNodeList() {
 
 }
 
-#endif /* NO_XPATH */
-
 
 
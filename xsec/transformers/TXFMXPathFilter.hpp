@@ -41,6 +41,7 @@ XSEC_DECLARE_XERCES_CLASS(DOMNamedNodeMap);
 
 class TXFMXPathFilterExpr;
 class XSECSafeBufferFormatter;
+class XSECExpandedDocument;
 
 struct filterSetHolder {
 
@@ -52,10 +53,12 @@ struct filterSetHolder {
 };
 
 
-#ifndef XSEC_NO_XPATH
-
 /**
- * \brief Transformer to handle XPath transforms
+ * \brief Transformer to handle XPath Filter 2.0 transforms
+ *
+ * Simple id(), "/" and here() based expressions are evaluated natively
+ * by XSECXPathPattern.  Everything else is handed to Xalan (if available).
+ *
  * @ingroup internal
  */
 
@@ -106,14 +109,14 @@ private:
 	lstsVectorType		m_lsts;
 
 	XSECSafeBufferFormatter * mp_formatter;
+	XSECExpandedDocument * mp_expanded;		// Shared by every expression
 
 	/* Used to hold details during tree-walk */
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode				
 						* mp_fragment;
 	XSECXPathNodeList	* mp_inputList;
+	bool				m_addParentNS;		// Name spaces were not expanded
 
 };
 
-#endif
-
 #endif /* XPATHFILTER_HEADER */
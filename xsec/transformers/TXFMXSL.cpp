@@ -29,46 +29,237 @@
 #include <xsec/transformers/TXFMXSL.hpp>
 #include <xsec/dsig/DSIGConstants.hpp>
 #include <xsec/framework/XSECError.hpp>
+#include <xsec/utils/XSECHashPool.hpp>
 
 #ifndef XSEC_NO_XSLT
 
 // Xerces
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/dom/DOMImplementation.hpp>
-#include <xercesc/dom/DOMImplementationLS.hpp>
-#include <xercesc/parsers/XercesDOMParser.hpp>
-#include <xercesc/framework/MemBufInputSource.hpp>
-#include <xercesc/util/Janitor.hpp>
+#include <xercesc/util/Mutexes.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
 
 XERCES_CPP_NAMESPACE_USE
 
+// Xalan
+#include <xalanc/XSLT/XSLTInputSource.hpp>
+#include <xalanc/XSLT/XSLTResultTarget.hpp>
+#include <xalanc/XalanTransformer/XalanCompiledStylesheet.hpp>
+#include <xalanc/XercesParserLiaison/FormatterToXercesDOM.hpp>
+
+XALAN_USING_XALAN(XSLTInputSource)
+XALAN_USING_XALAN(XSLTResultTarget)
+XALAN_USING_XALAN(XalanCompiledStylesheet)
+XALAN_USING_XALAN(FormatterToXercesDOM)
+
 #include <iostream>
 #include <strstream>
-#include <fstream>
+#include <map>
+#include <string>
 
-XALAN_USING_XALAN(XSLTResultTarget)
+// A cached stylesheet and the number of transforms using it.  An entry
+// dropped from the cache while in use is destroyed by its last user.
+
+struct XSLCacheEntry {
+	const XalanCompiledStylesheet	* mp_sheet;
+	unsigned int					m_users;
+	bool							m_dropped;
+};
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef map<string, XSLCacheEntry *>			XSLCacheMapType;
+#else
+typedef std::map<std::string, XSLCacheEntry *>	XSLCacheMapType;
+#endif
+
+// -----------------------------------------------------------------------
+//  Compiled stylesheet cache
+// -----------------------------------------------------------------------
+
+// Compiled stylesheets can be shared by XalanTransformer instances in
+// different threads.  They belong to the transformer that compiled them,
+// so cached ones are all compiled and destroyed by s_xslCompiler, and
+// only under the lock.
+
+static XMLMutex				* s_xslMutex = NULL;
+static XalanTransformer		* s_xslCompiler = NULL;
+static XSLCacheMapType		s_xslCache;
+static unsigned int			s_xslMaxCached = 32;
+
+static const XMLCh s_Core[] = {
+
+	chLatin_C,
+	chLatin_o,
+	chLatin_r,
+	chLatin_e,
+	chNull
+};
+
+void TXFMXSL::Initialise(void) {
+
+	XSECnew(s_xslMutex, XMLMutex());
+
+}
+
+void TXFMXSL::Terminate(void) {
+
+	clearStyleSheetCache();
+
+	// No transforms can be running now, so deleting the compiler
+	// destroys anything that was still in use
+	if (s_xslCompiler != NULL) {
+		delete s_xslCompiler;
+		s_xslCompiler = NULL;
+	}
+
+	delete s_xslMutex;
+	s_xslMutex = NULL;
+
+}
 
-// Function used to output data to a safeBuffer
-extern "C" {
+void TXFMXSL::clearStyleSheetCache(void) {
 
-typedef struct TransformXSLOutputHolderStruct {
+	if (s_xslMutex == NULL)
+		return;
 
-	safeBuffer	buffer;
-	int			offset;
+	XMLMutexLock lock(s_xslMutex);
 
-} TransformXSLOutputHolder;
+	XSLCacheMapType::iterator i;
 
-CallbackSizeType TransformXSLOutputFn(const char * s, CallbackSizeType sz, void * data) {
+	for (i = s_xslCache.begin(); i != s_xslCache.end(); ++i) {
 
-	TransformXSLOutputHolder * output = (TransformXSLOutputHolder *) data;
+		XSLCacheEntry * e = i->second;
 
-	output->buffer.sbMemcpyIn(output->offset, s, (int) sz);
-	output->offset += (int) sz;
-	output->buffer[output->offset] = '\0';
+		if (e->m_users == 0) {
+			s_xslCompiler->destroyStylesheet(e->mp_sheet);
+			delete e;
+		}
+		else {
+			// Left for the last transform using it
+			e->m_dropped = true;
+		}
 
-	return sz;
+	}
+
+	s_xslCache.clear();
 
 }
+
+void TXFMXSL::setMaxCachedStyleSheets(unsigned int max) {
+
+	if (s_xslMutex == NULL) {
+		s_xslMaxCached = max;
+		return;
+	}
+
+	XMLMutexLock lock(s_xslMutex);
+	s_xslMaxCached = max;
+
+}
+
+// Called when a transform has finished with a cached stylesheet
+
+static void releaseStyleSheet(XSLCacheEntry * e) {
+
+	XMLMutexLock lock(s_xslMutex);
+
+	if (--e->m_users == 0 && e->m_dropped) {
+		s_xslCompiler->destroyStylesheet(e->mp_sheet);
+		delete e;
+	}
+
+}
+
+class XSLCacheUse {
+
+public:
+
+	XSLCacheUse() : mp_entry(NULL) {}
+	~XSLCacheUse() {if (mp_entry != NULL) releaseStyleSheet(mp_entry);}
+
+	XSLCacheEntry		* mp_entry;
+
+};
+
+static const XalanCompiledStylesheet * compileStyleSheet(XalanTransformer & xt,
+		const char * sheet, xsecsize_t sheetLen) {
+
+	std::istrstream theXSLStream(sheet, (int) sheetLen);
+	const XalanCompiledStylesheet * ret = NULL;
+
+	if (xt.compileStylesheet(XSLTInputSource(&theXSLStream), ret) != 0 || ret == NULL) {
+		throw XSECException(XSECException::XSLError, xt.getLastError());
+	}
+
+	return ret;
+
+}
+
+// A stylesheet from the cache is marked as in use in "use" until the
+// caller has finished with it
+
+static const XalanCompiledStylesheet * getStyleSheet(XalanTransformer & local,
+		const safeBuffer & sbStyleSheet,
+		XSLCacheUse & use) {
+
+	const char * sheet = sbStyleSheet.rawCharBuffer();
+	xsecsize_t sheetLen = (xsecsize_t) strlen(sheet);
+
+	if (s_xslMutex == NULL)
+		return compileStyleSheet(local, sheet, sheetLen);
+
+	// Key on the digest of the stylesheet text
+
+	unsigned char digest[64];
+
+	XSECCryptoHash * h = XSECHashPool::getHash(XSECCryptoHash::HASH_SHA256);
+	h->hash((unsigned char *) sheet, (unsigned int) sheetLen);
+	unsigned int digestLen = h->finish(digest, 64);
+	XSECHashPool::releaseHash(h);
+
+	std::string key((const char *) digest, digestLen);
+
+	{
+
+		XMLMutexLock lock(s_xslMutex);
+
+		XSLCacheMapType::iterator i = s_xslCache.find(key);
+		if (i != s_xslCache.end()) {
+			++(i->second->m_users);
+			use.mp_entry = i->second;
+			return i->second->mp_sheet;
+		}
+
+		if (s_xslCache.size() < s_xslMaxCached) {
+
+			if (s_xslCompiler == NULL)
+				XSECnew(s_xslCompiler, XalanTransformer());
+
+			XSLCacheEntry * e;
+			XSECnew(e, XSLCacheEntry);
+			e->m_users = 1;
+			e->m_dropped = false;
+
+			try {
+				e->mp_sheet = compileStyleSheet(*s_xslCompiler, sheet, sheetLen);
+			}
+			catch (...) {
+				delete e;
+				throw;
+			}
+
+			s_xslCache[key] = e;
+			use.mp_entry = e;
+
+			return e->mp_sheet;
+
+		}
+
+	}
+
+	// Cache is full - compile this one just for the caller
+	return compileStyleSheet(local, sheet, sheetLen);
+
 }
 
 // -----------------------------------------------------------------------
@@ -105,20 +296,8 @@ void TXFMXSL::expandNameSpaces(void) {
 
 TXFMXSL::TXFMXSL(DOMDocument *doc) : 
 	TXFMBase(doc),
-#if XALAN_VERSION_MAJOR == 1 && XALAN_VERSION_MINOR > 10
-xds(xpl)
-#else
-#if defined XSEC_XERCESPARSERLIAISON_REQS_DOMSUPPORT
-xpl(xds) 
-#else
-xpl()
-#endif
-#endif
-{
-
-	// Zeroise all the pointers
-
-	xd = NULL;
+m_inDocLen(0),
+docOut(NULL) {
 
 }
 
@@ -148,66 +327,62 @@ void TXFMXSL::setInput(TXFMBase *newInput) {
 	// Should have a method to check if the input is a straight URL - if it is, just read the
 	// URL name and create an XSLTInputSource with this as the input ID.
 
-	int size = 0;
-	int count = 0;
-	unsigned char buf[512];
-
-	while ((count = input->readBytes((XMLByte *) buf, 512)) != 0) {
-
-		sbInDoc.sbMemcpyIn(size, buf, count);
-		size += count;
+	// Read straight into the buffer rather than via a bounce buffer.
+	// The buffer doubles when it fills, as resize() on its own only adds
+	// 1K and large inputs would be copied over and over.
 
-	}
-
-	sbInDoc[size] = '\0';
+	xsecsize_t count;
+	xsecsize_t size = 16384;
+	m_inDocLen = 0;
 
-}
+	sbInDoc.resize(size);
 
-void TXFMXSL::evaluateStyleSheet(const safeBuffer &sbStyleSheet) {
+	do {
 
-	// Set up iostreams for input
-	std::istrstream	theXMLStream((char *) sbInDoc.rawBuffer(), (int) strlen((char *) sbInDoc.rawBuffer()));
-	std::istrstream	theXSLStream((char *) sbStyleSheet.rawBuffer(), (int) strlen((char *) sbStyleSheet.rawBuffer()));
+		if (m_inDocLen + 4097 > size) {
+			size *= 2;
+			sbInDoc.resize(size);
+		}
 
-	// Now resolve
+		count = input->readBytes((XMLByte *) &sbInDoc[m_inDocLen], 4096);
+		m_inDocLen += count;
 
-	XalanTransformer xt;
-	TransformXSLOutputHolder txoh;
-	txoh.buffer.sbStrcpyIn("");
-	txoh.offset = 0;
-	
-	/*int res = */
-	xt.transform(&theXMLStream, &theXSLStream, (void *) & txoh, TransformXSLOutputFn);
+	} while (count != 0);
 
-	// Should check res
+	sbInDoc[m_inDocLen] = '\0';
 
-	// Now use xerces to "re parse" this back into a DOM_Nodes document
-	XercesDOMParser * parser = new XercesDOMParser;
-	Janitor<XercesDOMParser> j_parser(parser);
+}
 
-	parser->setDoNamespaces(true);
-	parser->setCreateEntityReferenceNodes(true);
-	parser->setLoadExternalDTD(false);
-	parser->setDoSchema(true);
+void TXFMXSL::evaluateStyleSheet(const safeBuffer &sbStyleSheet) {
 
-	SecurityManager securityManager;
-	parser->setSecurityManager(&securityManager);
+	// A cached stylesheet is held until the transform is done (use is
+	// destroyed after xt, so releases the sheet last)
+	XSLCacheUse use;
+	XalanTransformer xt;
 
-	// Create an input source
+	// Compiled (or found in the cache) before anything else is set up
+	const XalanCompiledStylesheet * css = getStyleSheet(xt, sbStyleSheet, use);
 
-	MemBufInputSource* memIS = new MemBufInputSource ((const XMLByte*) txoh.buffer.rawBuffer(), txoh.offset, "XSECMem");
-	Janitor<MemBufInputSource> j_memIS(memIS);
+	// Have the transformer build the result document directly, rather
+	// than serialising it and parsing it back in
 
-	int errorCount = 0;
+	DOMImplementation *impl = DOMImplementationRegistry::getDOMImplementation(s_Core);
+	docOut = impl->createDocument();
 
-	parser->parse(*memIS);
-    errorCount = parser->getErrorCount();
-    if (errorCount > 0)
-		throw XSECException(XSECException::XSLError, "Errors occured when XSL result was parsed back to DOM_Nodes");
+	std::istrstream	theXMLStream((char *) sbInDoc.rawBuffer(), (int) m_inDocLen);
+	FormatterToXercesDOM formatter(docOut, NULL, NULL);
 
-    docOut = parser->adoptDocument();
+	int res;
+	try {
+		res = xt.transform(XSLTInputSource(&theXMLStream), css, XSLTResultTarget(formatter));
+	}
+	catch (...) {
+		throw XSECException(XSECException::XSLError,
+			"Errors occured when building the XSL result as DOM_Nodes");
+	}
 
-	// Janitors clean up
+	if (res != 0)
+		throw XSECException(XSECException::XSLError, xt.getLastError());
 
 }
 
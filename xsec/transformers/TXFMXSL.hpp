@@ -56,24 +56,21 @@ XALAN_USING_XALAN(XalanTransformer)
 /**
  * \brief Transformer to handle XSLT transforms
  * @ingroup internal
+ *
+ * Compiled stylesheets are cached for the whole process, keyed by a
+ * SHA-256 digest of the stylesheet text, so a stylesheet used by many
+ * references (or many signatures) is only compiled once.  The result of
+ * the transformation is built directly into a new DOM document rather
+ * than being serialised and parsed back in.
  */
 
 class DSIG_EXPORT TXFMXSL : public TXFMBase {
 
 private:
 
-	safeBuffer expr;							// The expression being worked with
-
-	XercesDOMSupport	xds;
-	XercesParserLiaison xpl;
-
-	XalanDocument		* xd;
-
-	safeBuffer			sbInDoc;
+	safeBuffer			sbInDoc;			// Input bytes
+	xsecsize_t			m_inDocLen;
 
-	XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument		
-						* document;
-	
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument		
 						* docOut;			// The output from the transformation
 
@@ -102,6 +99,24 @@ public:
 
 	void evaluateStyleSheet(const safeBuffer &sbStyleSheet);
 
+	/**
+	 * \brief Set the number of compiled stylesheets kept
+	 *
+	 * Once the cache is full, further stylesheets are compiled for a
+	 * single use.  Defaults to 32.  Setting 0 disables caching.
+	 */
+
+	static void setMaxCachedStyleSheets(unsigned int max);
+
+	/**
+	 * \brief Drop all cached compiled stylesheets
+	 *
+	 * Safe to call while transforms are running.  A stylesheet that is
+	 * in use is destroyed when the last transform using it finishes.
+	 */
+
+	static void clearStyleSheetCache(void);
+
 	// Methods to get output data
 
 	virtual unsigned int readBytes(XMLByte * const toFill, const unsigned int maxToFill);
@@ -110,6 +125,16 @@ public:
 	virtual const XMLCh * getFragmentId();
 	
 private:
+
+	friend class XSECPlatformUtils;
+
+	// The cache lock is created by XSECPlatformUtils.  The compiler that
+	// owns the cached stylesheets is only created on first use, as Xalan
+	// may not be initialised yet.
+
+	static void Initialise(void);
+	static void Terminate(void);
+
 	TXFMXSL();
 
 };
@@ -0,0 +1,212 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECBinMappedFileInputStream := BinInputStream over a memory mapped
+ *                                 local file
+ *
+ * $Id$
+ *
+ */
+
+#include <xsec/utils/XSECBinMappedFileInputStream.hpp>
+#include <xsec/framework/XSECError.hpp>
+
+#include <xercesc/util/BinFileInputStream.hpp>
+#include <xercesc/util/XMLString.hpp>
+
+#if !defined(_WIN32)
+#	define XSEC_HAVE_MMAP
+#	include <sys/types.h>
+#	include <sys/stat.h>
+#	include <sys/mman.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <errno.h>
+#endif
+
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+// ---------------------------------------------------------------------------
+//  Constructors/Destructors
+// ---------------------------------------------------------------------------
+
+XSECBinMappedFileInputStream::XSECBinMappedFileInputStream(const XMLCh * path) :
+mp_data(NULL),
+m_size(0),
+m_pos(0),
+m_fd(-1),
+mp_file(NULL) {
+
+#if defined(XSEC_HAVE_MMAP)
+
+	char * localPath = XMLString::transcode(path);
+	int fd = open(localPath, O_RDONLY);
+	XSEC_RELEASE_XMLCH(localPath);
+
+	if (fd >= 0) {
+
+		struct stat st;
+
+		// Only regular files that fit in the address space are mapped
+		if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+			(unsigned long long) st.st_size == (unsigned long long) (xsecsize_t) st.st_size) {
+
+			void * m = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (m != MAP_FAILED) {
+
+#if defined(MADV_SEQUENTIAL)
+				madvise(m, (size_t) st.st_size, MADV_SEQUENTIAL);
+#endif
+				mp_data = (XMLByte *) m;
+				m_size = (xsecsize_t) st.st_size;
+
+			}
+
+		}
+
+		// The mapping stays valid once the descriptor is closed.  If the
+		// file could not be mapped, keep the descriptor and read it
+		// rather than opening the file a second time.
+
+		if (mp_data != NULL)
+			close(fd);
+		else
+			m_fd = fd;
+
+	}
+
+#else
+
+	// No mmap - read it as a normal file
+
+	XSECnew(mp_file, BinFileInputStream(path));
+
+#endif
+
+}
+
+XSECBinMappedFileInputStream::~XSECBinMappedFileInputStream() {
+
+#if defined(XSEC_HAVE_MMAP)
+	if (mp_data != NULL)
+		munmap(mp_data, m_size);
+	if (m_fd >= 0)
+		close(m_fd);
+#endif
+
+	if (mp_file != NULL)
+		delete mp_file;
+
+}
+
+// ---------------------------------------------------------------------------
+//  Mapping
+// ---------------------------------------------------------------------------
+
+bool XSECBinMappedFileInputStream::getIsOpen(void) const {
+
+	if (mp_data != NULL || m_fd >= 0)
+		return true;
+
+	return (mp_file != NULL && mp_file->getIsOpen());
+
+}
+
+const XMLByte * XSECBinMappedFileInputStream::consumeMapped(xsecsize_t & length) {
+
+	if (mp_data == NULL) {
+		length = 0;
+		return NULL;
+	}
+
+	const XMLByte * ret = &mp_data[m_pos];
+	length = m_size - m_pos;
+	m_pos = m_size;
+
+	return ret;
+
+}
+
+// ---------------------------------------------------------------------------
+//  Stream methods
+// ---------------------------------------------------------------------------
+
+#ifdef XSEC_XERCES_64BITSAFE
+XMLFilePos
+#else
+unsigned int
+#endif
+XSECBinMappedFileInputStream::curPos() const {
+
+	if (mp_file != NULL)
+		return mp_file->curPos();
+
+	return m_pos;
+
+}
+
+xsecsize_t XSECBinMappedFileInputStream::readBytes(XMLByte* const toFill,
+					   const xsecsize_t maxToRead) {
+
+	if (mp_file != NULL)
+		return mp_file->readBytes(toFill, maxToRead);
+
+#if defined(XSEC_HAVE_MMAP)
+	if (m_fd >= 0) {
+
+		ssize_t n;
+		do {
+			n = read(m_fd, toFill, (size_t) maxToRead);
+		} while (n < 0 && errno == EINTR);
+
+		if (n <= 0)
+			return 0;
+
+		m_pos += (xsecsize_t) n;
+		return (xsecsize_t) n;
+
+	}
+#endif
+
+	if (mp_data == NULL)
+		return 0;
+
+	xsecsize_t ret = m_size - m_pos;
+	if (ret > maxToRead)
+		ret = maxToRead;
+
+	if (ret > 0) {
+		memcpy(toFill, &mp_data[m_pos], ret);
+		m_pos += ret;
+	}
+
+	return ret;
+
+}
+
+#ifdef XSEC_XERCES_INPUTSTREAM_HAS_CONTENTTYPE
+const XMLCh* XSECBinMappedFileInputStream::getContentType() const {
+	return NULL;
+}
+#endif
@@ -0,0 +1,150 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECBinMappedFileInputStream := BinInputStream over a memory mapped
+ *                                 local file
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSECBINMAPPEDFILEINPUTSTREAM_INCLUDE
+#define XSECBINMAPPEDFILEINPUTSTREAM_INCLUDE
+
+#include <xsec/framework/XSECDefs.hpp>
+
+#include <xercesc/util/BinInputStream.hpp>
+
+XSEC_DECLARE_XERCES_CLASS(BinFileInputStream);
+
+/**
+ * @ingroup internal
+ */
+
+/**
+ * \brief Input stream over a local file, memory mapped where possible.
+ *
+ * Detached references to large local files were read through a
+ * BinFileInputStream, so every byte was copied through a small buffer
+ * by a read() call before being hashed.  Where the platform supports it
+ * (POSIX mmap), this stream maps the whole file and hints the kernel
+ * that it will be read sequentially.  The mapped bytes are available as
+ * one contiguous block, so a digest can be taken directly over the
+ * mapping.
+ *
+ * Files that cannot be mapped (empty files, pipes and devices, files
+ * too large for the address space) are read through the descriptor that
+ * was opened to map them, so the file is only opened once.  Platforms
+ * without mmap read through a BinFileInputStream.  readBytes() works in
+ * all cases.
+ *
+ * @note A mapping is only as stable as the file under it.  If another
+ * process truncates the file while it is mapped, touching the pages past
+ * the new end raises SIGBUS, which the library does not catch.  Files
+ * that may be rewritten while a signature is being created or verified
+ * should be resolved with a resolver that does not map them (for
+ * example one that leaves resolveURIMapped() at its default).
+ */
+
+class DSIG_EXPORT XSECBinMappedFileInputStream : public XERCES_CPP_NAMESPACE_QUALIFIER BinInputStream {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	/**
+	 * \brief Open a file
+	 *
+	 * @param path Local path to the file
+	 */
+
+	XSECBinMappedFileInputStream(const XMLCh * path);
+	virtual ~XSECBinMappedFileInputStream();
+
+	//@}
+
+	/** @name Mapping */
+	//@{
+
+	/**
+	 * \brief Was the file opened?
+	 */
+
+	bool getIsOpen(void) const;
+
+	/**
+	 * \brief Is the file memory mapped?
+	 */
+
+	bool isMapped(void) const {return mp_data != NULL;}
+
+	/**
+	 * \brief Take the unread part of a mapped file
+	 *
+	 * Returns the bytes not yet read and marks them as read, so a
+	 * subsequent readBytes() returns 0.
+	 *
+	 * @param length Set to the number of bytes available
+	 * @returns Pointer to the bytes (valid until the stream is deleted)
+	 * or NULL if the file is not mapped
+	 */
+
+	const XMLByte * consumeMapped(xsecsize_t & length);
+
+	//@}
+
+	/** @name BinInputStream interface */
+	//@{
+
+#ifdef XSEC_XERCES_64BITSAFE
+	virtual XMLFilePos curPos() const;
+#else
+	virtual unsigned int curPos() const;
+#endif
+
+	virtual xsecsize_t readBytes(XMLByte* const toFill,
+		const xsecsize_t maxToRead);
+
+#ifdef XSEC_XERCES_INPUTSTREAM_HAS_CONTENTTYPE
+	virtual const XMLCh* getContentType() const;
+#endif
+
+	//@}
+
+private:
+
+	XMLByte					* mp_data;		// Mapping (NULL if not mapped)
+	xsecsize_t				m_size;			// Size of the mapping
+	xsecsize_t				m_pos;			// Read position in the mapping
+	int						m_fd;			// Descriptor read when not mapped
+	XERCES_CPP_NAMESPACE_QUALIFIER BinFileInputStream
+							* mp_file;		// Used when not mapped
+
+	// Unimplemented
+	XSECBinMappedFileInputStream();
+	XSECBinMappedFileInputStream(const XSECBinMappedFileInputStream &);
+	XSECBinMappedFileInputStream & operator = (const XSECBinMappedFileInputStream &);
+
+};
+
+#endif /* XSECBINMAPPEDFILEINPUTSTREAM_INCLUDE */
@@ -0,0 +1,479 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECDOMFragmentBuilder := Parse serialised XML content directly into
+ *                           a fragment of an existing document
+ *
+ * $Id$
+ *
+ */
+
+// XSEC
+#include <xsec/utils/XSECDOMFragmentBuilder.hpp>
+#include <xsec/utils/XSECDOMUtils.hpp>
+#include <xsec/framework/XSECError.hpp>
+#include <xsec/dsig/DSIGConstants.hpp>
+
+// Xerces
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+#include <vector>
+
+XERCES_CPP_NAMESPACE_USE
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef vector<const XMLCh *>		NameVectorType;
+#else
+typedef std::vector<const XMLCh *>	NameVectorType;
+#endif
+
+// --------------------------------------------------------------------------------
+//			Constant Strings
+// --------------------------------------------------------------------------------
+
+static const XMLCh s_wrapperName[] = {
+
+	chLatin_f, chLatin_r, chLatin_a, chLatin_g, chLatin_m, chLatin_e, chLatin_n, chLatin_t, chNull };
+
+static const char s_wrapperEnd[] = "</fragment>";
+
+static const XMLCh s_memBufId[] = {
+
+	chLatin_X, chLatin_S, chLatin_E, chLatin_C, chLatin_M, chLatin_e, chLatin_m, chNull };
+
+// --------------------------------------------------------------------------------
+//			Segmented memory input
+// --------------------------------------------------------------------------------
+
+/*
+ * Feeds a number of memory buffers to the parser one after the other, so the
+ * wrapper and the content do not have to be concatenated first.  Buffers
+ * are not copied and must outlive the parse.
+ */
+
+class XSECSegmentBinInputStream : public BinInputStream {
+
+public:
+
+	XSECSegmentBinInputStream(const char ** segs, const xsecsize_t * lens, unsigned int count) :
+		mp_segs(segs), mp_lens(lens), m_count(count), m_seg(0), m_offset(0), m_pos(0) {}
+
+	virtual ~XSECSegmentBinInputStream() {}
+
+#ifdef XSEC_XERCES_64BITSAFE
+	virtual XMLFilePos curPos() const {return m_pos;}
+#else
+	virtual unsigned int curPos() const {return m_pos;}
+#endif
+
+	virtual xsecsize_t readBytes(XMLByte* const toFill, const xsecsize_t maxToRead) {
+
+		xsecsize_t ret = 0;
+
+		while (ret < maxToRead && m_seg < m_count) {
+
+			xsecsize_t avail = mp_lens[m_seg] - m_offset;
+			if (avail == 0) {
+				++m_seg;
+				m_offset = 0;
+				continue;
+			}
+
+			xsecsize_t cpy = (maxToRead - ret < avail ? maxToRead - ret : avail);
+			memcpy(&toFill[ret], &mp_segs[m_seg][m_offset], cpy);
+			m_offset += cpy;
+			ret += cpy;
+
+		}
+
+		m_pos += ret;
+		return ret;
+
+	}
+
+#ifdef XSEC_XERCES_INPUTSTREAM_HAS_CONTENTTYPE
+	virtual const XMLCh* getContentType() const {return NULL;}
+#endif
+
+private:
+
+	const char			** mp_segs;
+	const xsecsize_t	* mp_lens;
+	unsigned int		m_count;
+	unsigned int		m_seg;
+	xsecsize_t			m_offset;
+	xsecsize_t			m_pos;
+
+};
+
+class XSECSegmentInputSource : public InputSource {
+
+public:
+
+	XSECSegmentInputSource(const char ** segs, const xsecsize_t * lens, unsigned int count) :
+		mp_segs(segs), mp_lens(lens), m_count(count) {
+
+		setSystemId(s_memBufId);
+
+	}
+
+	virtual BinInputStream* makeStream() const {
+
+		XSECSegmentBinInputStream * ret;
+		XSECnew(ret, XSECSegmentBinInputStream(mp_segs, mp_lens, m_count));
+		return ret;
+
+	}
+
+private:
+
+	const char			** mp_segs;
+	const xsecsize_t	* mp_lens;
+	unsigned int		m_count;
+
+};
+
+// --------------------------------------------------------------------------------
+//			Constructors and Destructors
+// --------------------------------------------------------------------------------
+
+XSECDOMFragmentBuilder::XSECDOMFragmentBuilder() :
+mp_reader(NULL),
+mp_doc(NULL),
+mp_current(NULL),
+mp_cdata(NULL),
+m_depth(0),
+m_inCDATA(false) {
+
+	m_securityManager.setEntityExpansionLimit(XSEC_ENTITY_EXPANSION_LIMIT);
+
+}
+
+XSECDOMFragmentBuilder::~XSECDOMFragmentBuilder() {
+
+	if (mp_reader != NULL)
+		delete mp_reader;
+
+}
+
+// --------------------------------------------------------------------------------
+//			Wrapper element
+// --------------------------------------------------------------------------------
+
+void XSECDOMFragmentBuilder::makeWrapper(DOMNode * ctx) {
+
+	// Single walk up the ancestors.  The closest declaration of a given
+	// prefix wins, so anything already emitted is skipped.
+
+	NameVectorType seen;
+	safeBuffer sb;
+
+	sb.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+	sb.sbXMLChAppendCh(chOpenAngle);
+	sb.sbXMLChCat(s_wrapperName);
+
+	DOMNode * wk = ctx->getParentNode();
+
+	while (wk != NULL) {
+
+		DOMNamedNodeMap * atts = wk->getAttributes();
+		XMLSize_t length = (atts != NULL ? atts->getLength() : 0);
+
+		for (XMLSize_t i = 0; i < length; ++i) {
+
+			DOMNode * att = atts->item(i);
+			const XMLCh * name = att->getNodeName();
+
+			if (!(strEquals(name, DSIGConstants::s_unicodeStrXmlns) ||
+				(XMLString::compareNString(name, DSIGConstants::s_unicodeStrXmlns, 5) == 0 &&
+				name[5] == chColon)))
+				continue;
+
+			NameVectorType::size_type j;
+			for (j = 0; j < seen.size() && !strEquals(seen[j], name); ++j);
+			if (j < seen.size())
+				continue;
+
+			seen.push_back(name);
+
+			sb.sbXMLChAppendCh(chSpace);
+			sb.sbXMLChCat(name);
+			sb.sbXMLChAppendCh(chEqual);
+			sb.sbXMLChAppendCh(chDoubleQuote);
+
+			// Namespace names are URIs, but be safe about the few characters
+			// that would break the attribute value
+			const XMLCh * v = att->getNodeValue();
+			while (v != NULL && *v != chNull) {
+				switch (*v) {
+				case chAmpersand :
+					sb.sbXMLChCat("&amp;");
+					break;
+				case chOpenAngle :
+					sb.sbXMLChCat("&lt;");
+					break;
+				case chDoubleQuote :
+					sb.sbXMLChCat("&quot;");
+					break;
+				default :
+					sb.sbXMLChAppendCh(*v);
+				}
+				++v;
+			}
+
+			sb.sbXMLChAppendCh(chDoubleQuote);
+
+		}
+
+		wk = wk->getParentNode();
+
+	}
+
+	sb.sbXMLChAppendCh(chCloseAngle);
+
+	char * w = transcodeToUTF8(sb.rawXMLChBuffer());
+	m_wrapper.sbStrcpyIn(w);
+	XSEC_RELEASE_XMLCH(w);
+
+}
+
+// --------------------------------------------------------------------------------
+//			Parse
+// --------------------------------------------------------------------------------
+
+DOMDocumentFragment * XSECDOMFragmentBuilder::parse(const char * content,
+													xsecsize_t contentLen,
+													DOMNode * ctx) {
+
+	if (mp_reader == NULL) {
+
+		mp_reader = XMLReaderFactory::createXMLReader();
+
+		mp_reader->setFeature(XMLUni::fgSAX2CoreNameSpaces, true);
+		mp_reader->setFeature(XMLUni::fgSAX2CoreNameSpacePrefixes, true);
+		mp_reader->setFeature(XMLUni::fgXercesLoadExternalDTD, false);
+		mp_reader->setProperty(XMLUni::fgXercesSecurityManager, &m_securityManager);
+		mp_reader->setContentHandler(this);
+		mp_reader->setLexicalHandler(this);
+
+	}
+
+	// Skip any XML declaration
+
+	xsecsize_t offset = 0;
+	if (contentLen > 1 && content[0] == '<' && content[1] == '?') {
+		xsecsize_t i = 2;
+		while (i < contentLen && content[i] != '>')
+			++i;
+
+		if (i < contentLen)
+			offset = i + 1;
+	}
+
+	makeWrapper(ctx);
+
+	const char * segs[3];
+	xsecsize_t lens[3];
+
+	segs[0] = m_wrapper.rawCharBuffer();
+	lens[0] = (xsecsize_t) strlen(segs[0]);
+	segs[1] = &content[offset];
+	lens[1] = contentLen - offset;
+	segs[2] = s_wrapperEnd;
+	lens[2] = (xsecsize_t) strlen(s_wrapperEnd);
+
+	XSECSegmentInputSource is(segs, lens, 3);
+
+	// Set up the build state
+
+	mp_doc = ctx->getOwnerDocument();
+	DOMDocumentFragment * result = mp_doc->createDocumentFragment();
+
+	mp_current = result;
+	mp_cdata = NULL;
+	m_depth = 0;
+	m_inCDATA = false;
+
+	xsecsize_t errorCount;
+
+	try {
+		mp_reader->parse(is);
+		errorCount = mp_reader->getErrorCount();
+	}
+	catch (...) {
+		mp_current = NULL;
+		result->release();
+		throw;
+	}
+
+	mp_current = NULL;
+	mp_cdata = NULL;
+
+	if (errorCount > 0) {
+		result->release();
+		throw XSECException(XSECException::CipherError,
+			"Errors occured during de-serialisation of decrypted element content");
+	}
+
+	return result;
+
+}
+
+// --------------------------------------------------------------------------------
+//			SAX2 handlers
+// --------------------------------------------------------------------------------
+
+const XMLCh * XSECDOMFragmentBuilder::terminate(const XMLCh * chars, xsecsize_t length) {
+
+	xsecsize_t bytes = length * (xsecsize_t) sizeof(XMLCh);
+
+	m_text.sbMemcpyIn(chars, bytes);
+	m_text[bytes] = 0;
+	m_text[bytes + 1] = 0;
+	m_text.setBufferType(safeBuffer::BUFFER_UNICODE);
+
+	return m_text.rawXMLChBuffer();
+
+}
+
+void XSECDOMFragmentBuilder::startElement(const XMLCh* const uri,
+										  const XMLCh* const localname,
+										  const XMLCh* const qname,
+										  const Attributes& attrs) {
+
+	// Depth 0 is the wrapper
+	if (m_depth++ == 0)
+		return;
+
+	DOMElement * e = mp_doc->createElementNS(
+		(uri != NULL && *uri != chNull ? uri : NULL), qname);
+
+	XMLSize_t length = attrs.getLength();
+	for (XMLSize_t i = 0; i < length; ++i) {
+
+		const XMLCh * aname = attrs.getQName(i);
+		const XMLCh * auri = attrs.getURI(i);
+
+		if (strEquals(aname, DSIGConstants::s_unicodeStrXmlns) ||
+			(XMLString::compareNString(aname, DSIGConstants::s_unicodeStrXmlns, 5) == 0 &&
+			aname[5] == chColon))
+			auri = DSIGConstants::s_unicodeStrURIXMLNS;
+
+		e->setAttributeNS((auri != NULL && *auri != chNull ? auri : NULL), aname, attrs.getValue(i));
+
+	}
+
+	mp_current->appendChild(e);
+	mp_current = e;
+
+}
+
+void XSECDOMFragmentBuilder::endElement(const XMLCh* const uri,
+										const XMLCh* const localname,
+										const XMLCh* const qname) {
+
+	if (--m_depth == 0)
+		return;
+
+	mp_current = mp_current->getParentNode();
+
+}
+
+void XSECDOMFragmentBuilder::characters(const XMLCh* const chars, const xsecsize_t length) {
+
+	if (m_depth == 0 || length == 0)
+		return;
+
+	const XMLCh * t = terminate(chars, length);
+
+	if (m_inCDATA) {
+
+		if (mp_cdata == NULL) {
+			mp_cdata = mp_doc->createCDATASection(t);
+			mp_current->appendChild(mp_cdata);
+		}
+		else
+			((DOMCharacterData *) mp_cdata)->appendData(t);
+
+		return;
+
+	}
+
+	// The parser may hand over text in pieces - join them as the DOM parser does
+
+	DOMNode * last = mp_current->getLastChild();
+	if (last != NULL && last->getNodeType() == DOMNode::TEXT_NODE)
+		((DOMCharacterData *) last)->appendData(t);
+	else
+		mp_current->appendChild(mp_doc->createTextNode(t));
+
+}
+
+void XSECDOMFragmentBuilder::ignorableWhitespace(const XMLCh* const chars, const xsecsize_t length) {
+
+	characters(chars, length);
+
+}
+
+void XSECDOMFragmentBuilder::comment(const XMLCh* const chars, const xsecsize_t length) {
+
+	if (m_depth == 0)
+		return;
+
+	mp_current->appendChild(mp_doc->createComment(terminate(chars, length)));
+
+}
+
+void XSECDOMFragmentBuilder::processingInstruction(const XMLCh* const target,
+												   const XMLCh* const data) {
+
+	if (m_depth == 0)
+		return;
+
+	mp_current->appendChild(mp_doc->createProcessingInstruction(target, data));
+
+}
+
+void XSECDOMFragmentBuilder::startCDATA() {
+
+	m_inCDATA = true;
+	mp_cdata = NULL;
+
+}
+
+void XSECDOMFragmentBuilder::endCDATA() {
+
+	// An empty section still produces a node
+	if (mp_cdata == NULL && m_depth > 0)
+		mp_current->appendChild(mp_doc->createCDATASection(DSIGConstants::s_unicodeStrEmpty));
+
+	m_inCDATA = false;
+	mp_cdata = NULL;
+
+}
@@ -0,0 +1,151 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECDOMFragmentBuilder := Parse serialised XML content directly into
+ *                           a fragment of an existing document
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSECDOMFRAGMENTBUILDER_INCLUDE
+#define XSECDOMFRAGMENTBUILDER_INCLUDE
+
+// XSEC
+#include <xsec/framework/XSECDefs.hpp>
+#include <xsec/utils/XSECSafeBuffer.hpp>
+
+// Xerces
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/util/SecurityManager.hpp>
+
+XSEC_DECLARE_XERCES_CLASS(DOMNode);
+XSEC_DECLARE_XERCES_CLASS(DOMDocument);
+XSEC_DECLARE_XERCES_CLASS(DOMDocumentFragment);
+XSEC_DECLARE_XERCES_CLASS(SAX2XMLReader);
+
+/**
+ * @ingroup internal
+ */
+
+/**
+ * \brief Build DOM nodes in an existing document from serialised content.
+ *
+ * Decrypted element content needs to be turned back into nodes that
+ * live in the document the EncryptedData element came from.  Rather than
+ * parsing into a scratch document and then deep importing every node,
+ * this class drives a SAX2 parser and creates the nodes in the owner
+ * document as the events arrive.
+ *
+ * The content is wrapped in a dummy element carrying the namespace
+ * declarations in scope at the context node, so prefixes used (but not
+ * declared) in the content resolve as they did before encryption.  The
+ * wrapper start tag, the content and the end tag are fed to the parser as
+ * separate segments, so the content is never copied.
+ *
+ * The parser is created on first use and reused for subsequent calls.
+ * Namespace processing is on, external DTDs are not loaded and entity
+ * expansion is limited to XSEC_ENTITY_EXPANSION_LIMIT.
+ */
+
+class DSIG_EXPORT XSECDOMFragmentBuilder : public XERCES_CPP_NAMESPACE_QUALIFIER DefaultHandler {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	XSECDOMFragmentBuilder();
+	virtual ~XSECDOMFragmentBuilder();
+
+	//@}
+
+	/** @name Parsing */
+	//@{
+
+	/**
+	 * \brief Parse content into a fragment of the context's document
+	 *
+	 * @param content UTF-8 serialised content.  A leading XML
+	 * declaration is skipped.
+	 * @param contentLen Number of bytes in content
+	 * @param ctx The node whose position the content will take.  Used
+	 * to find the owner document and the in-scope namespaces.
+	 * @returns A new document fragment (owned by the caller) holding the
+	 * parsed nodes.
+	 * @throws XSECException if the content is not well formed
+	 */
+
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMDocumentFragment * parse(
+		const char * content,
+		xsecsize_t contentLen,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * ctx);
+
+	//@}
+
+	/** @name SAX2 handlers */
+	//@{
+
+	virtual void startElement(const XMLCh* const uri,
+		const XMLCh* const localname,
+		const XMLCh* const qname,
+		const XERCES_CPP_NAMESPACE_QUALIFIER Attributes& attrs);
+	virtual void endElement(const XMLCh* const uri,
+		const XMLCh* const localname,
+		const XMLCh* const qname);
+	virtual void characters(const XMLCh* const chars, const xsecsize_t length);
+	virtual void ignorableWhitespace(const XMLCh* const chars, const xsecsize_t length);
+	virtual void comment(const XMLCh* const chars, const xsecsize_t length);
+	virtual void processingInstruction(const XMLCh* const target,
+		const XMLCh* const data);
+	virtual void startCDATA();
+	virtual void endCDATA();
+
+	//@}
+
+private:
+
+	void makeWrapper(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * ctx);
+	const XMLCh * terminate(const XMLCh * chars, xsecsize_t length);
+
+	XERCES_CPP_NAMESPACE_QUALIFIER SAX2XMLReader
+							* mp_reader;		// Parser, created on first use
+	XERCES_CPP_NAMESPACE_QUALIFIER SecurityManager
+							m_securityManager;
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument
+							* mp_doc;			// Document nodes are created in
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode
+							* mp_current;		// Node new children go under
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode
+							* mp_cdata;			// Open CDATA section (if any)
+	unsigned int			m_depth;			// Element depth (wrapper is 1)
+	bool					m_inCDATA;
+	safeBuffer				m_wrapper;			// Wrapper start tag
+	safeBuffer				m_text;				// Scratch for character data
+
+	// Unimplemented
+	XSECDOMFragmentBuilder(const XSECDOMFragmentBuilder &);
+	XSECDOMFragmentBuilder & operator = (const XSECDOMFragmentBuilder &);
+
+};
+
+#endif /* XSECDOMFRAGMENTBUILDER_INCLUDE */
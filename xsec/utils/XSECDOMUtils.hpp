@@ -158,27 +158,35 @@ bool strEquals (const char * str1, const char *str2) {
 
 }
 
+// Comparisons against char strings are used for element and attribute
+// names throughout the load() paths.  Those literals are plain ASCII, which
+// maps directly onto UTF-16, so they are compared in place.  Only a string
+// holding a non-ASCII byte is transcoded (and so allocated).
+
 inline 
-bool strEquals (const char * str1, const XMLCh * str2) {
+bool strEquals (const XMLCh * str1, const char * str2) {
 
-	bool ret;
-	XMLCh * str1XMLCh = XMLString::transcode(str1);
+	if (str2 == NULL)
+		return false;
 
-	if (str1XMLCh != NULL) {
+	if (str1 == NULL)
+		return (*str2 == 0);
 
-		ret = (XMLString::compareString(str1XMLCh, str2) == 0);
-		XSEC_RELEASE_XMLCH(str1XMLCh);
+	const XMLCh * p1 = str1;
+	const unsigned char * p2 = (const unsigned char *) str2;
 
-	}
-	else
-		ret = false;
+	while (*p2 != 0 && *p2 < 0x80) {
 
-	return ret;
+		if (*p1 != (XMLCh) *p2)
+			return false;
 
-}
+		++p1;
+		++p2;
 
-inline 
-bool strEquals (const XMLCh * str1, const char * str2) {
+	}
+
+	if (*p2 == 0)
+		return (*p1 == 0);
 
 	bool ret;
 	XMLCh * str2XMLCh = XMLString::transcode(str2);
@@ -196,5 +204,12 @@ bool strEquals (const XMLCh * str1, const char * str2) {
 
 }
 
+inline 
+bool strEquals (const char * str1, const XMLCh * str2) {
+
+	return strEquals(str2, str1);
+
+}
+
 #endif /* XSECDOMUTILS_HEADER */
 
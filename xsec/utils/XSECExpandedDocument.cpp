@@ -0,0 +1,247 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECExpandedDocument := Private copy of a document with its name spaces
+ *                         expanded, for XPath engines that need them
+ *
+ * $Id$
+ *
+ */
+
+// XSEC
+#include <xsec/utils/XSECExpandedDocument.hpp>
+#include <xsec/utils/XSECNameSpaceExpander.hpp>
+#include <xsec/dsig/DSIGConstants.hpp>
+#include <xsec/framework/XSECError.hpp>
+
+// Xerces
+#include <xercesc/dom/DOM.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+// --------------------------------------------------------------------------------
+//           Constructors and Destructors
+// --------------------------------------------------------------------------------
+
+XSECExpandedDocument::XSECExpandedDocument(DOMDocument * doc) :
+mp_original(doc),
+mp_copy(NULL),
+mp_nse(NULL) {
+
+	mp_copy = (DOMDocument *) doc->cloneNode(true);
+
+	if (mp_copy == NULL || mp_copy->getDocumentElement() == NULL) {
+
+		if (mp_copy != NULL)
+			mp_copy->release();
+
+		throw XSECException(XSECException::XPathError,
+			"XSECExpandedDocument - unable to copy document");
+
+	}
+
+	try {
+
+		// Walk both trees together.  The copy has the same shape until
+		// it is expanded.
+
+		DOMNode * o = doc;
+		DOMNode * c = mp_copy;
+
+		while (o != NULL && c != NULL) {
+
+			mapNode(o, c);
+
+			if (o->getFirstChild() != NULL) {
+				o = o->getFirstChild();
+				c = c->getFirstChild();
+			}
+			else {
+				while (o != NULL && o != doc && o->getNextSibling() == NULL) {
+					o = o->getParentNode();
+					c = c->getParentNode();
+				}
+				if (o == NULL || o == doc)
+					break;
+				o = o->getNextSibling();
+				c = c->getNextSibling();
+			}
+
+		}
+
+		XSECnew(mp_nse, XSECNameSpaceExpander(mp_copy));
+		mp_nse->expandNameSpaces();
+
+	}
+	catch (...) {
+		if (mp_nse != NULL) {
+			mp_nse->deleteAddedNamespaces();
+			delete mp_nse;
+		}
+		mp_copy->release();
+		throw;
+	}
+
+}
+
+XSECExpandedDocument::~XSECExpandedDocument() {
+
+	// Frees the expander's records of what it added
+	if (mp_nse != NULL) {
+		mp_nse->deleteAddedNamespaces();
+		delete mp_nse;
+	}
+
+	if (mp_copy != NULL)
+		mp_copy->release();
+
+}
+
+// --------------------------------------------------------------------------------
+//           Mapping
+// --------------------------------------------------------------------------------
+
+void XSECExpandedDocument::mapNode(DOMNode * orig, DOMNode * copy) {
+
+	m_toOriginal[copy] = orig;
+
+	if (orig->getNodeType() != DOMNode::ELEMENT_NODE)
+		return;
+
+	DOMNamedNodeMap * oatts = orig->getAttributes();
+	DOMElement * ce = (DOMElement *) copy;
+	XMLSize_t sz = oatts->getLength();
+
+	for (XMLSize_t i = 0; i < sz; ++i) {
+
+		DOMAttr * oa = (DOMAttr *) oatts->item(i);
+		DOMAttr * ca;
+
+		if (oa->getLocalName() != NULL)
+			ca = ce->getAttributeNodeNS(oa->getNamespaceURI(), oa->getLocalName());
+		else
+			ca = ce->getAttributeNode(oa->getNodeName());
+
+		if (ca == NULL)
+			continue;
+
+		m_toOriginal[ca] = oa;
+
+#if defined (XSEC_XERCES_HAS_BOOLSETIDATTRIBUTE)
+		// Keep id() working in the copy
+		if (oa->isId() && !ca->isId())
+			ce->setIdAttributeNode(ca, true);
+#endif
+
+	}
+
+}
+
+DOMNode * XSECExpandedDocument::toCopy(const DOMNode * n) const {
+
+	if (n == NULL)
+		return NULL;
+
+	if (n == mp_original)
+		return mp_copy;
+
+	if (n->getOwnerDocument() != mp_original)
+		return NULL;
+
+	if (n->getNodeType() == DOMNode::ATTRIBUTE_NODE) {
+
+		// Attributes of the original are still there by name
+
+		const DOMAttr * a = (const DOMAttr *) n;
+		DOMElement * ce = (DOMElement *) toCopy(a->getOwnerElement());
+
+		if (ce == NULL)
+			return NULL;
+
+		if (a->getLocalName() != NULL)
+			return ce->getAttributeNodeNS(a->getNamespaceURI(), a->getLocalName());
+
+		return ce->getAttributeNode(a->getNodeName());
+
+	}
+
+	// The expansion only adds attributes, so a node is at the same
+	// position amongst its siblings in both trees
+
+	DOMNode * cp = toCopy(n->getParentNode());
+
+	if (cp == NULL)
+		return NULL;
+
+	const DOMNode * o = n->getParentNode()->getFirstChild();
+	DOMNode * c = cp->getFirstChild();
+
+	while (o != NULL && c != NULL && o != n) {
+
+		o = o->getNextSibling();
+		c = c->getNextSibling();
+
+	}
+
+	return (o == n ? c : NULL);
+
+}
+
+DOMNode * XSECExpandedDocument::toOriginal(const DOMNode * n) const {
+
+	NodeMapType::const_iterator i = m_toOriginal.find(n);
+
+	if (i != m_toOriginal.end())
+		return i->second;
+
+	if (n == NULL || n->getNodeType() != DOMNode::ATTRIBUTE_NODE)
+		return NULL;
+
+	// A declaration copied down by the expansion stands for the one it
+	// was copied from
+
+	const DOMAttr * a = (const DOMAttr *) n;
+
+	if (!XMLString::equals(a->getNamespaceURI(), DSIGConstants::s_unicodeStrURIXMLNS))
+		return NULL;
+
+	i = m_toOriginal.find(a->getOwnerElement());
+	if (i == m_toOriginal.end())
+		return NULL;
+
+	DOMNode * p = i->second;
+
+	while (p != NULL && p->getNodeType() == DOMNode::ELEMENT_NODE) {
+
+		DOMAttr * decl = ((DOMElement *) p)->getAttributeNodeNS(
+			DSIGConstants::s_unicodeStrURIXMLNS, a->getLocalName());
+
+		if (decl != NULL)
+			return decl;
+
+		p = p->getParentNode();
+
+	}
+
+	return NULL;
+
+}
@@ -0,0 +1,153 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECExpandedDocument := Private copy of a document with its name spaces
+ *                         expanded, for XPath engines that need them
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSECEXPANDEDDOCUMENT_INCLUDE
+#define XSECEXPANDEDDOCUMENT_INCLUDE
+
+// XSEC
+#include <xsec/framework/XSECDefs.hpp>
+
+#include <map>
+
+XSEC_DECLARE_XERCES_CLASS(DOMDocument);
+XSEC_DECLARE_XERCES_CLASS(DOMNode);
+
+class XSECNameSpaceExpander;
+
+/**
+ * @ingroup internal
+ */
+
+/**
+ * \brief Name space expanded copy of a document.
+ *
+ * Xalan only sees the namespace nodes of an element if they exist as
+ * attributes, so an expression handed to Xalan needs every in-scope
+ * declaration copied onto every element.  Doing that to the caller's
+ * document changes it for the duration of the transform, and stops two
+ * signatures over the same document being processed at once.
+ *
+ * This class makes the expansion on a deep copy instead, and maps nodes
+ * between the two.  A declaration that only exists in the copy because
+ * of the expansion maps back to the original declaration it was copied
+ * from - the same representation the canonicaliser's namespace stack
+ * uses for a document that has not been expanded.
+ *
+ * The copy is not changed once built, so a transform builds one (and
+ * only when an expression actually needs Xalan) and evaluates all of its
+ * expressions against it.  The prefixes used in the expressions are
+ * resolved by XSECXPathPrefixResolver rather than by adding declarations
+ * to the copy.  Only copy-to-original is held as a map; the few nodes
+ * that go the other way are found by their position in the tree.
+ *
+ * The caller's document is only read.
+ */
+
+class DSIG_EXPORT XSECExpandedDocument {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	/**
+	 * \brief Copy and expand a document
+	 *
+	 * @param doc The document to copy.  Not modified.
+	 */
+
+	XSECExpandedDocument(XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument * doc);
+	~XSECExpandedDocument();
+
+	//@}
+
+	/** @name Mapping */
+	//@{
+
+	/**
+	 * \brief The expanded copy
+	 */
+
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument * getDocument(void) const {return mp_copy;}
+
+	/**
+	 * \brief Find the copy of a node of the original document
+	 *
+	 * Found by walking down the copy along the path to n, so this is
+	 * intended for the handful of nodes (here and context) an expression
+	 * starts from.
+	 *
+	 * @returns The node in the copy, or NULL if n is not part of the
+	 * original document
+	 */
+
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * toCopy(
+		const XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * n) const;
+
+	/**
+	 * \brief Find the original of a node of the copy
+	 *
+	 * @returns The node in the original document (for an expanded
+	 * declaration, the declaration in scope).  NULL if the node was
+	 * added to the copy and has no original.
+	 */
+
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * toOriginal(
+		const XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * n) const;
+
+	//@}
+
+private:
+
+#if defined(XSEC_NO_NAMESPACES)
+	typedef map<const XERCES_CPP_NAMESPACE_QUALIFIER DOMNode *,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode *>			NodeMapType;
+#else
+	typedef std::map<const XERCES_CPP_NAMESPACE_QUALIFIER DOMNode *,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode *>			NodeMapType;
+#endif
+
+	void mapNode(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * orig,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * copy);
+
+	const XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument
+							* mp_original;
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument
+							* mp_copy;
+	XSECNameSpaceExpander	* mp_nse;
+	NodeMapType				m_toOriginal;
+
+	// Unimplemented
+	XSECExpandedDocument();
+	XSECExpandedDocument(const XSECExpandedDocument &);
+	XSECExpandedDocument & operator = (const XSECExpandedDocument &);
+
+};
+
+#endif /* XSECEXPANDEDDOCUMENT_INCLUDE */
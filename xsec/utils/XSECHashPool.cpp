@@ -0,0 +1,192 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECHashPool := Pool of re-usable digest objects
+ *
+ * $Id$
+ *
+ */
+
+// XSEC
+#include <xsec/utils/XSECHashPool.hpp>
+#include <xsec/utils/XSECPlatformUtils.hpp>
+#include <xsec/enc/XSECCryptoProvider.hpp>
+#include <xsec/framework/XSECError.hpp>
+
+// Xerces
+#include <xercesc/util/Mutexes.hpp>
+
+#include <vector>
+
+XERCES_CPP_NAMESPACE_USE
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef vector<XSECCryptoHash *>			HashVectorType;
+#else
+typedef std::vector<XSECCryptoHash *>		HashVectorType;
+#endif
+
+// One idle list per XSECCryptoHash::HashType
+#define XSEC_HASHPOOL_TYPES		(XSECCryptoHash::HASH_SHA512 + 1)
+
+// --------------------------------------------------------------------------------
+//			Pool state
+// --------------------------------------------------------------------------------
+
+static XMLMutex				* s_poolMutex = NULL;
+static HashVectorType		s_hashes[XSEC_HASHPOOL_TYPES];
+static unsigned int			s_maxIdle = 8;
+
+// --------------------------------------------------------------------------------
+//			Initialise and Terminate
+// --------------------------------------------------------------------------------
+
+void XSECHashPool::Initialise(void) {
+
+	XSECnew(s_poolMutex, XMLMutex());
+
+}
+
+void XSECHashPool::Terminate(void) {
+
+	clear();
+
+	delete s_poolMutex;
+	s_poolMutex = NULL;
+
+}
+
+void XSECHashPool::clear(void) {
+
+	if (s_poolMutex == NULL)
+		return;
+
+	XMLMutexLock lock(s_poolMutex);
+
+	for (int t = 0; t < XSEC_HASHPOOL_TYPES; ++t) {
+
+		HashVectorType::size_type i;
+		for (i = 0; i < s_hashes[t].size(); ++i)
+			delete s_hashes[t][i];
+		s_hashes[t].clear();
+
+	}
+
+}
+
+void XSECHashPool::setMaxIdle(unsigned int max) {
+
+	s_maxIdle = max;
+
+}
+
+// --------------------------------------------------------------------------------
+//			Hash objects
+// --------------------------------------------------------------------------------
+
+XSECCryptoHash * XSECHashPool::getHash(XSECCryptoHash::HashType type) {
+
+	XSECCryptoHash * ret = NULL;
+
+	if (s_poolMutex != NULL && type > XSECCryptoHash::HASH_NONE && type < XSEC_HASHPOOL_TYPES) {
+
+		XMLMutexLock lock(s_poolMutex);
+		if (!s_hashes[type].empty()) {
+			ret = s_hashes[type].back();
+			s_hashes[type].pop_back();
+		}
+
+	}
+
+	if (ret != NULL)
+		return ret;
+
+	switch (type) {
+
+	case XSECCryptoHash::HASH_SHA1 :
+		ret = XSECPlatformUtils::g_cryptoProvider->hashSHA(160);
+		break;
+	case XSECCryptoHash::HASH_SHA224 :
+		ret = XSECPlatformUtils::g_cryptoProvider->hashSHA(224);
+		break;
+	case XSECCryptoHash::HASH_SHA256 :
+		ret = XSECPlatformUtils::g_cryptoProvider->hashSHA(256);
+		break;
+	case XSECCryptoHash::HASH_SHA384 :
+		ret = XSECPlatformUtils::g_cryptoProvider->hashSHA(384);
+		break;
+	case XSECCryptoHash::HASH_SHA512 :
+		ret = XSECPlatformUtils::g_cryptoProvider->hashSHA(512);
+		break;
+	case XSECCryptoHash::HASH_MD5 :
+		ret = XSECPlatformUtils::g_cryptoProvider->hashMD5();
+		break;
+	default :
+		ret = NULL;
+
+	}
+
+	if (ret == NULL) {
+
+		throw XSECException(XSECException::CryptoProviderError,
+			"XSECHashPool - Error requesting hash object from Crypto Provider");
+
+	}
+
+	return ret;
+
+}
+
+void XSECHashPool::releaseHash(XSECCryptoHash * h) {
+
+	if (h == NULL)
+		return;
+
+	XSECCryptoHash::HashType type = h->getHashType();
+
+	if (s_poolMutex != NULL && type > XSECCryptoHash::HASH_NONE && type < XSEC_HASHPOOL_TYPES) {
+
+		// Make it ready for the next user.  If that fails the object is
+		// simply dropped.
+		bool ok = true;
+		try {
+			h->reset();
+		}
+		catch (...) {
+			ok = false;
+		}
+
+		if (ok) {
+
+			XMLMutexLock lock(s_poolMutex);
+			if (s_hashes[type].size() < s_maxIdle) {
+				s_hashes[type].push_back(h);
+				return;
+			}
+
+		}
+
+	}
+
+	delete h;
+
+}
@@ -0,0 +1,120 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECHashPool := Pool of re-usable digest objects
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSECHASHPOOL_INCLUDE
+#define XSECHASHPOOL_INCLUDE
+
+// XSEC
+#include <xsec/framework/XSECDefs.hpp>
+#include <xsec/enc/XSECCryptoHash.hpp>
+
+/**
+ * @ingroup internal
+ */
+
+/**
+ * \brief Pool of digest objects used internally by the library.
+ *
+ * Every reference digest used to ask the crypto provider for a new hash
+ * object, which (for OpenSSL) allocates and initialises a digest
+ * context, and deleted it when done.  This class keeps idle hash objects
+ * for re-use.  They are reset when returned, so a hash handed out is
+ * always ready for new data.
+ *
+ * Only plain digests are pooled.  HMAC objects hold key material, so
+ * they are still created and destroyed for each use.
+ *
+ * The pool is protected by a mutex, so any thread may check a hash out,
+ * but a hash is only ever used by one thread at a time.  It is emptied
+ * when the crypto provider is changed.
+ *
+ * Initialised and terminated by XSECPlatformUtils.
+ */
+
+class DSIG_EXPORT XSECHashPool {
+
+public:
+
+	/** @name Hash objects */
+	//@{
+
+	/**
+	 * \brief Check out a hash object
+	 *
+	 * @param type The digest algorithm required
+	 * @returns A hash that must be handed back via releaseHash
+	 * @throws XSECException if the provider cannot supply the algorithm
+	 */
+
+	static XSECCryptoHash * getHash(XSECCryptoHash::HashType type);
+
+	/**
+	 * \brief Return a hash object to the pool
+	 *
+	 * @param h Hash previously obtained from getHash
+	 */
+
+	static void releaseHash(XSECCryptoHash * h);
+
+	//@}
+
+	/** @name Pool management */
+	//@{
+
+	/**
+	 * \brief Set the number of idle hash objects kept per algorithm
+	 *
+	 * Hashes returned when the pool is full are deleted.  Defaults
+	 * to 8.  Setting 0 disables pooling.
+	 *
+	 * @param max Maximum number of idle hashes to keep
+	 */
+
+	static void setMaxIdle(unsigned int max);
+
+	/**
+	 * \brief Delete all idle hash objects
+	 */
+
+	static void clear(void);
+
+	//@}
+
+private:
+
+	friend class XSECPlatformUtils;
+
+	static void Initialise(void);
+	static void Terminate(void);
+
+	// Not instantiable
+	XSECHashPool();
+
+};
+
+#endif /* XSECHASHPOOL_INCLUDE */
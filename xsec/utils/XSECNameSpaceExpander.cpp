@@ -39,9 +39,6 @@ XSECNameSpaceExpander::XSECNameSpaceExpander(DOMDocument *d) {
 
 	mp_doc = d;
 	mp_fragment = d->getDocumentElement();
-	XSECnew(mp_formatter, XSECSafeBufferFormatter("UTF-8",XMLFormatter::NoEscapes, 
-												XMLFormatter::UnRep_CharRef));
-
 	m_expanded = false;
 	
 }
@@ -50,18 +47,12 @@ XSECNameSpaceExpander::XSECNameSpaceExpander(DOMElement *f) {
 
 	mp_doc = NULL;
 	mp_fragment = f;
-	XSECnew(mp_formatter, XSECSafeBufferFormatter("UTF-8",XMLFormatter::NoEscapes, 
-												XMLFormatter::UnRep_CharRef));
-
 	m_expanded = false;
 	
 }
 
 XSECNameSpaceExpander::~XSECNameSpaceExpander() {
 
-	if (mp_formatter != NULL)
-		delete mp_formatter;
-
 }
 
 void XSECNameSpaceExpander::recurse(DOMElement *n) {
@@ -77,7 +68,7 @@ void XSECNameSpaceExpander::recurse(DOMElement *n) {
 
 	DOMNamedNodeMap *nmap = n->getAttributes();
 
-	safeBuffer pname, pURI, nURI;
+	const XMLCh * pname;
 	DOMNode *finder;
 
 	XSECNameSpaceEntry * tmpEnt;
@@ -85,26 +76,25 @@ void XSECNameSpaceExpander::recurse(DOMElement *n) {
 	for (XMLSize_t i = 0; i < psize; i++) {
 
 		// Run through each parent node to find namespaces
-		pname << (*mp_formatter << pmap->item(i)->getNodeName());
+		pname = pmap->item(i)->getNodeName();
 
 		// See if this is an xmlns node
 		
-		if (pname.sbStrncmp("xmlns", 5) == 0) {
+		if (XMLString::startsWith(pname, DSIGConstants::s_unicodeStrXmlns)) {
 
 			// It is - see if it already exists
-			finder = nmap->getNamedItem(pname.sbStrToXMLCh());
+			finder = nmap->getNamedItem(pname);
 			if (finder == 0) {
 
 				// Need to add
 				n->setAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS, 
-					pmap->item(i)->getNodeName(),
+					pname,
 					pmap->item(i)->getNodeValue());
 
 				// Add it to the list so it can be removed later
 				XSECnew(tmpEnt, XSECNameSpaceEntry);
-				tmpEnt->m_name.sbStrcpyIn(pname);
 				tmpEnt->mp_node = n;
-				tmpEnt->mp_att = nmap->getNamedItem(pname.sbStrToXMLCh());
+				tmpEnt->mp_att = nmap->getNamedItem(pname);
 				m_lst.push_back(tmpEnt);
 
 			}
@@ -127,29 +117,6 @@ void XSECNameSpaceExpander::recurse(DOMElement *n) {
 
 }
 
-int attNodeCount(DOMElement * d) {
-
-	XMLSize_t ret;
-
-	ret = d->getAttributes()->getLength();
-
-	DOMNode *c;
-
-	c = d->getFirstChild();
-
-	while (c != NULL) {
-
-		if (c->getNodeType() == DOMNode::ELEMENT_NODE)
-			ret += attNodeCount((DOMElement *) c);
-
-		c = c->getNextSibling();
-
-	}
-
-	return (int) ret;
-
-}
-
 void XSECNameSpaceExpander::expandNameSpaces(void) {
 
 	if (m_expanded)
@@ -158,7 +125,6 @@ void XSECNameSpaceExpander::expandNameSpaces(void) {
 	DOMElement	*docElt;		// The document element - do not expand it's namespaces
 	
 	docElt = mp_fragment; //mp_doc->getDocumentElement();
-	int count = attNodeCount(docElt);
 
 	DOMNode *c;
 
@@ -172,8 +138,6 @@ void XSECNameSpaceExpander::expandNameSpaces(void) {
 
 	m_expanded = true;
 
-	count = attNodeCount(docElt);
-
 }
 
 
@@ -182,21 +146,13 @@ void XSECNameSpaceExpander::deleteAddedNamespaces(void) {
 	NameSpaceEntryListVectorType::size_type size = m_lst.size();
 	XSECNameSpaceEntry *e;
 
-	DOMElement *docElt = mp_fragment; //mp_doc->getDocumentElement();
-	int 	count = attNodeCount(docElt);
-
 	NameSpaceEntryListVectorType::size_type i;
 
 	for (i = 0; i < size; ++i) {
 
 		// Delete the element attribute, and then this node
 		e = m_lst[i];
-		if (e->m_name[5] == ':')
-			e->mp_node->removeAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS,
-										MAKE_UNICODE_STRING((char *) &((e->m_name.rawBuffer())[6])));
-		else
-			e->mp_node->removeAttributeNS(DSIGConstants::s_unicodeStrURIXMLNS,
-										MAKE_UNICODE_STRING((char *) e->m_name.rawBuffer()));
+		e->mp_node->removeAttributeNode((DOMAttr *) e->mp_att);
 
 		// Delete the entry
 		delete e;
@@ -206,7 +162,6 @@ void XSECNameSpaceExpander::deleteAddedNamespaces(void) {
 	// Now done - empty everything
 	m_lst.clear();
 	m_expanded = false;
-	count = attNodeCount(docElt);
 
 }
 
@@ -49,7 +49,6 @@ XSEC_DECLARE_XERCES_CLASS(DOMElement);
 struct XSECNameSpaceEntry {
 
 	// Variables
-	safeBuffer									m_name;			// The name for this name space
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMElement	* mp_node;		// The Element Node owner
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode		* mp_att;		// The added attribute node
 			
@@ -89,6 +88,13 @@ struct XSECNameSpaceEntry {
  * removes the propogated nodes when it goes out of scope (or when
  * deleteAddedNamespaces() is called).
  *
+ * @note Expansion modifies the document, so the library never expands a
+ * caller's document.  Xalan XPath expressions are run over an expanded
+ * copy (XSECExpandedDocument), and documents the library parses itself
+ * may be expanded in place.  Expressions evaluated natively, and the
+ * canonicaliser's namespace stack, read the in-scope namespaces from the
+ * ancestors instead.
+ *
  */
 
 
@@ -167,7 +173,6 @@ private:  // Functions
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMElement                      
 									* mp_fragment;  // If we are doing a fragment
 	bool							m_expanded;		// Have we expanded already?
-	XSECSafeBufferFormatter			* mp_formatter;
 
 };
 
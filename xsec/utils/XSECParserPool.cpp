@@ -0,0 +1,227 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECParserPool := Pool of re-usable, pre-configured parsers
+ *
+ * $Id$
+ *
+ */
+
+// XSEC
+#include <xsec/utils/XSECParserPool.hpp>
+#include <xsec/utils/XSECDOMFragmentBuilder.hpp>
+#include <xsec/framework/XSECError.hpp>
+
+// Xerces
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/util/Mutexes.hpp>
+#include <xercesc/util/SecurityManager.hpp>
+
+#include <vector>
+
+XERCES_CPP_NAMESPACE_USE
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef vector<XercesDOMParser *>			DOMParserVectorType;
+typedef vector<XSECDOMFragmentBuilder *>	BuilderVectorType;
+#else
+typedef std::vector<XercesDOMParser *>		DOMParserVectorType;
+typedef std::vector<XSECDOMFragmentBuilder *>	BuilderVectorType;
+#endif
+
+// --------------------------------------------------------------------------------
+//			Pool state
+// --------------------------------------------------------------------------------
+
+static XMLMutex				* s_poolMutex = NULL;
+static SecurityManager		* s_securityManager = NULL;
+static DOMParserVectorType	s_domParsers;
+static BuilderVectorType	s_builders;
+static unsigned int			s_maxIdle = 8;
+
+// --------------------------------------------------------------------------------
+//			Initialise and Terminate
+// --------------------------------------------------------------------------------
+
+void XSECParserPool::Initialise(void) {
+
+	XSECnew(s_securityManager, SecurityManager());
+	s_securityManager->setEntityExpansionLimit(XSEC_ENTITY_EXPANSION_LIMIT);
+
+	XSECnew(s_poolMutex, XMLMutex());
+
+}
+
+void XSECParserPool::Terminate(void) {
+
+	clear();
+
+	delete s_poolMutex;
+	s_poolMutex = NULL;
+
+	delete s_securityManager;
+	s_securityManager = NULL;
+
+}
+
+void XSECParserPool::clear(void) {
+
+	if (s_poolMutex == NULL)
+		return;
+
+	XMLMutexLock lock(s_poolMutex);
+
+	DOMParserVectorType::size_type i;
+	for (i = 0; i < s_domParsers.size(); ++i)
+		delete s_domParsers[i];
+	s_domParsers.clear();
+
+	BuilderVectorType::size_type j;
+	for (j = 0; j < s_builders.size(); ++j)
+		delete s_builders[j];
+	s_builders.clear();
+
+}
+
+void XSECParserPool::setMaxIdle(unsigned int max) {
+
+	s_maxIdle = max;
+
+}
+
+// --------------------------------------------------------------------------------
+//			DOM parsers
+// --------------------------------------------------------------------------------
+
+void XSECParserPool::applyPolicy(XercesDOMParser * parser) {
+
+	// Re-applied on every check out, so a caller that changed a setting
+	// can't leak it to the next user.
+
+	if (s_securityManager == NULL) {
+		throw XSECException(XSECException::InternalError,
+			"XSECParserPool - used before XSECPlatformUtils::Initialise()");
+	}
+
+	parser->setDoNamespaces(true);
+	parser->setLoadExternalDTD(false);
+	parser->setSecurityManager(s_securityManager);
+
+}
+
+XercesDOMParser * XSECParserPool::getDOMParser(void) {
+
+	XercesDOMParser * ret = NULL;
+
+	if (s_poolMutex != NULL) {
+
+		XMLMutexLock lock(s_poolMutex);
+		if (!s_domParsers.empty()) {
+			ret = s_domParsers.back();
+			s_domParsers.pop_back();
+		}
+
+	}
+
+	if (ret == NULL) {
+		XSECnew(ret, XercesDOMParser());
+	}
+
+	try {
+		applyPolicy(ret);
+	}
+	catch (...) {
+		delete ret;
+		throw;
+	}
+
+	return ret;
+
+}
+
+void XSECParserPool::releaseDOMParser(XercesDOMParser * parser) {
+
+	if (parser == NULL)
+		return;
+
+	// Drop anything the parser still holds (e.g. a document left
+	// behind by a failed parse)
+	parser->resetDocumentPool();
+
+	if (s_poolMutex != NULL) {
+
+		XMLMutexLock lock(s_poolMutex);
+		if (s_domParsers.size() < s_maxIdle) {
+			s_domParsers.push_back(parser);
+			return;
+		}
+
+	}
+
+	delete parser;
+
+}
+
+// --------------------------------------------------------------------------------
+//			Fragment builders
+// --------------------------------------------------------------------------------
+
+XSECDOMFragmentBuilder * XSECParserPool::getFragmentBuilder(void) {
+
+	XSECDOMFragmentBuilder * ret = NULL;
+
+	if (s_poolMutex != NULL) {
+
+		XMLMutexLock lock(s_poolMutex);
+		if (!s_builders.empty()) {
+			ret = s_builders.back();
+			s_builders.pop_back();
+		}
+
+	}
+
+	if (ret == NULL) {
+		XSECnew(ret, XSECDOMFragmentBuilder());
+	}
+
+	return ret;
+
+}
+
+void XSECParserPool::releaseFragmentBuilder(XSECDOMFragmentBuilder * builder) {
+
+	if (builder == NULL)
+		return;
+
+	if (s_poolMutex != NULL) {
+
+		XMLMutexLock lock(s_poolMutex);
+		if (s_builders.size() < s_maxIdle) {
+			s_builders.push_back(builder);
+			return;
+		}
+
+	}
+
+	delete builder;
+
+}
@@ -0,0 +1,148 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECParserPool := Pool of re-usable, pre-configured parsers
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSECPARSERPOOL_INCLUDE
+#define XSECPARSERPOOL_INCLUDE
+
+// XSEC
+#include <xsec/framework/XSECDefs.hpp>
+
+XSEC_DECLARE_XERCES_CLASS(XercesDOMParser);
+
+class XSECDOMFragmentBuilder;
+
+/**
+ * @ingroup internal
+ */
+
+/**
+ * \brief Pool of parsers used internally by the library.
+ *
+ * Whenever a byte stream has to be turned back into DOM nodes (a
+ * TXFMParser in a reference, or decrypted element content) the library
+ * used to construct a new parser and SecurityManager.  Parser setup is a
+ * significant part of the cost of parsing small documents, so this class
+ * keeps idle parsers for re-use.
+ *
+ * Parsers are checked out for the duration of a parse and returned
+ * afterwards.  The pool is protected by a mutex, so any thread may check
+ * a parser out, but a parser is only ever used by one thread at a time.
+ *
+ * Every parser handed out has the library's parse policy applied -
+ * namespaces on, no external DTD loading and entity expansion limited to
+ * XSEC_ENTITY_EXPANSION_LIMIT.
+ *
+ * Initialised and terminated by XSECPlatformUtils.
+ */
+
+class DSIG_EXPORT XSECParserPool {
+
+public:
+
+	/** @name DOM parsers */
+	//@{
+
+	/**
+	 * \brief Check out a DOM parser
+	 *
+	 * Documents should be taken from the parser using adoptDocument()
+	 * before it is returned.
+	 *
+	 * @returns A parser that must be handed back via releaseDOMParser
+	 */
+
+	static XERCES_CPP_NAMESPACE_QUALIFIER XercesDOMParser * getDOMParser(void);
+
+	/**
+	 * \brief Return a DOM parser to the pool
+	 *
+	 * @param parser Parser previously obtained from getDOMParser
+	 */
+
+	static void releaseDOMParser(XERCES_CPP_NAMESPACE_QUALIFIER XercesDOMParser * parser);
+
+	//@}
+
+	/** @name Fragment builders */
+	//@{
+
+	/**
+	 * \brief Check out a builder for parsing content into a document
+	 *
+	 * @returns A builder that must be handed back via releaseFragmentBuilder
+	 */
+
+	static XSECDOMFragmentBuilder * getFragmentBuilder(void);
+
+	/**
+	 * \brief Return a fragment builder to the pool
+	 *
+	 * @param builder Builder previously obtained from getFragmentBuilder
+	 */
+
+	static void releaseFragmentBuilder(XSECDOMFragmentBuilder * builder);
+
+	//@}
+
+	/** @name Pool management */
+	//@{
+
+	/**
+	 * \brief Set the number of idle parsers of each type kept
+	 *
+	 * Parsers returned when the pool is full are deleted.  Defaults
+	 * to 8.  Setting 0 disables pooling.
+	 *
+	 * @param max Maximum number of idle parsers to keep
+	 */
+
+	static void setMaxIdle(unsigned int max);
+
+	/**
+	 * \brief Delete all idle parsers
+	 */
+
+	static void clear(void);
+
+	//@}
+
+private:
+
+	friend class XSECPlatformUtils;
+
+	static void Initialise(void);
+	static void Terminate(void);
+
+	static void applyPolicy(XERCES_CPP_NAMESPACE_QUALIFIER XercesDOMParser * parser);
+
+	// Not instantiable
+	XSECParserPool();
+
+};
+
+#endif /* XSECPARSERPOOL_INCLUDE */
@@ -37,6 +37,9 @@
 #include <xsec/xkms/XKMSConstants.hpp>
 #include <xsec/framework/XSECAlgorithmMapper.hpp>
 #include <xsec/transformers/TXFMOutputFile.hpp>
+#include <xsec/utils/XSECParserPool.hpp>
+#include <xsec/utils/XSECHashPool.hpp>
+#include <xsec/transformers/TXFMXSL.hpp>
 
 #include "../xenc/impl/XENCCipherImpl.hpp"
 
@@ -124,6 +127,15 @@ void XSECPlatformUtils::Initialise(XSECCryptoProvider * p) {
 	// Initialise the DSIGSignature class
 	DSIGSignature::Initialise();
 
+	// Initialise the parser and hash pools
+	XSECParserPool::Initialise();
+	XSECHashPool::Initialise();
+
+#ifndef XSEC_NO_XSLT
+	// And the compiled stylesheet cache
+	TXFMXSL::Initialise();
+#endif
+
 	const char* sink = getenv("XSEC_DEBUG_FILE");
 	if (sink && *sink)
 	    g_loggingSink = TXFMOutputFileFactory;
@@ -131,6 +143,9 @@ void XSECPlatformUtils::Initialise(XSECCryptoProvider * p) {
 
 void XSECPlatformUtils::SetCryptoProvider(XSECCryptoProvider * p) {
 
+	// Pooled hashes belong to the old provider
+	XSECHashPool::clear();
+
 	if (g_cryptoProvider != NULL)
 		delete g_cryptoProvider;
 
@@ -154,6 +169,15 @@ void XSECPlatformUtils::Terminate(void) {
 	if (--initCount > 0)
 		return;
 
+#ifndef XSEC_NO_XSLT
+	// Cached stylesheets belong to Xalan, so go before anything else
+	TXFMXSL::Terminate();
+#endif
+
+	// Release pooled parsers and hashes
+	XSECParserPool::Terminate();
+	XSECHashPool::Terminate();
+
 	// Clean out the algorithm mapper
 	delete internalMapper;
 
@@ -32,6 +32,7 @@
 #include <xsec/utils/XSECSafeBuffer.hpp>
 #include <xsec/utils/XSECDOMUtils.hpp>
 #include <xsec/utils/XSECSOAPRequestorSimple.hpp>
+#include <xsec/utils/XSECParserPool.hpp>
 #include <xsec/xkms/XKMSConstants.hpp>
 
 #include "../utils/XSECAutoPtr.hpp"
@@ -218,111 +219,122 @@ char * XSECSOAPRequestorSimple::wrapAndSerialise(DOMDocument * request) {
 
 DOMDocument * XSECSOAPRequestorSimple::parseAndUnwrap(const char * buf, unsigned int len) {
 
-	XercesDOMParser parser;
-	parser.setDoNamespaces(true);
-	parser.setLoadExternalDTD(false);
+	XercesDOMParser * parser = XSECParserPool::getDOMParser();
+	DOMDocument * responseDoc;
 
-	SecurityManager securityManager;
-	securityManager.setEntityExpansionLimit(XSEC_ENTITY_EXPANSION_LIMIT);
-	parser.setSecurityManager(&securityManager);
+	try {
 
-	// Create an input source
+		// Create an input source
 
-	MemBufInputSource memIS((const XMLByte*) buf, len, "XSECMem");
+		MemBufInputSource memIS((const XMLByte*) buf, len, "XSECMem");
 
-	parser.parse(memIS);
-	xsecsize_t errorCount = parser.getErrorCount();
-    if (errorCount > 0)
-		throw XSECException(XSECException::HTTPURIInputStreamError,
-							"Error parsing response message");
+		parser->parse(memIS);
+		xsecsize_t errorCount = parser->getErrorCount();
+		if (errorCount > 0)
+			throw XSECException(XSECException::HTTPURIInputStreamError,
+								"Error parsing response message");
 
-	if (m_envelopeType == ENVELOPE_NONE) {
+		responseDoc = parser->adoptDocument();
+
+	}
+	catch (...) {
 
-		return parser.adoptDocument();
+		XSECParserPool::releaseDOMParser(parser);
+		throw;
 
 	}
 
-	DOMDocument * responseDoc = parser.getDocument();
+	XSECParserPool::releaseDOMParser(parser);
+
+	if (m_envelopeType == ENVELOPE_NONE) {
+
+		return responseDoc;
+
+	}
 
 	// Must be a SOAP message of some kind - so lets remove the wrapper.
-	// First create a new document for the Response message
+	// The message is moved up to replace the Envelope rather than being
+	// copied into a new document, so a large response is not duplicated.
 
-	XMLCh tempStr[100];
-	XMLString::transcode("Core", tempStr, 99);    
-	DOMImplementation *impl = DOMImplementationRegistry::getDOMImplementation(tempStr);
+	try {
 
-	DOMDocument * retDoc = impl->createDocument();
+		// Find the base of the response
 
-	// Find the base of the response
+		DOMNode * e = responseDoc->getDocumentElement();
 
+		e = e->getFirstChild();
 
-	DOMNode * e = responseDoc->getDocumentElement();
+		while (e != NULL && (e->getNodeType() != DOMNode::ELEMENT_NODE || !strEquals(e->getLocalName(), "Body")))
+			e = e->getNextSibling();
 
-	e = e->getFirstChild();
+		if (e == NULL)
+			throw XSECException(XSECException::HTTPURIInputStreamError,
+								"Could not find SOAP body");
 
-	while (e != NULL && (e->getNodeType() != DOMNode::ELEMENT_NODE || !strEquals(e->getLocalName(), "Body")))
-		e = e->getNextSibling();
+		e = findFirstChildOfType(e, DOMNode::ELEMENT_NODE);
 
-	if (e == NULL)
-		throw XSECException(XSECException::HTTPURIInputStreamError,
-							"Could not find SOAP body");
+		if (e == NULL)
+			throw XSECException(XSECException::HTTPURIInputStreamError,
+								"Could not find message within SOAP body");
 
-	e = findFirstChildOfType(e, DOMNode::ELEMENT_NODE);
+		/* See if this is a soap fault */
+		if (strEquals(e->getLocalName(), "Fault")) {
 
-	if (e == NULL)
-		throw XSECException(XSECException::HTTPURIInputStreamError,
-							"Could not find message within SOAP body");
+			// Something has gone wrong somewhere!
+			safeBuffer sb;
+			sb.sbTranscodeIn("SOAP Fault : ");
 
-	/* See if this is a soap fault */
-	if (strEquals(e->getLocalName(), "Fault")) {
+			// Find the fault code
 
-		// Something has gone wrong somewhere!
-		safeBuffer sb;
-		sb.sbTranscodeIn("SOAP Fault : ");
+			e = findFirstElementChild(e);
+			while (e != NULL && !strEquals(e->getLocalName(), "Code"))
+				e = findNextElementChild(e);
+			
+			if (e != NULL) {
+				DOMNode * c = findFirstElementChild(e);
+				while (c != NULL && !strEquals(c->getLocalName(), "Value"))
+					c = findNextElementChild(c);
+				if (c != NULL) {
+					DOMNode * t = findFirstChildOfType(c, DOMNode::TEXT_NODE);
+					if (t != NULL) {
+						sb.sbXMLChCat(t->getNodeValue());
+						sb.sbXMLChCat(" : ");
+					}
+				}
+			}
 
-		// Find the fault code
+			// Find the reason
+			while (e != NULL && !strEquals(e->getLocalName(), "Reason"))
+				e = findNextElementChild(e);
 
-		e = findFirstElementChild(e);
-		while (e != NULL && !strEquals(e->getLocalName(), "Code"))
-			e = findNextElementChild(e);
-		
-		if (e != NULL) {
-			DOMNode * c = findFirstElementChild(e);
-			while (c != NULL && !strEquals(c->getLocalName(), "Value"))
-				c = findNextElementChild(c);
-			if (c != NULL) {
-				DOMNode * t = findFirstChildOfType(c, DOMNode::TEXT_NODE);
+			if (e != NULL) {
+				DOMNode * t = findFirstChildOfType(e, DOMNode::TEXT_NODE);
 				if (t != NULL) {
 					sb.sbXMLChCat(t->getNodeValue());
-					sb.sbXMLChCat(" : ");
 				}
-			}
-		}
-
-		// Find the reason
-		while (e != NULL && !strEquals(e->getLocalName(), "Reason"))
-			e = findNextElementChild(e);
 
-		if (e != NULL) {
-			DOMNode * t = findFirstChildOfType(e, DOMNode::TEXT_NODE);
-			if (t != NULL) {
-				sb.sbXMLChCat(t->getNodeValue());
 			}
 
-		}
+			XSECAutoPtrChar msg(sb.rawXMLChBuffer());
 
-		retDoc->release();
+			throw XSECException(XSECException::HTTPURIInputStreamError,
+								msg.get());
+		}
 
-		XSECAutoPtrChar msg(sb.rawXMLChBuffer());
+		DOMNode * envelope = responseDoc->getDocumentElement();
+		e->getParentNode()->removeChild(e);
+		responseDoc->replaceChild(e, envelope);
+		envelope->release();
 
-		throw XSECException(XSECException::HTTPURIInputStreamError,
-							msg.get());
 	}
+	catch (...) {
 
+		responseDoc->release();
+		throw;
 
-	retDoc->appendChild(retDoc->importNode(e, true));
+	}
 
-	return retDoc;
+	return responseDoc;
 
 }
 
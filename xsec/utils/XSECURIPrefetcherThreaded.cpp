@@ -0,0 +1,581 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * XSEC
+ *
+ * XSECURIPrefetcherThreaded := URI prefetcher that fetches on a bounded
+ *                              set of worker threads
+ *
+ * $Id$
+ */
+
+#include <xsec/utils/XSECURIPrefetcherThreaded.hpp>
+#include <xsec/utils/XSECBinMappedFileInputStream.hpp>
+#include <xsec/framework/XSECURIResolver.hpp>
+#include <xsec/framework/XSECError.hpp>
+
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/Janitor.hpp>
+
+#if defined(_WIN32)
+#	include <windows.h>
+#else
+#	include <pthread.h>
+#endif
+
+#include <string.h>
+
+#include <vector>
+#include <deque>
+
+XERCES_CPP_NAMESPACE_USE
+
+#define XSEC_PREFETCH_CHUNK		16384
+
+// ---------------------------------------------------------------------------
+//  Lock and condition
+// ---------------------------------------------------------------------------
+
+// XMLMutex has no condition variable, so the prefetcher carries its own.
+// One condition is shared by everything waiting on the prefetcher - there
+// are only ever a handful of waiters.
+
+class PrefetchMonitor {
+
+public:
+
+	PrefetchMonitor() {
+#if defined(_WIN32)
+		InitializeCriticalSection(&m_cs);
+		InitializeConditionVariable(&m_cv);
+#else
+		pthread_mutex_init(&m_mutex, NULL);
+		pthread_cond_init(&m_cond, NULL);
+#endif
+	}
+
+	~PrefetchMonitor() {
+#if defined(_WIN32)
+		DeleteCriticalSection(&m_cs);
+#else
+		pthread_cond_destroy(&m_cond);
+		pthread_mutex_destroy(&m_mutex);
+#endif
+	}
+
+	void lock(void) {
+#if defined(_WIN32)
+		EnterCriticalSection(&m_cs);
+#else
+		pthread_mutex_lock(&m_mutex);
+#endif
+	}
+
+	void unlock(void) {
+#if defined(_WIN32)
+		LeaveCriticalSection(&m_cs);
+#else
+		pthread_mutex_unlock(&m_mutex);
+#endif
+	}
+
+	// Must be called with the lock held
+	void wait(void) {
+#if defined(_WIN32)
+		SleepConditionVariableCS(&m_cv, &m_cs, INFINITE);
+#else
+		pthread_cond_wait(&m_cond, &m_mutex);
+#endif
+	}
+
+	void notifyAll(void) {
+#if defined(_WIN32)
+		WakeAllConditionVariable(&m_cv);
+#else
+		pthread_cond_broadcast(&m_cond);
+#endif
+	}
+
+private:
+
+#if defined(_WIN32)
+	CRITICAL_SECTION		m_cs;
+	CONDITION_VARIABLE		m_cv;
+#else
+	pthread_mutex_t			m_mutex;
+	pthread_cond_t			m_cond;
+#endif
+
+};
+
+class PrefetchLock {
+
+public:
+
+	PrefetchLock(PrefetchMonitor & monitor) : m_monitor(monitor) {m_monitor.lock();}
+	~PrefetchLock() {m_monitor.unlock();}
+
+private:
+
+	PrefetchMonitor			& m_monitor;
+
+	PrefetchLock(const PrefetchLock &);
+	PrefetchLock & operator = (const PrefetchLock &);
+
+};
+
+// ---------------------------------------------------------------------------
+//  State
+// ---------------------------------------------------------------------------
+
+struct PrefetchEntry {
+
+	enum State {
+		QUEUED,			// Waiting for a worker
+		OPENING,		// Worker is resolving the URI
+		DECLINED,		// Resolver can map it - left to the library
+		FAILED,			// Could not be opened
+		STREAMING,		// Data arriving
+		COMPLETE,		// All data in the buffer
+		ABORTED			// Read failed or fetch abandoned
+	};
+
+	XMLCh					* mp_uri;
+	XSECURIResolver			* mp_resolver;
+	State					m_state;
+	bool					m_abandoned;	// Nobody will read the data
+	unsigned int			m_refs;			// Prefetcher list, worker and stream
+	std::vector<XMLByte>	m_data;
+	xsecsize_t				m_readPos;
+
+};
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef vector<PrefetchEntry *>			PrefetchEntryVectorType;
+typedef deque<PrefetchEntry *>			PrefetchEntryQueueType;
+#else
+typedef std::vector<PrefetchEntry *>	PrefetchEntryVectorType;
+typedef std::deque<PrefetchEntry *>		PrefetchEntryQueueType;
+#endif
+
+struct XSECURIPrefetchState {
+
+	PrefetchMonitor			m_monitor;
+	PrefetchEntryVectorType	m_entries;		// Not yet claimed
+	PrefetchEntryQueueType	m_queue;		// Not yet started
+	unsigned int			m_maxInFlight;
+	unsigned int			m_running;		// Worker threads alive
+	xsecsize_t				m_bufferLimit;
+	bool					m_shutdown;
+
+};
+
+// Called with the lock held
+static void releaseEntry(PrefetchEntry * entry) {
+
+	if (--entry->m_refs > 0)
+		return;
+
+	if (entry->mp_uri != NULL)
+		XSEC_RELEASE_XMLCH(entry->mp_uri);
+	if (entry->mp_resolver != NULL)
+		delete entry->mp_resolver;
+
+	delete entry;
+
+}
+
+// ---------------------------------------------------------------------------
+//  Stream handed to the consumer
+// ---------------------------------------------------------------------------
+
+class PrefetchedInputStream : public BinInputStream {
+
+public:
+
+	PrefetchedInputStream(XSECURIPrefetchState * state, PrefetchEntry * entry) :
+		mp_state(state), mp_entry(entry), m_pos(0) {}
+
+	virtual ~PrefetchedInputStream() {
+
+		PrefetchLock lock(mp_state->m_monitor);
+
+		// Lets a worker blocked on a full buffer give up
+		mp_entry->m_abandoned = true;
+		mp_state->m_monitor.notifyAll();
+		releaseEntry(mp_entry);
+
+	}
+
+#ifdef XSEC_XERCES_64BITSAFE
+	virtual XMLFilePos curPos() const {return m_pos;}
+#else
+	virtual unsigned int curPos() const {return (unsigned int) m_pos;}
+#endif
+
+	virtual xsecsize_t readBytes(XMLByte* const toFill, const xsecsize_t maxToRead) {
+
+		PrefetchLock lock(mp_state->m_monitor);
+
+		PrefetchEntry * e = mp_entry;
+		while (e->m_state == PrefetchEntry::STREAMING && (xsecsize_t) e->m_data.size() == e->m_readPos)
+			mp_state->m_monitor.wait();
+
+		xsecsize_t avail = (xsecsize_t) e->m_data.size() - e->m_readPos;
+
+		if (avail == 0) {
+
+			if (e->m_state == PrefetchEntry::ABORTED) {
+				throw XSECException(XSECException::ErrorOpeningURI,
+					"XSECURIPrefetcherThreaded - error reading prefetched URI");
+			}
+
+			return 0;
+
+		}
+
+		xsecsize_t n = (avail < maxToRead ? avail : maxToRead);
+		memcpy(toFill, &e->m_data[e->m_readPos], n);
+		e->m_readPos += n;
+		m_pos += n;
+
+		// Reclaim the space that has been read
+		if (e->m_readPos == (xsecsize_t) e->m_data.size()) {
+			e->m_data.clear();
+			e->m_readPos = 0;
+		}
+		else if (e->m_readPos >= mp_state->m_bufferLimit) {
+			e->m_data.erase(e->m_data.begin(), e->m_data.begin() + e->m_readPos);
+			e->m_readPos = 0;
+		}
+
+		mp_state->m_monitor.notifyAll();
+
+		return n;
+
+	}
+
+#ifdef XSEC_XERCES_INPUTSTREAM_HAS_CONTENTTYPE
+	virtual const XMLCh* getContentType() const {return NULL;}
+#endif
+
+private:
+
+	XSECURIPrefetchState	* mp_state;
+	PrefetchEntry			* mp_entry;
+	xsecsize_t				m_pos;
+
+};
+
+// ---------------------------------------------------------------------------
+//  Workers
+// ---------------------------------------------------------------------------
+
+static void fetchEntry(XSECURIPrefetchState * state, PrefetchEntry * entry) {
+
+	BinInputStream * is = NULL;
+	PrefetchEntry::State opened = PrefetchEntry::FAILED;
+
+	// Resolvers are only ever used by one thread - each entry has its own clone
+	try {
+		XSECBinMappedFileInputStream * m = entry->mp_resolver->resolveURIMapped(entry->mp_uri);
+		if (m != NULL && m->isMapped()) {
+			delete m;
+			opened = PrefetchEntry::DECLINED;
+		}
+		else if (m != NULL) {
+			// Local but not mappable - read the stream already opened
+			is = m;
+			opened = PrefetchEntry::STREAMING;
+		}
+		else {
+			is = entry->mp_resolver->resolveURI(entry->mp_uri);
+			if (is != NULL)
+				opened = PrefetchEntry::STREAMING;
+		}
+	}
+	catch (...) {
+	}
+
+	{
+		PrefetchLock lock(state->m_monitor);
+		entry->m_state = opened;
+		state->m_monitor.notifyAll();
+	}
+
+	if (is == NULL)
+		return;
+
+	Janitor<BinInputStream> j_is(is);
+	XMLByte buf[XSEC_PREFETCH_CHUNK];
+
+	for (;;) {
+
+		xsecsize_t n = 0;
+		bool failed = false;
+
+		try {
+			n = is->readBytes(buf, XSEC_PREFETCH_CHUNK);
+		}
+		catch (...) {
+			failed = true;
+		}
+
+		PrefetchLock lock(state->m_monitor);
+
+		while (!failed && n > 0 && !entry->m_abandoned && !state->m_shutdown &&
+			(xsecsize_t) entry->m_data.size() - entry->m_readPos >= state->m_bufferLimit)
+			state->m_monitor.wait();
+
+		if (failed || entry->m_abandoned || state->m_shutdown) {
+			entry->m_state = PrefetchEntry::ABORTED;
+			state->m_monitor.notifyAll();
+			return;
+		}
+
+		if (n == 0) {
+			entry->m_state = PrefetchEntry::COMPLETE;
+			state->m_monitor.notifyAll();
+			return;
+		}
+
+		entry->m_data.insert(entry->m_data.end(), buf, buf + n);
+		state->m_monitor.notifyAll();
+
+	}
+
+}
+
+static void runWorker(XSECURIPrefetchState * state) {
+
+	state->m_monitor.lock();
+
+	while (!state->m_shutdown && !state->m_queue.empty()) {
+
+		PrefetchEntry * entry = state->m_queue.front();
+		state->m_queue.pop_front();
+		entry->m_state = PrefetchEntry::OPENING;
+		entry->m_refs++;
+
+		state->m_monitor.unlock();
+
+		try {
+			fetchEntry(state, entry);
+		}
+		catch (...) {
+			// Only allocation failures get here - the consumer sees a
+			// truncated fetch as an error
+			PrefetchLock lock(state->m_monitor);
+			if (entry->m_state == PrefetchEntry::OPENING)
+				entry->m_state = PrefetchEntry::FAILED;
+			else
+				entry->m_state = PrefetchEntry::ABORTED;
+			state->m_monitor.notifyAll();
+		}
+
+		state->m_monitor.lock();
+		releaseEntry(entry);
+
+	}
+
+	// The destructor may delete the state as soon as it is unlocked
+	state->m_running--;
+	state->m_monitor.notifyAll();
+	state->m_monitor.unlock();
+
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI prefetchThread(LPVOID arg) {
+	runWorker((XSECURIPrefetchState *) arg);
+	return 0;
+}
+#else
+extern "C" {
+	static void * prefetchThread(void * arg) {
+		runWorker((XSECURIPrefetchState *) arg);
+		return NULL;
+	}
+}
+#endif
+
+// Called with the lock held
+static bool startWorker(XSECURIPrefetchState * state) {
+
+#if defined(_WIN32)
+	HANDLE h = CreateThread(NULL, 0, prefetchThread, (LPVOID) state, 0, NULL);
+	if (h == NULL)
+		return false;
+	CloseHandle(h);
+#else
+	pthread_t t;
+	if (pthread_create(&t, NULL, prefetchThread, (void *) state) != 0)
+		return false;
+	pthread_detach(t);
+#endif
+
+	return true;
+
+}
+
+// ---------------------------------------------------------------------------
+//  Constructors/Destructors
+// ---------------------------------------------------------------------------
+
+XSECURIPrefetcherThreaded::XSECURIPrefetcherThreaded(unsigned int maxInFlight,
+													 xsecsize_t bufferLimit) {
+
+	XSECnew(mp_state, XSECURIPrefetchState);
+	mp_state->m_maxInFlight = (maxInFlight > 0 ? maxInFlight : 1);
+	mp_state->m_running = 0;
+	mp_state->m_bufferLimit = (bufferLimit > 0 ? bufferLimit : XSEC_PREFETCH_CHUNK);
+	mp_state->m_shutdown = false;
+
+}
+
+XSECURIPrefetcherThreaded::~XSECURIPrefetcherThreaded() {
+
+	{
+		PrefetchLock lock(mp_state->m_monitor);
+
+		mp_state->m_shutdown = true;
+		mp_state->m_queue.clear();
+		mp_state->m_monitor.notifyAll();
+
+		while (mp_state->m_running > 0)
+			mp_state->m_monitor.wait();
+
+		PrefetchEntryVectorType::size_type i;
+		for (i = 0; i < mp_state->m_entries.size(); ++i)
+			releaseEntry(mp_state->m_entries[i]);
+		mp_state->m_entries.clear();
+	}
+
+	delete mp_state;
+
+}
+
+// ---------------------------------------------------------------------------
+//  Interface
+// ---------------------------------------------------------------------------
+
+void XSECURIPrefetcherThreaded::prefetchURI(const XMLCh * uri, XSECURIResolver * resolver) {
+
+	if (uri == NULL || resolver == NULL)
+		return;
+
+	PrefetchLock lock(mp_state->m_monitor);
+
+	if (mp_state->m_shutdown)
+		return;
+
+	PrefetchEntryVectorType::size_type i;
+	for (i = 0; i < mp_state->m_entries.size(); ++i) {
+		if (XMLString::equals(mp_state->m_entries[i]->mp_uri, uri))
+			return;
+	}
+
+	PrefetchEntry * entry;
+	XSECnew(entry, PrefetchEntry);
+	entry->mp_uri = NULL;
+	entry->mp_resolver = NULL;
+	entry->m_state = PrefetchEntry::QUEUED;
+	entry->m_abandoned = false;
+	entry->m_refs = 1;
+	entry->m_readPos = 0;
+
+	try {
+		entry->mp_uri = XMLString::replicate(uri);
+		entry->mp_resolver = resolver->clone();
+		mp_state->m_entries.push_back(entry);
+	}
+	catch (...) {
+		releaseEntry(entry);
+		throw;
+	}
+
+	mp_state->m_queue.push_back(entry);
+
+	// If no thread can be started the URI stays queued, and is resolved
+	// by the library when claimed
+	if (mp_state->m_running < mp_state->m_maxInFlight && startWorker(mp_state))
+		mp_state->m_running++;
+
+}
+
+BinInputStream * XSECURIPrefetcherThreaded::claimURI(const XMLCh * uri) {
+
+	if (uri == NULL)
+		return NULL;
+
+	PrefetchLock lock(mp_state->m_monitor);
+
+	PrefetchEntry * entry = NULL;
+	PrefetchEntryVectorType::iterator it;
+	for (it = mp_state->m_entries.begin(); it != mp_state->m_entries.end(); ++it) {
+		if (XMLString::equals((*it)->mp_uri, uri)) {
+			entry = *it;
+			mp_state->m_entries.erase(it);
+			break;
+		}
+	}
+
+	if (entry == NULL)
+		return NULL;
+
+	if (entry->m_state == PrefetchEntry::QUEUED) {
+
+		// Not started - quicker to let the caller open it than to wait
+		PrefetchEntryQueueType::iterator q;
+		for (q = mp_state->m_queue.begin(); q != mp_state->m_queue.end(); ++q) {
+			if (*q == entry) {
+				mp_state->m_queue.erase(q);
+				break;
+			}
+		}
+
+		releaseEntry(entry);
+		return NULL;
+
+	}
+
+	while (entry->m_state == PrefetchEntry::OPENING)
+		mp_state->m_monitor.wait();
+
+	if (entry->m_state == PrefetchEntry::DECLINED || entry->m_state == PrefetchEntry::FAILED) {
+		releaseEntry(entry);
+		return NULL;
+	}
+
+	// The stream takes over the list's reference
+	PrefetchedInputStream * ret;
+	try {
+		XSECnew(ret, PrefetchedInputStream(mp_state, entry));
+	}
+	catch (...) {
+		entry->m_abandoned = true;
+		mp_state->m_monitor.notifyAll();
+		releaseEntry(entry);
+		throw;
+	}
+
+	return ret;
+
+}
@@ -0,0 +1,115 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * XSEC
+ *
+ * XSECURIPrefetcherThreaded := URI prefetcher that fetches on a bounded
+ *                              set of worker threads
+ *
+ * $Id$
+ */
+
+#ifndef XSECURIPREFETCHERTHREADED_INCLUDE
+#define XSECURIPREFETCHERTHREADED_INCLUDE
+
+#include <xsec/framework/XSECDefs.hpp>
+#include <xsec/framework/XSECURIPrefetcher.hpp>
+
+struct XSECURIPrefetchState;
+
+/**
+ * @ingroup pubsig
+ */
+/*\@{*/
+
+/**
+ * @brief Prefetch external URIs on worker threads.
+ *
+ * Each URI handed to prefetchURI() is queued and fetched through a
+ * clone of the signature's resolver on one of at most maxInFlight
+ * worker threads.  Workers are started as URIs are queued and exit
+ * when the queue is empty.
+ *
+ * Fetched data is buffered per URI up to a limit.  Once the limit is
+ * reached the worker waits until the consumer has read some of the
+ * buffer, so a large document is streamed rather than held in memory.
+ *
+ * URIs the resolver can memory map (see
+ * XSECURIResolver::resolveURIMapped) are not fetched - claimURI()
+ * returns NULL for them and the library maps them itself.  A URI whose
+ * fetch has not yet started when it is claimed is also left to the
+ * library, as is one that could not be opened (so the error is
+ * reported exactly as it would be without a prefetcher).
+ *
+ * One prefetcher may be shared by several signatures.  It is not
+ * cloned when registered, and must outlive every stream returned by
+ * claimURI().
+ */
+
+class DSIG_EXPORT XSECURIPrefetcherThreaded : public XSECURIPrefetcher {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	/**
+	 * \brief Constructor
+	 *
+	 * @param maxInFlight Maximum number of URIs fetched at once
+	 * @param bufferLimit Number of bytes buffered per URI before the
+	 * worker waits for the consumer
+	 */
+
+	XSECURIPrefetcherThreaded(unsigned int maxInFlight = 4,
+		xsecsize_t bufferLimit = 262144);
+
+	/**
+	 * \brief Destructor
+	 *
+	 * Abandons any fetches still queued or in progress and waits for
+	 * the worker threads to finish.
+	 */
+
+	virtual ~XSECURIPrefetcherThreaded();
+
+	//@}
+
+	/** @name Interface Methods */
+	//@{
+
+	virtual void prefetchURI(const XMLCh * uri, XSECURIResolver * resolver);
+
+	virtual XERCES_CPP_NAMESPACE_QUALIFIER BinInputStream *
+		claimURI(const XMLCh * uri);
+
+	//@}
+
+private:
+
+	XSECURIPrefetchState		* mp_state;
+
+	// Unimplemented
+	XSECURIPrefetcherThreaded(const XSECURIPrefetcherThreaded &);
+	XSECURIPrefetcherThreaded & operator = (const XSECURIPrefetcherThreaded &);
+
+};
+
+
+#endif /* XSECURIPREFETCHERTHREADED_INCLUDE */
@@ -44,33 +44,40 @@ XSECXPathNodeList::XSECXPathNodeList(unsigned int initialSize) {
 
 	m_num = 0;
 	mp_tree = NULL;
+	mp_refs = NULL;
+	mp_current = NULL;
 
 }
 
 XSECXPathNodeList::XSECXPathNodeList(const XSECXPathNodeList &other) {
 
-	m_num = other.m_num;
-	mp_tree = copy_tree(other.mp_tree);
+	m_num = 0;
+	mp_tree = NULL;
+	mp_refs = NULL;
 	mp_current = NULL;
 
+	share(other);
+
 }
 
 XSECXPathNodeList::~XSECXPathNodeList() {
 
-	// Delete all the elements in the node list
-	delete_tree(mp_tree);
+	// Delete all the elements in the node list (if we are the last user)
+	release();
 
 }
 
 XSECXPathNodeList & XSECXPathNodeList::operator= (const XSECXPathNodeList & toCopy) {
 
-	// For now simply delete the old list and set with the new
-	// Large overhead as we call other functions, but simplest way to
-	// implement for now
+	// Pick up a reference to the other tree.  The copy is only made
+	// if (and when) one of the lists is modified.
+
+	if (toCopy.mp_tree == mp_tree)
+		return *this;
+
+	release();
+	share(toCopy);
 
-	mp_tree = copy_tree(toCopy.mp_tree);
-	m_num = toCopy.m_num;
-	mp_current = NULL;
 	return *this;
 
 }
@@ -144,6 +151,7 @@ XSECXPathNodeList::btn * XSECXPathNodeList::copy_tree(btn * t) const {
 			c->l = NULL;
 			c->r = NULL;
 			c->v = n->v;
+			c->h = n->h;
 
 			// R we at top?
 			if (ret == NULL) {
@@ -188,6 +196,68 @@ XSECXPathNodeList::btn * XSECXPathNodeList::copy_tree(btn * t) const {
 	return ret;
 }
 
+// --------------------------------------------------------------------------------
+//           Sharing trees between lists.
+// --------------------------------------------------------------------------------
+
+void XSECXPathNodeList::share(const XSECXPathNodeList & other) {
+
+	// Assumes we hold nothing
+
+	if (other.mp_tree == NULL)
+		return;
+
+	// The count is only created once a tree is actually shared
+	if (other.mp_refs == NULL) {
+		XSECnew(other.mp_refs, unsigned int);
+		*(other.mp_refs) = 1;
+	}
+
+	mp_tree = other.mp_tree;
+	mp_refs = other.mp_refs;
+	m_num = other.m_num;
+	++(*mp_refs);
+
+}
+
+void XSECXPathNodeList::release(void) {
+
+	if (mp_refs != NULL && --(*mp_refs) > 0) {
+		// Someone else still has the tree
+	}
+	else {
+		delete_tree(mp_tree);
+		delete mp_refs;
+	}
+
+	mp_tree = NULL;
+	mp_refs = NULL;
+	mp_current = NULL;
+	m_num = 0;
+
+}
+
+void XSECXPathNodeList::unshare(void) {
+
+	if (mp_refs == NULL)
+		return;
+
+	if (*mp_refs == 1) {
+		// Everyone else has gone - the tree is ours again
+		delete mp_refs;
+		mp_refs = NULL;
+		return;
+	}
+
+	// Take a private copy to modify
+	btn * t = copy_tree(mp_tree);
+	--(*mp_refs);
+	mp_refs = NULL;
+	mp_tree = t;
+	mp_current = NULL;
+
+}
+
 
 // --------------------------------------------------------------------------------
 //           Adding and Deleting Nodes.
@@ -301,6 +371,13 @@ void XSECXPathNodeList::addNode(const DOMNode *n) {
 
 	btn * v;
 
+	if (mp_refs != NULL) {
+		// Don't take a copy of a shared tree for a node it already holds
+		if (findNodeIndex(n) != NULL)
+			return;
+		unshare();
+	}
+
 	if (m_num == 0) {
 		XSECnew(mp_tree, btn);
 		mp_tree->l = mp_tree->r = NULL;
@@ -409,6 +486,11 @@ void XSECXPathNodeList::removeNode(const DOMNode *n) {
 		// Not found!
 		return;
 
+	if (mp_refs != NULL) {
+		unshare();
+		i = findNodeIndex(n);
+	}
+
 	// Delete from tree
 	if (i == mp_tree) {
 		// Bugger - we are at the top of the tree
@@ -621,9 +703,7 @@ void XSECXPathNodeList::removeNode(const DOMNode *n) {
 
 void XSECXPathNodeList::clear() {
 
-	m_num = 0;
-	delete_tree(mp_tree);
-	mp_tree = NULL;
+	release();
 
 }
 
@@ -694,6 +774,10 @@ const DOMNode *XSECXPathNodeList::getNextNode(void) const {
 
 void XSECXPathNodeList::intersect(const XSECXPathNodeList &toIntersect) {
 
+	// Intersecting with ourselves (or a list sharing our tree) is a no-op
+	if (toIntersect.mp_tree == mp_tree)
+		return;
+
 	// Create a new list
 	XSECXPathNodeList ret;
 
@@ -707,11 +791,15 @@ void XSECXPathNodeList::intersect(const XSECXPathNodeList &toIntersect) {
 
 	}
 
-	// Swap lists
+	// Swap lists - ret releases our old tree (or our share of it)
 	btn * t = mp_tree;
+	unsigned int * r = mp_refs;
 	mp_tree = ret.mp_tree;
-	ret.mp_tree = t;
+	mp_refs = ret.mp_refs;
 	m_num = ret.m_num;
+	ret.mp_tree = t;
+	ret.mp_refs = r;
+	mp_current = NULL;
 
 	return;
 
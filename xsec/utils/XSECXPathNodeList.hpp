@@ -56,6 +56,11 @@ XSEC_DECLARE_XERCES_CLASS(DOMNode)
  * potential to become a real bottleneck.  It could potentially be implemented
  * as a hash list based on names of nodes (or even pointers).
  *
+ * Copies share the underlying tree, so handing a node-set from one
+ * transform to the next is cheap.  The tree is only copied when a list
+ * that shares it is modified.  The sharing is not locked, so lists
+ * copied from one another must not be used from different threads.
+ *
  */
 
 class DSIG_EXPORT XSECXPathNodeList {
@@ -70,9 +75,8 @@ public:
 	/**
 	 * \brief Copy Constructor
 	 *
-	 * @note The XSEC Library generally passes NodeLists around as pointers.
-	 * There is a LARGE overhead associated with re-creating lists, so we
-	 * try to avoid doing it unless necessary.
+	 * The new list shares the nodes of the original until either
+	 * of them is modified.
 	 */
 
 	XSECXPathNodeList(const XSECXPathNodeList &other);
@@ -82,11 +86,8 @@ public:
 	/**
 	 * \brief Assignment Operator.
 	 *
-	 * Set one node list equal to another.
-	 *
-	 * @note Do not do this frequently, particularly for large lists
-	 * as it will replicate the entire list and is a fairly expensive
-	 * operation
+	 * Set one node list equal to another.  As for the copy constructor
+	 * the nodes are shared rather than copied.
 	 *
 	 * @param toCopy The list to be copied from
 	 */
@@ -198,8 +199,12 @@ private:
 	void rotate_left(btn * t);
 	void rotate_right(btn * t);
 	long calc_height(btn * t);
+	void share(const XSECXPathNodeList & other);
+	void release(void);
+	void unshare(void);
 
 	btn								* mp_tree;			// The tree
+	mutable unsigned int			* mp_refs;			// Lists sharing mp_tree (NULL if only us)
 	unsigned int					m_num;				// Number of elements in the tree
 
 	mutable btn						* mp_current;		// current point in list for getNextNode
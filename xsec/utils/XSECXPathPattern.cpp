@@ -0,0 +1,542 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECXPathPattern := Recogniser and native evaluator for the handful of
+ *                     XPath expressions commonly found in signatures
+ *
+ * $Id$
+ *
+ */
+
+// XSEC
+
+#include <xsec/utils/XSECXPathPattern.hpp>
+#include <xsec/utils/XSECDOMUtils.hpp>
+#include <xsec/dsig/DSIGConstants.hpp>
+#include <xsec/framework/XSECError.hpp>
+
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+
+#include <string.h>
+
+XERCES_CPP_NAMESPACE_USE
+
+// --------------------------------------------------------------------------------
+//           Local helpers
+// --------------------------------------------------------------------------------
+
+static bool matchToken(const char * &p, const char * tok) {
+
+	size_t len = strlen(tok);
+
+	if (strncmp(p, tok, len) != 0)
+		return false;
+
+	p += len;
+	return true;
+
+}
+
+static bool isNameChar(unsigned char c) {
+
+	return ((c >= 'a' && c <= 'z') ||
+			(c >= 'A' && c <= 'Z') ||
+			(c >= '0' && c <= '9') ||
+			c == '_' || c == '-' || c == '.' ||
+			c >= 0x80);
+
+}
+
+static bool isXMLSpace(char c) {
+
+	return (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+
+}
+
+// --------------------------------------------------------------------------------
+//           Constructors and Destructors
+// --------------------------------------------------------------------------------
+
+XSECXPathPattern::XSECXPathPattern() {
+
+	m_type = PATTERN_UNKNOWN;
+	m_hasURI = false;
+
+}
+
+XSECXPathPattern::~XSECXPathPattern() {}
+
+// --------------------------------------------------------------------------------
+//           Compilation
+// --------------------------------------------------------------------------------
+
+bool XSECXPathPattern::parseQName(const char * &p, safeBuffer &qname) const {
+
+	const char * start = p;
+	bool colon = false;
+
+	while (isNameChar((unsigned char) *p) || (*p == ':' && !colon && p[1] != ':')) {
+		if (*p == ':')
+			colon = true;
+		++p;
+	}
+
+	if (p == start || p[-1] == ':')
+		return false;
+
+	qname.sbStrncpyIn(start, (xsecsize_t) (p - start));
+	return true;
+
+}
+
+bool XSECXPathPattern::resolveQName(safeBuffer &qname, DOMDocument * doc, DOMNamedNodeMap * nsMap) {
+
+	const char * q = qname.rawCharBuffer();
+	const char * colon = strchr(q, ':');
+
+	m_localName.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+
+	if (colon == NULL) {
+
+		// No prefix means no namespace in XPath 1.0
+		m_localName.sbXMLChCat8(q);
+		m_hasURI = false;
+		return true;
+
+	}
+
+	m_localName.sbXMLChCat8(colon + 1);
+
+	safeBuffer prefix;
+	prefix.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+	safeBuffer prefixUTF8;
+	prefixUTF8.sbStrncpyIn(q, (xsecsize_t) (colon - q));
+	prefix.sbXMLChCat8(prefixUTF8.rawCharBuffer());
+
+	// Same order as the Xalan path - the document element wins, then
+	// whatever was declared on the XPath element
+
+	const XMLCh * uri = NULL;
+	DOMElement * de = (doc != NULL ? doc->getDocumentElement() : NULL);
+
+	if (de != NULL) {
+		DOMAttr * a = de->getAttributeNodeNS(DSIGConstants::s_unicodeStrURIXMLNS,
+			prefix.rawXMLChBuffer());
+		if (a != NULL)
+			uri = a->getNodeValue();
+	}
+
+	if (uri == NULL && nsMap != NULL) {
+		DOMNode * a = nsMap->getNamedItemNS(DSIGConstants::s_unicodeStrURIXMLNS,
+			prefix.rawXMLChBuffer());
+		if (a != NULL)
+			uri = a->getNodeValue();
+	}
+
+	if (uri == NULL)
+		return false;
+
+	m_URI.sbXMLChIn(uri);
+	m_hasURI = true;
+	return true;
+
+}
+
+bool XSECXPathPattern::compile(const char * expr, DOMDocument * doc, DOMNamedNodeMap * nsMap) {
+
+	m_type = PATTERN_UNKNOWN;
+
+	if (expr == NULL)
+		return false;
+
+	// Remove white space outside of literals so that line breaks and
+	// indentation in the signature do not matter
+
+	safeBuffer sb;
+	xsecsize_t j = 0;
+	char quote = 0;
+
+	for (const char * c = expr; *c != '\0'; ++c) {
+
+		if (quote != 0) {
+			if (*c == quote)
+				quote = 0;
+		}
+		else if (*c == '"' || *c == '\'')
+			quote = *c;
+		else if (isXMLSpace(*c))
+			continue;
+
+		sb[j++] = (unsigned char) *c;
+
+	}
+
+	sb[j] = '\0';
+	sb.setBufferType(safeBuffer::BUFFER_CHAR);
+
+	if (quote != 0)
+		return false;
+
+	const char * p = sb.rawCharBuffer();
+	safeBuffer q1, q2, q3;
+
+	if (strcmp(p, "/") == 0) {
+
+		m_type = PATTERN_ROOT;
+		return true;
+
+	}
+
+	if (strcmp(p, "self::text()") == 0) {
+
+		m_type = PATTERN_SELF_TEXT;
+		return true;
+
+	}
+
+	if (matchToken(p, "id(")) {
+
+		quote = *p;
+		if (quote != '"' && quote != '\'')
+			return false;
+
+		const char * end = strchr(p + 1, quote);
+		if (end == NULL || strcmp(end + 1, ")") != 0)
+			return false;
+
+		m_ids.sbStrncpyIn(p + 1, (xsecsize_t) (end - p - 1));
+		m_type = PATTERN_ID;
+		return true;
+
+	}
+
+	if (matchToken(p, "not(ancestor-or-self::")) {
+
+		if (!parseQName(p, q1) || strcmp(p, ")") != 0)
+			return false;
+
+		if (!resolveQName(q1, doc, nsMap))
+			return false;
+
+		m_type = PATTERN_NOT_ANCESTOR_OR_SELF;
+		return true;
+
+	}
+
+	if (matchToken(p, "here()/ancestor::")) {
+
+		if (!parseQName(p, q1) || strcmp(p, "[1]") != 0)
+			return false;
+
+		if (!resolveQName(q1, doc, nsMap))
+			return false;
+
+		m_type = PATTERN_HERE_ANCESTOR;
+		return true;
+
+	}
+
+	if (matchToken(p, "count(ancestor-or-self::")) {
+
+		// The enveloped signature expression from the XMLDSig spec
+		if (!parseQName(p, q1) ||
+			!matchToken(p, "|here()/ancestor::") ||
+			!parseQName(p, q2) ||
+			!matchToken(p, "[1])>count(ancestor-or-self::") ||
+			!parseQName(p, q3) ||
+			strcmp(p, ")") != 0)
+			return false;
+
+		if (q1.sbStrcmp(q2) != 0 || q1.sbStrcmp(q3) != 0)
+			return false;
+
+		if (!resolveQName(q1, doc, nsMap))
+			return false;
+
+		m_type = PATTERN_NOT_HERE_ANCESTOR;
+		return true;
+
+	}
+
+	return false;
+
+}
+
+bool XSECXPathPattern::isPredicate(void) const {
+
+	return (m_type == PATTERN_NOT_ANCESTOR_OR_SELF ||
+			m_type == PATTERN_NOT_HERE_ANCESTOR ||
+			m_type == PATTERN_SELF_TEXT);
+
+}
+
+// --------------------------------------------------------------------------------
+//           Evaluation helpers
+// --------------------------------------------------------------------------------
+
+bool XSECXPathPattern::nameMatches(const DOMNode * n) const {
+
+	if (n == NULL || n->getNodeType() != DOMNode::ELEMENT_NODE)
+		return false;
+
+	if (!strEquals(n->getLocalName(), m_localName.rawXMLChBuffer()))
+		return false;
+
+	const XMLCh * ns = n->getNamespaceURI();
+
+	if (m_hasURI)
+		return strEquals(ns, m_URI.rawXMLChBuffer());
+
+	return (ns == NULL || ns[0] == chNull);
+
+}
+
+bool XSECXPathPattern::isExcluded(const DOMNode * n, const DOMNode * hereAncestor) const {
+
+	switch (m_type) {
+
+	case PATTERN_NOT_ANCESTOR_OR_SELF :
+
+		return nameMatches(n);
+
+	case PATTERN_NOT_HERE_ANCESTOR :
+
+		return (n == hereAncestor);
+
+	default :
+
+		return false;
+
+	}
+
+}
+
+DOMNode * XSECXPathPattern::findHereAncestor(DOMNode * here) const {
+
+	DOMNode * p = (here != NULL ? here->getParentNode() : NULL);
+
+	while (p != NULL && !nameMatches(p))
+		p = p->getParentNode();
+
+	return p;
+
+}
+
+void XSECXPathPattern::addAncestorNSNodes(DOMNode * n,
+										  const XSECXPathNodeList * inputList,
+										  XSECXPathNodeList & lst) {
+
+	while (n != NULL) {
+
+		if (n->getNodeType() == DOMNode::ELEMENT_NODE) {
+
+			DOMNamedNodeMap * atts = n->getAttributes();
+			XMLSize_t sz = (atts != NULL ? atts->getLength() : 0);
+
+			for (XMLSize_t i = 0; i < sz; ++i) {
+
+				DOMNode * a = atts->item(i);
+				const XMLCh * name = a->getNodeName();
+
+				if (XMLString::compareNString(name, DSIGConstants::s_unicodeStrXmlns, 5) == 0 &&
+					(name[5] == chNull || name[5] == chColon) &&
+					(inputList == NULL || inputList->hasNode(a)))
+					lst.addNode(a);
+
+			}
+
+		}
+
+		n = n->getParentNode();
+
+	}
+
+}
+
+// --------------------------------------------------------------------------------
+//           Evaluation
+// --------------------------------------------------------------------------------
+
+void XSECXPathPattern::evaluatePredicate(DOMNode * start,
+										 DOMNode * here,
+										 const XSECXPathNodeList * inputList,
+										 bool addParentNS,
+										 XSECXPathNodeList & lst) const {
+
+	if (!isPredicate()) {
+
+		throw XSECException(XSECException::XPathError,
+			"XSECXPathPattern::evaluatePredicate - expression is not a predicate");
+
+	}
+
+	if (start == NULL)
+		return;
+
+	DOMNode * hereAncestor = NULL;
+
+	if (m_type == PATTERN_NOT_HERE_ANCESTOR) {
+
+		// No enclosing element means the expression is false everywhere
+		hereAncestor = findHereAncestor(here);
+		if (hereAncestor == NULL)
+			return;
+
+	}
+
+	bool textOnly = (m_type == PATTERN_SELF_TEXT);
+
+	if (!textOnly) {
+
+		// The ancestor axis runs to the root regardless of where the
+		// input starts, so an excluded ancestor removes everything
+
+		DOMNode * a = start->getParentNode();
+		while (a != NULL) {
+			if (isExcluded(a, hereAncestor))
+				return;
+			a = a->getParentNode();
+		}
+
+		if (addParentNS && start->getNodeType() != DOMNode::DOCUMENT_NODE)
+			addAncestorNSNodes(start->getParentNode(), inputList, lst);
+
+	}
+
+	// Single walk through the tree, pruning excluded sub-trees
+
+	DOMNode * c = start;
+	DOMNode * next;
+
+	while (c != NULL) {
+
+		next = NULL;
+
+		if (!isExcluded(c, hereAncestor)) {
+
+			if (textOnly) {
+
+				DOMNode::NodeType t = c->getNodeType();
+				if ((t == DOMNode::TEXT_NODE || t == DOMNode::CDATA_SECTION_NODE) &&
+					(inputList == NULL || inputList->hasNode(c)))
+					lst.addNode(c);
+
+			}
+			else {
+
+				if (inputList == NULL || inputList->hasNode(c))
+					lst.addNode(c);
+
+				if (c->getNodeType() == DOMNode::ELEMENT_NODE) {
+
+					DOMNamedNodeMap * atts = c->getAttributes();
+					XMLSize_t sz = (atts != NULL ? atts->getLength() : 0);
+
+					for (XMLSize_t i = 0; i < sz; ++i) {
+						if (inputList == NULL || inputList->hasNode(atts->item(i)))
+							lst.addNode(atts->item(i));
+					}
+
+				}
+
+			}
+
+			next = c->getFirstChild();
+
+		}
+
+		// Across or up
+
+		while (next == NULL && c != start) {
+
+			next = c->getNextSibling();
+			if (next == NULL)
+				c = c->getParentNode();
+
+		}
+
+		c = next;
+
+	}
+
+}
+
+void XSECXPathPattern::selectNodes(DOMDocument * doc,
+								   DOMNode * here,
+								   XSECXPathNodeList & lst) const {
+
+	switch (m_type) {
+
+	case PATTERN_ROOT :
+
+		lst.addNode(doc);
+		break;
+
+	case PATTERN_HERE_ANCESTOR :
+
+		{
+			DOMNode * a = findHereAncestor(here);
+			if (a != NULL)
+				lst.addNode(a);
+		}
+		break;
+
+	case PATTERN_ID :
+
+		{
+			// id() takes a white space separated list of Ids
+			const char * p = m_ids.rawCharBuffer();
+			safeBuffer tok, id;
+
+			while (*p != '\0') {
+
+				while (isXMLSpace(*p))
+					++p;
+
+				const char * s = p;
+				while (*p != '\0' && !isXMLSpace(*p))
+					++p;
+
+				if (p == s)
+					break;
+
+				tok.sbStrncpyIn(s, (xsecsize_t) (p - s));
+				id.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
+				id.sbXMLChCat8(tok.rawCharBuffer());
+
+				DOMElement * e = doc->getElementById(id.rawXMLChBuffer());
+				if (e != NULL)
+					lst.addNode(e);
+
+			}
+		}
+		break;
+
+	default :
+
+		throw XSECException(XSECException::XPathError,
+			"XSECXPathPattern::selectNodes - expression is not a node-set");
+
+	}
+
+}
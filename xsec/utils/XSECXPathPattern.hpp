@@ -0,0 +1,206 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECXPathPattern := Recogniser and native evaluator for the handful of
+ *                     XPath expressions commonly found in signatures
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSECXPATHPATTERN_INCLUDE
+#define XSECXPATHPATTERN_INCLUDE
+
+// XSEC
+#include <xsec/framework/XSECDefs.hpp>
+#include <xsec/utils/XSECSafeBuffer.hpp>
+#include <xsec/utils/XSECXPathNodeList.hpp>
+
+// Xerces
+
+XSEC_DECLARE_XERCES_CLASS(DOMNode);
+XSEC_DECLARE_XERCES_CLASS(DOMDocument);
+XSEC_DECLARE_XERCES_CLASS(DOMNamedNodeMap);
+
+/**
+ * @ingroup internal
+ */
+
+/**
+ * \brief Native evaluator for common XPath shapes.
+ *
+ * Most signatures in the wild use a very small number of XPath
+ * expressions - typically the "not in a Signature" exclusion, the
+ * here() based enveloped signature expression from the XMLDSig
+ * specification and id() or "/" selections in XPath Filter 2.0.
+ *
+ * This class recognises those shapes and evaluates them directly
+ * against the DOM as a single tree walk (pruning excluded subtrees),
+ * so they do not need to go through Xalan.  Anything that is not
+ * recognised is reported as such so the caller can fall back to the
+ * full XPath engine.
+ *
+ * Whitespace (outside of string literals) is ignored when matching,
+ * and prefixes are resolved in the same order the Xalan path uses -
+ * first the document element, then the namespaces defined on the
+ * XPath element itself.
+ */
+
+class DSIG_EXPORT XSECXPathPattern {
+
+public:
+
+	enum patternType {
+
+		PATTERN_UNKNOWN					= 0,	// Needs the full XPath engine
+		PATTERN_NOT_ANCESTOR_OR_SELF	= 1,	// not(ancestor-or-self::p:n)
+		PATTERN_NOT_HERE_ANCESTOR		= 2,	// count(ancestor-or-self::p:n | here()/ancestor::p:n[1]) > count(ancestor-or-self::p:n)
+		PATTERN_SELF_TEXT				= 3,	// self::text()
+		PATTERN_ROOT					= 4,	// /
+		PATTERN_ID						= 5,	// id("...")
+		PATTERN_HERE_ANCESTOR			= 6		// here()/ancestor::p:n[1]
+
+	};
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	XSECXPathPattern();
+	~XSECXPathPattern();
+
+	//@}
+
+	/** @name Compilation */
+	//@{
+
+	/**
+	 * \brief Attempt to recognise an expression
+	 *
+	 * @param expr The (UTF-8) expression to compile
+	 * @param doc The document the expression will be run against - used
+	 * to resolve prefixes against the document element
+	 * @param nsMap Attributes of the XPath element (may be NULL)
+	 * @returns true if the expression was recognised and can be
+	 * evaluated natively.
+	 */
+
+	bool compile(const char * expr,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument * doc,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNamedNodeMap * nsMap);
+
+	/**
+	 * \brief Get the type of the compiled expression
+	 */
+
+	patternType getPatternType(void) const {return m_type;}
+
+	/**
+	 * \brief Is this a predicate (XPath transform) expression?
+	 *
+	 * Predicates are evaluated against every node in the input.  Non
+	 * predicates select a node-set (XPath Filter 2.0).
+	 */
+
+	bool isPredicate(void) const;
+
+	//@}
+
+	/** @name Evaluation */
+	//@{
+
+	/**
+	 * \brief Evaluate a predicate expression
+	 *
+	 * Walk the nodes at and below start and add those that match to
+	 * the output list.  If an input list is provided, only nodes that are
+	 * also in the input list are added.
+	 *
+	 * @param start Node to start the walk at (document or fragment)
+	 * @param here The node to use for here()
+	 * @param inputList If non-NULL, the input node-set
+	 * @param addParentNS If true, in-scope namespace declarations of the
+	 * ancestors of start are added (used when name spaces have not been
+	 * expanded and start is a fragment)
+	 * @param lst The list to add nodes to
+	 */
+
+	void evaluatePredicate(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * start,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * here,
+		const XSECXPathNodeList * inputList,
+		bool addParentNS,
+		XSECXPathNodeList & lst) const;
+
+	/**
+	 * \brief Evaluate a node-set expression
+	 *
+	 * @param doc The document to select from
+	 * @param here The node to use for here()
+	 * @param lst The list to add nodes to
+	 */
+
+	void selectNodes(XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument * doc,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * here,
+		XSECXPathNodeList & lst) const;
+
+	//@}
+
+	/**
+	 * \brief Add in-scope namespace declarations of ancestors
+	 *
+	 * Used when a sub-tree is selected from an unexpanded document, so
+	 * the canonicaliser name space stack can find the declarations that
+	 * belong to the selected nodes.
+	 *
+	 * @param n First ancestor to look at
+	 * @param inputList If non-NULL, only add nodes that are in this list
+	 * @param lst The list to add nodes to
+	 */
+
+	static void addAncestorNSNodes(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * n,
+		const XSECXPathNodeList * inputList,
+		XSECXPathNodeList & lst);
+
+private:
+
+	bool nameMatches(const XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * n) const;
+	bool isExcluded(const XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * n,
+		const XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * hereAncestor) const;
+	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * findHereAncestor(
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * here) const;
+	bool parseQName(const char * &p, safeBuffer &qname) const;
+	bool resolveQName(safeBuffer &qname,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument * doc,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMNamedNodeMap * nsMap);
+
+	patternType			m_type;
+	safeBuffer			m_localName;		// Local name of the element test
+	safeBuffer			m_URI;				// Namespace of the element test
+	bool				m_hasURI;			// False if element test has no namespace
+	safeBuffer			m_ids;				// Space separated list for id()
+
+	// Unimplemented
+	XSECXPathPattern(const XSECXPathPattern &);
+	XSECXPathPattern & operator = (const XSECXPathPattern &);
+
+};
+
+#endif /* XSECXPATHPATTERN_INCLUDE */
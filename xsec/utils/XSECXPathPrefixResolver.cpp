@@ -0,0 +1,150 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECXPathPrefixResolver := Resolve the prefixes of an XPath expression
+ *                            against the declarations in scope where it
+ *                            was written
+ *
+ * $Id$
+ *
+ */
+
+// XSEC
+#include <xsec/utils/XSECXPathPrefixResolver.hpp>
+#include <xsec/dsig/DSIGConstants.hpp>
+#include <xsec/framework/XSECError.hpp>
+
+// Xerces
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/util/XMLUniDefs.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+XERCES_CPP_NAMESPACE_USE
+
+#ifndef XSEC_NO_XPATH
+
+// --------------------------------------------------------------------------------
+//           Constructors and Destructors
+// --------------------------------------------------------------------------------
+
+XSECXPathPrefixResolver::XSECXPathPrefixResolver(const DOMNamedNodeMap * atts,
+												 const DOMNode * scope) :
+mp_atts(atts),
+mp_scope(scope) {
+
+}
+
+XSECXPathPrefixResolver::~XSECXPathPrefixResolver() {
+
+	BindingVectorType::iterator i;
+
+	for (i = m_bindings.begin(); i != m_bindings.end(); ++i)
+		delete (*i);
+
+}
+
+void XSECXPathPrefixResolver::addBinding(const XalanDOMString & prefix,
+										 const XalanDOMString & uri) {
+
+	Binding * b;
+	XSECnew(b, Binding);
+
+	b->prefix = prefix;
+	b->uri = uri;
+
+	m_bindings.push_back(b);
+
+}
+
+// --------------------------------------------------------------------------------
+//           PrefixResolver
+// --------------------------------------------------------------------------------
+
+const XalanDOMString * XSECXPathPrefixResolver::getNamespaceForPrefix(
+		const XalanDOMString & prefix) const {
+
+	BindingVectorType::const_iterator i;
+
+	for (i = m_bindings.begin(); i != m_bindings.end(); ++i) {
+
+		if ((*i)->prefix == prefix)
+			return &((*i)->uri);
+
+	}
+
+	// Not seen yet - find the declaration
+
+	const XMLCh * p = prefix.c_str();
+	const XMLCh * uri = NULL;
+
+	if (p == NULL || p[0] == chNull)
+		return NULL;
+
+	if (XMLString::equals(p, XMLUni::fgXMLString))
+		uri = XMLUni::fgXMLURIName;
+
+	else {
+
+		const DOMNode * a = NULL;
+
+		if (mp_atts != NULL)
+			a = mp_atts->getNamedItemNS(DSIGConstants::s_unicodeStrURIXMLNS, p);
+
+		const DOMNode * e = mp_scope;
+
+		while (a == NULL && e != NULL && e->getNodeType() == DOMNode::ELEMENT_NODE) {
+
+			a = ((const DOMElement *) e)->getAttributeNodeNS(
+				DSIGConstants::s_unicodeStrURIXMLNS, p);
+			e = e->getParentNode();
+
+		}
+
+		if (a != NULL)
+			uri = a->getNodeValue();
+
+	}
+
+	// An empty value un-declares the prefix
+
+	if (uri == NULL || uri[0] == chNull)
+		return NULL;
+
+	Binding * b;
+	XSECnew(b, Binding);
+
+	b->prefix = prefix;
+	b->uri = XalanDOMString(uri);
+
+	m_bindings.push_back(b);
+
+	return &(b->uri);
+
+}
+
+const XalanDOMString & XSECXPathPrefixResolver::getURI() const {
+
+	return m_uri;
+
+}
+
+#endif /* XSEC_NO_XPATH */
@@ -0,0 +1,143 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XSECXPathPrefixResolver := Resolve the prefixes of an XPath expression
+ *                            against the declarations in scope where it
+ *                            was written
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XSECXPATHPREFIXRESOLVER_INCLUDE
+#define XSECXPATHPREFIXRESOLVER_INCLUDE
+
+// XSEC
+#include <xsec/framework/XSECDefs.hpp>
+
+#include <vector>
+
+XSEC_DECLARE_XERCES_CLASS(DOMNode);
+XSEC_DECLARE_XERCES_CLASS(DOMNamedNodeMap);
+
+#ifndef XSEC_NO_XALAN
+
+#if defined(_MSC_VER)
+#	pragma warning(disable: 4267)
+#endif
+
+#include <xalanc/Include/PlatformDefinitions.hpp>
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+#include <xalanc/DOMSupport/PrefixResolver.hpp>
+
+#if defined(_MSC_VER)
+#	pragma warning(default: 4267)
+#endif
+
+XALAN_USING_XALAN(PrefixResolver);
+XALAN_USING_XALAN(XalanDOMString);
+
+#endif
+
+#ifndef XSEC_NO_XPATH
+
+/**
+ * @ingroup internal
+ */
+
+/**
+ * \brief Prefix resolver for the XPath transforms
+ *
+ * Looks prefixes up in the declarations of the element that holds the
+ * expression and then in its ancestors, as each one is asked for.  The
+ * document is only read, so nothing needs to be copied onto the document
+ * being searched before Xalan can resolve the expression's prefixes.
+ */
+
+class XSECXPathPrefixResolver : public PrefixResolver {
+
+public:
+
+	/**
+	 * \brief Constructor
+	 *
+	 * @param atts Declarations searched first (may be NULL)
+	 * @param scope Element whose in-scope declarations are searched
+	 * next, walking up through its ancestors (may be NULL)
+	 */
+
+	XSECXPathPrefixResolver(
+		const XERCES_CPP_NAMESPACE_QUALIFIER DOMNamedNodeMap * atts,
+		const XERCES_CPP_NAMESPACE_QUALIFIER DOMNode * scope);
+
+	virtual
+	~XSECXPathPrefixResolver();
+
+	/**
+	 * \brief Bind a prefix that is not declared in the document
+	 *
+	 * Used for the prefix the here() function is rewritten to.
+	 */
+
+	void addBinding(const XalanDOMString & prefix, const XalanDOMString & uri);
+
+	// PrefixResolver
+
+	virtual const XalanDOMString *
+	getNamespaceForPrefix(const XalanDOMString & prefix) const;
+
+	virtual const XalanDOMString &
+	getURI() const;
+
+private:
+
+	struct Binding {
+		XalanDOMString	prefix;
+		XalanDOMString	uri;
+	};
+
+#if defined(XSEC_NO_NAMESPACES)
+	typedef vector<Binding *>				BindingVectorType;
+#else
+	typedef std::vector<Binding *>			BindingVectorType;
+#endif
+
+	const XERCES_CPP_NAMESPACE_QUALIFIER DOMNamedNodeMap
+							* mp_atts;
+	const XERCES_CPP_NAMESPACE_QUALIFIER DOMNode
+							* mp_scope;
+	XalanDOMString			m_uri;
+
+	// Prefixes found so far.  Filled in as they are asked for.
+	mutable BindingVectorType
+							m_bindings;
+
+	// Unimplemented
+	XSECXPathPrefixResolver();
+	XSECXPathPrefixResolver(const XSECXPathPrefixResolver &);
+	XSECXPathPrefixResolver & operator = (const XSECXPathPrefixResolver &);
+
+};
+
+#endif /* XSEC_NO_XPATH */
+
+#endif /* XSECXPATHPREFIXRESOLVER_INCLUDE */
@@ -74,13 +74,18 @@
 #include <xercesc/util/XMLUni.hpp>
 #include <xercesc/util/Janitor.hpp>
 #include <xercesc/util/XMLString.hpp>
-#include <xercesc/util/BinFileInputStream.hpp>
 
 XERCES_CPP_NAMESPACE_USE
 
 #include <xsec/framework/XSECError.hpp>
 #include <xsec/utils/XSECDOMUtils.hpp>
 #include <xsec/utils/unixutils/XSECBinHTTPURIInputStream.hpp>
+#include <xsec/utils/XSECBinMappedFileInputStream.hpp>
+#include <xsec/utils/XSECSafeBuffer.hpp>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdio.h>
 
 #include "../../utils/XSECAutoPtr.hpp"
 
@@ -137,13 +142,10 @@ XSECURIResolverGenericUnix::~XSECURIResolverGenericUnix() {
 //  Resolve a URI that is passed in
 // -----------------------------------------------------------------------
 
-BinInputStream * XSECURIResolverGenericUnix::resolveURI(const XMLCh * uri) {
+XMLUri * XSECURIResolverGenericUnix::makeURI(const XMLCh * uri) {
 
-	XSEC_USING_XERCES(BinInputStream);
 	XSEC_USING_XERCES(XMLUri);
-	XSEC_USING_XERCES(XMLUni);
 	XSEC_USING_XERCES(Janitor);
-	XSEC_USING_XERCES(BinFileInputStream);
 
 	XMLUri					* xmluri;
 
@@ -191,42 +193,75 @@ BinInputStream * XSECURIResolverGenericUnix::resolveURI(const XMLCh * uri) {
 	else {
 		XSECnew(xmluri, XMLUri(uri));
 	}
-	
+
+	return xmluri;
+
+}
+
+XMLCh * XSECURIResolverGenericUnix::localFilePath(const XMLUri * xmluri) {
+
+	XSEC_USING_XERCES(XMLUni);
+
+	// Returns the path for a file: URI on the local host, or NULL
+
+	if (XMLString::compareIString(xmluri->getScheme(), gFileScheme))
+		return NULL;
+
+	// This is a file.  We only really understand if this is localhost
+	// XMLUri has already cleaned of escape characters (%xx)
+
+	if (xmluri->getHost() == NULL || xmluri->getHost()[0] == chNull ||
+		!XMLString::compareIString(xmluri->getHost(), XMLUni::fgLocalHostString)) {
+
+		// Clean hex escapes
+		return cleanURIEscapes(xmluri->getPath());
+
+	}
+
+	return NULL;
+
+}
+
+BinInputStream * XSECURIResolverGenericUnix::resolveURI(const XMLCh * uri) {
+
+	XSEC_USING_XERCES(BinInputStream);
+	XSEC_USING_XERCES(XMLUri);
+	XSEC_USING_XERCES(Janitor);
+
+	XMLUri * xmluri = makeURI(uri);
 	Janitor<XMLUri> j_xmluri(xmluri);
 
 	// Determine what kind of URI this is and how to handle it.
 	
 	if (!XMLString::compareIString(xmluri->getScheme(), gFileScheme)) {
 
-		// This is a file.  We only really understand if this is localhost
-		// XMLUri has already cleaned of escape characters (%xx)
-        
-		if (xmluri->getHost() == NULL || xmluri->getHost()[0] == chNull ||
-			!XMLString::compareIString(xmluri->getHost(), XMLUni::fgLocalHostString)) {
+		XMLCh * realPath = localFilePath(xmluri);
 
-			// Clean hex escapes
-			XMLCh * realPath = cleanURIEscapes(xmluri->getPath());
+		if (realPath == NULL) {
 
-			// Localhost
+			throw XSECException(XSECException::ErrorOpeningURI,
+				"XSECURIResolverGenericUnix - unable to open non-localhost file");
 
-            BinFileInputStream* retStrm = new BinFileInputStream(realPath);
-            XSEC_RELEASE_XMLCH(realPath);
+		}
 
-            if (!retStrm->getIsOpen())
-            {
-                delete retStrm;
-                return 0;
-            }
-            return retStrm;
+		// Localhost - mapped where the file allows, otherwise read
 
+		XSECBinMappedFileInputStream * retStrm;
+		try {
+			XSECnew(retStrm, XSECBinMappedFileInputStream(realPath));
 		}
+		catch (...) {
+			XSEC_RELEASE_XMLCH(realPath);
+			throw;
+		}
+		XSEC_RELEASE_XMLCH(realPath);
 
-		else {
-
-			throw XSECException(XSECException::ErrorOpeningURI,
-				"XSECURIResolverGenericUnix - unable to open non-localhost file");
-		
+		if (!retStrm->getIsOpen())
+		{
+			delete retStrm;
+			return 0;
 		}
+		return retStrm;
 
 	}
 
@@ -247,6 +282,81 @@ BinInputStream * XSECURIResolverGenericUnix::resolveURI(const XMLCh * uri) {
 	
 }
 
+XSECBinMappedFileInputStream * XSECURIResolverGenericUnix::resolveURIMapped(const XMLCh * uri) {
+
+	XSEC_USING_XERCES(XMLUri);
+	XSEC_USING_XERCES(Janitor);
+
+	// Anything that can't be mapped is left for resolveURI()
+
+	if (uri == NULL)
+		return NULL;
+
+	XMLUri * xmluri = makeURI(uri);
+	Janitor<XMLUri> j_xmluri(xmluri);
+
+	XMLCh * realPath = localFilePath(xmluri);
+	if (realPath == NULL)
+		return NULL;
+
+	XSECBinMappedFileInputStream * ret;
+	try {
+		XSECnew(ret, XSECBinMappedFileInputStream(realPath));
+	}
+	catch (...) {
+		XSEC_RELEASE_XMLCH(realPath);
+		throw;
+	}
+	XSEC_RELEASE_XMLCH(realPath);
+
+	// A file that could not be mapped is still open, and is read from
+	// the same descriptor rather than being opened again by resolveURI()
+
+	if (!ret->getIsOpen()) {
+		delete ret;
+		return NULL;
+	}
+
+	return ret;
+
+}
+
+bool XSECURIResolverGenericUnix::getValidator(const XMLCh * uri, safeBuffer & validator) {
+
+	XSEC_USING_XERCES(XMLUri);
+	XSEC_USING_XERCES(Janitor);
+
+	// Local files only - the HTTP stream has no conditional requests
+
+	if (uri == NULL)
+		return false;
+
+	XMLUri * xmluri = makeURI(uri);
+	Janitor<XMLUri> j_xmluri(xmluri);
+
+	XMLCh * realPath = localFilePath(xmluri);
+	if (realPath == NULL)
+		return false;
+
+	char * path = XMLString::transcode(realPath);
+	XSEC_RELEASE_XMLCH(realPath);
+
+	struct stat st;
+	int res = stat(path, &st);
+	XSEC_RELEASE_XMLCH(path);
+
+	if (res != 0)
+		return false;
+
+	char buf[96];
+	sprintf(buf, "%lu:%lu:%lu", (unsigned long) st.st_ino,
+		(unsigned long) st.st_mtime, (unsigned long) st.st_size);
+	validator.sbStrcpyIn(buf);
+
+	return true;
+
+}
+
 // -----------------------------------------------------------------------
 //  Clone me
 // -----------------------------------------------------------------------
@@ -57,6 +57,8 @@
 
 #include <xercesc/util/XMLString.hpp>
 
+XSEC_DECLARE_XERCES_CLASS(XMLUri);
+
 /**
  * @ingroup pubsig
  */
@@ -119,6 +121,33 @@ public:
 
 	virtual XSECURIResolver * clone(void);
 
+	/**
+	 * \brief Map a local file URI onto memory.
+	 *
+	 * Returns a stream for file: URIs on the local host, mapped if the
+	 * file allows it (see XSECBinMappedFileInputStream for the
+	 * truncation hazard), and NULL for anything else.
+	 *
+	 * @param uri The string containing the URI to be de-referenced.
+	 * @returns A local file stream, or NULL
+	 */
+
+	virtual XSECBinMappedFileInputStream *
+		resolveURIMapped(const XMLCh * uri);
+
+	/**
+	 * \brief Find a validator for a local file.
+	 *
+	 * The validator is built from the inode, modification time and
+	 * size of the file.  Other URIs have no validator.
+	 *
+	 * @param uri The string containing the URI to be checked.
+	 * @param validator Set to the validator
+	 * @returns true for a local file that exists
+	 */
+
+	virtual bool getValidator(const XMLCh * uri, safeBuffer & validator);
+
 	//@}
 
 	/** @name Class specific functions */
@@ -135,6 +164,9 @@ public:
 
 private:
 
+	XERCES_CPP_NAMESPACE_QUALIFIER XMLUri * makeURI(const XMLCh * uri);
+	XMLCh * localFilePath(const XERCES_CPP_NAMESPACE_QUALIFIER XMLUri * xmluri);
+
 	XMLCh			* mp_baseURI;
 
 
@@ -182,6 +182,14 @@ public:
 	 * processes the encrypted data and provides an InputStream that the
 	 * caller can read from to read the plain text data.
 	 *
+	 * Decryption is streamed, including for authenticated (AES-GCM)
+	 * algorithms where the provider supports it.  In that case the
+	 * authentication tag is only checked once the end of the cipher text
+	 * is reached, so data read from the stream must be treated as
+	 * unauthenticated until a read has returned 0 (end of stream)
+	 * without an exception being thrown.  Callers that cannot discard
+	 * already-consumed output should use one of the other decrypt calls.
+	 *
 	 * @param element Root of EncryptedData DOM structyre to decrypt
 	 * @returns A BinInputStream object that the application can use to
 	 * read the decrypted data.
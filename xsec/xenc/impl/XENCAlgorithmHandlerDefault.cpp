@@ -577,10 +577,11 @@ bool XENCAlgorithmHandlerDefault::appendDecryptCipherTXFM(
 			"XENCAlgorithmHandlerDefault::appendDecryptCipherTXFM - only supports bulk symmetric algorithms");
 	}
 
-    if (skm == XSECCryptoSymmetricKey::MODE_GCM) {
+    if (skm == XSECCryptoSymmetricKey::MODE_GCM &&
+            !((XSECCryptoSymmetricKey*) key)->supportsDeferredTag()) {
 
-        // GCM doesn't fit the pipelined model of the existing code, so we have a custom
-        // routine that decrypts to a safeBuffer directly.
+        // The provider needs the tag up front, which doesn't fit the pipelined model,
+        // so we have a custom routine that decrypts to a safeBuffer directly.
         safeBuffer result;
         unsigned int sz = doGCMDecryptToSafeBuffer(cipherText, key, taglen, result);
 
@@ -594,9 +595,11 @@ bool XENCAlgorithmHandlerDefault::appendDecryptCipherTXFM(
     }
 
 
-	// Add the decryption TXFM
+	// Add the decryption TXFM.  For GCM this streams, holding back the trailing tag
+	// until the end of the cipher text, so the output is unauthenticated until the
+	// final read has succeeded.
 	TXFMCipher* tcipher;
-	XSECnew(tcipher, TXFMCipher(doc, key, false));
+	XSECnew(tcipher, TXFMCipher(doc, key, false, skm, taglen));
 	cipherText->appendTxfm(tcipher);
 
 	return true;
@@ -862,16 +865,18 @@ unsigned int XENCAlgorithmHandlerDefault::decryptToSafeBuffer(
 
 	}
 
-    if (skm == XSECCryptoSymmetricKey::MODE_GCM) {
-        // GCM doesn't fit the pipelined model of the existing code, so we have a custom
-        // routine that decrypts to a safeBuffer directly.
+    if (skm == XSECCryptoSymmetricKey::MODE_GCM &&
+            !((XSECCryptoSymmetricKey*) key)->supportsDeferredTag()) {
+        // The provider needs the tag up front, which doesn't fit the pipelined model,
+        // so we have a custom routine that decrypts to a safeBuffer directly.
         return doGCMDecryptToSafeBuffer(cipherText, key, taglen, result);
     }
 
-	// It's symmetric and it's not a key wrap or GCM, so just treat as a block algorithm.
+	// It's symmetric and it's not a key wrap, so just treat as a block algorithm.
+	// (GCM streams through the same transform, checking the tag at the end.)
 
 	TXFMCipher * tcipher;
-	XSECnew(tcipher, TXFMCipher(doc, key, false));
+	XSECnew(tcipher, TXFMCipher(doc, key, false, skm, taglen));
 
 	cipherText->appendTxfm(tcipher);
 
@@ -882,11 +887,19 @@ unsigned int XENCAlgorithmHandlerDefault::decryptToSafeBuffer(
 	XMLByte buf[1024];
 	TXFMBase * b = cipherText->getLastTxfm();
 
-	unsigned int bytesRead = (unsigned int) b->readBytes(buf, 1024);
-	while (bytesRead > 0) {
-		result.sbMemcpyIn(offset, buf, bytesRead);
-		offset += bytesRead;
-		bytesRead = (unsigned int) b->readBytes(buf, 1024);
+	try {
+		unsigned int bytesRead = (unsigned int) b->readBytes(buf, 1024);
+		while (bytesRead > 0) {
+			result.sbMemcpyIn(offset, buf, bytesRead);
+			offset += bytesRead;
+			bytesRead = (unsigned int) b->readBytes(buf, 1024);
+		}
+	}
+	catch (...) {
+		// Don't leave unauthenticated plain text lying around
+		result.cleanseBuffer();
+		memset(buf, 0, 1024);
+		throw;
 	}
 
 	result[offset] = '\0'; 
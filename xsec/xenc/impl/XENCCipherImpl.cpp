@@ -46,6 +46,8 @@
 #include <xsec/framework/XSECAlgorithmHandler.hpp>
 #include <xsec/utils/XSECPlatformUtils.hpp>
 #include <xsec/utils/XSECBinTXFMInputStream.hpp>
+#include <xsec/utils/XSECDOMFragmentBuilder.hpp>
+#include <xsec/utils/XSECParserPool.hpp>
 
 #include "XENCCipherImpl.hpp"
 #include "XENCEncryptedDataImpl.hpp"
@@ -56,8 +58,6 @@
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMElement.hpp>
 #include <xercesc/util/XMLUniDefs.hpp>
-#include <xercesc/parsers/XercesDOMParser.hpp>
-#include <xercesc/framework/MemBufInputSource.hpp>
 #include <xercesc/util/Janitor.hpp>
 
 // With all the characters - just uplift entire thing
@@ -72,10 +72,6 @@ using std::cout;
 // --------------------------------------------------------------------------------
 
 
-const XMLCh s_tagname[] = {
-
-chLatin_f, chLatin_r, chLatin_a, chLatin_g, chLatin_m, chLatin_e, chLatin_n, chLatin_t, chNull };
-
 const XMLCh s_noData[] = { chLatin_n, chLatin_o, chLatin_D, chLatin_a, chLatin_t, chLatin_a, chNull };
 
 const XMLCh s_ds[] = { chLatin_d, chLatin_s, chNull };
@@ -211,137 +207,26 @@ void XENCCipherImpl::setKEK(XSECCryptoKey * key) {
 
 DOMDocumentFragment * XENCCipherImpl::deSerialise(safeBuffer &content, DOMNode * ctx) {
 
-    DOMDocumentFragment * result;
-
-    // Create the context to parse the document against
-    safeBuffer sb, sbt;
-    sb.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
-    //sb.sbXMLChAppendCh(chUnicodeMarker);
-    //sb.sbXMLChCat8("<?xml version=\"1.0\" encoding=\"UTF-16\"?><");
-    sb.sbXMLChAppendCh(chOpenAngle);
-    sb.sbXMLChCat(s_tagname);
-
-    // Run through each node up to the document node and find any
-    // xmlns: nodes that may be needed during the parse of the decrypted content
-
-    DOMNode * ctxParent = ctx->getParentNode();
-    DOMNode * wk = ctxParent;
-
-    while (wk != NULL) {
-
-        DOMNamedNodeMap * atts = wk->getAttributes();
-        XMLSize_t length;
-        if (atts != NULL)
-            length = atts->getLength();
-        else
-            length = 0;
-
-        for (XMLSize_t i = 0; i < length; ++i) {
-            DOMNode * att = atts->item(i);
-            if (strEquals(att->getNodeName(), DSIGConstants::s_unicodeStrXmlns) ||
-                    (XMLString::compareNString(att->getNodeName(), DSIGConstants::s_unicodeStrXmlns, 5) == 0 &&
-                            att->getNodeName()[5] == chColon)) {
-
-                // Check to see if this node has already been found
-                DOMNode * p = ctxParent;
-                bool found = false;
-                while (p != wk) {
-                    DOMNamedNodeMap * tstAtts = p->getAttributes();
-                    if (tstAtts != NULL && tstAtts->getNamedItem(att->getNodeName()) != NULL) {
-                        found = true;
-                        break;
-                    }
-                    p = p->getParentNode();
-                }
-                if (found == false) {
-
-                    // This is an attribute node that needs to be added
-                    sb.sbXMLChAppendCh(chSpace);
-                    sb.sbXMLChCat(att->getNodeName());
-                    sb.sbXMLChAppendCh(chEqual);
-                    sb.sbXMLChAppendCh(chDoubleQuote);
-                    sb.sbXMLChCat(att->getNodeValue());
-                    sb.sbXMLChAppendCh(chDoubleQuote);
-                }
-            }
-        }
-        wk = wk->getParentNode();
-    }
-    sb.sbXMLChAppendCh(chCloseAngle);
-
-    char* prefix = transcodeToUTF8(sb.rawXMLChBuffer());
-    sbt = prefix;
-    XSEC_RELEASE_XMLCH(prefix);
-
-    const char * crcb = content.rawCharBuffer();
-    int offset = 0;
-    if (crcb[0] == '<' && crcb[1] == '?') {
-        // Have a PI prefix - get rid of it
-        int i = 2;
-        while (crcb[i] != '\0' && crcb[i] != '>')
-            ++i;
-
-        if (crcb[i] == '>')
-            offset = i + 1;
-    }
-
-    sbt.sbStrcatIn(&crcb[offset]);
-
-    // Terminate the string
-    sb.sbXMLChIn(DSIGConstants::s_unicodeStrEmpty);
-    sb.sbXMLChAppendCh(chOpenAngle);
-    sb.sbXMLChAppendCh(chForwardSlash);
-    sb.sbXMLChCat(s_tagname);
-    sb.sbXMLChAppendCh(chCloseAngle);
+    // The builder creates the nodes straight into the context document, with
+    // the namespaces in scope at ctx available to the content.  Builders (and
+    // their parsers) come from the shared pool, so repeated decrypts don't pay
+    // for parser setup.
 
-    char* trailer = transcodeToUTF8(sb.rawXMLChBuffer());
-    sbt.sbStrcatIn(trailer);
-    XSEC_RELEASE_XMLCH(trailer);
-
-    // Create an input source
-    xsecsize_t bytes = XMLString::stringLen(sbt.rawCharBuffer());
-    MemBufInputSource memIS((const XMLByte*) sbt.rawBuffer(), bytes, "XSECMem");
-
-    XercesDOMParser parser;
-    parser.setDoNamespaces(true);
-    parser.setLoadExternalDTD(false);
-
-    SecurityManager securityManager;
-    securityManager.setEntityExpansionLimit(XSEC_ENTITY_EXPANSION_LIMIT);
-    parser.setSecurityManager(&securityManager);
-
-    parser.parse(memIS);
-    xsecsize_t errorCount = parser.getErrorCount();
-    if (errorCount > 0)
-        throw XSECException(XSECException::CipherError, "Errors occured during de-serialisation of decrypted element content");
-
-    DOMDocument * doc = parser.getDocument();
-
-    // Create a DocumentFragment to hold the children of the parsed doc element
-    DOMDocument *ctxDocument = ctx->getOwnerDocument();
-    result = ctxDocument->createDocumentFragment();
-    Janitor<DOMDocumentFragment> j_result(result);
-
-    // Now get the children of the document into a DOC fragment
-    DOMNode * fragElt = doc->getDocumentElement();
-    DOMNode * child;
-
-    if (fragElt != NULL) {
-        child = fragElt->getFirstChild();
-    } else {
+    XSECDOMFragmentBuilder * builder = XSECParserPool::getFragmentBuilder();
+    DOMDocumentFragment * result;
 
-        throw XSECException(XSECException::CipherError, "XENCCipher::deSerialse - re-parsed document unexpectedly empty");
+    try {
+        const char * crcb = content.rawCharBuffer();
+        result = builder->parse(crcb, (xsecsize_t) strlen(crcb), ctx);
     }
-
-    while (child != NULL) {
-        result->appendChild(ctxDocument->importNode(child, true));
-        child = child->getNextSibling();
+    catch (...) {
+        XSECParserPool::releaseFragmentBuilder(builder);
+        throw;
     }
 
-    // Done!
-
-    j_result.release();
+    XSECParserPool::releaseFragmentBuilder(builder);
     return result;
+
 }
 
 // --------------------------------------------------------------------------------
@@ -0,0 +1,332 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XKMSCompoundProcessor := Answer the members of a CompoundRequest
+ *                          concurrently
+ *
+ * $Id$
+ *
+ */
+
+// XSEC Includes
+
+#include <xsec/framework/XSECDefs.hpp>
+#include <xsec/framework/XSECError.hpp>
+#include <xsec/xkms/XKMSCompoundProcessor.hpp>
+#include <xsec/xkms/XKMSCompoundRequest.hpp>
+#include <xsec/xkms/XKMSCompoundResult.hpp>
+#include <xsec/xkms/XKMSMessageFactory.hpp>
+#include <xsec/xkms/XKMSRequestAbstractType.hpp>
+#include <xsec/xkms/XKMSResultType.hpp>
+
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/util/Mutexes.hpp>
+#include <xercesc/util/XMLString.hpp>
+
+#if defined(_WIN32)
+#	include <windows.h>
+#else
+#	include <pthread.h>
+#endif
+
+#include <vector>
+
+XERCES_CPP_NAMESPACE_USE
+
+// --------------------------------------------------------------------------------
+//           Work shared between the threads
+// --------------------------------------------------------------------------------
+
+struct XKMSCompoundItem {
+
+	DOMDocument					* mp_doc;		// Private copy of the request
+	XKMSRequestAbstractType		* mp_request;
+	XKMSResultType				* mp_result;	// Built in mp_doc
+
+};
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef vector<XKMSCompoundItem>			CompoundItemVectorType;
+#else
+typedef std::vector<XKMSCompoundItem>		CompoundItemVectorType;
+#endif
+
+struct XKMSCompoundWork {
+
+	XKMSRequestHandler			* mp_handler;
+	XKMSMessageFactory			* mp_factory;
+	CompoundItemVectorType		m_items;
+	CompoundItemVectorType::size_type
+								m_next;			// Next item to hand out
+	XMLMutex					m_mutex;		// Protects m_next
+
+};
+
+static void answerItem(XKMSCompoundWork * work, XKMSCompoundItem & item) {
+
+	// Nothing may escape a worker thread, so every failure turns into a
+	// Receiver/Failure result
+	try {
+		item.mp_result = work->mp_handler->processRequest(
+			item.mp_request, work->mp_factory, item.mp_doc);
+	}
+	catch (...) {
+		item.mp_result = NULL;
+	}
+
+	if (item.mp_result != NULL)
+		return;
+
+	try {
+		item.mp_result = work->mp_factory->createResult(item.mp_request, item.mp_doc,
+			XKMSResultType::Receiver, XKMSResultType::Failure);
+	}
+	catch (...) {
+		item.mp_result = NULL;
+	}
+
+}
+
+static void runWorker(XKMSCompoundWork * work) {
+
+	for (;;) {
+
+		CompoundItemVectorType::size_type i;
+
+		{
+			XMLMutexLock lock(&(work->m_mutex));
+			if (work->m_next >= work->m_items.size())
+				return;
+			i = work->m_next++;
+		}
+
+		answerItem(work, work->m_items[i]);
+
+	}
+
+}
+
+#if defined(_WIN32)
+typedef HANDLE		CompoundThreadType;
+
+static DWORD WINAPI compoundThread(LPVOID arg) {
+	runWorker((XKMSCompoundWork *) arg);
+	return 0;
+}
+
+static bool startThread(XKMSCompoundWork * work, CompoundThreadType & t) {
+	t = CreateThread(NULL, 0, compoundThread, (LPVOID) work, 0, NULL);
+	return (t != NULL);
+}
+
+static void joinThread(CompoundThreadType & t) {
+	WaitForSingleObject(t, INFINITE);
+	CloseHandle(t);
+}
+#else
+typedef pthread_t	CompoundThreadType;
+
+extern "C" {
+	static void * compoundThread(void * arg) {
+		runWorker((XKMSCompoundWork *) arg);
+		return NULL;
+	}
+}
+
+static bool startThread(XKMSCompoundWork * work, CompoundThreadType & t) {
+	return (pthread_create(&t, NULL, compoundThread, (void *) work) == 0);
+}
+
+static void joinThread(CompoundThreadType & t) {
+	pthread_join(t, NULL);
+}
+#endif
+
+#if defined(XSEC_NO_NAMESPACES)
+typedef vector<CompoundThreadType>			CompoundThreadVectorType;
+#else
+typedef std::vector<CompoundThreadType>		CompoundThreadVectorType;
+#endif
+
+static void releaseItems(CompoundItemVectorType & items) {
+
+	CompoundItemVectorType::size_type i;
+	for (i = 0; i < items.size(); ++i) {
+
+		if (items[i].mp_result != NULL)
+			delete items[i].mp_result;
+		if (items[i].mp_request != NULL)
+			delete items[i].mp_request;
+		if (items[i].mp_doc != NULL)
+			items[i].mp_doc->release();
+
+	}
+
+	items.clear();
+
+}
+
+// --------------------------------------------------------------------------------
+//           Construct/Destruct
+// --------------------------------------------------------------------------------
+
+XKMSCompoundProcessor::XKMSCompoundProcessor(XKMSRequestHandler * handler,
+											 unsigned int threads) :
+mp_handler(handler),
+m_threads(threads) {
+
+	if (m_threads == 0)
+		m_threads = 1;
+
+}
+
+XKMSCompoundProcessor::~XKMSCompoundProcessor() {
+
+}
+
+// --------------------------------------------------------------------------------
+//           Process a CompoundRequest
+// --------------------------------------------------------------------------------
+
+XKMSCompoundResult * XKMSCompoundProcessor::process(
+		XKMSCompoundRequest * request,
+		XKMSMessageFactory * factory,
+		DOMDocument * doc,
+		const XMLCh * id) {
+
+	if (request == NULL || factory == NULL || doc == NULL || mp_handler == NULL) {
+
+		throw XSECException(XSECException::XKMSError,
+			"XKMSCompoundProcessor::process - called with missing parameters");
+
+	}
+
+	XKMSCompoundWork work;
+	work.mp_handler = mp_handler;
+	work.mp_factory = factory;
+	work.m_next = 0;
+
+	XKMSCompoundResult * cr = NULL;
+
+	try {
+
+		// Copy each request into a document of its own.  Done here, as
+		// loading the request list and reading the source DOM are not
+		// safe to do from several threads.
+
+		XMLCh tempStr[100];
+		XMLString::transcode("Core", tempStr, 99);
+		DOMImplementation *impl = DOMImplementationRegistry::getDOMImplementation(tempStr);
+
+		int sz = request->getRequestListSize();
+		work.m_items.reserve(sz);
+
+		for (int i = 0; i < sz; ++i) {
+
+			XKMSCompoundItem item;
+			item.mp_doc = impl->createDocument();
+			item.mp_request = NULL;
+			item.mp_result = NULL;
+			work.m_items.push_back(item);
+
+			DOMNode * copy = item.mp_doc->importNode(
+				request->getRequestListItem(i)->getElement(), true);
+			item.mp_doc->appendChild(copy);
+
+			XKMSMessageAbstractType * msg = 
+				factory->newMessageFromDOM((DOMElement *) copy);
+			work.m_items[i].mp_request = factory->toRequestAbstractType(msg);
+
+			if (work.m_items[i].mp_request == NULL) {
+
+				delete msg;
+				throw XSECException(XSECException::XKMSError,
+					"XKMSCompoundProcessor::process - CompoundRequest holds a non-request message");
+
+			}
+
+		}
+
+		// Fan out.  The calling thread works too, so if no thread can be
+		// started the requests are still answered.
+
+		CompoundThreadVectorType threads;
+		unsigned int extra = m_threads - 1;
+		if (extra > work.m_items.size())
+			extra = (unsigned int) work.m_items.size();
+
+		for (unsigned int t = 0; t < extra; ++t) {
+
+			CompoundThreadType th;
+			if (!startThread(&work, th))
+				break;
+			threads.push_back(th);
+
+		}
+
+		runWorker(&work);
+
+		CompoundThreadVectorType::size_type j;
+		for (j = 0; j < threads.size(); ++j)
+			joinThread(threads[j]);
+
+		// Assemble the results in request order
+
+		cr = factory->createCompoundResult(request, doc, XKMSResultType::Success,
+			XKMSResultType::NoneMinor, id);
+		DOMElement * crElt = cr->getElement();
+
+		CompoundItemVectorType::size_type k;
+		for (k = 0; k < work.m_items.size(); ++k) {
+
+			if (work.m_items[k].mp_result == NULL) {
+
+				throw XSECException(XSECException::XKMSError,
+					"XKMSCompoundProcessor::process - unable to create a result");
+
+			}
+
+			crElt->appendChild(doc->importNode(work.m_items[k].mp_result->getElement(), true));
+
+		}
+
+		releaseItems(work.m_items);
+
+		// Re-read the CompoundResult so its list holds the new results.  The
+		// members are only loaded when they are asked for.
+		XKMSMessageAbstractType * msg = factory->newMessageFromDOM(crElt);
+		delete cr;
+		cr = NULL;
+
+		return (XKMSCompoundResult *) msg;
+
+	}
+	catch (...) {
+
+		if (cr != NULL)
+			delete cr;
+		releaseItems(work.m_items);
+		throw;
+
+	}
+
+}
@@ -0,0 +1,161 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * XSEC
+ *
+ * XKMSCompoundProcessor := Answer the members of a CompoundRequest
+ *                          concurrently
+ *
+ * $Id$
+ *
+ */
+
+#ifndef XKMSCOMPOUNDPROCESSOR_INCLUDE
+#define XKMSCOMPOUNDPROCESSOR_INCLUDE
+
+// XSEC Includes
+
+#include <xsec/framework/XSECDefs.hpp>
+
+XSEC_DECLARE_XERCES_CLASS(DOMDocument);
+
+class XKMSCompoundRequest;
+class XKMSCompoundResult;
+class XKMSMessageFactory;
+class XKMSRequestAbstractType;
+class XKMSResultType;
+
+/**
+ * @ingroup xkms
+ */
+
+/**
+ * @brief Application call back used to answer a single request
+ *
+ * An XKMSCompoundProcessor hands each request held in a CompoundRequest
+ * to an implementation of this interface.  Calls are made from several
+ * threads at once, so implementations must be thread safe.
+ */
+
+class DSIG_EXPORT XKMSRequestHandler {
+
+public:
+
+	virtual ~XKMSRequestHandler() {};
+
+	/**
+	 * \brief Build the result for one request
+	 *
+	 * The request and the document are private to the call - each
+	 * request is copied into a document of its own before it is handed
+	 * out, so the handler may read the request and create nodes in the
+	 * document without locking.  The factory is shared between all
+	 * threads and must only be used to create messages.
+	 *
+	 * @param request The request to be answered.  Use the message type
+	 * to find out which type of request it is.
+	 * @param factory Factory to create the result with
+	 * @param doc Document to create the result in
+	 * @returns The result (owned by the caller).  If NULL is returned (or an
+	 * exception is thrown) a Receiver/Failure Result is sent instead.
+	 */
+
+	virtual XKMSResultType * processRequest(
+		XKMSRequestAbstractType * request,
+		XKMSMessageFactory * factory,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument * doc) = 0;
+
+};
+
+/**
+ * @brief Answer the requests in a CompoundRequest using a pool of threads
+ *
+ * The requests held in a CompoundRequest are independent of each other,
+ * so a responder can work on them at the same time.  This class copies
+ * each member request into a document of its own, gives the requests to
+ * a number of worker threads that call the application's
+ * XKMSRequestHandler, and then builds the CompoundResult, placing the
+ * results in the same order as the requests they answer.
+ *
+ * Copying the requests is done on the calling thread, as is moving the
+ * results into the output document.  The DOM is never touched by more
+ * than one thread at a time.
+ */
+
+class DSIG_EXPORT XKMSCompoundProcessor {
+
+public:
+
+	/** @name Constructors and Destructors */
+	//@{
+
+	/**
+	 * \brief Constructor
+	 *
+	 * @param handler The application handler used to answer each request.
+	 * Not owned by the processor.
+	 * @param threads Maximum number of threads to use for a single
+	 * CompoundRequest (including the calling thread).
+	 */
+
+	XKMSCompoundProcessor(XKMSRequestHandler * handler, unsigned int threads = 4);
+	~XKMSCompoundProcessor();
+
+	//@}
+
+	/** @name Processing */
+	//@{
+
+	/**
+	 * \brief Answer a CompoundRequest
+	 *
+	 * Calls the handler for every request in the CompoundRequest
+	 * and returns a CompoundResult holding the results.  The CompoundResult
+	 * itself has a major result of Success.
+	 *
+	 * @param request The CompoundRequest to answer
+	 * @param factory Factory used to create the results
+	 * @param doc Document to create the CompoundResult in.  As with the
+	 * factory, the new element is not appended to the document.
+	 * @param id Id for the CompoundResult.  If NULL, the library will
+	 * generate a new Unique Id value.
+	 * @returns The new CompoundResult (owned by the caller)
+	 */
+
+	XKMSCompoundResult * process(
+		XKMSCompoundRequest * request,
+		XKMSMessageFactory * factory,
+		XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument * doc,
+		const XMLCh * id = NULL);
+
+	//@}
+
+private:
+
+	XKMSRequestHandler			* mp_handler;
+	unsigned int				m_threads;
+
+	// Unimplemented
+	XKMSCompoundProcessor(const XKMSCompoundProcessor &);
+	XKMSCompoundProcessor & operator = (const XKMSCompoundProcessor &);
+
+};
+
+#endif /* XKMSCOMPOUNDPROCESSOR_INCLUDE */
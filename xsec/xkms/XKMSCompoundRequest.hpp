@@ -115,6 +115,10 @@ public:
 	 * Obtain a particular request from the list of requests held in this
 	 * compound object
 	 *
+	 * Items read from an existing message are loaded from the DOM the
+	 * first time they are requested, so a problem with an individual
+	 * request is reported here rather than when the message is loaded.
+	 *
 	 * @returns The nominated item
 	 */
 	 
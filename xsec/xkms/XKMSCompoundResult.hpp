@@ -125,6 +125,10 @@ public:
 	 * Obtain a particular Result from the list of Results held in this
 	 * compound object
 	 *
+	 * Items read from an existing message are loaded from the DOM the
+	 * first time they are requested, so a problem with an individual
+	 * Result is reported here rather than when the message is loaded.
+	 *
 	 * @returns The nominated item
 	 */
 	 
@@ -38,9 +38,137 @@ XERCES_CPP_NAMESPACE_USE
 //           Constant Strings Storage
 // --------------------------------------------------------------------------------
 
-const XMLCh * XKMSConstants::s_unicodeStrURIXKMS;
-const XMLCh * XKMSConstants::s_unicodeStrURISOAP11;
-const XMLCh * XKMSConstants::s_unicodeStrURISOAP12;
+// Namespace URIs are static data, so nothing is transcoded at start up
+
+static const XMLCh s_strURIXKMS[] = {
+
+	chLatin_h,
+	chLatin_t,
+	chLatin_t,
+	chLatin_p,
+	chColon,
+	chForwardSlash,
+	chForwardSlash,
+	chLatin_w,
+	chLatin_w,
+	chLatin_w,
+	chPeriod,
+	chLatin_w,
+	chDigit_3,
+	chPeriod,
+	chLatin_o,
+	chLatin_r,
+	chLatin_g,
+	chForwardSlash,
+	chDigit_2,
+	chDigit_0,
+	chDigit_0,
+	chDigit_2,
+	chForwardSlash,
+	chDigit_0,
+	chDigit_3,
+	chForwardSlash,
+	chLatin_x,
+	chLatin_k,
+	chLatin_m,
+	chLatin_s,
+	chPound,
+	chNull
+};
+
+static const XMLCh s_strURISOAP11[] = {
+
+	chLatin_h,
+	chLatin_t,
+	chLatin_t,
+	chLatin_p,
+	chColon,
+	chForwardSlash,
+	chForwardSlash,
+	chLatin_s,
+	chLatin_c,
+	chLatin_h,
+	chLatin_e,
+	chLatin_m,
+	chLatin_a,
+	chLatin_s,
+	chPeriod,
+	chLatin_x,
+	chLatin_m,
+	chLatin_l,
+	chLatin_s,
+	chLatin_o,
+	chLatin_a,
+	chLatin_p,
+	chPeriod,
+	chLatin_o,
+	chLatin_r,
+	chLatin_g,
+	chForwardSlash,
+	chLatin_s,
+	chLatin_o,
+	chLatin_a,
+	chLatin_p,
+	chForwardSlash,
+	chLatin_e,
+	chLatin_n,
+	chLatin_v,
+	chLatin_e,
+	chLatin_l,
+	chLatin_o,
+	chLatin_p,
+	chLatin_e,
+	chForwardSlash,
+	chNull
+};
+
+static const XMLCh s_strURISOAP12[] = {
+
+	chLatin_h,
+	chLatin_t,
+	chLatin_t,
+	chLatin_p,
+	chColon,
+	chForwardSlash,
+	chForwardSlash,
+	chLatin_w,
+	chLatin_w,
+	chLatin_w,
+	chPeriod,
+	chLatin_w,
+	chDigit_3,
+	chPeriod,
+	chLatin_o,
+	chLatin_r,
+	chLatin_g,
+	chForwardSlash,
+	chDigit_2,
+	chDigit_0,
+	chDigit_0,
+	chDigit_3,
+	chForwardSlash,
+	chDigit_0,
+	chDigit_5,
+	chForwardSlash,
+	chLatin_s,
+	chLatin_o,
+	chLatin_a,
+	chLatin_p,
+	chDash,
+	chLatin_e,
+	chLatin_n,
+	chLatin_v,
+	chLatin_e,
+	chLatin_l,
+	chLatin_o,
+	chLatin_p,
+	chLatin_e,
+	chNull
+};
+
+const XMLCh * XKMSConstants::s_unicodeStrURIXKMS = s_strURIXKMS;
+const XMLCh * XKMSConstants::s_unicodeStrURISOAP11 = s_strURISOAP11;
+const XMLCh * XKMSConstants::s_unicodeStrURISOAP12 = s_strURISOAP12;
 
 // NOTE All tags are unicode (UTF-16) - but are not marked as such
 
@@ -1806,23 +1934,10 @@ const XMLCh XKMSConstants::s_tagStatusReasonCodes[][17] = {
 
 void XKMSConstants::create() {
 
-	// Set up the static strings
-
-	s_unicodeStrURIXKMS = XMLString::transcode(URI_ID_XKMS);
-	s_unicodeStrURISOAP11 = XMLString::transcode(URI_ID_SOAP11);
-	s_unicodeStrURISOAP12 = XMLString::transcode(URI_ID_SOAP12);
+	// The strings are static - nothing to set up
 
 }
 
 void XKMSConstants::destroy() {
 
-    XMLCh* temp1 = const_cast<XMLCh*>(s_unicodeStrURIXKMS);
-    XMLCh* temp2 = const_cast<XMLCh*>(s_unicodeStrURISOAP11);
-    XMLCh* temp3 = const_cast<XMLCh*>(s_unicodeStrURISOAP12);
-	XSEC_RELEASE_XMLCH(temp1);
-	XSEC_RELEASE_XMLCH(temp2);
-	XSEC_RELEASE_XMLCH(temp3);
-    s_unicodeStrURIXKMS = NULL;
-    s_unicodeStrURISOAP11 = NULL;
-    s_unicodeStrURISOAP12 = NULL;
 }
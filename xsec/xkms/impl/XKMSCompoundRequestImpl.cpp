@@ -108,13 +108,18 @@ void XKMSCompoundRequestImpl::load() {
 
 	while (e != NULL) {
 
-		if (strEquals(getXKMSLocalName(e), XKMSConstants::s_tagLocateRequest) ||
-			strEquals(getXKMSLocalName(e), XKMSConstants::s_tagValidateRequest)) {
+		const XMLCh * name = getXKMSLocalName(e);
 
-			// Have a legitimate request to load
-			XKMSMessageAbstractTypeImpl * m = 
-				(XKMSMessageAbstractTypeImpl *) m_factory.newMessageFromDOM(e);
-			m_requestList.push_back((XKMSRequestAbstractTypeImpl *) m);
+		if (strEquals(name, XKMSConstants::s_tagLocateRequest) ||
+			strEquals(name, XKMSConstants::s_tagValidateRequest) ||
+			strEquals(name, XKMSConstants::s_tagRegisterRequest) ||
+			strEquals(name, XKMSConstants::s_tagRevokeRequest) ||
+			strEquals(name, XKMSConstants::s_tagReissueRequest) ||
+			strEquals(name, XKMSConstants::s_tagRecoverRequest)) {
+
+			// Have a legitimate request - loaded when it is first used
+			m_requestElements.push_back(e);
+			m_requestList.push_back(NULL);
 
 		}
 
@@ -161,8 +166,15 @@ XKMSRequestAbstractType * XKMSCompoundRequestImpl::getRequestListItem(int item)
 			"XKMSCompoundRequest::getRequestListItem - item out of range");
 	}
 
-	return m_requestList[item];
+	if (m_requestList[item] == NULL) {
+
+		XKMSMessageAbstractTypeImpl * m = 
+			(XKMSMessageAbstractTypeImpl *) m_factory.newMessageFromDOM(m_requestElements[item]);
+		m_requestList[item] = (XKMSRequestAbstractTypeImpl *) m;
 
+	}
+
+	return m_requestList[item];
 
 }
 
@@ -176,6 +188,7 @@ XKMSLocateRequest * XKMSCompoundRequestImpl::createLocateRequest(
 
 	XKMSLocateRequest * r = m_factory.createLocateRequest(service, m_msg.mp_env->getParentDocument(), id);
 	m_requestList.push_back((XKMSRequestAbstractTypeImpl*) r);
+	m_requestElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -190,6 +203,7 @@ XKMSValidateRequest * XKMSCompoundRequestImpl::createValidateRequest(
 
 	XKMSValidateRequest * r = m_factory.createValidateRequest(service, m_msg.mp_env->getParentDocument(), id);
 	m_requestList.push_back((XKMSRequestAbstractTypeImpl*) r);
+	m_requestElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -203,6 +217,7 @@ XKMSRegisterRequest * XKMSCompoundRequestImpl::createRegisterRequest(
 
 	XKMSRegisterRequest * r = m_factory.createRegisterRequest(service, m_msg.mp_env->getParentDocument(), id);
 	m_requestList.push_back((XKMSRequestAbstractTypeImpl*) r);
+	m_requestElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -216,6 +231,7 @@ XKMSRevokeRequest * XKMSCompoundRequestImpl::createRevokeRequest(
 
 	XKMSRevokeRequest * r = m_factory.createRevokeRequest(service, m_msg.mp_env->getParentDocument(), id);
 	m_requestList.push_back((XKMSRequestAbstractTypeImpl*) r);
+	m_requestElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -229,6 +245,7 @@ XKMSReissueRequest * XKMSCompoundRequestImpl::createReissueRequest(
 
 	XKMSReissueRequest * r = m_factory.createReissueRequest(service, m_msg.mp_env->getParentDocument(), id);
 	m_requestList.push_back((XKMSRequestAbstractTypeImpl*) r);
+	m_requestElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -242,6 +259,7 @@ XKMSRecoverRequest * XKMSCompoundRequestImpl::createRecoverRequest(
 
 	XKMSRecoverRequest * r = m_factory.createRecoverRequest(service, m_msg.mp_env->getParentDocument(), id);
 	m_requestList.push_back((XKMSRequestAbstractTypeImpl*) r);
+	m_requestElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
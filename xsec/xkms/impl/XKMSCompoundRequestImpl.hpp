@@ -108,11 +108,16 @@ private:
 
 #if defined(XSEC_NO_NAMESPACES)
 	typedef vector<XKMSRequestAbstractTypeImpl *>		RequestListVectorType;
+	typedef vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementListVectorType;
 #else
 	typedef std::vector<XKMSRequestAbstractTypeImpl *>	RequestListVectorType;
+	typedef std::vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementListVectorType;
 #endif
 
+	// Requests found by load() are only built when first accessed - an
+	// entry in m_requestList is NULL until then
 	RequestListVectorType	m_requestList;
+	ElementListVectorType	m_requestElements;
 
 	/* Used to consume and produce messages in the list */
 	XKMSMessageFactoryImpl	m_factory;
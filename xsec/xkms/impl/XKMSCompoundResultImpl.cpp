@@ -110,13 +110,20 @@ void XKMSCompoundResultImpl::load() {
 
 	while (e != NULL) {
 
-		if (strEquals(getXKMSLocalName(e), XKMSConstants::s_tagLocateResult) ||
-			strEquals(getXKMSLocalName(e), XKMSConstants::s_tagValidateResult)) {
+		const XMLCh * name = getXKMSLocalName(e);
 
-			// Have a legitimate Result to load
-			XKMSMessageAbstractTypeImpl * m = 
-				(XKMSMessageAbstractTypeImpl *) m_factory.newMessageFromDOM(e);
-			m_resultList.push_back((XKMSResultTypeImpl *) m);
+		if (strEquals(name, XKMSConstants::s_tagLocateResult) ||
+			strEquals(name, XKMSConstants::s_tagValidateResult) ||
+			strEquals(name, XKMSConstants::s_tagStatusResult) ||
+			strEquals(name, XKMSConstants::s_tagRegisterResult) ||
+			strEquals(name, XKMSConstants::s_tagRevokeResult) ||
+			strEquals(name, XKMSConstants::s_tagReissueResult) ||
+			strEquals(name, XKMSConstants::s_tagRecoverResult) ||
+			strEquals(name, XKMSConstants::s_tagResult)) {
+
+			// Have a legitimate Result - loaded when it is first used
+			m_resultElements.push_back(e);
+			m_resultList.push_back(NULL);
 
 		}
 
@@ -165,8 +172,15 @@ XKMSResultType * XKMSCompoundResultImpl::getResultListItem(int item) {
 			"XKMSCompoundResult::getResultListItem - item out of range");
 	}
 
-	return m_resultList[item];
+	if (m_resultList[item] == NULL) {
+
+		XKMSMessageAbstractTypeImpl * m = 
+			(XKMSMessageAbstractTypeImpl *) m_factory.newMessageFromDOM(m_resultElements[item]);
+		m_resultList[item] = (XKMSResultTypeImpl *) m;
 
+	}
+
+	return m_resultList[item];
 
 }
 
@@ -182,6 +196,7 @@ XKMSLocateResult * XKMSCompoundResultImpl::createLocateResult(
 
 	XKMSLocateResult * r = m_factory.createLocateResult(request, m_msg.mp_env->getParentDocument(), rmaj, rmin, id);
 	m_resultList.push_back((XKMSResultTypeImpl*) r);
+	m_resultElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -198,6 +213,7 @@ XKMSValidateResult * XKMSCompoundResultImpl::createValidateResult(
 
 	XKMSValidateResult * r = m_factory.createValidateResult(request, m_msg.mp_env->getParentDocument(), rmaj, rmin, id);
 	m_resultList.push_back((XKMSResultTypeImpl*) r);
+	m_resultElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -214,6 +230,7 @@ XKMSStatusResult * XKMSCompoundResultImpl::createStatusResult(
 
 	XKMSStatusResult * r = m_factory.createStatusResult(request, m_msg.mp_env->getParentDocument(), rmaj, rmin, id);
 	m_resultList.push_back((XKMSResultTypeImpl*) r);
+	m_resultElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -230,6 +247,7 @@ XKMSRegisterResult * XKMSCompoundResultImpl::createRegisterResult(
 
 	XKMSRegisterResult * r = m_factory.createRegisterResult(request, m_msg.mp_env->getParentDocument(), rmaj, rmin, id);
 	m_resultList.push_back((XKMSResultTypeImpl*) r);
+	m_resultElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -246,6 +264,7 @@ XKMSRevokeResult * XKMSCompoundResultImpl::createRevokeResult(
 
 	XKMSRevokeResult * r = m_factory.createRevokeResult(request, m_msg.mp_env->getParentDocument(), rmaj, rmin, id);
 	m_resultList.push_back((XKMSResultTypeImpl*) r);
+	m_resultElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -262,6 +281,7 @@ XKMSRecoverResult * XKMSCompoundResultImpl::createRecoverResult(
 
 	XKMSRecoverResult * r = m_factory.createRecoverResult(request, m_msg.mp_env->getParentDocument(), rmaj, rmin, id);
 	m_resultList.push_back((XKMSResultTypeImpl*) r);
+	m_resultElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -278,6 +298,7 @@ XKMSReissueResult * XKMSCompoundResultImpl::createReissueResult(
 
 	XKMSReissueResult * r = m_factory.createReissueResult(request, m_msg.mp_env->getParentDocument(), rmaj, rmin, id);
 	m_resultList.push_back((XKMSResultTypeImpl*) r);
+	m_resultElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
@@ -295,6 +316,7 @@ XKMSResult * XKMSCompoundResultImpl::createResult(
 
 	XKMSResult * r = m_factory.createResult(request, m_msg.mp_env->getParentDocument(), rmaj, rmin, id);
 	m_resultList.push_back((XKMSResultTypeImpl*) r);
+	m_resultElements.push_back(r->getElement());
 
 	m_msg.mp_messageAbstractTypeElement->appendChild(r->getElement());
 	m_msg.mp_env->doPrettyPrint(m_msg.mp_messageAbstractTypeElement);
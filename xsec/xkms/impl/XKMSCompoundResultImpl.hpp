@@ -129,11 +129,16 @@ private:
 
 #if defined(XSEC_NO_NAMESPACES)
 	typedef vector<XKMSResultTypeImpl *>		ResultListVectorType;
+	typedef vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementListVectorType;
 #else
 	typedef std::vector<XKMSResultTypeImpl *>	ResultListVectorType;
+	typedef std::vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementListVectorType;
 #endif
 
+	// Results found by load() are only built when first accessed - an
+	// entry in m_resultList is NULL until then
 	ResultListVectorType	m_resultList;
+	ElementListVectorType	m_resultElements;
 
 	/* Used to consume and produce messages in the list */
 	XKMSMessageFactoryImpl	m_factory;
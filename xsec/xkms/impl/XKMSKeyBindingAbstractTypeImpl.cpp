@@ -152,11 +152,9 @@ void XKMSKeyBindingAbstractTypeImpl::load(void) {
 
 	while (tmpElt != NULL && strEquals(getXKMSLocalName(tmpElt), XKMSConstants::s_tagUseKeyWith)) {
 
-		XKMSUseKeyWithImpl *ukw;
-		XSECnew(ukw, XKMSUseKeyWithImpl(mp_env, tmpElt));
-
-		m_useKeyWithList.push_back(ukw);
-		ukw->load();
+		// Built when first accessed
+		m_useKeyWithElements.push_back(tmpElt);
+		m_useKeyWithList.push_back(NULL);
 
 		tmpElt = findNextElementChild(tmpElt);
 	}
@@ -472,6 +470,18 @@ XKMSUseKeyWith * XKMSKeyBindingAbstractTypeImpl::getUseKeyWithItem(int item) con
 			"XKMSKeyBindingAbstractType::getUseKeyWithItem - item out of range");
 	}
 
+	if (m_useKeyWithList[item] == NULL) {
+
+		XKMSUseKeyWithImpl * ukw;
+		XSECnew(ukw, XKMSUseKeyWithImpl(mp_env, m_useKeyWithElements[item]));
+		Janitor<XKMSUseKeyWithImpl> j_ukw(ukw);
+		ukw->load();
+
+		j_ukw.release();
+		m_useKeyWithList[item] = ukw;
+
+	}
+
 	return m_useKeyWithList[item];
 
 }
@@ -487,6 +497,7 @@ XKMSUseKeyWith * XKMSKeyBindingAbstractTypeImpl::appendUseKeyWithItem(
 	m_useKeyWithList.push_back(u);
 
 	DOMElement * e = u->createBlankUseKeyWith(application, identifier);
+	m_useKeyWithElements.push_back(e);
 
 	// Find where to append the element
 	DOMElement * t = findFirstElementChild(mp_keyBindingAbstractTypeElement);
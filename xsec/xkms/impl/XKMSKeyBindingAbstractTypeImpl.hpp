@@ -119,11 +119,16 @@ private:
 
 #if defined(XSEC_NO_NAMESPACES)
 	typedef vector<XKMSUseKeyWithImpl *>		UseKeyWithVectorType;
+	typedef vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementVectorType;
 #else
 	typedef std::vector<XKMSUseKeyWithImpl *>	UseKeyWithVectorType;
+	typedef std::vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementVectorType;
 #endif
 
-	UseKeyWithVectorType	m_useKeyWithList;
+	// UseKeyWith objects found by load() are only built when first
+	// accessed - an entry in m_useKeyWithList is NULL until then
+	mutable UseKeyWithVectorType	m_useKeyWithList;
+	ElementVectorType		m_useKeyWithElements;
 	
 	XERCES_CPP_NAMESPACE_QUALIFIER DOMNode
 					* mp_idAttr;
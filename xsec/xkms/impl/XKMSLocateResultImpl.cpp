@@ -36,6 +36,7 @@
 #include "XKMSUnverifiedKeyBindingImpl.hpp"
 
 #include <xercesc/dom/DOM.hpp>
+#include <xercesc/util/Janitor.hpp>
 
 XERCES_CPP_NAMESPACE_USE
 
@@ -101,12 +102,11 @@ void XKMSLocateResultImpl::load() {
 
 	if (nl != NULL) {
 
-		XKMSUnverifiedKeyBindingImpl * ukb;
 		for (unsigned int i = 0; i < nl->getLength() ; ++ i) {
 
-			XSECnew(ukb, XKMSUnverifiedKeyBindingImpl(m_msg.mp_env, (DOMElement *) nl->item(i)));
-			m_unverifiedKeyBindingList.push_back(ukb);
-			ukb->load();
+			// Built when first accessed
+			m_unverifiedKeyBindingElements.push_back((DOMElement *) nl->item(i));
+			m_unverifiedKeyBindingList.push_back(NULL);
 
 		}
 
@@ -160,6 +160,18 @@ XKMSUnverifiedKeyBinding * XKMSLocateResultImpl::getUnverifiedKeyBindingItem(int
 			"XKMSLocateResult::getUnverifiedKeyBindingItem - item out of range");
 	}
 
+	if (m_unverifiedKeyBindingList[item] == NULL) {
+
+		XKMSUnverifiedKeyBindingImpl * ukb;
+		XSECnew(ukb, XKMSUnverifiedKeyBindingImpl(m_msg.mp_env, m_unverifiedKeyBindingElements[item]));
+		Janitor<XKMSUnverifiedKeyBindingImpl> j_ukb(ukb);
+		ukb->load();
+
+		j_ukb.release();
+		m_unverifiedKeyBindingList[item] = ukb;
+
+	}
+
 	return m_unverifiedKeyBindingList[item];
 
 }
@@ -173,6 +185,7 @@ XKMSUnverifiedKeyBinding * XKMSLocateResultImpl::appendUnverifiedKeyBindingItem(
 	m_unverifiedKeyBindingList.push_back(u);
 
 	DOMElement * e = u->createBlankUnverifiedKeyBinding();
+	m_unverifiedKeyBindingElements.push_back(e);
 
 	// Append the element
 
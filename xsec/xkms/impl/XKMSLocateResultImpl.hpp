@@ -89,11 +89,16 @@ private:
 
 #if defined(XSEC_NO_NAMESPACES)
 	typedef vector<XKMSUnverifiedKeyBindingImpl *>		UnverifiedKeyBindingVectorType;
+	typedef vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementVectorType;
 #else
 	typedef std::vector<XKMSUnverifiedKeyBindingImpl *>	UnverifiedKeyBindingVectorType;
+	typedef std::vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementVectorType;
 #endif
 
-	UnverifiedKeyBindingVectorType	m_unverifiedKeyBindingList;
+	// Key bindings found by load() are only built when first accessed -
+	// an entry in m_unverifiedKeyBindingList is NULL until then
+	mutable UnverifiedKeyBindingVectorType	m_unverifiedKeyBindingList;
+	ElementVectorType	m_unverifiedKeyBindingElements;
 
 	// Unimplemented
 	XKMSLocateResultImpl(const XKMSLocateResultImpl &);
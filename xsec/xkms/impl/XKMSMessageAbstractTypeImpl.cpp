@@ -131,15 +131,7 @@ void XKMSMessageAbstractTypeImpl::load(void) {
 
 	}
 
-	// The provider will take care of cleaning this up later.
-
-	if (mp_signatureElement != NULL) {
-
-		mp_signature = m_prov.newSignatureFromDOM(mp_signatureElement->getOwnerDocument(), 
-												  mp_signatureElement);
-		mp_signature->load();
-
-	}
+	// The signature itself is loaded by getSignature() when first used
 
 	// Cheque for OpaqueClientData
 	mp_opaqueClientDataElement = (DOMElement *) findFirstChildOfType(mp_messageAbstractTypeElement, DOMNode::ELEMENT_NODE);
@@ -245,12 +237,31 @@ DOMElement * XKMSMessageAbstractTypeImpl::createBlankMessageAbstractType(
 
 bool XKMSMessageAbstractTypeImpl::isSigned(void) const {
 
-	return mp_signature != NULL;
+	return mp_signature != NULL || mp_signatureElement != NULL;
 
 }
 
 DSIGSignature * XKMSMessageAbstractTypeImpl::getSignature(void) const {
 
+	if (mp_signature == NULL && mp_signatureElement != NULL) {
+
+		// The provider will take care of cleaning this up later.
+
+		DSIGSignature * sig = m_prov.newSignatureFromDOM(mp_signatureElement->getOwnerDocument(), 
+												  mp_signatureElement);
+
+		try {
+			sig->load();
+		}
+		catch (...) {
+			m_prov.releaseSignature(sig);
+			throw;
+		}
+
+		mp_signature = sig;
+
+	}
+
 	return mp_signature;
 
 }
@@ -118,8 +118,9 @@ private:
 	XERCES_CPP_NAMESPACE_QUALIFIER  DOMElement
 						* mp_opaqueClientDataElement;
 
-	XSECProvider		m_prov;
-	DSIGSignature		* mp_signature;
+	// The signature is loaded on first use by getSignature()
+	mutable XSECProvider	m_prov;
+	mutable DSIGSignature	* mp_signature;
 
 	int					m_opaqueClientDataSize;
 
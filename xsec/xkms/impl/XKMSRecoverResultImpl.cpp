@@ -44,6 +44,7 @@
 #include "XKMSRSAKeyPairImpl.hpp"
 
 #include <xercesc/dom/DOM.hpp>
+#include <xercesc/util/Janitor.hpp>
 
 XERCES_CPP_NAMESPACE_USE
 
@@ -116,12 +117,11 @@ void XKMSRecoverResultImpl::load() {
 
 	if (nl != NULL) {
 
-		XKMSKeyBindingImpl * kb;
 		for (unsigned int i = 0; i < nl->getLength() ; ++ i) {
 
-			XSECnew(kb, XKMSKeyBindingImpl(m_msg.mp_env, (DOMElement *) nl->item(i)));
-			m_keyBindingList.push_back(kb);
-			kb->load();
+			// Built when first accessed
+			m_keyBindingElements.push_back((DOMElement *) nl->item(i));
+			m_keyBindingList.push_back(NULL);
 
 		}
 
@@ -181,6 +181,18 @@ XKMSKeyBinding * XKMSRecoverResultImpl::getKeyBindingItem(int item) const {
 			"XKMSRecoverResult::getKeyBindingItem - item out of range");
 	}
 
+	if (m_keyBindingList[item] == NULL) {
+
+		XKMSKeyBindingImpl * kb;
+		XSECnew(kb, XKMSKeyBindingImpl(m_msg.mp_env, m_keyBindingElements[item]));
+		Janitor<XKMSKeyBindingImpl> j_kb(kb);
+		kb->load();
+
+		j_kb.release();
+		m_keyBindingList[item] = kb;
+
+	}
+
 	return m_keyBindingList[item];
 
 }
@@ -194,6 +206,7 @@ XKMSKeyBinding * XKMSRecoverResultImpl::appendKeyBindingItem(XKMSStatus::StatusV
 	m_keyBindingList.push_back(u);
 
 	DOMElement * e = u->createBlankKeyBinding(status);
+	m_keyBindingElements.push_back(e);
 
 	// Append the element
 	DOMElement * c = findFirstElementChild(m_msg.mp_messageAbstractTypeElement);
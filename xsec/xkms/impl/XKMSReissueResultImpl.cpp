@@ -36,6 +36,7 @@
 #include "XKMSKeyBindingImpl.hpp"
 
 #include <xercesc/dom/DOM.hpp>
+#include <xercesc/util/Janitor.hpp>
 
 XERCES_CPP_NAMESPACE_USE
 
@@ -101,12 +102,11 @@ void XKMSReissueResultImpl::load() {
 
 	if (nl != NULL) {
 
-		XKMSKeyBindingImpl * kb;
 		for (unsigned int i = 0; i < nl->getLength() ; ++ i) {
 
-			XSECnew(kb, XKMSKeyBindingImpl(m_msg.mp_env, (DOMElement *) nl->item(i)));
-			m_keyBindingList.push_back(kb);
-			kb->load();
+			// Built when first accessed
+			m_keyBindingElements.push_back((DOMElement *) nl->item(i));
+			m_keyBindingList.push_back(NULL);
 
 		}
 
@@ -160,6 +160,18 @@ XKMSKeyBinding * XKMSReissueResultImpl::getKeyBindingItem(int item) const {
 			"XKMSReissueResult::getKeyBindingItem - item out of range");
 	}
 
+	if (m_keyBindingList[item] == NULL) {
+
+		XKMSKeyBindingImpl * kb;
+		XSECnew(kb, XKMSKeyBindingImpl(m_msg.mp_env, m_keyBindingElements[item]));
+		Janitor<XKMSKeyBindingImpl> j_kb(kb);
+		kb->load();
+
+		j_kb.release();
+		m_keyBindingList[item] = kb;
+
+	}
+
 	return m_keyBindingList[item];
 
 }
@@ -173,6 +185,7 @@ XKMSKeyBinding * XKMSReissueResultImpl::appendKeyBindingItem(XKMSStatus::StatusV
 	m_keyBindingList.push_back(u);
 
 	DOMElement * e = u->createBlankKeyBinding(status);
+	m_keyBindingElements.push_back(e);
 
 	// Append the element
 
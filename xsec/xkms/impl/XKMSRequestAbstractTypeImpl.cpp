@@ -34,7 +34,7 @@
 #include <xsec/xkms/XKMSConstants.hpp>
 
 #include <xercesc/dom/DOM.hpp>
-#include <xercesc/dom/DOMNodeList.hpp>
+#include <xercesc/util/Janitor.hpp>
 
 #include "XKMSRequestAbstractTypeImpl.hpp"
 #include "XKMSRespondWithImpl.hpp"
@@ -92,40 +92,33 @@ void XKMSRequestAbstractTypeImpl::load(void) {
 
 	}
 
-	// Get any respond with elements
-	DOMNodeList * nl = m_msg.mp_messageAbstractTypeElement->getElementsByTagNameNS(
-		XKMSConstants::s_unicodeStrURIXKMS,
-		XKMSConstants::s_tagRespondWith);
+	// RespondWith and ResponseMechanism elements are children of the
+	// request.  A descendant search would also find those belonging to
+	// every request within a CompoundRequest.
 
-	if (nl != NULL) {
-
-		XKMSRespondWithImpl * rw;
-		for (unsigned int i = 0; i < nl->getLength() ; ++ i) {
-
-			XSECnew(rw, XKMSRespondWithImpl(m_msg.mp_env, (DOMElement *) nl->item(i)));
-			rw->load();
-			m_respondWithList.push_back(rw);
+	DOMElement * c = findFirstElementChild(m_msg.mp_messageAbstractTypeElement);
 
-		}
+	while (c != NULL) {
 
-	}
+		if (strEquals(getXKMSLocalName(c), XKMSConstants::s_tagRespondWith)) {
 
-	// Get any ResponseMechanism elements
-	nl = m_msg.mp_messageAbstractTypeElement->getElementsByTagNameNS(
-		XKMSConstants::s_unicodeStrURIXKMS,
-		XKMSConstants::s_tagResponseMechanism);
+			// Built when first accessed
+			m_respondWithElements.push_back(c);
+			m_respondWithList.push_back(NULL);
 
-	if (nl != NULL) {
+		}
 
-		XKMSResponseMechanismImpl * rm;
-		for (unsigned int i = 0; i < nl->getLength() ; ++ i) {
+		else if (strEquals(getXKMSLocalName(c), XKMSConstants::s_tagResponseMechanism)) {
 
-			XSECnew(rm, XKMSResponseMechanismImpl(m_msg.mp_env, (DOMElement *) nl->item(i)));
-			rm->load();
+			XKMSResponseMechanismImpl * rm;
+			XSECnew(rm, XKMSResponseMechanismImpl(m_msg.mp_env, c));
 			m_responseMechanismList.push_back(rm);
+			rm->load();
 
 		}
 
+		c = findNextElementChild(c);
+
 	}
 
 	mp_originalRequestIdAttr = 
@@ -232,20 +225,25 @@ XKMSRespondWith * XKMSRequestAbstractTypeImpl::getRespondWithItem(int item) {
 
 	}
 
-	return m_respondWithList[item];
+	if (m_respondWithList[item] == NULL) {
 
-}
+		XKMSRespondWithImpl * rw;
+		XSECnew(rw, XKMSRespondWithImpl(m_msg.mp_env, m_respondWithElements[item]));
+		Janitor<XKMSRespondWithImpl> j_rw(rw);
+		rw->load();
 
-const XMLCh * XKMSRequestAbstractTypeImpl::getRespondWithItemStr(int item) {
+		j_rw.release();
+		m_respondWithList[item] = rw;
 
-	if (item < 0 || item >= (int) m_respondWithList.size()) {
+	}
 
-		throw XSECException(XSECException::RequestAbstractTypeError,
-			"XKMSRequestAbstractTypeImpl::getRespondWithItem - item out of range");
+	return m_respondWithList[item];
 
-	}
+}
+
+const XMLCh * XKMSRequestAbstractTypeImpl::getRespondWithItemStr(int item) {
 
-	return m_respondWithList[item]->getRespondWithString();
+	return getRespondWithItem(item)->getRespondWithString();
 
 }
 
@@ -284,6 +282,7 @@ void XKMSRequestAbstractTypeImpl::appendRespondWithItem(const XMLCh * item) {
 
 	// Add to the list
 	m_respondWithList.push_back(rw);
+	m_respondWithElements.push_back(elt);
 
 }
 
@@ -126,8 +126,10 @@ private:
 
 #if defined(XSEC_NO_NAMESPACES)
 	typedef vector<XKMSRespondWithImpl *>		RespondWithVectorType;
+	typedef vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementVectorType;
 #else
 	typedef std::vector<XKMSRespondWithImpl *>	RespondWithVectorType;
+	typedef std::vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementVectorType;
 #endif
 
 #if defined(XSEC_NO_NAMESPACES)
@@ -136,7 +138,10 @@ private:
 	typedef std::vector<XKMSResponseMechanismImpl *>	ResponseMechanismVectorType;
 #endif
 
+	// RespondWith objects found by load() are only built when first
+	// accessed - an entry in m_respondWithList is NULL until then
 	RespondWithVectorType		m_respondWithList;		// List of m_respondWith elements
+	ElementVectorType			m_respondWithElements;
 	ResponseMechanismVectorType	m_responseMechanismList;// List of responseMechanism elements
 
 	XERCES_CPP_NAMESPACE_QUALIFIER  DOMAttr
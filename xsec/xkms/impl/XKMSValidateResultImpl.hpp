@@ -88,11 +88,16 @@ private:
 
 #if defined(XSEC_NO_NAMESPACES)
 	typedef vector<XKMSKeyBindingImpl *>		KeyBindingVectorType;
+	typedef vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementVectorType;
 #else
 	typedef std::vector<XKMSKeyBindingImpl *>	KeyBindingVectorType;
+	typedef std::vector<XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *>	ElementVectorType;
 #endif
 
-	KeyBindingVectorType	m_keyBindingList;
+	// Key bindings found by load() are only built when first accessed -
+	// an entry in m_keyBindingList is NULL until then
+	mutable KeyBindingVectorType	m_keyBindingList;
+	ElementVectorType	m_keyBindingElements;
 
 	// Unimplemented
 	XKMSValidateResultImpl(const XKMSValidateResultImpl &);